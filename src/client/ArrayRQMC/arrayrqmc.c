@@ -0,0 +1,249 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Array-RQMC for a single-server queue.
+ *
+ * Estimates the expected average waiting time of the first customers of an
+ * M/M/1 queue, simulated with the Lindley recursion, with array-RQMC: the
+ * chains are sorted by waiting time on the device between steps, and each
+ * step uses a freshly shifted two-dimensional lattice rule.
+ *
+ * Every chain has the exact distribution of the queue, so the empirical
+ * variance of the chains within a replication estimates the variance of a
+ * single run; dividing it by the number of chains gives the variance of the
+ * Monte Carlo estimator with the same number of runs, which is compared to
+ * the variance of the array-RQMC estimator across replications.
+ */
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common.h"
+
+#include <clQMC/arrayrqmc.h>
+#include <clQMC/randomshift.h>
+
+#define STEP_DIMENSION 2
+#define SHIFTS_SEED    1234
+
+typedef struct ChainState_ {
+  clqmc_fptype wait;
+  clqmc_fptype sum;
+} ChainState;
+
+typedef struct TaskData_ {
+  cl_uint log2_chains;
+  cl_uint steps;
+  cl_uint replications;
+  clqmc_fptype lambda;
+  clqmc_fptype mu;
+} TaskData;
+
+int task(cl_context context, cl_device_id device, cl_command_queue queue, void* data_)
+{
+  const TaskData* data = (const TaskData*) data_;
+  cl_uint chains = (cl_uint) 1 << data->log2_chains;
+  cl_int err;
+
+  // Lattice rule of the steps and sorter
+
+  size_t lattice_size;
+  clqmcLatticeRule* lattice = clqmcArrayRQMCCreateLatticeRule(data->log2_chains, STEP_DIMENSION,
+      CLQMC_LATTICE_CBC_POLY, &lattice_size, (clqmcStatus*) &err);
+  check_error(err, NULL);
+
+  profile_begin("build sorter");
+  clqmcArrayRQMCSorter* sorter = clqmcArrayRQMCSorterCreate(context, device, chains, 0, (clqmcStatus*) &err);
+  profile_end();
+  check_error(err, NULL);
+
+
+  // Buffers
+
+  cl_mem lattice_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      lattice_size, lattice, &err);
+  check_error(err, "cannot create lattice buffer");
+
+  size_t shifts_size = data->steps * STEP_DIMENSION * sizeof(clqmc_fptype);
+  clqmc_fptype* shifts = (clqmc_fptype*) malloc(shifts_size);
+  cl_mem shifts_buf = clCreateBuffer(context, CL_MEM_READ_ONLY, shifts_size, NULL, &err);
+  check_error(err, "cannot create shifts buffer");
+
+  cl_mem states_buf[2];
+  for (int k = 0; k < 2; k++) {
+    states_buf[k] = clCreateBuffer(context, CL_MEM_READ_WRITE, chains * sizeof(ChainState), NULL, &err);
+    check_error(err, "cannot create states buffer");
+  }
+  cl_mem keys_buf = clCreateBuffer(context, CL_MEM_READ_WRITE, chains * sizeof(clqmc_fptype), NULL, &err);
+  check_error(err, "cannot create keys buffer");
+  cl_mem perm_buf = clCreateBuffer(context, CL_MEM_READ_WRITE, chains * sizeof(cl_uint), NULL, &err);
+  check_error(err, "cannot create permutation buffer");
+
+
+  // Kernels
+
+  cl_program program = build_program_from_file(context, device, "client/ArrayRQMC/arrayrqmc_kernel.cl", NULL);
+  cl_kernel init_kernel = clCreateKernel(program, "initChains", &err);
+  check_error(err, "cannot create kernel");
+  cl_kernel step_kernel = clCreateKernel(program, "advanceChains", &err);
+  check_error(err, "cannot create kernel");
+
+  err  = clSetKernelArg(init_kernel, 1, sizeof(keys_buf), &keys_buf);
+  err |= clSetKernelArg(init_kernel, 2, sizeof(perm_buf), &perm_buf);
+  err |= clSetKernelArg(step_kernel, 0, sizeof(lattice_buf), &lattice_buf);
+  err |= clSetKernelArg(step_kernel, 1, sizeof(shifts_buf), &shifts_buf);
+  err |= clSetKernelArg(step_kernel, 3, sizeof(data->lambda), &data->lambda);
+  err |= clSetKernelArg(step_kernel, 4, sizeof(data->mu), &data->mu);
+  err |= clSetKernelArg(step_kernel, 7, sizeof(keys_buf), &keys_buf);
+  err |= clSetKernelArg(step_kernel, 8, sizeof(perm_buf), &perm_buf);
+  check_error(err, "cannot set kernel arguments");
+
+
+  // Simulation
+
+  ChainState* states = (ChainState*) malloc(chains * sizeof(ChainState));
+  double* estimates = (double*) malloc(data->replications * sizeof(double));
+  double chain_variance = 0.0;
+  size_t global_size = chains;
+
+  profile_begin("simulation");
+
+  for (cl_uint r = 0; r < data->replications; r++) {
+
+    // Independent random shifts for all steps
+    err = clqmcRandomShiftsGenerate(SHIFTS_SEED, r * data->steps, data->steps, STEP_DIMENSION, shifts);
+    check_error(err, NULL);
+    err = clEnqueueWriteBuffer(queue, shifts_buf, CL_FALSE, 0, shifts_size, shifts, 0, NULL, NULL);
+    check_error(err, "cannot write shifts buffer");
+
+    int in = 0;
+    err = clSetKernelArg(init_kernel, 0, sizeof(states_buf[in]), &states_buf[in]);
+    check_error(err, "cannot set kernel arguments");
+    err = clEnqueueNDRangeKernel(queue, init_kernel, 1, NULL, &global_size, NULL, 0, NULL, NULL);
+    check_error(err, "cannot enqueue kernel");
+
+    for (cl_uint step = 0; step < data->steps; step++) {
+      err = clqmcArrayRQMCSorterEnqueue(sorter, queue, keys_buf, perm_buf, 0, NULL, NULL);
+      check_error(err, NULL);
+
+      err  = clSetKernelArg(step_kernel, 2, sizeof(step), &step);
+      err |= clSetKernelArg(step_kernel, 5, sizeof(states_buf[in]), &states_buf[in]);
+      err |= clSetKernelArg(step_kernel, 6, sizeof(states_buf[1 - in]), &states_buf[1 - in]);
+      check_error(err, "cannot set kernel arguments");
+      err = clEnqueueNDRangeKernel(queue, step_kernel, 1, NULL, &global_size, NULL, 0, NULL, NULL);
+      check_error(err, "cannot enqueue kernel");
+      in = 1 - in;
+    }
+
+    err = clEnqueueReadBuffer(queue, states_buf[in], CL_TRUE, 0, chains * sizeof(ChainState), states, 0, NULL, NULL);
+    check_error(err, "cannot read states buffer");
+
+    double sum = 0.0, sum_squares = 0.0;
+    for (cl_uint i = 0; i < chains; i++) {
+      double y = states[i].sum / data->steps;
+      sum += y;
+      sum_squares += y * y;
+    }
+    estimates[r] = sum / chains;
+    chain_variance += (sum_squares - sum * estimates[r]) / (chains - 1) / data->replications;
+  }
+
+  profile_end();
+
+  double mean = 0.0, variance = 0.0;
+  for (cl_uint r = 0; r < data->replications; r++)
+    mean += estimates[r] / data->replications;
+  for (cl_uint r = 0; r < data->replications; r++)
+    variance += (estimates[r] - mean) * (estimates[r] - mean) / (data->replications - 1);
+
+  printf("\nArray-RQMC for the average waiting time of %u customers in an M/M/1 queue (lambda = %g, mu = %g)\n\n",
+      data->steps, (double) data->lambda, (double) data->mu);
+  err = clqmcLatticeRuleWriteInfo(lattice, stdout);
+  check_error(err, NULL);
+  printf("sorting work-group size: %lu\n\n", (unsigned long) clqmcArrayRQMCSorterLocalSize(sorter));
+  printf("%16s%16s%16s%16s%16s\n", "replications", "chains", "mean", "variance", "MC variance");
+  printf("%16u%16u%16.6g%16.6g%16.6g\n", data->replications, chains, mean, variance, chain_variance / chains);
+  printf("\nvariance reduction factor: %g\n", chain_variance / chains / variance);
+
+
+  // Clean up
+
+  free(states);
+  free(estimates);
+  free(shifts);
+  clReleaseKernel(init_kernel);
+  clReleaseKernel(step_kernel);
+  clReleaseProgram(program);
+  clReleaseMemObject(lattice_buf);
+  clReleaseMemObject(shifts_buf);
+  clReleaseMemObject(states_buf[0]);
+  clReleaseMemObject(states_buf[1]);
+  clReleaseMemObject(keys_buf);
+  clReleaseMemObject(perm_buf);
+  clqmcArrayRQMCSorterDestroy(sorter);
+  err = clqmcLatticeRuleDestroy(lattice);
+  check_error(err, NULL);
+
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+  cl_device_type device_type = CL_DEVICE_TYPE_CPU;
+
+  while (argc && (*argv)[0] == '-') {
+    if (strcmp(*argv, "--gpu") == 0) {
+      device_type = CL_DEVICE_TYPE_GPU;
+      argv++; argc--;
+    }
+    else
+      break;
+  }
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s [--gpu] <log2-chains> <customers> <replications>\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  TaskData data;
+  data.log2_chains  = (cl_uint) atoi(argv[0]);
+  data.steps        = (cl_uint) atoi(argv[1]);
+  data.replications = (cl_uint) atoi(argv[2]);
+  data.lambda       = 1.0;
+  data.mu           = 2.0;
+
+  if (data.log2_chains < 1 || data.steps < 1 || data.replications < 2) {
+    fprintf(stderr, "%s: at least 2 chains, 1 customer and 2 replications are required\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  return call_with_opencl(0, device_type, 0, &task, &data, CL_TRUE);
+}
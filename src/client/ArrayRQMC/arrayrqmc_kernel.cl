@@ -0,0 +1,77 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include <clQMC/arrayrqmc.clh>
+
+// State of a chain: waiting time of the current customer and sum of the
+// waiting times of the previous customers.
+typedef struct ChainState_ {
+  clqmc_fptype wait;
+  clqmc_fptype sum;
+} ChainState;
+
+__kernel void initChains(
+        __global ChainState* states,
+        __global clqmc_fptype* keys,
+        __global uint* perm)
+{
+  uint i = get_global_id(0);
+  states[i].wait = 0;
+  states[i].sum  = 0;
+  keys[i] = 0;
+  perm[i] = i;
+}
+
+// Lindley recursion W_{j+1} = max(0, W_j + S_j - A_{j+1}), with exponential
+// service times S_j of rate mu and interarrival times A_{j+1} of rate lambda,
+// for the chain of rank get_global_id(0).
+__kernel void advanceChains(
+        __global const clqmcLatticeRule* lattice,
+        __global const clqmc_fptype* shifts,
+        uint step,
+        clqmc_fptype lambda,
+        clqmc_fptype mu,
+        __global const ChainState* statesIn,
+        __global ChainState* statesOut,
+        __global clqmc_fptype* keys,
+        __global uint* perm)
+{
+  uint rank = get_global_id(0);
+
+  clqmcLatticeRuleStream stream;
+  clqmcArrayRQMCCreateStepStream(&stream, lattice, step, rank, shifts);
+
+  ChainState x = statesIn[perm[rank]];
+  clqmc_fptype service  = clqmcLatticeRuleNextExponential(&stream) / mu;
+  clqmc_fptype arrival  = clqmcLatticeRuleNextExponential(&stream) / lambda;
+  x.sum += x.wait;
+  x.wait = fmax(x.wait + service - arrival, (clqmc_fptype) 0);
+
+  statesOut[rank] = x;
+  keys[rank] = x.wait;
+  perm[rank] = rank;
+}
+
+/*
+vim: ft=c
+*/
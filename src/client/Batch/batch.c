@@ -0,0 +1,220 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Batched launch of many small RQMC integrations.
+ *
+ * Estimates the integrals of a family of product functions over unit
+ * hypercubes of various dimensions, each with its own lattice rule and random
+ * shifts, with a single kernel launch on a batch object (see
+ * clQMC/batch.h), one work group per problem.  The same kernel is then
+ * launched once per problem, to show the overhead of small launches.
+ */
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common.h"
+
+#include <clQMC/batch.h>
+#include <clQMC/randomshift.h>
+
+#define SHIFTS_SEED     1234
+#define LOCAL_SIZE      64
+#define MAX_DIMENSION   16
+#define SHOWN_PROBLEMS  8
+
+typedef struct TaskData_ {
+  cl_uint problems;
+  cl_uint replications;
+} TaskData;
+
+int task(cl_context context, cl_device_id device, cl_command_queue queue, void* data_)
+{
+  const TaskData* data = (const TaskData*) data_;
+  cl_uint problems = data->problems;
+  cl_int err;
+
+  // Lattice rules, shifts and weights of the problems: the dimension and the
+  // number of points vary from problem to problem.
+
+  clqmcLatticeRule** lattices = (clqmcLatticeRule**) malloc(problems * sizeof(clqmcLatticeRule*));
+  clqmc_fptype** shifts = (clqmc_fptype**) malloc(problems * sizeof(clqmc_fptype*));
+  cl_uint* replications = (cl_uint*) malloc(problems * sizeof(cl_uint));
+  clqmc_fptype* weights = (clqmc_fptype*) malloc(problems * sizeof(clqmc_fptype));
+
+  for (cl_uint p = 0; p < problems; p++) {
+    cl_uint dimension = 2 + p % (MAX_DIMENSION - 1);
+    lattices[p] = clqmcLatticeRuleCreateFromCatalogue(8 + p % 5, dimension, CLQMC_LATTICE_CBC_POLY, NULL, (clqmcStatus*) &err);
+    check_error(err, NULL);
+    replications[p] = data->replications;
+    shifts[p] = (clqmc_fptype*) malloc(data->replications * dimension * sizeof(clqmc_fptype));
+    err = clqmcRandomShiftsGenerate(SHIFTS_SEED, p * data->replications, data->replications, dimension, shifts[p]);
+    check_error(err, NULL);
+    weights[p] = (clqmc_fptype) (1.0 / (1 + p % 7));
+  }
+
+  size_t batch_size;
+  clqmcBatch* batch = clqmcBatchCreate(problems, (const clqmcLatticeRule* const*) lattices,
+      (const clqmc_fptype* const*) shifts, replications, &batch_size, (clqmcStatus*) &err);
+  check_error(err, NULL);
+  cl_uint outputs = clqmcBatchNumOutputs(batch);
+
+
+  // Buffers and kernel
+
+  cl_mem batch_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      batch_size, batch, &err);
+  check_error(err, "cannot create batch buffer");
+  cl_mem weights_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      problems * sizeof(clqmc_fptype), weights, &err);
+  check_error(err, "cannot create weights buffer");
+  cl_mem out_buf = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_HOST_READ_ONLY,
+      outputs * sizeof(clqmc_fptype), NULL, &err);
+  check_error(err, "cannot create output buffer");
+
+  cl_program program = build_program_from_file(context, device, "client/Batch/batch_kernel.cl", NULL);
+  cl_kernel kernel = clCreateKernel(program, "integrate", &err);
+  check_error(err, "cannot create kernel");
+
+  err  = clSetKernelArg(kernel, 0, sizeof(batch_buf),   &batch_buf);
+  err |= clSetKernelArg(kernel, 1, sizeof(weights_buf), &weights_buf);
+  err |= clSetKernelArg(kernel, 2, sizeof(out_buf),     &out_buf);
+  err |= clSetKernelArg(kernel, 3, LOCAL_SIZE * sizeof(clqmc_fptype), NULL);
+  check_error(err, "cannot set kernel arguments");
+
+
+  // Single launch for all problems, and a single readback
+
+  clqmc_fptype* out = (clqmc_fptype*) malloc(outputs * sizeof(clqmc_fptype));
+  size_t local_size = LOCAL_SIZE;
+  size_t global_size = (size_t) problems * LOCAL_SIZE;
+
+  profile_begin("batched launch");
+  err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size, &local_size, 0, NULL, NULL);
+  check_error(err, "cannot enqueue kernel");
+  err = clEnqueueReadBuffer(queue, out_buf, CL_TRUE, 0, outputs * sizeof(clqmc_fptype), out, 0, NULL, NULL);
+  check_error(err, "cannot read output buffer");
+  profile_end();
+
+  // One launch per problem, for comparison
+
+  profile_begin("one launch per problem");
+  for (cl_uint p = 0; p < problems; p++) {
+    size_t offset = (size_t) p * LOCAL_SIZE;
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, &offset, &local_size, &local_size, 0, NULL, NULL);
+    check_error(err, "cannot enqueue kernel");
+  }
+  err = clFinish(queue);
+  check_error(err, "cannot finish queue");
+  profile_end();
+
+
+  // Per-problem estimates
+
+  printf("\nBatch of %u problems with %u replications each (%lu bytes)\n\n",
+      problems, data->replications, (unsigned long) batch_size);
+  printf("%10s%12s%10s%10s%16s%16s\n", "problem", "dimension", "points", "weight", "mean", "std. error");
+
+  double max_z = 0.0;
+  for (cl_uint p = 0; p < problems; p++) {
+    const clqmc_fptype* y = out + clqmcBatchOutputOffset(batch, p);
+    cl_uint reps = clqmcBatchReplications(batch, p);
+    double mean = 0.0, variance = 0.0;
+    for (cl_uint r = 0; r < reps; r++)
+      mean += y[r] / reps;
+    for (cl_uint r = 0; r < reps; r++)
+      variance += (y[r] - mean) * (y[r] - mean) / (reps - 1);
+    double std_error = sqrt(variance / reps);
+    if (std_error > 0 && fabs(mean - 1.0) / std_error > max_z)
+      max_z = fabs(mean - 1.0) / std_error;
+    if (p < SHOWN_PROBLEMS) {
+      const clqmcLatticeRule* lattice = clqmcBatchLatticeRule(batch, p);
+      printf("%10u%12u%10u%10.4g%16.8g%16.4g\n", p, clqmcLatticeRuleDimension(lattice),
+          clqmcLatticeRuleNumPoints(lattice), (double) weights[p], mean, std_error);
+    }
+  }
+  if (problems > SHOWN_PROBLEMS)
+    printf("%10s\n", "...");
+  printf("\nlargest deviation from the exact value 1: %g standard errors\n", max_z);
+
+
+  // Clean up
+
+  free(out);
+  for (cl_uint p = 0; p < problems; p++) {
+    clqmcLatticeRuleDestroy(lattices[p]);
+    free(shifts[p]);
+  }
+  free(lattices);
+  free(shifts);
+  free(replications);
+  free(weights);
+  clReleaseKernel(kernel);
+  clReleaseProgram(program);
+  clReleaseMemObject(batch_buf);
+  clReleaseMemObject(weights_buf);
+  clReleaseMemObject(out_buf);
+  err = clqmcBatchDestroy(batch);
+  check_error(err, NULL);
+
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+  cl_device_type device_type = CL_DEVICE_TYPE_CPU;
+
+  while (argc && (*argv)[0] == '-') {
+    if (strcmp(*argv, "--gpu") == 0) {
+      device_type = CL_DEVICE_TYPE_GPU;
+      argv++; argc--;
+    }
+    else
+      break;
+  }
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s [--gpu] <problems> <replications>\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  TaskData data;
+  data.problems     = (cl_uint) atoi(argv[0]);
+  data.replications = (cl_uint) atoi(argv[1]);
+
+  if (data.problems < 1 || data.replications < 2) {
+    fprintf(stderr, "%s: at least 1 problem and 2 replications are required\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  return call_with_opencl(0, device_type, 0, &task, &data, CL_TRUE);
+}
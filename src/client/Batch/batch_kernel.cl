@@ -0,0 +1,72 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include <clQMC/batch.clh>
+
+// Work group p estimates, for each replication of problem p of the batch,
+// the average over the points of its lattice rule of
+//   f(u) = prod_j (1 + c (3 u_j^2 - 1)),
+// whose exact integral is 1, with c = weights[p], and writes it to the slot
+// of the replication in `out`.  The work items of the group process the
+// points in an interleaved fashion, so that the number of points need not be
+// a multiple of the work-group size.
+//
+// The problem index is derived from the global id rather than from the group
+// id so that the host can also process a single problem per launch with a
+// global work offset, for comparison.
+__kernel void integrate(
+        __global const clqmcBatch* batch,
+        __global const clqmc_fptype* weights,
+        __global clqmc_fptype* out,
+        __local clqmc_fptype* scratch)
+{
+  uint problem = get_global_id(0) / get_local_size(0);
+  uint lid     = get_local_id(0);
+  uint lsize   = get_local_size(0);
+
+  __global const clqmcLatticeRule* lattice = clqmcBatchLatticeRule(batch, problem);
+  uint n = clqmcLatticeRuleNumPoints(lattice);
+  uint d = clqmcLatticeRuleDimension(lattice);
+  clqmc_fptype c = weights[problem];
+
+  for (uint r = 0; r < clqmcBatchReplications(batch, problem); r++) {
+    clqmc_fptype sum = 0;
+    for (uint i = lid; i < n; i += lsize) {
+      clqmcLatticeRuleStream stream;
+      clqmcBatchCreateOverStream(&stream, batch, problem, r, n, i);
+      clqmc_fptype f = 1;
+      for (uint j = 0; j < d; j++) {
+        clqmc_fptype u = clqmcLatticeRuleNextCoordinate(&stream);
+        f *= 1 + c * (3 * u * u - 1);
+      }
+      sum += f;
+    }
+    sum = clqmcBatchWorkGroupSum(sum, scratch);
+    if (lid == 0)
+      out[clqmcBatchOutputOffset(batch, problem) + r] = sum / n;
+  }
+}
+
+/*
+vim: ft=c
+*/
@@ -0,0 +1,554 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Throughput benchmark for lattice rules on the device.
+ *
+ * For each combination of the swept parameters, the lattice rule and the
+ * random shifts are created on the host and one of the kernels of
+ * bench_kernel.cl is launched repeatedly.  One line of CSV is written per
+ * combination, with the best device time measured with OpenCL event profiling
+ * and the best host wall time over all repetitions, after a warm-up launch.
+ *
+ * In "generate" mode, only the generation kernel is timed and the integrand
+ * is the sum of the coordinates.  In "integrate" mode, the integrand of the
+ * tutorial examples is evaluated and the block averages are reduced on the
+ * device to one estimate per replication; both kernels are timed.
+ *
+ * After the timed launches, the estimate of the first replication is compared
+ * to an estimate computed on the host in double precision from the same
+ * points and shift, to catch a lattice rule or shifts that do not match the
+ * precision of the kernel.
+ */
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "../common.h"
+
+#include <clQMC/latticerule.h>
+
+#define DIMENSION 30
+#define MAX_LIST 32
+
+// Same generating vector as in the tutorial examples; good for numbers of
+// points that are powers of 2, ranging from 2^5 to 2^20.
+static cl_int gen_vec[DIMENSION] = {
+  1, 201367, 117137, 36487, 165651, 490691, 77109, 210171, 410853, 356813, 371285, 54177, 312383, 487121, 29017, 392635, 45723, 454749, 64693, 130185, 288231, 141321, 197541, 499599, 131691, 385041, 42593, 238365, 279943, 134157
+};
+
+typedef enum BenchPrecision_ { BENCH_FLOAT = 0, BENCH_DOUBLE = 1 } BenchPrecision;
+typedef enum BenchMapping_ { BENCH_EXAMPLE3 = 0, BENCH_EXAMPLE4 = 1, BENCH_STRIDED = 2 } BenchMapping;
+typedef enum BenchMode_ { BENCH_GENERATE = 0, BENCH_INTEGRATE = 1 } BenchMode;
+
+static const char* precision_names[] = { "float", "double" };
+static const char* mapping_names[]   = { "example3", "example4", "strided" };
+static const char* mode_names[]      = { "generate", "integrate" };
+static const char* kernel_names[]    = { "mapPartsPerWorkItem", "mapReplicationsPerWorkItem", "mapStridedPartsPerWorkItem" };
+
+typedef struct BenchOptions_ {
+  int log2_points_first, log2_points_last;
+  int log2_ppwi_first, log2_ppwi_last;
+  cl_uint replications[MAX_LIST];
+  size_t replications_count;
+  cl_uint replications_per_wi[MAX_LIST];
+  size_t replications_per_wi_count;
+  int precisions;   // bit mask of (1 << BenchPrecision)
+  int mappings;     // bit mask of (1 << BenchMapping)
+  int modes;        // bit mask of (1 << BenchMode)
+  int repeat;
+  FILE* output;
+} BenchOptions;
+
+static double wall_time()
+{
+#ifdef _MSC_VER
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double) count.QuadPart / (double) freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#endif
+}
+
+static cl_ulong event_duration(cl_event ev)
+{
+  cl_ulong start, end;
+  cl_int err;
+  err  = clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  err |= clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_END,   sizeof(end),   &end,   NULL);
+  check_error(err, "cannot read event profiling info");
+  return end - start;
+}
+
+// Simple 64-bit LCG; the quality of the shifts does not matter for timing.
+static double next_uniform(cl_ulong* state)
+{
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (*state >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Average of the integrand of bench_kernel.cl over the points of the lattice
+// rule shifted by `shift`, with the coordinates computed in the precision of
+// the kernel as in clqmcLatticeRuleNextCoordinate() and the average computed
+// in double precision.
+static double reference_estimate(BenchPrecision precision, BenchMode mode, cl_uint points, const double* shift)
+{
+  double sum = 0.0;
+  for (cl_uint i = 0; i < points; i++) {
+    double value = mode == BENCH_INTEGRATE ? 1.0 : 0.0;
+    for (int j = 0; j < DIMENSION; j++) {
+      double gen_normed = (double) (gen_vec[j] % points) / points;
+      double u;
+      if (precision == BENCH_FLOAT) {
+        volatile cl_float product = (cl_float) gen_normed * (cl_float) i;
+        u = fmodf(product + (cl_float) shift[j], 1.0f);
+      }
+      else
+        u = fmod(gen_normed * i + shift[j], 1.0);
+      if (mode == BENCH_INTEGRATE)
+        value *= 3 * u * u;
+      else
+        value += u;
+    }
+    sum += value;
+  }
+  return sum / points;
+}
+
+static void parse_range(const char* arg, int* first, int* last)
+{
+  const char* sep = strchr(arg, ':');
+  *first = atoi(arg);
+  *last = sep ? atoi(sep + 1) : *first;
+  if (*first < 0 || *last < *first || *last > 30)
+    check_error(CLQMC_INVALID_VALUE, "invalid range: %s", arg);
+}
+
+static size_t parse_list(const char* arg, cl_uint* values)
+{
+  size_t count = 0;
+  while (*arg) {
+    if (count == MAX_LIST)
+      check_error(CLQMC_INVALID_VALUE, "too many values in list");
+    char* end;
+    values[count] = (cl_uint) strtoul(arg, &end, 10);
+    if (end == arg || values[count] == 0)
+      check_error(CLQMC_INVALID_VALUE, "invalid list: %s", arg);
+    count++;
+    arg = *end == ',' ? end + 1 : end;
+  }
+  return count;
+}
+
+static int parse_choice(const char* arg, const char** names, int count)
+{
+  if (strcmp(arg, "all") == 0)
+    return (1 << count) - 1;
+  for (int i = 0; i < count; i++)
+    if (strcmp(arg, names[i]) == 0)
+      return 1 << i;
+  check_error(CLQMC_INVALID_VALUE, "invalid choice: %s", arg);
+  return 0;
+}
+
+static void usage(const char* prog)
+{
+  fprintf(stderr,
+      "usage: %s [options]\n"
+      "options:\n"
+      "  --gpu                                use a GPU device instead of a CPU device\n"
+      "  --platform <index>                   OpenCL platform index (default: 0)\n"
+      "  --device <index>                     OpenCL device index (default: 0)\n"
+      "  --log2-points <first>[:<last>]       (default: 10:16)\n"
+      "  --log2-points-per-work-item <f>[:<l>] (default: 0:4)\n"
+      "  --replications <list>                comma-separated (default: 1,32)\n"
+      "  --replications-per-work-item <list>  example4 mapping only (default: 1)\n"
+      "  --precision float|double|all         (default: all)\n"
+      "  --mapping example3|example4|strided|all (default: all)\n"
+      "  --mode generate|integrate|all        (default: all)\n"
+      "  --repeat <count>                     timed launches per configuration (default: 5)\n"
+      "  --output <file>                      CSV output file (default: standard output)\n",
+      prog);
+  exit(EXIT_FAILURE);
+}
+
+typedef struct BenchData_ {
+  const BenchOptions* opts;
+} BenchData;
+
+static cl_bool has_double(cl_device_id device)
+{
+  cl_bitfield config = 0;
+  cl_int err = clGetDeviceInfo(device, CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(config), &config, NULL);
+  return err == CL_SUCCESS && config != 0;
+}
+
+// Return 0 if the estimate of the first replication matches the host
+// reference, or 1 otherwise.
+static int run_config(
+    FILE* out,
+    const char* device_name,
+    cl_context context,
+    cl_command_queue queue,
+    cl_kernel kernel,
+    cl_kernel reduce_kernel,
+    size_t reduce_group_size,
+    BenchPrecision precision,
+    BenchMapping mapping,
+    BenchMode mode,
+    int log2_points,
+    int log2_ppwi,
+    cl_uint replications,
+    cl_uint replications_per_wi,
+    int repeat)
+{
+  cl_int err;
+  cl_uint points = 1u << log2_points;
+  cl_uint ppwi = 1u << log2_ppwi;
+  cl_uint blocks = points / ppwi;
+  size_t fpsize = precision == BENCH_FLOAT ? sizeof(cl_float) : sizeof(cl_double);
+
+  // the layout of the lattice rule depends on the precision of the kernel
+  size_t pointset_size;
+  clqmcLatticeRule* pointset = precision == BENCH_FLOAT
+    ? clqmcLatticeRuleCreate_clqmc_float (points, DIMENSION, gen_vec, &pointset_size, &err)
+    : clqmcLatticeRuleCreate_clqmc_double(points, DIMENSION, gen_vec, &pointset_size, &err);
+  check_error(err, NULL);
+
+  cl_mem pointset_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      pointset_size, pointset, &err);
+  check_error(err, "cannot create point set buffer");
+
+  void* shifts = malloc(replications * DIMENSION * fpsize);
+  double first_shift[DIMENSION];
+  cl_ulong state = 12345;
+  for (size_t i = 0; i < replications * DIMENSION; i++) {
+    double u = next_uniform(&state);
+    if (precision == BENCH_FLOAT)
+      u = ((cl_float*) shifts)[i] = (cl_float) u;
+    else
+      ((cl_double*) shifts)[i] = u;
+    if (i < DIMENSION)
+      first_shift[i] = u;
+  }
+  cl_mem shifts_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      replications * DIMENSION * fpsize, shifts, &err);
+  check_error(err, "cannot create shifts buffer");
+  free(shifts);
+
+  cl_mem values_buf = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_HOST_NO_ACCESS,
+      (size_t) replications * blocks * fpsize, NULL, &err);
+  check_error(err, "cannot create output buffer");
+
+  cl_mem estimates_buf = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_HOST_READ_ONLY,
+      replications * fpsize, NULL, &err);
+  check_error(err, "cannot create estimates buffer");
+
+  int iarg = 0;
+  err  = clSetKernelArg(kernel, iarg++, sizeof(pointset_buf), &pointset_buf);
+  err |= clSetKernelArg(kernel, iarg++, sizeof(shifts_buf), &shifts_buf);
+  err |= clSetKernelArg(kernel, iarg++, sizeof(ppwi), &ppwi);
+  err |= clSetKernelArg(kernel, iarg++, sizeof(replications), &replications);
+  err |= clSetKernelArg(kernel, iarg++, sizeof(values_buf), &values_buf);
+  check_error(err, "cannot set kernel arguments");
+
+  iarg = 0;
+  err  = clSetKernelArg(reduce_kernel, iarg++, sizeof(values_buf), &values_buf);
+  err |= clSetKernelArg(reduce_kernel, iarg++, sizeof(blocks), &blocks);
+  err |= clSetKernelArg(reduce_kernel, iarg++, sizeof(estimates_buf), &estimates_buf);
+  err |= clSetKernelArg(reduce_kernel, iarg++, reduce_group_size * fpsize, NULL);
+  check_error(err, "cannot set reduction kernel arguments");
+
+  size_t global_size = mapping != BENCH_EXAMPLE4
+    ? blocks
+    : (size_t) blocks * (replications / replications_per_wi);
+  size_t reduce_global_size = replications * reduce_group_size;
+
+  cl_ulong best_device = 0;
+  double best_wall = 0.0;
+
+  // the first launch is a warm-up
+  for (int r = -1; r < repeat; r++) {
+
+    cl_event ev[2];
+    cl_uint num_events = 1;
+
+    double t0 = wall_time();
+
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size, NULL, 0, NULL, &ev[0]);
+    check_error(err, "cannot enqueue kernel");
+
+    if (mode == BENCH_INTEGRATE) {
+      err = clEnqueueNDRangeKernel(queue, reduce_kernel, 1, NULL, &reduce_global_size, &reduce_group_size, 0, NULL, &ev[1]);
+      check_error(err, "cannot enqueue reduction kernel");
+      num_events++;
+    }
+
+    err = clFinish(queue);
+    check_error(err, "cannot finish command queue");
+
+    double wall = wall_time() - t0;
+
+    cl_ulong device = 0;
+    for (cl_uint i = 0; i < num_events; i++) {
+      device += event_duration(ev[i]);
+      clReleaseEvent(ev[i]);
+    }
+
+    if (r == 0 || (r > 0 && device < best_device))
+      best_device = device;
+    if (r == 0 || (r > 0 && wall < best_wall))
+      best_wall = wall;
+  }
+
+  double total_points = (double) points * replications;
+  fprintf(out, "\"%s\",%s,%s,%s,%d,%u,%u,%u,%lu,%llu,%.0f,%.6g,%.6g\n",
+      device_name,
+      precision_names[precision],
+      mapping_names[mapping],
+      mode_names[mode],
+      log2_points,
+      ppwi,
+      replications,
+      mapping != BENCH_EXAMPLE4 ? replications : replications_per_wi,
+      (unsigned long) global_size,
+      (unsigned long long) best_device,
+      best_wall * 1e9,
+      total_points / (best_device * 1e-9),
+      total_points / best_wall);
+  fflush(out);
+
+  // Check the estimate of the first replication.  In single precision, the
+  // products of the point indices with the normalized generating vector are
+  // rounded with more than 2^12 points (and rounded differently if the device
+  // contracts them into fused multiply-adds), and the product integrand
+  // amplifies the rounding errors well beyond any useful tolerance; these
+  // estimates are not checked.
+  int mismatch = 0;
+  int check = precision == BENCH_DOUBLE || mode == BENCH_GENERATE || log2_points <= 12;
+  if (check && mode != BENCH_INTEGRATE) {
+    err = clEnqueueNDRangeKernel(queue, reduce_kernel, 1, NULL, &reduce_group_size, &reduce_group_size, 0, NULL, NULL);
+    check_error(err, "cannot enqueue reduction kernel");
+  }
+  if (check) {
+    union { cl_float f; cl_double d; } estimate;
+    err = clEnqueueReadBuffer(queue, estimates_buf, CL_TRUE, 0, fpsize, &estimate, 0, NULL, NULL);
+    check_error(err, "cannot read estimates buffer");
+    double device_estimate = precision == BENCH_FLOAT ? estimate.f : estimate.d;
+    double reference = reference_estimate(precision, mode, points, first_shift);
+    double tolerance = precision == BENCH_FLOAT ? 1e-3 : 1e-9;
+    mismatch = !(fabs(device_estimate - reference) <= tolerance * fabs(reference));
+    if (mismatch)
+      fprintf(stderr, "error: %s %s %s with 2^%d points and %u points per work item: estimate %.10g, expected %.10g\n",
+          precision_names[precision], mapping_names[mapping], mode_names[mode], log2_points, ppwi,
+          device_estimate, reference);
+  }
+
+  clReleaseMemObject(estimates_buf);
+  clReleaseMemObject(values_buf);
+  clReleaseMemObject(shifts_buf);
+  clReleaseMemObject(pointset_buf);
+  err = clqmcLatticeRuleDestroy(pointset);
+  check_error(err, NULL);
+  return mismatch;
+}
+
+static int task(cl_context context, cl_device_id device, cl_command_queue queue, void* data_)
+{
+  const BenchOptions* opts = ((const BenchData*) data_)->opts;
+  cl_int err;
+
+  char device_name[128];
+  strncpy(device_name, get_device_name(device), sizeof(device_name) - 1);
+  device_name[sizeof(device_name) - 1] = '\0';
+
+  size_t reduce_group_size = 1;
+  while (2 * reduce_group_size <= get_max_workgroup_size(device) && reduce_group_size < 256)
+    reduce_group_size *= 2;
+
+  fprintf(opts->output, "device,precision,mapping,mode,log2_points,points_per_work_item,replications,"
+      "replications_per_work_item,work_items,device_ns,wall_ns,device_points_per_second,wall_points_per_second\n");
+
+  int mismatches = 0;
+
+  for (int precision = BENCH_FLOAT; precision <= BENCH_DOUBLE; precision++) {
+
+    if (!(opts->precisions & (1 << precision)))
+      continue;
+
+    if (precision == BENCH_DOUBLE && !has_double(device)) {
+      fprintf(stderr, "skipping double precision: not supported by device %s\n", get_device_name(device));
+      continue;
+    }
+
+    for (int mode = BENCH_GENERATE; mode <= BENCH_INTEGRATE; mode++) {
+
+      if (!(opts->modes & (1 << mode)))
+        continue;
+
+      char options[64] = "";
+      if (precision == BENCH_FLOAT)
+        strcat(options, "-DCLQMC_SINGLE_PRECISION ");
+      if (mode == BENCH_INTEGRATE)
+        strcat(options, "-DBENCH_INTEGRATE");
+
+      cl_program program = build_program_from_file(context, device,
+          "client/Bench/bench_kernel.cl", options);
+
+      cl_kernel reduce_kernel = clCreateKernel(program, "reduceReplications", &err);
+      check_error(err, "cannot create reduction kernel");
+
+      for (int mapping = BENCH_EXAMPLE3; mapping <= BENCH_STRIDED; mapping++) {
+
+        if (!(opts->mappings & (1 << mapping)))
+          continue;
+
+        cl_kernel kernel = clCreateKernel(program, kernel_names[mapping], &err);
+        check_error(err, "cannot create kernel");
+
+        for (int log2_points = opts->log2_points_first; log2_points <= opts->log2_points_last; log2_points++)
+          for (int log2_ppwi = opts->log2_ppwi_first; log2_ppwi <= opts->log2_ppwi_last && log2_ppwi <= log2_points; log2_ppwi++)
+            for (size_t i = 0; i < opts->replications_count; i++) {
+              cl_uint replications = opts->replications[i];
+              if (mapping != BENCH_EXAMPLE4) {
+                mismatches += run_config(opts->output, device_name, context, queue, kernel, reduce_kernel, reduce_group_size,
+                    precision, mapping, mode, log2_points, log2_ppwi, replications, 0, opts->repeat);
+                continue;
+              }
+              for (size_t j = 0; j < opts->replications_per_wi_count; j++) {
+                cl_uint replications_per_wi = opts->replications_per_wi[j];
+                if (replications % replications_per_wi)
+                  continue;
+                mismatches += run_config(opts->output, device_name, context, queue, kernel, reduce_kernel, reduce_group_size,
+                    precision, mapping, mode, log2_points, log2_ppwi, replications, replications_per_wi, opts->repeat);
+              }
+            }
+
+        clReleaseKernel(kernel);
+      }
+
+      clReleaseKernel(reduce_kernel);
+      clReleaseProgram(program);
+    }
+  }
+
+  if (mismatches)
+    fprintf(stderr, "%d configurations produced wrong estimates\n", mismatches);
+  return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+  cl_device_type device_type = CL_DEVICE_TYPE_CPU;
+  int platform_index = 0;
+  int device_index = 0;
+
+  BenchOptions opts;
+  opts.log2_points_first = 10;
+  opts.log2_points_last = 16;
+  opts.log2_ppwi_first = 0;
+  opts.log2_ppwi_last = 4;
+  opts.replications[0] = 1;
+  opts.replications[1] = 32;
+  opts.replications_count = 2;
+  opts.replications_per_wi[0] = 1;
+  opts.replications_per_wi_count = 1;
+  opts.precisions = 0x3;
+  opts.mappings = 0x7;
+  opts.modes = 0x3;
+  opts.repeat = 5;
+  opts.output = stdout;
+
+  while (argc) {
+    const char* opt = *argv++; argc--;
+    if (strcmp(opt, "--gpu") == 0) {
+      device_type = CL_DEVICE_TYPE_GPU;
+      continue;
+    }
+    if (argc == 0)
+      usage(prog);
+    const char* arg = *argv++; argc--;
+    if (strcmp(opt, "--platform") == 0)
+      platform_index = atoi(arg);
+    else if (strcmp(opt, "--device") == 0)
+      device_index = atoi(arg);
+    else if (strcmp(opt, "--log2-points") == 0)
+      parse_range(arg, &opts.log2_points_first, &opts.log2_points_last);
+    else if (strcmp(opt, "--log2-points-per-work-item") == 0)
+      parse_range(arg, &opts.log2_ppwi_first, &opts.log2_ppwi_last);
+    else if (strcmp(opt, "--replications") == 0)
+      opts.replications_count = parse_list(arg, opts.replications);
+    else if (strcmp(opt, "--replications-per-work-item") == 0)
+      opts.replications_per_wi_count = parse_list(arg, opts.replications_per_wi);
+    else if (strcmp(opt, "--precision") == 0)
+      opts.precisions = parse_choice(arg, precision_names, 2);
+    else if (strcmp(opt, "--mapping") == 0)
+      opts.mappings = parse_choice(arg, mapping_names, 3);
+    else if (strcmp(opt, "--mode") == 0)
+      opts.modes = parse_choice(arg, mode_names, 2);
+    else if (strcmp(opt, "--repeat") == 0)
+      opts.repeat = atoi(arg);
+    else if (strcmp(opt, "--output") == 0) {
+      opts.output = fopen(arg, "w");
+      if (opts.output == NULL) {
+        perror("cannot open output file");
+        exit(EXIT_FAILURE);
+      }
+    }
+    else
+      usage(prog);
+  }
+
+  if (opts.repeat < 1)
+    usage(prog);
+
+  BenchData data = { &opts };
+  int ret = call_with_opencl(platform_index, device_type, device_index, &task, &data, CL_FALSE);
+
+  if (opts.output != stdout)
+    fclose(opts.output);
+
+  return ret;
+}
+
+/*
+vim: ft=c sw=2 expandtab
+*/
@@ -0,0 +1,180 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+// Benchmark kernels.
+//
+// The host program builds this file with CLQMC_SINGLE_PRECISION defined or
+// not, and with BENCH_INTEGRATE defined to evaluate the integrand of the
+// tutorial examples instead of merely summing the coordinates.
+
+#include <clQMC/latticerule.clh>
+
+#ifdef BENCH_INTEGRATE
+  clqmc_fptype evalPoint(clqmcLatticeRuleStream* stream, uint dimension)
+  {
+    clqmc_fptype ret = 1.0;
+    for (uint j = 0; j < dimension; j++) {
+      clqmc_fptype uj = clqmcLatticeRuleNextCoordinate(stream);
+      ret *= 3 * uj * uj;
+    }
+    return ret;
+  }
+#else
+  // The sum is written to the output buffer so that the generation of the
+  // coordinates cannot be optimized away.
+  clqmc_fptype evalPoint(clqmcLatticeRuleStream* stream, uint dimension)
+  {
+    clqmc_fptype ret = 0.0;
+    for (uint j = 0; j < dimension; j++)
+      ret += clqmcLatticeRuleNextCoordinate(stream);
+    return ret;
+  }
+#endif
+
+// Mapping of DocsTutorial/example3_kernel.cl: each work item processes the
+// same block of points for every replication.
+__kernel void mapPartsPerWorkItem(
+        __global const clqmcLatticeRule* pointset,
+        __global const clqmc_fptype* shifts,
+        uint points_per_work_item,
+        uint replications,
+        __global clqmc_fptype* out)
+{
+  uint gsize     = get_global_size(0);
+  uint gid       = get_global_id(0);
+  uint dimension = clqmcLatticeRuleDimension(pointset);
+
+  clqmcLatticeRuleStream stream;
+
+  for (uint k = 0; k < replications; k++) {
+
+    clqmcLatticeRuleCreateOverStream(&stream, pointset, gsize, gid, &shifts[k * dimension]);
+
+    clqmc_fptype sum = 0.0;
+
+    for (uint i = 0; i < points_per_work_item; i++) {
+      sum += evalPoint(&stream, dimension);
+      clqmcLatticeRuleForwardToNextPoint(&stream);
+    }
+
+    out[k * gsize + gid] = sum / points_per_work_item;
+  }
+}
+
+// Same as mapPartsPerWorkItem, but each work item processes the interleaved
+// points gid, gid + gsize, gid + 2 * gsize, etc.
+__kernel void mapStridedPartsPerWorkItem(
+        __global const clqmcLatticeRule* pointset,
+        __global const clqmc_fptype* shifts,
+        uint points_per_work_item,
+        uint replications,
+        __global clqmc_fptype* out)
+{
+  uint gsize     = get_global_size(0);
+  uint gid       = get_global_id(0);
+  uint dimension = clqmcLatticeRuleDimension(pointset);
+
+  clqmcLatticeRuleStream stream;
+
+  for (uint k = 0; k < replications; k++) {
+
+    clqmcLatticeRuleCreateStridedOverStream(&stream, pointset, gsize, gid, &shifts[k * dimension]);
+
+    clqmc_fptype sum = 0.0;
+
+    for (uint i = 0; i < points_per_work_item; i++) {
+      sum += evalPoint(&stream, dimension);
+      clqmcLatticeRuleForwardToNextPoint(&stream);
+    }
+
+    out[k * gsize + gid] = sum / points_per_work_item;
+  }
+}
+
+// Mapping of DocsTutorial/example4_kernel.cl: the replications are
+// distributed across work items.
+__kernel void mapReplicationsPerWorkItem(
+        __global const clqmcLatticeRule* pointset,
+        __global const clqmc_fptype* shifts,
+        uint points_per_work_item,
+        uint replications,
+        __global clqmc_fptype* out)
+{
+  uint gid       = get_global_id(0);
+  uint dimension = clqmcLatticeRuleDimension(pointset);
+  uint num_point_subsets = clqmcLatticeRuleNumPoints(pointset) / points_per_work_item;
+  uint replications_per_work_item = replications * num_point_subsets / get_global_size(0);
+
+  clqmcLatticeRuleStream stream;
+
+  for (uint k = 0; k < replications_per_work_item; k++) {
+
+    uint replication = (gid / num_point_subsets) * replications_per_work_item + k;
+    uint point_subset_index = gid % num_point_subsets;
+
+    clqmcLatticeRuleCreateOverStream(&stream, pointset,
+      num_point_subsets, point_subset_index,
+      &shifts[replication * dimension]);
+
+    clqmc_fptype sum = 0.0;
+
+    for (uint i = 0; i < points_per_work_item; i++) {
+      sum += evalPoint(&stream, dimension);
+      clqmcLatticeRuleForwardToNextPoint(&stream);
+    }
+
+    out[replication * num_point_subsets + point_subset_index] = sum / points_per_work_item;
+  }
+}
+
+// Average the `blocks` consecutive values of each replication.
+// Each work group processes one replication; its size must be a power of 2.
+__kernel void reduceReplications(
+        __global const clqmc_fptype* values,
+        uint blocks,
+        __global clqmc_fptype* estimates,
+        __local clqmc_fptype* scratch)
+{
+  uint lid   = get_local_id(0);
+  uint lsize = get_local_size(0);
+  uint k     = get_group_id(0);
+
+  clqmc_fptype sum = 0.0;
+  for (uint i = lid; i < blocks; i += lsize)
+    sum += values[k * blocks + i];
+  scratch[lid] = sum;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (uint s = lsize / 2; s > 0; s /= 2) {
+    if (lid < s)
+      scratch[lid] += scratch[lid + s];
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (lid == 0)
+    estimates[k] = scratch[0] / blocks;
+}
+
+/*
+vim: ft=c sw=2 expandtab
+*/
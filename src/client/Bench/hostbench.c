@@ -0,0 +1,720 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Micro-benchmark for the host API of lattice rules.
+ *
+ * Each benchmark calls one function of the host API a fixed number of times
+ * for every combination of dimension, number of points and thread count, and
+ * reports the best time per call over the repetitions, as CSV.  Each thread
+ * runs the same benchmark on its own objects and is pinned to a distinct
+ * processor where the platform allows it; the reported time is the slowest
+ * thread's.
+ *
+ * The results can be saved to a baseline file and later compared against it:
+ * with --baseline, each result is flagged as a regression when it is slower
+ * than the baseline by more than the tolerance, and the program exits with a
+ * nonzero status if any regression was found.
+ *
+ * A few edge cases of the host API are checked before any timing, and the
+ * program exits with a nonzero status if one of them fails.
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <pthread.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+#include <clQMC/latticerule.h>
+#include <clQMC/transforms.h>
+
+#define MAX_LIST 32
+#define MAX_THREADS 256
+#define MAX_BASELINE 4096
+
+typedef struct BenchContext_ {
+  const char* name;
+  cl_uint dimension;
+  cl_uint points;
+  size_t iterations;
+  const cl_int* genVec;
+  const clqmcLatticeRule* lattice;
+  const cl_double* shift;
+  int cpu;
+  double seconds;
+  double sink;
+} BenchContext;
+
+typedef void (*BenchFunc)(BenchContext*);
+
+static double wall_time()
+{
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double) count.QuadPart / (double) freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#endif
+}
+
+static void check(clqmcStatus err)
+{
+  if (err != CLQMC_SUCCESS) {
+    fprintf(stderr, "Error %d: %s\n", err, clqmcGetErrorString());
+    exit(EXIT_FAILURE);
+  }
+}
+
+
+/********************************************************************************
+ * Benchmarks                                                                   *
+ ********************************************************************************/
+
+// Each benchmark performs ctx->iterations calls of the measured function.
+
+static void bench_create(BenchContext* ctx)
+{
+  clqmcStatus err;
+  double t0 = wall_time();
+  for (size_t i = 0; i < ctx->iterations; i++) {
+    clqmcLatticeRule* lattice = clqmcLatticeRuleCreate_clqmc_double(ctx->points, ctx->dimension, ctx->genVec, NULL, &err);
+    ctx->sink += clqmcLatticeRuleNumPoints(lattice);
+    clqmcLatticeRuleDestroy(lattice);
+  }
+  ctx->seconds = wall_time() - t0;
+  check(err);
+}
+
+static void bench_create_stream(BenchContext* ctx)
+{
+  clqmcStatus err;
+  double t0 = wall_time();
+  for (size_t i = 0; i < ctx->iterations; i++) {
+    clqmcLatticeRuleStream* stream = clqmcLatticeRuleCreateStream_clqmc_double(ctx->lattice, 1, 0, ctx->shift, &err);
+    ctx->sink += clqmcLatticeRuleCurrentPointIndex(stream);
+    clqmcLatticeRuleDestroyStream(stream);
+  }
+  ctx->seconds = wall_time() - t0;
+  check(err);
+}
+
+static void bench_create_over_stream(BenchContext* ctx)
+{
+  clqmcLatticeRuleStream stream;
+  clqmcStatus err = CLQMC_SUCCESS;
+  cl_uint parts = ctx->points < 1024 ? ctx->points : 1024;
+  double t0 = wall_time();
+  for (size_t i = 0; i < ctx->iterations; i++) {
+    err = clqmcLatticeRuleCreateOverStream_clqmc_double(&stream, ctx->lattice, parts, (cl_uint) (i % parts), ctx->shift);
+    if (err != CLQMC_SUCCESS)
+      break;
+    ctx->sink += clqmcLatticeRuleCurrentPointIndex(&stream);
+  }
+  ctx->seconds = wall_time() - t0;
+  check(err);
+}
+
+// Reports the time per stream; streams are created by batches of 1024.
+static void bench_create_streams(BenchContext* ctx)
+{
+  clqmcStatus err;
+  cl_uint parts = ctx->points < 1024 ? ctx->points : 1024;
+  cl_uint replications = 1024 / parts;
+  size_t batches = ctx->iterations / (parts * replications);
+  if (batches == 0)
+    batches = 1;
+  cl_double* shifts = (cl_double*) calloc((size_t) replications * ctx->dimension, sizeof(cl_double));
+  double t0 = wall_time();
+  for (size_t i = 0; i < batches; i++) {
+    clqmcLatticeRuleStream* streams = clqmcLatticeRuleCreateStreams_clqmc_double(ctx->lattice, parts, replications, shifts, NULL, &err);
+    ctx->sink += clqmcLatticeRuleCurrentPointIndex(&streams[parts - 1]);
+    clqmcLatticeRuleDestroyStreams(streams);
+  }
+  ctx->seconds = (wall_time() - t0) * ctx->iterations / (batches * parts * replications);
+  check(err);
+  free(shifts);
+}
+
+#define IMPLEMENT_NEXT_COORDINATE_FOR_TYPE(fptype) \
+  static void bench_next_coordinate_##fptype(BenchContext* ctx) \
+  { \
+    clqmcStatus err; \
+    fptype* shift = (fptype*) malloc(ctx->dimension * sizeof(fptype)); \
+    for (cl_uint j = 0; j < ctx->dimension; j++) \
+      shift[j] = (fptype) ctx->shift[j]; \
+    clqmcLatticeRule* lattice = clqmcLatticeRuleCreate_##fptype(ctx->points, ctx->dimension, ctx->genVec, NULL, &err); \
+    check(err); \
+    clqmcLatticeRuleStream stream; \
+    check(clqmcLatticeRuleCreateOverStream_##fptype(&stream, lattice, 1, 0, shift)); \
+    fptype sum = 0; \
+    size_t done = 0; \
+    double t0 = wall_time(); \
+    while (done < ctx->iterations) { \
+      for (cl_uint j = 0; j < ctx->dimension; j++) \
+        sum += clqmcLatticeRuleNextCoordinate_##fptype(&stream); \
+      clqmcLatticeRuleForwardToNextPoint(&stream); \
+      done += ctx->dimension; \
+    } \
+    ctx->seconds = (wall_time() - t0) * ctx->iterations / done; \
+    ctx->sink += sum; \
+    clqmcLatticeRuleDestroy(lattice); \
+    free(shift); \
+  }
+
+IMPLEMENT_NEXT_COORDINATE_FOR_TYPE(clqmc_float)
+IMPLEMENT_NEXT_COORDINATE_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_NEXT_COORDINATE_FOR_TYPE
+
+static void bench_next_normal(BenchContext* ctx)
+{
+  clqmcLatticeRuleStream stream;
+  check(clqmcLatticeRuleCreateOverStream_clqmc_double(&stream, ctx->lattice, 1, 0, ctx->shift));
+  double sum = 0;
+  size_t done = 0;
+  double t0 = wall_time();
+  while (done < ctx->iterations) {
+    for (cl_uint j = 0; j < ctx->dimension; j++)
+      sum += clqmcLatticeRuleNextNormal_clqmc_double(&stream);
+    clqmcLatticeRuleForwardToNextPoint(&stream);
+    done += ctx->dimension;
+  }
+  ctx->seconds = (wall_time() - t0) * ctx->iterations / done;
+  ctx->sink += sum;
+}
+
+static void bench_forward_to_next_point(BenchContext* ctx)
+{
+  clqmcLatticeRuleStream stream;
+  check(clqmcLatticeRuleCreateOverStream_clqmc_double(&stream, ctx->lattice, 1, 0, ctx->shift));
+  cl_uint sum = 0;
+  double t0 = wall_time();
+  for (size_t i = 0; i < ctx->iterations; i++)
+    sum += clqmcLatticeRuleForwardToNextPoint(&stream);
+  ctx->seconds = wall_time() - t0;
+  ctx->sink += sum;
+}
+
+typedef struct BenchEntry_ {
+  const char* name;
+  BenchFunc func;
+  size_t iterations;    // default number of calls
+} BenchEntry;
+
+static const BenchEntry benchmarks[] = {
+  { "create",                 bench_create,                  100000 },
+  { "create_stream",          bench_create_stream,          1000000 },
+  { "create_over_stream",     bench_create_over_stream,    10000000 },
+  { "create_streams",         bench_create_streams,         1000000 },
+  { "next_coordinate_float",  bench_next_coordinate_clqmc_float, 10000000 },
+  { "next_coordinate_double", bench_next_coordinate_clqmc_double, 10000000 },
+  { "next_normal",            bench_next_normal,            10000000 },
+  { "forward_to_next_point",  bench_forward_to_next_point, 100000000 },
+};
+
+#define NUM_BENCHMARKS (sizeof(benchmarks) / sizeof(benchmarks[0]))
+
+
+/********************************************************************************
+ * Threads                                                                      *
+ ********************************************************************************/
+
+static BenchFunc current_func;
+
+static void pin_to_cpu(int cpu)
+{
+#if defined(_WIN32)
+  SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << (cpu % (8 * sizeof(DWORD_PTR))));
+#elif defined(__linux__)
+  cpu_set_t set;
+  if (sched_getaffinity(0, sizeof(set), &set) != 0 || CPU_COUNT(&set) == 0)
+    return;
+  // pick the cpu-th processor available to the process, cyclically
+  int index = cpu % CPU_COUNT(&set);
+  int target = 0;
+  for (; target < CPU_SETSIZE; target++)
+    if (CPU_ISSET(target, &set) && index-- == 0)
+      break;
+  CPU_ZERO(&set);
+  CPU_SET(target, &set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+    fprintf(stderr, "warning: cannot pin thread to processor %d\n", cpu);
+#else
+  (void) cpu;   // thread affinity is not available on this platform
+#endif
+}
+
+#ifdef _WIN32
+static DWORD WINAPI thread_main(LPVOID arg)
+#else
+static void* thread_main(void* arg)
+#endif
+{
+  BenchContext* ctx = (BenchContext*) arg;
+  pin_to_cpu(ctx->cpu);
+  current_func(ctx);
+  return 0;
+}
+
+// Run the benchmark in `threads` threads and return the time per call of the
+// slowest one, in nanoseconds.
+static double run_threads(BenchFunc func, BenchContext* proto, int threads)
+{
+  BenchContext ctx[MAX_THREADS];
+  current_func = func;
+  for (int t = 0; t < threads; t++) {
+    ctx[t] = *proto;
+    ctx[t].cpu = t;
+  }
+
+  if (threads == 1)
+    thread_main(&ctx[0]);
+  else {
+#ifdef _WIN32
+    HANDLE handles[MAX_THREADS];
+    for (int t = 0; t < threads; t++)
+      handles[t] = CreateThread(NULL, 0, thread_main, &ctx[t], 0, NULL);
+    WaitForMultipleObjects(threads, handles, TRUE, INFINITE);
+    for (int t = 0; t < threads; t++)
+      CloseHandle(handles[t]);
+#else
+    pthread_t handles[MAX_THREADS];
+    for (int t = 0; t < threads; t++)
+      pthread_create(&handles[t], NULL, thread_main, &ctx[t]);
+    for (int t = 0; t < threads; t++)
+      pthread_join(handles[t], NULL);
+#endif
+  }
+
+  double seconds = 0.0;
+  for (int t = 0; t < threads; t++) {
+    if (ctx[t].seconds > seconds)
+      seconds = ctx[t].seconds;
+    proto->sink += ctx[t].sink;
+  }
+  return seconds * 1e9 / proto->iterations;
+}
+
+
+/********************************************************************************
+ * Sanity checks                                                                *
+ ********************************************************************************/
+
+// Checks the edge cases of the fused transforms before timing them: past the
+// last coordinate of a point, the variates must be NaN, and the gamma inverse
+// CDF must increase up to infinity as u approaches 1.  Returns the number of failures.
+#define IMPLEMENT_CHECK_TRANSFORMS_FOR_TYPE(fptype, below_one) \
+  static int check_transforms_##fptype(void) \
+  { \
+    static const cl_int genVec[2] = { 1, 5 }; \
+    static const fptype shapes[4] = { (fptype) 0.3, (fptype) 1.0, (fptype) 2.5, (fptype) 100.0 }; \
+    clqmcStatus err; \
+    int failures = 0; \
+    clqmcLatticeRule* lattice = clqmcLatticeRuleCreate_##fptype(16, 2, genVec, NULL, &err); \
+    check(err); \
+    clqmcLatticeRuleStream stream; \
+    for (int k = 0; k < 3; k++) { \
+      check(clqmcLatticeRuleCreateOverStream_##fptype(&stream, lattice, 1, 0, NULL)); \
+      clqmcLatticeRuleForwardToNextPoint(&stream); \
+      fptype value = 0; \
+      for (int j = 0; j <= 2; j++) \
+        value = k == 0 ? clqmcLatticeRuleNextNormal_##fptype(&stream) \
+              : k == 1 ? clqmcLatticeRuleNextExponential_##fptype(&stream) \
+              : clqmcLatticeRuleNextGamma_##fptype(&stream, (fptype) 2.5); \
+      if (!isnan(value)) { \
+        fprintf(stderr, "check failed: %s variate %d past the dimension is %g instead of NaN\n", #fptype, k, (double) value); \
+        failures++; \
+      } \
+    } \
+    for (int i = 0; i < 4; i++) { \
+      fptype x = clqmcGammaInverseCDF_##fptype(shapes[i], (below_one)); \
+      fptype y = clqmcGammaInverseCDF_##fptype(shapes[i], (fptype) 0.999); \
+      fptype z = clqmcGammaInverseCDF_##fptype(shapes[i], (fptype) 1.0); \
+      if (!isfinite(x) || !(x >= y) || !(z > x)) { \
+        fprintf(stderr, "check failed: %s gamma inverse CDF with shape %g near 1 is %g\n", #fptype, (double) shapes[i], (double) x); \
+        failures++; \
+      } \
+    } \
+    clqmcLatticeRuleDestroy(lattice); \
+    return failures; \
+  }
+
+IMPLEMENT_CHECK_TRANSFORMS_FOR_TYPE(clqmc_float,  nextafterf(1.0f, 0.0f))
+IMPLEMENT_CHECK_TRANSFORMS_FOR_TYPE(clqmc_double, nextafter(1.0, 0.0))
+#undef IMPLEMENT_CHECK_TRANSFORMS_FOR_TYPE
+
+// Provokes an error whose message mentions 2^log2_points points and checks
+// that the error string of the calling thread is the one just set.
+static int provoke_error(cl_uint log2_points)
+{
+  char expected[32];
+  snprintf(expected, sizeof(expected), "2^%u points", log2_points);
+  clqmcStatus err;
+  clqmcLatticeRule* lattice = clqmcLatticeRuleCreateFromCatalogue_clqmc_double(
+      log2_points, 1, CLQMC_LATTICE_CBC_POLY, NULL, &err);
+  if (lattice != NULL)
+    clqmcLatticeRuleDestroy(lattice);
+  return lattice == NULL && err == CLQMC_INVALID_VALUE && strstr(clqmcGetErrorString(), expected) != NULL;
+}
+
+typedef struct ErrorCheckContext_ {
+  cl_uint log2_points;
+  int failures;
+} ErrorCheckContext;
+
+#ifdef _WIN32
+static DWORD WINAPI error_check_main(LPVOID arg)
+#else
+static void* error_check_main(void* arg)
+#endif
+{
+  ErrorCheckContext* ctx = (ErrorCheckContext*) arg;
+  // the error string set by the main thread must not be visible here
+  if (clqmcGetErrorString()[0] != '\0')
+    ctx->failures++;
+  for (int i = 0; i < 10000; i++)
+    if (!provoke_error(ctx->log2_points)) {
+      ctx->failures++;
+      break;
+    }
+  return 0;
+}
+
+// Checks that the error string is thread-local: errors set concurrently by
+// several threads are each read back by the thread that set them, and leave
+// the error string of the main thread intact.  Returns the number of failures.
+static int check_error_strings(void)
+{
+  enum { THREADS = 4 };
+  ErrorCheckContext ctx[THREADS];
+  int failures = 0;
+  if (!provoke_error(99))
+    failures++;
+  for (int t = 0; t < THREADS; t++) {
+    ctx[t].log2_points = 100 + (cl_uint) t;
+    ctx[t].failures = 0;
+  }
+#ifdef _WIN32
+  HANDLE handles[THREADS];
+  for (int t = 0; t < THREADS; t++)
+    handles[t] = CreateThread(NULL, 0, error_check_main, &ctx[t], 0, NULL);
+  WaitForMultipleObjects(THREADS, handles, TRUE, INFINITE);
+  for (int t = 0; t < THREADS; t++)
+    CloseHandle(handles[t]);
+#else
+  pthread_t handles[THREADS];
+  for (int t = 0; t < THREADS; t++)
+    pthread_create(&handles[t], NULL, error_check_main, &ctx[t]);
+  for (int t = 0; t < THREADS; t++)
+    pthread_join(handles[t], NULL);
+#endif
+  for (int t = 0; t < THREADS; t++)
+    failures += ctx[t].failures;
+  if (strstr(clqmcGetErrorString(), "2^99 points") == NULL)
+    failures++;
+  if (failures)
+    fprintf(stderr, "check failed: the error string is shared between threads\n");
+  return failures;
+}
+
+
+/********************************************************************************
+ * Baseline                                                                     *
+ ********************************************************************************/
+
+typedef struct BaselineEntry_ {
+  char name[64];
+  cl_uint dimension;
+  int log2_points;
+  int threads;
+  double ns_per_call;
+} BaselineEntry;
+
+static size_t read_baseline(const char* filename, BaselineEntry* entries)
+{
+  FILE* file = fopen(filename, "r");
+  if (file == NULL) {
+    perror("cannot open baseline file");
+    exit(EXIT_FAILURE);
+  }
+  size_t count = 0;
+  char line[256];
+  while (fgets(line, sizeof(line), file) && count < MAX_BASELINE) {
+    BaselineEntry* e = &entries[count];
+    if (line[0] == '#')
+      continue;
+    if (sscanf(line, "%63s %u %d %d %lf", e->name, &e->dimension, &e->log2_points, &e->threads, &e->ns_per_call) == 5)
+      count++;
+  }
+  fclose(file);
+  return count;
+}
+
+static const BaselineEntry* find_baseline(const BaselineEntry* entries, size_t count,
+    const char* name, cl_uint dimension, int log2_points, int threads)
+{
+  for (size_t i = 0; i < count; i++)
+    if (strcmp(entries[i].name, name) == 0 && entries[i].dimension == dimension
+        && entries[i].log2_points == log2_points && entries[i].threads == threads)
+      return &entries[i];
+  return NULL;
+}
+
+
+/********************************************************************************
+ * Main                                                                         *
+ ********************************************************************************/
+
+static size_t parse_list(const char* arg, cl_uint* values)
+{
+  size_t count = 0;
+  while (*arg && count < MAX_LIST) {
+    char* end;
+    values[count] = (cl_uint) strtoul(arg, &end, 10);
+    if (end == arg)
+      break;
+    count++;
+    arg = *end == ',' ? end + 1 : end;
+  }
+  if (*arg || count == 0) {
+    fprintf(stderr, "invalid list: %s\n", arg);
+    exit(EXIT_FAILURE);
+  }
+  return count;
+}
+
+static void usage(const char* prog)
+{
+  fprintf(stderr,
+      "usage: %s [options]\n"
+      "options:\n"
+      "  --benchmarks <list>        comma-separated names (default: all)\n"
+      "  --dimensions <list>        (default: 1,10,100,1000)\n"
+      "  --log2-points <list>       (default: 10,20,30)\n"
+      "  --threads <list>           (default: 1)\n"
+      "  --iterations <count>       calls per benchmark, overrides the defaults\n"
+      "  --repeat <count>           the best of <count> runs is reported (default: 3)\n"
+      "  --save-baseline <file>     write the results to a baseline file\n"
+      "  --baseline <file>          compare the results to a baseline file\n"
+      "  --tolerance <fraction>     allowed slowdown relative to the baseline (default: 0.1)\n"
+      "benchmarks:\n",
+      prog);
+  for (size_t b = 0; b < NUM_BENCHMARKS; b++)
+    fprintf(stderr, "  %s\n", benchmarks[b].name);
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+
+  cl_uint dimensions[MAX_LIST] = { 1, 10, 100, 1000 };
+  size_t dimensions_count = 4;
+  cl_uint log2_points[MAX_LIST] = { 10, 20, 30 };
+  size_t log2_points_count = 3;
+  cl_uint threads[MAX_LIST] = { 1 };
+  size_t threads_count = 1;
+  const char* selected = NULL;
+  size_t iterations = 0;
+  int repeat = 3;
+  const char* save_baseline = NULL;
+  const char* baseline = NULL;
+  double tolerance = 0.1;
+
+  while (argc) {
+    const char* opt = *argv++; argc--;
+    if (argc == 0)
+      usage(prog);
+    const char* arg = *argv++; argc--;
+    if (strcmp(opt, "--benchmarks") == 0)
+      selected = arg;
+    else if (strcmp(opt, "--dimensions") == 0)
+      dimensions_count = parse_list(arg, dimensions);
+    else if (strcmp(opt, "--log2-points") == 0)
+      log2_points_count = parse_list(arg, log2_points);
+    else if (strcmp(opt, "--threads") == 0)
+      threads_count = parse_list(arg, threads);
+    else if (strcmp(opt, "--iterations") == 0)
+      iterations = (size_t) strtoull(arg, NULL, 10);
+    else if (strcmp(opt, "--repeat") == 0)
+      repeat = atoi(arg);
+    else if (strcmp(opt, "--save-baseline") == 0)
+      save_baseline = arg;
+    else if (strcmp(opt, "--baseline") == 0)
+      baseline = arg;
+    else if (strcmp(opt, "--tolerance") == 0)
+      tolerance = atof(arg);
+    else
+      usage(prog);
+  }
+
+  if (repeat < 1)
+    usage(prog);
+  for (size_t i = 0; i < dimensions_count; i++)
+    if (dimensions[i] == 0)
+      usage(prog);
+  for (size_t i = 0; i < log2_points_count; i++)
+    if (log2_points[i] > 31)
+      usage(prog);
+  for (size_t i = 0; i < threads_count; i++)
+    if (threads[i] == 0 || threads[i] > MAX_THREADS)
+      usage(prog);
+
+  BaselineEntry* baseline_entries = NULL;
+  size_t baseline_count = 0;
+  if (baseline) {
+    baseline_entries = (BaselineEntry*) malloc(MAX_BASELINE * sizeof(BaselineEntry));
+    baseline_count = read_baseline(baseline, baseline_entries);
+  }
+
+  FILE* save = NULL;
+  if (save_baseline) {
+    save = fopen(save_baseline, "w");
+    if (save == NULL) {
+      perror("cannot open baseline file for writing");
+      exit(EXIT_FAILURE);
+    }
+    fprintf(save, "# benchmark dimension log2_points threads ns_per_call\n");
+  }
+
+  if (check_transforms_clqmc_float() + check_transforms_clqmc_double() + check_error_strings())
+    exit(EXIT_FAILURE);
+
+  printf("benchmark,dimension,log2_points,threads,iterations,ns_per_call,baseline_ns_per_call,ratio,status\n");
+
+  int regressions = 0;
+  double sink = 0.0;
+
+  for (size_t b = 0; b < NUM_BENCHMARKS; b++) {
+
+    const BenchEntry* bench = &benchmarks[b];
+
+    if (selected) {
+      const char* p = strstr(selected, bench->name);
+      size_t len = strlen(bench->name);
+      if (p == NULL || (p != selected && p[-1] != ',') || (p[len] != '\0' && p[len] != ','))
+        continue;
+    }
+
+    for (size_t id = 0; id < dimensions_count; id++)
+    for (size_t ip = 0; ip < log2_points_count; ip++)
+    for (size_t it = 0; it < threads_count; it++) {
+
+      cl_uint dimension = dimensions[id];
+      cl_uint points = (cl_uint) (1ULL << log2_points[ip]);
+
+      // Korobov-like generating vector; its quality does not matter here.
+      cl_int* genVec = (cl_int*) malloc(dimension * sizeof(cl_int));
+      cl_double* shift = (cl_double*) malloc(dimension * sizeof(cl_double));
+      for (cl_uint j = 0; j < dimension; j++) {
+        genVec[j] = (cl_int) ((2 * j + 1) % points);
+        shift[j] = (j + 0.5) / dimension;
+      }
+      clqmcStatus err;
+      clqmcLatticeRule* lattice = clqmcLatticeRuleCreate_clqmc_double(points, dimension, genVec, NULL, &err);
+      check(err);
+
+      BenchContext ctx;
+      ctx.name = bench->name;
+      ctx.dimension = dimension;
+      ctx.points = points;
+      ctx.iterations = iterations ? iterations : bench->iterations;
+      ctx.genVec = genVec;
+      ctx.lattice = lattice;
+      ctx.shift = shift;
+      ctx.cpu = 0;
+      ctx.seconds = 0.0;
+      ctx.sink = 0.0;
+
+      double best = 0.0;
+      for (int r = 0; r < repeat; r++) {
+        double ns = run_threads(bench->func, &ctx, (int) threads[it]);
+        if (r == 0 || ns < best)
+          best = ns;
+      }
+      sink += ctx.sink;
+
+      printf("%s,%u,%u,%u,%lu,%.4g", bench->name, dimension, log2_points[ip], threads[it],
+          (unsigned long) ctx.iterations, best);
+
+      const BaselineEntry* ref = baseline_count
+        ? find_baseline(baseline_entries, baseline_count, bench->name, dimension, log2_points[ip], threads[it])
+        : NULL;
+      if (ref) {
+        double ratio = best / ref->ns_per_call;
+        int slower = ratio > 1.0 + tolerance;
+        regressions += slower;
+        printf(",%.4g,%.3f,%s\n", ref->ns_per_call, ratio, slower ? "REGRESSION" : "ok");
+      }
+      else
+        printf(",,,\n");
+      fflush(stdout);
+
+      if (save)
+        fprintf(save, "%s %u %u %u %.6g\n", bench->name, dimension, log2_points[ip], threads[it], best);
+
+      clqmcLatticeRuleDestroy(lattice);
+      free(shift);
+      free(genVec);
+    }
+  }
+
+  if (save)
+    fclose(save);
+  free(baseline_entries);
+
+  // keep the compiler from discarding the computations
+  if (sink == 0.12345)
+    printf("\n");
+
+  if (regressions)
+    fprintf(stderr, "%d regression(s) above tolerance %g\n", regressions, tolerance);
+
+  return regressions ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*
+vim: ft=c sw=2 expandtab
+*/
@@ -0,0 +1,228 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+/* Brownian path constructions for an Asian option.
+ *
+ * Estimates the price of an arithmetic Asian call option under a geometric
+ * Brownian motion observed at equally spaced times, with a randomly shifted
+ * lattice rule whose dimension is the number of observation times, and with
+ * each of the path constructions of clQMC/brownian.h.  All constructions
+ * give the same expectation, but the bridge and the PCA concentrate the
+ * variance of the payoff on the first coordinates of the lattice rule, which
+ * reduces the variance of the RQMC estimator.
+ */
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common.h"
+
+#include <clQMC/brownian.h>
+#include <clQMC/randomshift.h>
+
+#define SHIFTS_SEED 1234
+
+// at most this many work items per shift
+#define MAX_BLOCKS 1024
+
+typedef struct TaskData_ {
+  cl_uint log2_points;
+  cl_uint steps;
+  cl_uint replications;
+  clqmc_fptype s0;
+  clqmc_fptype strike;
+  clqmc_fptype rate;
+  clqmc_fptype sigma;
+  clqmc_fptype maturity;
+} TaskData;
+
+static const char* construction_names[] = { "sequential", "bridge", "PCA" };
+
+int task(cl_context context, cl_device_id device, cl_command_queue queue, void* data_)
+{
+  const TaskData* data = (const TaskData*) data_;
+  cl_int err;
+
+  // Lattice rule, shifts and observation times
+
+  size_t lattice_size;
+  clqmcLatticeRule* lattice = clqmcLatticeRuleCreateFromCatalogue(data->log2_points, data->steps,
+      CLQMC_LATTICE_CBC_POLY, &lattice_size, (clqmcStatus*) &err);
+  check_error(err, NULL);
+
+  cl_uint points = clqmcLatticeRuleNumPoints(lattice);
+  cl_uint blocks = points < MAX_BLOCKS ? points : MAX_BLOCKS;
+  size_t global_size = (size_t) data->replications * blocks;
+
+  size_t shifts_size = (size_t) data->replications * data->steps * sizeof(clqmc_fptype);
+  clqmc_fptype* shifts = (clqmc_fptype*) malloc(shifts_size);
+  err = clqmcRandomShiftsGenerate(SHIFTS_SEED, 0, data->replications, data->steps, shifts);
+  check_error(err, NULL);
+
+  cl_double* times = (cl_double*) malloc(data->steps * sizeof(cl_double));
+  for (cl_uint j = 0; j < data->steps; j++)
+    times[j] = data->maturity * (j + 1) / data->steps;
+
+
+  // Buffers and kernel
+
+  cl_mem lattice_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      lattice_size, lattice, &err);
+  check_error(err, "cannot create lattice buffer");
+  cl_mem shifts_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      shifts_size, shifts, &err);
+  check_error(err, "cannot create shifts buffer");
+  cl_mem out_buf = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_HOST_READ_ONLY,
+      global_size * sizeof(clqmc_fptype), NULL, &err);
+  check_error(err, "cannot create output buffer");
+
+  // the kernel stores a path in a private array of STEPS values
+  char options[64];
+  snprintf(options, sizeof(options), "-DSTEPS=%u", data->steps);
+  cl_program program = build_program_from_file(context, device, "client/BrownianPath/brownianpath_kernel.cl", options);
+  cl_kernel kernel = clCreateKernel(program, "asianCall", &err);
+  check_error(err, "cannot create kernel");
+
+  err  = clSetKernelArg(kernel, 0, sizeof(lattice_buf),    &lattice_buf);
+  err |= clSetKernelArg(kernel, 1, sizeof(shifts_buf),     &shifts_buf);
+  err |= clSetKernelArg(kernel, 3, sizeof(blocks),         &blocks);
+  err |= clSetKernelArg(kernel, 4, sizeof(data->s0),       &data->s0);
+  err |= clSetKernelArg(kernel, 5, sizeof(data->strike),   &data->strike);
+  err |= clSetKernelArg(kernel, 6, sizeof(data->rate),     &data->rate);
+  err |= clSetKernelArg(kernel, 7, sizeof(data->sigma),    &data->sigma);
+  err |= clSetKernelArg(kernel, 8, sizeof(data->maturity), &data->maturity);
+  err |= clSetKernelArg(kernel, 9, sizeof(out_buf),        &out_buf);
+  check_error(err, "cannot set kernel arguments");
+
+
+  // Simulation with each construction
+
+  clqmc_fptype* out = (clqmc_fptype*) malloc(global_size * sizeof(clqmc_fptype));
+  double variances[3];
+
+  printf("\nArithmetic Asian call option with %u observations (S0 = %g, K = %g, r = %g, sigma = %g, T = %g)\n\n",
+      data->steps, (double) data->s0, (double) data->strike, (double) data->rate, (double) data->sigma,
+      (double) data->maturity);
+  err = clqmcLatticeRuleWriteInfo(lattice, stdout);
+  check_error(err, NULL);
+  printf("\n%16s%16s%16s%16s\n", "construction", "mean", "variance", "reduction");
+
+  for (int c = CLQMC_BROWNIAN_SEQUENTIAL; c <= CLQMC_BROWNIAN_PCA; c++) {
+
+    size_t path_size;
+    clqmcBrownianPath* path = clqmcBrownianPathCreate(data->steps, times, (clqmcBrownianConstruction) c,
+        &path_size, (clqmcStatus*) &err);
+    check_error(err, NULL);
+    cl_mem path_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+        path_size, path, &err);
+    check_error(err, "cannot create path buffer");
+    err = clSetKernelArg(kernel, 2, sizeof(path_buf), &path_buf);
+    check_error(err, "cannot set kernel arguments");
+
+    cl_event ev;
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size, NULL, 0, NULL, &ev);
+    check_error(err, "cannot enqueue kernel");
+    profile_event(construction_names[c], ev);
+    err = clEnqueueReadBuffer(queue, out_buf, CL_TRUE, 0, global_size * sizeof(clqmc_fptype), out, 1, &ev, NULL);
+    check_error(err, "cannot read output buffer");
+    clReleaseEvent(ev);
+
+    double mean = 0.0, variance = 0.0;
+    for (cl_uint r = 0; r < data->replications; r++) {
+      double sum = 0.0;
+      for (cl_uint b = 0; b < blocks; b++)
+        sum += out[r * blocks + b];
+      double estimate = sum / points;
+      double delta = estimate - mean;
+      mean += delta / (r + 1);
+      variance += delta * (estimate - mean);
+    }
+    variances[c] = variance / (data->replications - 1);
+
+    printf("%16s%16.6g%16.6g%16.4g\n", construction_names[c], mean, variances[c], variances[0] / variances[c]);
+
+    clReleaseMemObject(path_buf);
+    clqmcBrownianPathDestroy(path);
+  }
+
+
+  // Clean up
+
+  free(out);
+  free(shifts);
+  free(times);
+  clReleaseKernel(kernel);
+  clReleaseProgram(program);
+  clReleaseMemObject(lattice_buf);
+  clReleaseMemObject(shifts_buf);
+  clReleaseMemObject(out_buf);
+  err = clqmcLatticeRuleDestroy(lattice);
+  check_error(err, NULL);
+
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+  cl_device_type device_type = CL_DEVICE_TYPE_CPU;
+
+  while (argc && (*argv)[0] == '-') {
+    if (strcmp(*argv, "--gpu") == 0) {
+      device_type = CL_DEVICE_TYPE_GPU;
+      argv++; argc--;
+    }
+    else
+      break;
+  }
+
+  if (argc != 3) {
+    fprintf(stderr, "usage: %s [--gpu] <log2-points> <observations> <replications>\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  TaskData data;
+  data.log2_points  = (cl_uint) atoi(argv[0]);
+  data.steps        = (cl_uint) atoi(argv[1]);
+  data.replications = (cl_uint) atoi(argv[2]);
+  data.s0           = 100.0;
+  data.strike       = 100.0;
+  data.rate         = 0.05;
+  data.sigma        = 0.2;
+  data.maturity     = 1.0;
+
+  if (data.steps < 1 || data.replications < 2) {
+    fprintf(stderr, "%s: at least 1 observation and 2 replications are required\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  return call_with_opencl(0, device_type, 0, &task, &data, CL_TRUE);
+}
@@ -0,0 +1,72 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+#include <clQMC/brownian.clh>
+
+// Work item i processes block i % blocks of the points of the lattice rule,
+// randomized with shift i / blocks, and writes the sum of the discounted
+// payoffs of an arithmetic Asian call option to out[i].  The path at the
+// STEPS equally spaced observation times is built with `path`.
+__kernel void asianCall(
+        __global const clqmcLatticeRule* lattice,
+        __global const clqmc_fptype* shifts,
+        __constant const clqmcBrownianPath* path,
+        uint blocks,
+        clqmc_fptype s0,
+        clqmc_fptype strike,
+        clqmc_fptype rate,
+        clqmc_fptype sigma,
+        clqmc_fptype maturity,
+        __global clqmc_fptype* out)
+{
+  uint gid   = get_global_id(0);
+  uint block = gid % blocks;
+  uint rep   = gid / blocks;
+
+  clqmcLatticeRuleStream stream;
+  clqmcLatticeRuleCreateOverStream(&stream, lattice, blocks, block,
+      shifts + rep * clqmcLatticeRuleDimension(lattice));
+
+  clqmc_fptype h = maturity / STEPS;
+  clqmc_fptype drift = rate - sigma * sigma / 2;
+  clqmc_fptype w[STEPS];
+
+  uint pointsPerBlock = clqmcLatticeRuleNumPoints(lattice) / blocks;
+  clqmc_fptype sum = 0;
+  for (uint i = 0; i < pointsPerBlock; i++) {
+    clqmcBrownianPathNextPath(path, &stream, w);
+    clqmc_fptype average = 0;
+    for (uint j = 0; j < STEPS; j++)
+      average += s0 * exp(drift * h * (j + 1) + sigma * w[j]);
+    average /= STEPS;
+    sum += fmax(average - strike, (clqmc_fptype) 0);
+    clqmcLatticeRuleForwardToNextPoint(&stream);
+  }
+
+  out[gid] = exp(-rate * maturity) * sum;
+}
+
+/*
+vim: ft=c
+*/
@@ -0,0 +1,683 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Integration daemon.
+ *
+ * Sets up OpenCL once with call_with_opencl(), then serves jobs submitted
+ * over a Unix domain socket (see clqmcd.h) until it receives a shutdown
+ * command or SIGINT/SIGTERM.  The programs built for the jobs, keyed by
+ * source contents, kernel name, precision and options, and the lattice rules
+ * copied to the device, keyed by catalogue entry and precision, are kept
+ * for the lifetime of the daemon, so that repeated jobs only pay for
+ * generating the shifts, the kernel and the transfer of the estimates.
+ *
+ * Connections are served one at a time, and the jobs of a connection in
+ * order, so jobs never compete for the device.
+ */
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <errno.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../common.h"
+#include "clqmcd.h"
+
+#include <clQMC/latticerule.h>
+#include <clQMC/randomshift.h>
+
+// at most this many work items per shift when the job leaves it to the daemon
+#define MAX_BLOCKS      1024
+// upper bound on the number of kernel parameters of a job
+#define MAX_PARAMS      (1u << 20)
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+typedef struct ProgramEntry_ {
+  cl_ulong hash;                // of the expanded source
+  char name[sizeof(((clqmcdJob*) 0)->kernelName)];
+  char options[sizeof(((clqmcdJob*) 0)->options)];
+  cl_uint single;
+  cl_program program;
+  cl_kernel kernel;
+  struct ProgramEntry_* next;
+} ProgramEntry;
+
+typedef struct LatticeEntry_ {
+  cl_uint log2_points;
+  cl_uint dimension;
+  cl_uint family;
+  cl_uint single;
+  cl_uint points;
+  cl_mem buffer;
+  struct LatticeEntry_* next;
+} LatticeEntry;
+
+// device buffer and host staging area that only grow
+typedef struct Buffer_ {
+  cl_mem mem;
+  void* host;
+  size_t size;
+} Buffer;
+
+typedef struct Daemon_ {
+  const char* socket_path;
+  cl_context context;
+  cl_device_id device;
+  cl_command_queue queue;
+  ProgramEntry* programs;
+  LatticeEntry* lattices;
+  Buffer shifts;
+  Buffer params;
+  Buffer out;
+  double* estimates;
+  cl_uint estimates_size;
+  unsigned long jobs;
+} Daemon;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int sig)
+{
+  (void) sig;
+  stop_requested = 1;
+}
+
+static cl_ulong now_ns(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (cl_ulong) ts.tv_sec * 1000000000u + (cl_ulong) ts.tv_nsec;
+}
+
+// Record an error in the result and return its status.
+static cl_int fail(clqmcdResult* result, cl_int status, const char* fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(result->message, sizeof(result->message), fmt, args);
+  va_end(args);
+  result->status = status;
+  return status;
+}
+
+
+// Programs
+
+// Read a kernel source file relative to the library root; unlike
+// build_program_from_file(), errors are returned to the client instead of
+// terminating the daemon.  Absolute paths and parent directories are
+// rejected, so that clients cannot read files outside of the library root.
+static char* read_source(const char* file, clqmcdResult* result)
+{
+  const char* p = file;
+  if (file[0] == '\0' || file[0] == '/') {
+    fail(result, CLQMC_INVALID_VALUE, "the kernel file must be relative to the library root");
+    return NULL;
+  }
+  while ((p = strstr(p, "..")) != NULL) {
+    if ((p == file || p[-1] == '/') && (p[2] == '\0' || p[2] == '/')) {
+      fail(result, CLQMC_INVALID_VALUE, "the kernel file cannot refer to a parent directory");
+      return NULL;
+    }
+    p += 2;
+  }
+
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/%s", clqmcGetLibraryRoot(), file);
+  FILE* f = fopen(path, "rb");
+  if (!f) {
+    fail(result, CLQMC_INVALID_VALUE, "cannot open kernel file %s: %s", path, strerror(errno));
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char* source = len >= 0 ? (char*) malloc((size_t) len + 1) : NULL;
+  if (!source || fread(source, 1, (size_t) len, f) != (size_t) len) {
+    fail(result, CLQMC_INVALID_VALUE, "cannot read kernel file %s", path);
+    free(source);
+    fclose(f);
+    return NULL;
+  }
+  source[len] = '\0';
+  fclose(f);
+  return source;
+}
+
+// The source is read and hashed for every job, so that an edited kernel file
+// is rebuilt; only the build is skipped when the program is cached.
+static cl_kernel get_kernel(Daemon* d, const clqmcdJob* job, clqmcdResult* result)
+{
+  char* source = read_source(job->kernelFile, result);
+  if (!source)
+    return NULL;
+
+  cl_int err;
+  cl_ulong hash;
+  const char* sources[1] = { source };
+  cl_program program = clqmcCreateProgramWithSource(d->context, 1, sources, NULL, &hash, (clqmcStatus*) &err);
+  free(source);
+  if (err != CL_SUCCESS) {
+    fail(result, err, "%s", clqmcGetErrorString());
+    return NULL;
+  }
+
+  for (ProgramEntry* e = d->programs; e; e = e->next) {
+    if (e->hash == hash && e->single == job->singlePrecision
+        && strcmp(e->name, job->kernelName) == 0 && strcmp(e->options, job->options) == 0) {
+      clReleaseProgram(program);
+      result->cached |= CLQMCD_CACHED_PROGRAM;
+      return e->kernel;
+    }
+  }
+
+  // the clQMC headers are embedded in the library, but the kernel may
+  // include other files installed with it
+  const char* includes = clqmcGetLibraryDeviceIncludes(NULL);
+  if (!includes)
+    includes = "";
+  size_t options_size = strlen(includes) + strlen(job->options) + 32;
+  char* options = (char*) malloc(options_size);
+  if (!options) {
+    fail(result, CLQMC_OUT_OF_RESOURCES, "cannot allocate build options");
+    clReleaseProgram(program);
+    return NULL;
+  }
+  snprintf(options, options_size, "%s%s %s", includes,
+      job->singlePrecision ? " -DCLQMC_SINGLE_PRECISION" : "", job->options);
+  err = clBuildProgram(program, 1, &d->device, options, NULL, NULL);
+  free(options);
+  if (err != CL_SUCCESS) {
+    // return the beginning of the build log
+    size_t log_size = 0;
+    char* log = NULL;
+    if (clGetProgramBuildInfo(program, d->device, CL_PROGRAM_BUILD_LOG, 0, NULL, &log_size) == CL_SUCCESS)
+      log = (char*) malloc(log_size + 1);
+    if (log && clGetProgramBuildInfo(program, d->device, CL_PROGRAM_BUILD_LOG, log_size, log, NULL) == CL_SUCCESS) {
+      log[log_size] = '\0';
+      fail(result, err, "cannot build program:\n%s", log);
+    }
+    else
+      fail(result, err, "cannot build program");
+    free(log);
+    clReleaseProgram(program);
+    return NULL;
+  }
+
+  cl_kernel kernel = clCreateKernel(program, job->kernelName, &err);
+  if (err != CL_SUCCESS) {
+    fail(result, err, "cannot create kernel %s", job->kernelName);
+    clReleaseProgram(program);
+    return NULL;
+  }
+
+  ProgramEntry* e = (ProgramEntry*) malloc(sizeof(ProgramEntry));
+  if (!e) {
+    fail(result, CLQMC_OUT_OF_RESOURCES, "cannot allocate program cache entry");
+    clReleaseKernel(kernel);
+    clReleaseProgram(program);
+    return NULL;
+  }
+  e->hash = hash;
+  strcpy(e->name, job->kernelName);
+  strcpy(e->options, job->options);
+  e->single = job->singlePrecision;
+  e->program = program;
+  e->kernel = kernel;
+  e->next = d->programs;
+  d->programs = e;
+  return kernel;
+}
+
+
+// Lattice rules
+
+static LatticeEntry* get_lattice(Daemon* d, const clqmcdJob* job, clqmcdResult* result)
+{
+  for (LatticeEntry* e = d->lattices; e; e = e->next) {
+    if (e->log2_points == job->log2Points && e->dimension == job->dimension
+        && e->family == job->family && e->single == job->singlePrecision) {
+      result->cached |= CLQMCD_CACHED_LATTICE;
+      return e;
+    }
+  }
+
+  clqmcStatus status;
+  size_t size;
+  clqmcLatticeRuleFamily family = (clqmcLatticeRuleFamily) job->family;
+  clqmcLatticeRule* lattice = job->singlePrecision
+    ? clqmcLatticeRuleCreateFromCatalogue_clqmc_float (job->log2Points, job->dimension, family, &size, &status)
+    : clqmcLatticeRuleCreateFromCatalogue_clqmc_double(job->log2Points, job->dimension, family, &size, &status);
+  if (!lattice) {
+    fail(result, status, "%s", clqmcGetErrorString());
+    return NULL;
+  }
+
+  cl_int err;
+  cl_mem buffer = clCreateBuffer(d->context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      size, lattice, &err);
+  cl_uint points = clqmcLatticeRuleNumPoints(lattice);
+  clqmcLatticeRuleDestroy(lattice);
+  if (err != CL_SUCCESS) {
+    fail(result, err, "cannot create lattice buffer");
+    return NULL;
+  }
+
+  LatticeEntry* e = (LatticeEntry*) malloc(sizeof(LatticeEntry));
+  if (!e) {
+    fail(result, CLQMC_OUT_OF_RESOURCES, "cannot allocate lattice cache entry");
+    clReleaseMemObject(buffer);
+    return NULL;
+  }
+  e->log2_points = job->log2Points;
+  e->dimension = job->dimension;
+  e->family = job->family;
+  e->single = job->singlePrecision;
+  e->points = points;
+  e->buffer = buffer;
+  e->next = d->lattices;
+  d->lattices = e;
+  return e;
+}
+
+
+// Buffers
+
+static cl_int reserve(Daemon* d, Buffer* b, size_t size, cl_mem_flags flags, clqmcdResult* result)
+{
+  if (size <= b->size)
+    return CL_SUCCESS;
+  if (b->mem)
+    clReleaseMemObject(b->mem);
+  free(b->host);
+  b->size = 0;
+  b->host = malloc(size);
+  if (!b->host)
+    return fail(result, CLQMC_OUT_OF_RESOURCES, "cannot allocate %lu bytes", (unsigned long) size);
+  cl_int err;
+  b->mem = clCreateBuffer(d->context, flags, size, NULL, &err);
+  if (err != CL_SUCCESS) {
+    b->mem = NULL;
+    return fail(result, err, "cannot create buffer of %lu bytes", (unsigned long) size);
+  }
+  b->size = size;
+  return CL_SUCCESS;
+}
+
+static void release_buffer(Buffer* b)
+{
+  if (b->mem)
+    clReleaseMemObject(b->mem);
+  free(b->host);
+}
+
+
+// Jobs
+
+// Run a job and leave its estimates in d->estimates.
+static cl_int run_job(Daemon* d, const clqmcdJob* job, const double* params, clqmcdResult* result)
+{
+  if (job->replications == 0)
+    return fail(result, CLQMC_INVALID_VALUE, "at least one replication is required");
+
+  LatticeEntry* lattice = get_lattice(d, job, result);
+  if (!lattice)
+    return result->status;
+  cl_kernel kernel = get_kernel(d, job, result);
+  if (!kernel)
+    return result->status;
+
+  cl_uint blocks = job->blocks ? job->blocks : (lattice->points < MAX_BLOCKS ? lattice->points : MAX_BLOCKS);
+  if (lattice->points % blocks != 0)
+    return fail(result, CLQMC_INVALID_VALUE, "the number of blocks must divide the number of points (%u)", lattice->points);
+  result->blocks = blocks;
+
+  size_t fpsize = job->singlePrecision ? sizeof(cl_float) : sizeof(cl_double);
+  size_t global_size = (size_t) job->replications * blocks;
+  size_t shifts_size = (size_t) job->replications * job->dimension * fpsize;
+  // kernels can read params[0] even without parameters; it is then zero
+  cl_uint num_params = job->numParams ? job->numParams : 1;
+  size_t params_size = num_params * fpsize;
+  size_t out_size = global_size * fpsize;
+
+  cl_int err;
+  if ((err = reserve(d, &d->shifts, shifts_size, CL_MEM_READ_ONLY, result)) != CL_SUCCESS
+      || (err = reserve(d, &d->params, params_size, CL_MEM_READ_ONLY, result)) != CL_SUCCESS
+      || (err = reserve(d, &d->out, out_size, CL_MEM_WRITE_ONLY, result)) != CL_SUCCESS)
+    return err;
+
+  // the shifts and the parameters in the precision of the job
+  if (job->singlePrecision) {
+    err = clqmcRandomShiftsGenerate_clqmc_float(job->seed, job->firstReplication, job->replications, job->dimension,
+        (cl_float*) d->shifts.host);
+    for (cl_uint i = 0; i < num_params; i++)
+      ((cl_float*) d->params.host)[i] = i < job->numParams ? (cl_float) params[i] : 0.0f;
+  }
+  else {
+    err = clqmcRandomShiftsGenerate_clqmc_double(job->seed, job->firstReplication, job->replications, job->dimension,
+        (cl_double*) d->shifts.host);
+    for (cl_uint i = 0; i < num_params; i++)
+      ((cl_double*) d->params.host)[i] = i < job->numParams ? params[i] : 0.0;
+  }
+  if (err != CLQMC_SUCCESS)
+    return fail(result, err, "%s", clqmcGetErrorString());
+
+  err = clEnqueueWriteBuffer(d->queue, d->shifts.mem, CL_FALSE, 0, shifts_size, d->shifts.host, 0, NULL, NULL);
+  if (err == CL_SUCCESS)
+    err = clEnqueueWriteBuffer(d->queue, d->params.mem, CL_FALSE, 0, params_size, d->params.host, 0, NULL, NULL);
+  if (err != CL_SUCCESS)
+    return fail(result, err, "cannot write input buffers");
+
+  err  = clSetKernelArg(kernel, 0, sizeof(lattice->buffer), &lattice->buffer);
+  err |= clSetKernelArg(kernel, 1, sizeof(d->shifts.mem),   &d->shifts.mem);
+  err |= clSetKernelArg(kernel, 2, sizeof(d->params.mem),   &d->params.mem);
+  err |= clSetKernelArg(kernel, 3, sizeof(blocks),          &blocks);
+  err |= clSetKernelArg(kernel, 4, sizeof(d->out.mem),      &d->out.mem);
+  if (err != CL_SUCCESS)
+    return fail(result, err, "cannot set kernel arguments; see clqmcd.h for the kernel signature");
+
+  cl_event ev;
+  err = clEnqueueNDRangeKernel(d->queue, kernel, 1, NULL, &global_size, NULL, 0, NULL, &ev);
+  if (err != CL_SUCCESS)
+    return fail(result, err, "cannot enqueue kernel");
+  profile_event(job->kernelName, ev);
+  err = clEnqueueReadBuffer(d->queue, d->out.mem, CL_TRUE, 0, out_size, d->out.host, 1, &ev, NULL);
+  if (err == CL_SUCCESS) {
+    cl_ulong start = 0, end = 0;
+    clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+    clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+    result->kernelTime = end - start;
+  }
+  clReleaseEvent(ev);
+  if (err != CL_SUCCESS)
+    return fail(result, err, "cannot read output buffer");
+
+  // estimates per replication
+  if (job->replications > d->estimates_size) {
+    free(d->estimates);
+    d->estimates = (double*) malloc(job->replications * sizeof(double));
+    d->estimates_size = d->estimates ? job->replications : 0;
+    if (!d->estimates)
+      return fail(result, CLQMC_OUT_OF_RESOURCES, "cannot allocate estimates");
+  }
+  for (cl_uint r = 0; r < job->replications; r++) {
+    double sum = 0.0;
+    for (cl_uint b = 0; b < blocks; b++) {
+      size_t i = (size_t) r * blocks + b;
+      sum += job->singlePrecision ? ((cl_float*) d->out.host)[i] : ((cl_double*) d->out.host)[i];
+    }
+    d->estimates[r] = sum / lattice->points;
+  }
+  result->replications = job->replications;
+  result->status = CLQMC_SUCCESS;
+  return CLQMC_SUCCESS;
+}
+
+
+// Socket
+
+static int read_all(int fd, void* buf, size_t size)
+{
+  char* p = (char*) buf;
+  while (size > 0) {
+    ssize_t n = recv(fd, p, size, 0);
+    if (n < 0 && errno == EINTR && !stop_requested)
+      continue;
+    if (n <= 0)
+      return -1;
+    p += n;
+    size -= (size_t) n;
+  }
+  return 0;
+}
+
+static int write_all(int fd, const void* buf, size_t size)
+{
+  const char* p = (const char*) buf;
+  while (size > 0) {
+    ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    p += n;
+    size -= (size_t) n;
+  }
+  return 0;
+}
+
+// Serve the jobs of a connection; return 1 if a shutdown was requested.
+static int serve_connection(Daemon* d, int fd)
+{
+  double* params = NULL;
+  int shutdown = 0;
+  clqmcdJob job;
+
+  while (!shutdown && !stop_requested && read_all(fd, &job, sizeof(job)) == 0) {
+    clqmcdResult result;
+    memset(&result, 0, sizeof(result));
+    cl_ulong start = now_ns();
+
+    if (job.magic != CLQMCD_MAGIC || job.version != CLQMCD_VERSION) {
+      fail(&result, CLQMC_INVALID_VALUE, "protocol mismatch (expected version %u)", CLQMCD_VERSION);
+      write_all(fd, &result, sizeof(result));
+      break;
+    }
+    if (job.numParams > MAX_PARAMS) {
+      fail(&result, CLQMC_INVALID_VALUE, "too many parameters (at most %u)", MAX_PARAMS);
+      write_all(fd, &result, sizeof(result));
+      break;
+    }
+    job.kernelFile[sizeof(job.kernelFile) - 1] = '\0';
+    job.kernelName[sizeof(job.kernelName) - 1] = '\0';
+    job.options[sizeof(job.options) - 1] = '\0';
+
+    free(params);
+    params = (double*) malloc((job.numParams ? job.numParams : 1) * sizeof(double));
+    if (!params || (job.numParams && read_all(fd, params, job.numParams * sizeof(double)) < 0))
+      break;
+
+    if (job.command == CLQMCD_RUN) {
+      run_job(d, &job, params, &result);
+      d->jobs++;
+    }
+    else if (job.command == CLQMCD_SHUTDOWN)
+      shutdown = 1;
+    else if (job.command != CLQMCD_PING)
+      fail(&result, CLQMC_INVALID_VALUE, "unknown command %u", job.command);
+    result.jobTime = now_ns() - start;
+
+    if (job.command == CLQMCD_RUN)
+      fprintf(stderr, "clqmcd: job %lu: %s(%s) 2^%u points, %u dimensions, %u shifts: %s, kernel %.3f ms, job %.3f ms%s%s\n",
+          d->jobs, job.kernelName, job.kernelFile, job.log2Points, job.dimension, job.replications,
+          result.status == CLQMC_SUCCESS ? "ok" : "failed",
+          result.kernelTime * 1e-6, result.jobTime * 1e-6,
+          result.cached & CLQMCD_CACHED_PROGRAM ? ", cached program" : "",
+          result.cached & CLQMCD_CACHED_LATTICE ? ", cached lattice" : "");
+
+    if (write_all(fd, &result, sizeof(result)) < 0)
+      break;
+    if (result.status == CLQMC_SUCCESS && result.replications > 0
+        && write_all(fd, d->estimates, result.replications * sizeof(double)) < 0)
+      break;
+  }
+
+  free(params);
+  return shutdown;
+}
+
+// Bind the listening socket, refusing to replace the socket of a running
+// daemon.
+static int open_socket(const char* path)
+{
+  struct sockaddr_un addr;
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "clqmcd: socket path too long: %s\n", path);
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  int probe = clqmcd_connect(path);
+  if (probe >= 0) {
+    clqmcd_disconnect(probe);
+    fprintf(stderr, "clqmcd: a daemon is already listening on %s\n", path);
+    return -1;
+  }
+  unlink(path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    perror("clqmcd: socket");
+    return -1;
+  }
+  // only the owner may submit jobs
+  mode_t mask = umask(0077);
+  int ret = bind(fd, (struct sockaddr*) &addr, sizeof(addr));
+  umask(mask);
+  if (ret < 0 || listen(fd, 16) < 0) {
+    perror("clqmcd: bind");
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static void release_caches(Daemon* d)
+{
+  while (d->programs) {
+    ProgramEntry* e = d->programs;
+    d->programs = e->next;
+    clReleaseKernel(e->kernel);
+    clReleaseProgram(e->program);
+    free(e);
+  }
+  while (d->lattices) {
+    LatticeEntry* e = d->lattices;
+    d->lattices = e->next;
+    clReleaseMemObject(e->buffer);
+    free(e);
+  }
+  release_buffer(&d->shifts);
+  release_buffer(&d->params);
+  release_buffer(&d->out);
+  free(d->estimates);
+}
+
+int task(cl_context context, cl_device_id device, cl_command_queue queue, void* data)
+{
+  Daemon d;
+  memset(&d, 0, sizeof(d));
+  d.socket_path = (const char*) data;
+  d.context = context;
+  d.device = device;
+  d.queue = queue;
+
+  const char* device_name = get_device_name(device);
+  int listen_fd = open_socket(d.socket_path);
+  if (listen_fd < 0)
+    return EXIT_FAILURE;
+
+  // interrupt accept() and recv() on SIGINT and SIGTERM
+  struct sigaction sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = handle_signal;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+  signal(SIGPIPE, SIG_IGN);
+
+  fprintf(stderr, "clqmcd: serving %s on %s\n", device_name, d.socket_path);
+
+  while (!stop_requested) {
+    int fd = accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+      if (errno == EINTR)
+        continue;
+      perror("clqmcd: accept");
+      break;
+    }
+    int shutdown = serve_connection(&d, fd);
+    close(fd);
+    if (shutdown)
+      break;
+  }
+
+  fprintf(stderr, "clqmcd: exiting after %lu jobs\n", d.jobs);
+  close(listen_fd);
+  unlink(d.socket_path);
+  release_caches(&d);
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+  cl_device_type device_type = CL_DEVICE_TYPE_CPU;
+  int device_index = 0;
+  const char* socket_path = NULL;
+
+  while (argc && (*argv)[0] == '-') {
+    if (strcmp(*argv, "--gpu") == 0) {
+      device_type = CL_DEVICE_TYPE_GPU;
+      argv++; argc--;
+    }
+    else if (strcmp(*argv, "--device") == 0 && argc > 1) {
+      device_index = atoi(argv[1]);
+      argv += 2; argc -= 2;
+    }
+    else if (strcmp(*argv, "--socket") == 0 && argc > 1) {
+      socket_path = argv[1];
+      argv += 2; argc -= 2;
+    }
+    else
+      break;
+  }
+
+  if (argc != 0 || device_index < 0) {
+    fprintf(stderr, "usage: %s [--gpu] [--device <index>] [--socket <path>]\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  if (!socket_path)
+    socket_path = clqmcd_default_socket_path();
+
+  return call_with_opencl(0, device_type, device_index, &task, (void*) socket_path, CL_TRUE);
+}
@@ -0,0 +1,157 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Protocol and client library of the clqmcd integration daemon.
+ *
+ * The clqmcd daemon owns an OpenCL context and command queue for the
+ * lifetime of the process, and keeps the programs it has built and the
+ * lattice rules it has copied to the device resident between jobs, so that
+ * the latency of a job is essentially the duration of its kernel.
+ * Jobs are submitted over a Unix domain socket, one fixed-size job header
+ * followed by the kernel parameters, and answered with a fixed-size result
+ * header followed by one estimate per replication.  The daemon and its
+ * clients must run on the same host and use the same build of this header.
+ *
+ * A job runs a user kernel, read from a file relative to the CLQMC_ROOT of
+ * the daemon (absolute paths and `..` components are rejected), with the
+ * following signature:
+ *
+ *   __kernel void name(__global const clqmcLatticeRule* lattice,
+ *                      __global const clqmc_fptype* shifts,
+ *                      __global const clqmc_fptype* params,
+ *                      uint blocks,
+ *                      __global clqmc_fptype* out);
+ *
+ * with replications * blocks work items: work item i processes block
+ * i % blocks of the points of the lattice rule, randomized with shift
+ * i / blocks (of `dimension` coordinates each), and writes the sum of the
+ * integrand over its points to out[i].  The params buffer holds the job
+ * parameters, or a single zero if the job has none.  The daemon returns,
+ * for each replication, the sum of the blocks divided by the number of
+ * points.
+ * The kernel is compiled with clqmc_fptype set by the precision of the job
+ * and with the job options (e.g., -D definitions).
+ */
+
+#ifndef CLQMCD_H
+#define CLQMCD_H
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#define CLQMCD_MAGIC    0x444d5143u
+#define CLQMCD_VERSION  1
+
+/*! @brief Commands understood by the daemon.
+ */
+typedef enum clqmcdCommand_ {
+  CLQMCD_RUN = 0,       /*!< Run a job. */
+  CLQMCD_PING,          /*!< Reply with an empty result. */
+  CLQMCD_SHUTDOWN       /*!< Reply with an empty result and exit. */
+} clqmcdCommand;
+
+/*! @brief Job header, followed on the socket by `numParams` doubles.
+ */
+typedef struct clqmcdJob_ {
+  cl_uint  magic;               /*!< CLQMCD_MAGIC. */
+  cl_uint  version;             /*!< CLQMCD_VERSION. */
+  cl_uint  command;             /*!< A clqmcdCommand value. */
+  cl_uint  singlePrecision;     /*!< Nonzero to run in single precision. */
+  cl_uint  log2Points;          /*!< Lattice rule from the catalogue... */
+  cl_uint  dimension;           /*!< ...of this dimension... */
+  cl_uint  family;              /*!< ...and of this clqmcLatticeRuleFamily. */
+  cl_uint  replications;        /*!< Number of random shifts. */
+  cl_uint  firstReplication;    /*!< Index of the first shift. */
+  cl_uint  blocks;              /*!< Work items per shift, or 0 for automatic. */
+  cl_ulong seed;                /*!< Seed of the random shifts. */
+  cl_uint  numParams;           /*!< Number of kernel parameters. */
+  char     kernelFile[256];     /*!< Source file, relative to CLQMC_ROOT. */
+  char     kernelName[64];      /*!< Kernel function name. */
+  char     options[256];        /*!< Extra build options. */
+} clqmcdJob;
+
+/*! @brief Flags of clqmcdResult.cached.
+ */
+#define CLQMCD_CACHED_PROGRAM   0x01
+#define CLQMCD_CACHED_LATTICE   0x02
+
+/*! @brief Result header, followed on the socket by `replications` doubles
+ *  if `status` is CLQMC_SUCCESS.
+ */
+typedef struct clqmcdResult_ {
+  cl_int   status;              /*!< clqmcStatus or OpenCL error code. */
+  cl_uint  replications;        /*!< Number of estimates that follow. */
+  cl_uint  blocks;              /*!< Work items per shift actually used. */
+  cl_uint  cached;              /*!< CLQMCD_CACHED_* flags. */
+  cl_ulong kernelTime;          /*!< Kernel duration, in nanoseconds. */
+  cl_ulong jobTime;             /*!< Time spent by the daemon on the job, in nanoseconds. */
+  char     message[256];        /*!< Error message, or empty. */
+} clqmcdResult;
+
+/*! @brief Return the default path of the socket.
+ *
+ *  The value of the environment variable CLQMCD_SOCKET if it is set, or
+ *  `clqmcd-<uid>.sock` in the directory named by XDG_RUNTIME_DIR or in
+ *  `/tmp`.
+ *  A pointer to a static memory location is returned.
+ */
+const char* clqmcd_default_socket_path(void);
+
+/*! @brief Initialize a job with default values.
+ *
+ *  Double precision, CLQMC_LATTICE_CBC_POLY family, 10 shifts from seed 1,
+ *  automatic number of blocks, no parameters and no build options.
+ */
+void clqmcd_job_init(clqmcdJob* job, const char* kernelFile, const char* kernelName,
+    cl_uint log2Points, cl_uint dimension);
+
+/*! @brief Connect to the daemon.
+ *
+ *  @param[in] path     Socket path, or NULL for the default path.
+ *  @return Socket descriptor, or -1 on error (with errno set).
+ */
+int clqmcd_connect(const char* path);
+
+/*! @brief Close a connection to the daemon.
+ */
+void clqmcd_disconnect(int fd);
+
+/*! @brief Submit a job and wait for its result.
+ *
+ *  Multiple jobs can be submitted in sequence over the same connection.
+ *
+ *  @param[in]  fd          Socket descriptor returned by clqmcd_connect().
+ *  @param[in]  job         Job header; the magic and version are filled in.
+ *  @param[in]  params      The `job->numParams` kernel parameters.
+ *  @param[out] result      Result header.
+ *  @param[out] estimates   Array of at least `job->replications` estimates,
+ *                          or NULL to discard them.
+ *  @return 0 if the result was received (check `result->status`), or -1 on a
+ *  communication error.
+ */
+int clqmcd_submit(int fd, const clqmcdJob* job, const double* params, clqmcdResult* result, double* estimates);
+
+#endif
@@ -0,0 +1,167 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Client library of the clqmcd integration daemon; see clqmcd.h. */
+
+#include "clqmcd.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <clQMC/latticerule.h>
+
+// the daemon and this library handle broken connections as errors
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static char socket_path[sizeof(((struct sockaddr_un*) 0)->sun_path)];
+
+const char* clqmcd_default_socket_path(void)
+{
+  const char* path = getenv("CLQMCD_SOCKET");
+  if (path && *path) {
+    snprintf(socket_path, sizeof(socket_path), "%s", path);
+    return socket_path;
+  }
+  const char* dir = getenv("XDG_RUNTIME_DIR");
+  snprintf(socket_path, sizeof(socket_path), "%s/clqmcd-%u.sock", dir && *dir ? dir : "/tmp", (unsigned) getuid());
+  return socket_path;
+}
+
+void clqmcd_job_init(clqmcdJob* job, const char* kernelFile, const char* kernelName,
+    cl_uint log2Points, cl_uint dimension)
+{
+  memset(job, 0, sizeof(*job));
+  job->magic        = CLQMCD_MAGIC;
+  job->version      = CLQMCD_VERSION;
+  job->command      = CLQMCD_RUN;
+  job->log2Points   = log2Points;
+  job->dimension    = dimension;
+  job->family       = CLQMC_LATTICE_CBC_POLY;
+  job->replications = 10;
+  job->seed         = 1;
+  if (kernelFile)
+    snprintf(job->kernelFile, sizeof(job->kernelFile), "%s", kernelFile);
+  if (kernelName)
+    snprintf(job->kernelName, sizeof(job->kernelName), "%s", kernelName);
+}
+
+int clqmcd_connect(const char* path)
+{
+  struct sockaddr_un addr;
+  if (!path)
+    path = clqmcd_default_socket_path();
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return -1;
+  }
+  return fd;
+}
+
+void clqmcd_disconnect(int fd)
+{
+  if (fd >= 0)
+    close(fd);
+}
+
+// Write or read exactly `size` bytes, retrying after interruptions.
+static int write_all(int fd, const void* buf, size_t size)
+{
+  const char* p = (const char*) buf;
+  while (size > 0) {
+    ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    p += n;
+    size -= (size_t) n;
+  }
+  return 0;
+}
+
+static int read_all(int fd, void* buf, size_t size)
+{
+  char* p = (char*) buf;
+  while (size > 0) {
+    ssize_t n = recv(fd, p, size, 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return -1;
+    p += n;
+    size -= (size_t) n;
+  }
+  return 0;
+}
+
+int clqmcd_submit(int fd, const clqmcdJob* job, const double* params, clqmcdResult* result, double* estimates)
+{
+  clqmcdJob header = *job;
+  header.magic   = CLQMCD_MAGIC;
+  header.version = CLQMCD_VERSION;
+  if (header.command != CLQMCD_RUN)
+    header.numParams = 0;
+
+  if (write_all(fd, &header, sizeof(header)) < 0)
+    return -1;
+  if (header.numParams > 0 && write_all(fd, params, header.numParams * sizeof(double)) < 0)
+    return -1;
+
+  if (read_all(fd, result, sizeof(*result)) < 0)
+    return -1;
+  result->message[sizeof(result->message) - 1] = '\0';
+  if (result->status != CLQMC_SUCCESS || result->replications == 0)
+    return 0;
+
+  // the daemon returns one estimate per replication of the job
+  if (result->replications != header.replications)
+    return -1;
+  if (estimates)
+    return read_all(fd, estimates, result->replications * sizeof(double));
+  for (cl_uint r = 0; r < result->replications; r++) {
+    double value;
+    if (read_all(fd, &value, sizeof(value)) < 0)
+      return -1;
+  }
+  return 0;
+}
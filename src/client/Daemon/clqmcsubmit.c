@@ -0,0 +1,168 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Command-line client of the clqmcd integration daemon.
+ *
+ * Submits a job (see clqmcd.h) one or more times over the same connection,
+ * and prints the mean and standard error of the estimates along with the kernel
+ * time and the round-trip time of each submission, or pings or shuts down
+ * the daemon.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "clqmcd.h"
+
+#include <clQMC/latticerule.h>
+
+static double now_ms(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
+
+static void usage(const char* prog)
+{
+  fprintf(stderr,
+      "usage: %s [options] <kernel-file> <kernel-name> <log2-points> <dimension> [<param> ...]\n"
+      "       %s [--socket <path>] --ping | --shutdown\n"
+      "options:\n"
+      "  --socket <path>         socket of the daemon\n"
+      "  --single                run in single precision\n"
+      "  --replications <r>      number of random shifts (default: 10)\n"
+      "  --seed <s>              seed of the random shifts (default: 1)\n"
+      "  --blocks <b>            work items per shift (default: automatic)\n"
+      "  --options <string>      extra build options\n"
+      "  --repeat <k>            submit the job k times (default: 1)\n",
+      prog, prog);
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+  const char* socket_path = NULL;
+  cl_uint command = CLQMCD_RUN;
+  clqmcdJob job;
+  unsigned repeat = 1;
+
+  clqmcd_job_init(&job, NULL, NULL, 0, 0);
+
+  while (argc && (*argv)[0] == '-') {
+    if (strcmp(*argv, "--ping") == 0)
+      command = CLQMCD_PING;
+    else if (strcmp(*argv, "--shutdown") == 0)
+      command = CLQMCD_SHUTDOWN;
+    else if (strcmp(*argv, "--single") == 0)
+      job.singlePrecision = 1;
+    else if (argc > 1 && strcmp(*argv, "--socket") == 0)
+      socket_path = *++argv, argc--;
+    else if (argc > 1 && strcmp(*argv, "--replications") == 0)
+      job.replications = (cl_uint) atoi(*++argv), argc--;
+    else if (argc > 1 && strcmp(*argv, "--seed") == 0)
+      job.seed = (cl_ulong) strtoull(*++argv, NULL, 10), argc--;
+    else if (argc > 1 && strcmp(*argv, "--blocks") == 0)
+      job.blocks = (cl_uint) atoi(*++argv), argc--;
+    else if (argc > 1 && strcmp(*argv, "--options") == 0)
+      snprintf(job.options, sizeof(job.options), "%s", *++argv), argc--;
+    else if (argc > 1 && strcmp(*argv, "--repeat") == 0)
+      repeat = (unsigned) atoi(*++argv), argc--;
+    else {
+      usage(prog);
+      return EXIT_FAILURE;
+    }
+    argv++; argc--;
+  }
+
+  if (command == CLQMCD_RUN && (argc < 4 || job.replications < 1 || repeat < 1)) {
+    usage(prog);
+    return EXIT_FAILURE;
+  }
+
+  job.command = command;
+  double* params = NULL;
+  if (command == CLQMCD_RUN) {
+    snprintf(job.kernelFile, sizeof(job.kernelFile), "%s", argv[0]);
+    snprintf(job.kernelName, sizeof(job.kernelName), "%s", argv[1]);
+    job.log2Points = (cl_uint) atoi(argv[2]);
+    job.dimension  = (cl_uint) atoi(argv[3]);
+    job.numParams  = (cl_uint) (argc - 4);
+    params = (double*) malloc((job.numParams ? job.numParams : 1) * sizeof(double));
+    for (cl_uint i = 0; i < job.numParams; i++)
+      params[i] = atof(argv[4 + i]);
+  }
+
+  int fd = clqmcd_connect(socket_path);
+  if (fd < 0) {
+    fprintf(stderr, "%s: cannot connect to %s: ", prog, socket_path ? socket_path : clqmcd_default_socket_path());
+    perror(NULL);
+    return EXIT_FAILURE;
+  }
+
+  double* estimates = (double*) malloc(job.replications * sizeof(double));
+  int ret = EXIT_SUCCESS;
+
+  if (command == CLQMCD_RUN)
+    printf("%10s%16s%16s%12s%12s%12s\n", "job", "mean", "std. error", "kernel ms", "job ms", "total ms");
+
+  for (unsigned k = 0; k < repeat; k++) {
+    clqmcdResult result;
+    double start = now_ms();
+    if (clqmcd_submit(fd, &job, params, &result, estimates) < 0) {
+      fprintf(stderr, "%s: connection to the daemon lost\n", prog);
+      ret = EXIT_FAILURE;
+      break;
+    }
+    double total = now_ms() - start;
+    if (result.status != CLQMC_SUCCESS) {
+      fprintf(stderr, "%s: job failed (%d): %s\n", prog, result.status, result.message);
+      ret = EXIT_FAILURE;
+      break;
+    }
+    if (command != CLQMCD_RUN) {
+      printf("%s: ok (%.3f ms)\n", command == CLQMCD_PING ? "ping" : "shutdown", total);
+      break;
+    }
+
+    double mean = 0.0, variance = 0.0;
+    for (cl_uint r = 0; r < job.replications; r++)
+      mean += estimates[r] / job.replications;
+    for (cl_uint r = 0; r < job.replications; r++)
+      variance += (estimates[r] - mean) * (estimates[r] - mean);
+    double std_error = job.replications > 1 ? sqrt(variance / (job.replications - 1) / job.replications) : NAN;
+
+    printf("%10u%16.8g%16.4g%12.3f%12.3f%12.3f%s%s\n", k, mean, std_error,
+        result.kernelTime * 1e-6, result.jobTime * 1e-6, total,
+        result.cached & CLQMCD_CACHED_PROGRAM ? "" : "  (built)",
+        result.cached & CLQMCD_CACHED_LATTICE ? "" : "  (new lattice)");
+  }
+
+  clqmcd_disconnect(fd);
+  free(estimates);
+  free(params);
+  return ret;
+}
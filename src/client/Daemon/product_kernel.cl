@@ -0,0 +1,62 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include <clQMC/latticerule.clh>
+
+// Example job for the clqmcd daemon (see clqmcd.h): integrates
+//   f(u) = prod_j (1 + c (3 u_j^2 - 1)),
+// whose exact integral is 1, with c = params[0].
+__kernel void product(
+        __global const clqmcLatticeRule* lattice,
+        __global const clqmc_fptype* shifts,
+        __global const clqmc_fptype* params,
+        uint blocks,
+        __global clqmc_fptype* out)
+{
+  uint gid   = get_global_id(0);
+  uint block = gid % blocks;
+  uint rep   = gid / blocks;
+  uint d     = clqmcLatticeRuleDimension(lattice);
+
+  clqmcLatticeRuleStream stream;
+  clqmcLatticeRuleCreateOverStream(&stream, lattice, blocks, block, shifts + rep * d);
+
+  clqmc_fptype c = params[0];
+  clqmc_fptype sum = 0;
+  uint pointsPerBlock = clqmcLatticeRuleNumPoints(lattice) / blocks;
+  for (uint i = 0; i < pointsPerBlock; i++) {
+    clqmc_fptype f = 1;
+    for (uint j = 0; j < d; j++) {
+      clqmc_fptype u = clqmcLatticeRuleNextCoordinate(&stream);
+      f *= 1 + c * (3 * u * u - 1);
+    }
+    sum += f;
+    clqmcLatticeRuleForwardToNextPoint(&stream);
+  }
+
+  out[gid] = sum;
+}
+
+/*
+vim: ft=c
+*/
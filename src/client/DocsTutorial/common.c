@@ -24,9 +24,14 @@
 #include "./common.h"
 #include "../common.h"
 
+#include <clQMC/autotune.h>
+
 #include <stdio.h>
 #include <string.h>
 
+// largest output buffer of the calibration launches
+#define MAX_AUTOTUNE_OUTPUT_SIZE (64 << 20)
+
 // see common.h for a description of this generating vector
 cl_int gen_vec[DIMENSION] = {
   1, 201367, 117137, 36487, 165651, 490691, 77109, 210171, 410853, 356813, 371285, 54177, 312383, 487121, 29017, 392635, 45723, 454749, 64693, 130185, 288231, 141321, 197541, 499599, 131691, 385041, 42593, 238365, 279943, 134157
@@ -39,17 +44,23 @@ int tut_main(int argc, char** argv, TutorialOptions opts)
 {
   const char* prog = *argv++; argc--;
   cl_device_type device_type = CL_DEVICE_TYPE_CPU;
+  cl_bool autotune = CL_FALSE;
 
   while (argc && (*argv)[0] == '-') {
-    if (strcmp(*argv, "--gpu") == 0) {
+    if (strcmp(*argv, "--gpu") == 0)
       device_type = CL_DEVICE_TYPE_GPU;
-      argv++; argc--;
-    }
+    else if ((opts & TUT_AUTOTUNE) && strcmp(*argv, "--autotune") == 0)
+      autotune = CL_TRUE;
+    else
+      break;
+    argv++; argc--;
   }
 
-  int nargs = 2
-    + (opts & TUT_REPLICATIONS        ? 1 : 0)
-    + (opts & TUT_REPLICATIONS_PER_WI ? 1 : 0);
+  // the launch configuration is not given with --autotune
+  int nargs = (autotune ? 1 : 2)
+    + (opts & TUT_REPLICATIONS                      ? 1 : 0)
+    + (opts & TUT_REPLICATIONS_PER_WI && !autotune  ? 1 : 0)
+    + (opts & TUT_OUTPUTS                           ? 1 : 0);
 
   if (argc != nargs) {
     fprintf(stderr, "usage: %s [--gpu] <log2-points> <log2-points-per-work-item>", prog);
@@ -57,22 +68,138 @@ int tut_main(int argc, char** argv, TutorialOptions opts)
         fprintf(stderr, " <replications>");
     if (opts & TUT_REPLICATIONS_PER_WI)
         fprintf(stderr, " <replications-per-work-item>");
+    if (opts & TUT_OUTPUTS)
+        fprintf(stderr, " <outputs>");
     fprintf(stderr, "\n");
+    if (opts & TUT_AUTOTUNE) {
+      fprintf(stderr, "       %s [--gpu] --autotune <log2-points>", prog);
+      if (opts & TUT_REPLICATIONS)
+        fprintf(stderr, " <replications>");
+      if (opts & TUT_OUTPUTS)
+        fprintf(stderr, " <outputs>");
+      fprintf(stderr, "\n");
+    }
     exit(EXIT_FAILURE);
   }
 
-  TaskData data = { 0, 0, 0, 0 };
+  TaskData data = { 0, 1, 0, 1, 1, 0, autotune };
   int iarg = 0;
   data.points = 1 << atoi(argv[iarg++]);
-  data.points_per_work_item = 1 << atoi(argv[iarg++]);
+  if (!autotune)
+    data.points_per_work_item = 1 << atoi(argv[iarg++]);
   if (opts & TUT_REPLICATIONS)
     data.replications = atoi(argv[iarg++]);
-  if (opts & TUT_REPLICATIONS_PER_WI)
+  if ((opts & TUT_REPLICATIONS_PER_WI) && !autotune)
     data.replications_per_work_item = atoi(argv[iarg++]);
+  if (opts & TUT_OUTPUTS)
+    data.outputs = atoi(argv[iarg++]);
 
   return call_with_opencl(0, device_type, 0, &task, &data, CL_TRUE);
 }
 
+typedef struct AutotuneData_ {
+  cl_command_queue queue;
+  cl_kernel kernel;
+  cl_uint points;
+  cl_uint replications;
+} AutotuneData;
+
+static clqmcStatus autotune_launch(void* user_data, const clqmcLaunchConfig* config, cl_event* event)
+{
+  const AutotuneData* data = (const AutotuneData*) user_data;
+  size_t global_size = clqmcLaunchConfigGlobalSize(config, data->points, data->replications);
+  cl_int err = clSetKernelArg(data->kernel, 2, sizeof(config->pointsPerWorkItem), &config->pointsPerWorkItem);
+  if (err == CL_SUCCESS)
+    err = clEnqueueNDRangeKernel(data->queue, data->kernel, 1, NULL, &global_size,
+        config->localSize ? &config->localSize : NULL, 0, NULL, event);
+  return (clqmcStatus) err;
+}
+
+void tut_autotune(cl_context context, cl_device_id device, cl_command_queue queue, cl_kernel kernel, cl_ulong source_hash,
+    cl_mem pointset_buf, cl_mem shifts_buf, const char* name, cl_bool replications_per_wi, TaskData* data)
+{
+  cl_int err;
+
+  // candidate points per work item, such that the output fits in the temporary buffer
+  cl_uint points_per_wi[9];
+  cl_uint num_points_per_wi = 0;
+  for (cl_uint p = 1; p <= 256 && data->points % p == 0; p *= 2) {
+    if ((size_t) data->replications * (data->points / p) * sizeof(clqmc_fptype) <= MAX_AUTOTUNE_OUTPUT_SIZE)
+      points_per_wi[num_points_per_wi++] = p;
+  }
+  if (num_points_per_wi == 0)
+    check_error(CLQMC_INVALID_VALUE, "too many points and replications to autotune");
+
+  // candidate work-group sizes, up to the limit of the kernel on the device
+  size_t max_local_size = get_max_workgroup_size(device);
+  size_t kernel_local_size;
+  err = clGetKernelWorkGroupInfo(kernel, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(kernel_local_size), &kernel_local_size, NULL);
+  check_error(err, "cannot query kernel work-group size");
+  if (kernel_local_size < max_local_size)
+    max_local_size = kernel_local_size;
+  size_t local_sizes[8] = { 0 };
+  cl_uint num_local_sizes = 1;
+  for (size_t l = 16; l <= max_local_size && l <= 1024; l *= 2)
+    local_sizes[num_local_sizes++] = l;
+
+  cl_mem output_buf = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_HOST_NO_ACCESS,
+      (size_t) data->replications * (data->points / points_per_wi[0]) * sizeof(clqmc_fptype), NULL, &err);
+  check_error(err, "cannot create output buffer");
+
+  err  = clSetKernelArg(kernel, 0, sizeof(pointset_buf), &pointset_buf);
+  err |= clSetKernelArg(kernel, 1, sizeof(shifts_buf), &shifts_buf);
+  err |= clSetKernelArg(kernel, 3, sizeof(data->replications), &data->replications);
+  err |= clSetKernelArg(kernel, 4, sizeof(output_buf), &output_buf);
+  check_error(err, "cannot set kernel arguments");
+
+  // the configurations are specific to the kernel and to the precision
+  char key[64];
+  snprintf(key, sizeof(key), "DocsTutorial/%s:%s", name, sizeof(clqmc_fptype) == sizeof(cl_float) ? "float" : "double");
+  AutotuneData tune_data = { queue, kernel, data->points, data->replications };
+  clqmcAutotuner* tuner = clqmcAutotunerCreate(device, key, source_hash, data->points, data->replications,
+      &autotune_launch, &tune_data, (clqmcStatus*) &err);
+  check_error(err, NULL);
+  err = clqmcAutotunerSetCandidates(tuner, num_points_per_wi, points_per_wi,
+      replications_per_wi ? 0 : 1, replications_per_wi ? NULL : &data->replications,
+      num_local_sizes, local_sizes);
+  check_error(err, NULL);
+
+  // the random shifts must be ready
+  err = clFinish(queue);
+  check_error(err, "cannot finish command queue");
+
+  clqmcLaunchConfig best;
+  cl_bool cached;
+  profile_begin("autotuning");
+  err = clqmcAutotunerRun(tuner, CL_FALSE, &best, &cached);
+  profile_end();
+  check_error(err, NULL);
+
+  const char* cache_file = clqmcAutotunerGetCacheFile(tuner);
+  if (cached)
+    printf("\nLaunch configuration read from %s\n", cache_file);
+  else {
+    printf("\nAutotuning:\n\n");
+    err = clqmcAutotunerWriteInfo(tuner, stdout);
+    check_error(err, NULL);
+    if (cache_file)
+      printf("saved to:         %s\n", cache_file);
+  }
+  printf("points per work item: %u, replications per work item: %u, work-group size: ",
+      best.pointsPerWorkItem, best.replicationsPerWorkItem);
+  if (best.localSize)
+    printf(SIZE_T_FORMAT "\n", best.localSize);
+  else
+    printf("auto\n");
+
+  data->points_per_work_item = best.pointsPerWorkItem;
+  data->replications_per_work_item = best.replicationsPerWorkItem;
+  data->local_size = best.localSize;
+
+  clqmcAutotunerDestroy(tuner);
+  clReleaseMemObject(output_buf);
+}
+
 void computeStats(size_t n, clqmc_fptype* values, clqmc_fptype* avg, clqmc_fptype* var)
 {
   double sum = 0.0;
@@ -97,10 +224,12 @@ void rqmcReduce(cl_uint replications, cl_uint blocks, clqmc_fptype* values, clqm
 
 void rqmcReport(cl_uint replications, cl_uint points, cl_uint blocks, clqmc_fptype* values)
 {
+  profile_begin("host reduction");
   clqmc_fptype* estimates = (clqmc_fptype*) malloc(replications * sizeof(clqmc_fptype));
   rqmcReduce(replications, blocks, values, estimates);
   clqmc_fptype avg, var;
   computeStats(replications, estimates, &avg, &var);
+  profile_end();
   free(estimates);
   printf("%16s%16s%16s%16s\n", "replications", "points", "mean", replications > 1 ? "variance" : "");
   printf("%16d%16d%16.6g", replications, points, avg);
@@ -110,3 +239,31 @@ void rqmcReport(cl_uint replications, cl_uint points, cl_uint blocks, clqmc_fpty
     printf("\n");
 }
 
+void rqmcReportVector(cl_uint replications, cl_uint points, cl_uint blocks, cl_uint outputs, clqmc_fptype* values)
+{
+  profile_begin("host reduction");
+  // the values of each output of each replication are contiguous
+  clqmc_fptype* estimates = (clqmc_fptype*) malloc(replications * outputs * sizeof(clqmc_fptype));
+  rqmcReduce(replications * outputs, blocks, values, estimates);
+  clqmc_fptype* column = (clqmc_fptype*) malloc(replications * sizeof(clqmc_fptype));
+  clqmc_fptype* avg = (clqmc_fptype*) malloc(outputs * sizeof(clqmc_fptype));
+  clqmc_fptype* var = (clqmc_fptype*) malloc(outputs * sizeof(clqmc_fptype));
+  for (cl_uint c = 0; c < outputs; c++) {
+    for (cl_uint k = 0; k < replications; k++)
+      column[k] = estimates[k * outputs + c];
+    computeStats(replications, column, &avg[c], &var[c]);
+  }
+  profile_end();
+  printf("%16s%16s%16s%16s%16s\n", "replications", "points", "output", "mean", replications > 1 ? "variance" : "");
+  for (cl_uint c = 0; c < outputs; c++) {
+    printf("%16d%16d%16d%16.6g", replications, points, c, avg[c]);
+    if (replications > 1)
+      printf("%16.6g\n", var[c]);
+    else
+      printf("\n");
+  }
+  free(estimates);
+  free(column);
+  free(avg);
+  free(var);
+}
@@ -39,6 +39,10 @@
  */
 #define DIMENSION 30
 
+/*! @brief Seed of the random shifts of the RQMC examples
+ */
+#define SHIFTS_SEED 1234
+
 /*! @brief Generating vector for embedded lattice rules.
  *
  *  This generating vector is good for numbers of points
@@ -54,16 +58,38 @@ typedef struct TaskData_ {
   cl_uint points_per_work_item;
   cl_uint replications;
   cl_uint replications_per_work_item;
+  cl_uint outputs;
+  size_t local_size;            // 0 for the choice of the OpenCL implementation
+  cl_bool autotune;
 } TaskData;
 
 typedef enum TutorialOptions_ {
   TUT_DEFAULT                   = 0x00,
   TUT_REPLICATIONS              = 0x01,
-  TUT_REPLICATIONS_PER_WI       = 0x02
+  TUT_REPLICATIONS_PER_WI       = 0x02,
+  TUT_OUTPUTS                   = 0x04,
+  TUT_AUTOTUNE                  = 0x08
 } TutorialOptions;
 
 int tut_main(int argc, char** argv, TutorialOptions opts);
 
+/*! @brief Select the launch configuration of a kernel by autotuning.
+ *
+ *  Time `kernel`, whose arguments are those of the kernels of examples 3
+ *  and 4, over candidate numbers of points per work item, numbers of
+ *  replications per work item (only if `replications_per_wi` is `CL_TRUE`;
+ *  otherwise, each work item loops over all replications) and work-group
+ *  sizes (see clQMC/autotune.h), and store the fastest configuration in
+ *  `data`.
+ *  The configuration is read from the cache file of the device if it was
+ *  selected by a previous run for the same program source, given by
+ *  `source_hash` (see build_program_from_file_with_hash()).
+ *  The kernel arguments are modified; the output is written to a temporary
+ *  buffer.
+ */
+void tut_autotune(cl_context context, cl_device_id device, cl_command_queue queue, cl_kernel kernel, cl_ulong source_hash,
+    cl_mem pointset_buf, cl_mem shifts_buf, const char* name, cl_bool replications_per_wi, TaskData* data);
+
 /*! @brief Compute the average and variance of a sample.
  */
 void computeStats(size_t n, clqmc_fptype* values, clqmc_fptype* avg, clqmc_fptype* var);
@@ -79,5 +105,15 @@ void rqmcReduce(cl_uint replications, cl_uint blocks, clqmc_fptype* values, clqm
  */
 void rqmcReport(cl_uint replications, cl_uint points, cl_uint blocks, clqmc_fptype* values);
 
+/*! @brief Print a report on RQMC experiments with vector outputs.
+ *
+ *  Same as rqmcReport(), but with `outputs` values per point.
+ *  The values of output `c` for replication `k` are the `blocks`
+ *  consecutive values that start at index `(k * outputs + c) * blocks` of
+ *  `values`, and the mean and variance of each output across the
+ *  replications are reported.
+ */
+void rqmcReportVector(cl_uint replications, cl_uint points, cl_uint blocks, cl_uint outputs, clqmc_fptype* values);
+
 
 #endif // CLQMC_DOCS_TUTORIAL_COMMON_H
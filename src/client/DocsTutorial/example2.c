@@ -84,18 +84,20 @@ int task(cl_context context, cl_device_id device, cl_command_queue queue, void*
 
   // Execution
 
-  cl_event ev;
+  cl_event ev, ev_read;
   size_t global_size = points_block_count;
   err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size, NULL, 0, NULL, &ev);
   check_error(err, "cannot enqueue kernel");
+  profile_event("kernel", ev);
 
   err = clWaitForEvents(1, &ev);
   check_error(err, "error waiting for events");
 
   clqmc_fptype* output = (clqmc_fptype*) malloc(points_block_count * sizeof(clqmc_fptype));
   err = clEnqueueReadBuffer(queue, output_buf, CL_TRUE, 0,
-      points_block_count * sizeof(clqmc_fptype), output, 0, NULL, NULL);
+      points_block_count * sizeof(clqmc_fptype), output, 0, NULL, &ev_read);
   check_error(err, "cannot read output buffer");
+  profile_event("read output", ev_read);
 
   printf("\nQuasi-Monte Carlo integration:\n\n");
 
@@ -109,6 +111,7 @@ int task(cl_context context, cl_device_id device, cl_command_queue queue, void*
   // Clean up
 
   clReleaseEvent(ev);
+  clReleaseEvent(ev_read);
   clReleaseMemObject(output_buf);
   clReleaseMemObject(pointset_buf);
   clReleaseKernel(kernel);
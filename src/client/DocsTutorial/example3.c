@@ -31,16 +31,16 @@
 #include "./common.h"
 
 #include <clQMC/latticerule.h>
-#include <clRNG/mrg31k3p.h>
+#include <clQMC/randomshift.h>
 
 int main(int argc, char** argv)
 {
-  return tut_main(argc, argv, TUT_REPLICATIONS);
+  return tut_main(argc, argv, TUT_REPLICATIONS | TUT_AUTOTUNE);
 }
 
 int task(cl_context context, cl_device_id device, cl_command_queue queue, void* data_)
 {
-  const TaskData* data = (const TaskData*) data_;
+  TaskData* data = (TaskData*) data_;
   cl_int err;
 
   if (data->points % data->points_per_work_item)
@@ -60,21 +60,36 @@ int task(cl_context context, cl_device_id device, cl_command_queue queue, void*
 
 
   // Shifts buffer
-  
-  clqmc_fptype* shifts = (clqmc_fptype*) malloc(data->replications * DIMENSION * sizeof(clqmc_fptype));
 
-  // populate random shifts using a random stream
-  clrngMrg31k3pStream* stream = clrngMrg31k3pCreateStreams(NULL, 1, NULL, &err);
+  cl_mem shifts_buf = clCreateBuffer(context, CL_MEM_READ_WRITE | CL_MEM_HOST_NO_ACCESS,
+      data->replications * DIMENSION * sizeof(clqmc_fptype), NULL, &err);
+  check_error(err, "cannot create shifts buffer");
+
+  // populate random shifts directly on the device
+  clqmcRandomShiftGenerator* generator = clqmcRandomShiftGeneratorCreate(context, device, &err);
   check_error(err, NULL);
-  for (cl_uint i = 0; i < data->replications; i++)
-      for (cl_uint j = 0; j < DIMENSION; j++)
-          shifts[i * DIMENSION + j] = clrngMrg31k3pRandomU01(stream);
-  err = clrngMrg31k3pDestroyStreams(stream);
+  cl_event ev_shifts;
+  err = clqmcRandomShiftGeneratorEnqueue(generator, queue, SHIFTS_SEED, 0, data->replications, DIMENSION, shifts_buf,
+      0, NULL, &ev_shifts);
   check_error(err, NULL);
+  profile_event("random shifts", ev_shifts);
 
-  cl_mem shifts_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
-      data->replications * DIMENSION * sizeof(clqmc_fptype), shifts, &err);
-  check_error(err, "cannot create shifts buffer");
+
+  // OpenCL kernel
+
+  cl_ulong source_hash;
+  cl_program program = build_program_from_file_with_hash(context, device,
+      "client/DocsTutorial/example3_kernel.cl",
+      NULL, &source_hash);
+  check_error(err, NULL);
+  cl_kernel kernel = clCreateKernel(program, "simulateWithRQMC", &err);
+  check_error(err, "cannot create kernel");
+
+
+  // Launch configuration
+
+  if (data->autotune)
+    tut_autotune(context, device, queue, kernel, source_hash, pointset_buf, shifts_buf, "example3", CL_FALSE, data);
 
 
   // Output buffer
@@ -85,14 +100,7 @@ int task(cl_context context, cl_device_id device, cl_command_queue queue, void*
   check_error(err, "cannot create output buffer");
 
 
-  // OpenCL kernel
-
-  cl_program program = build_program_from_file(context, device,
-      "client/DocsTutorial/example3_kernel.cl",
-      NULL);
-  check_error(err, NULL);
-  cl_kernel kernel = clCreateKernel(program, "simulateWithRQMC", &err);
-  check_error(err, "cannot create kernel");
+  // Kernel arguments
 
   int iarg = 0;
   err  = clSetKernelArg(kernel, iarg++, sizeof(pointset_buf), &pointset_buf);
@@ -105,18 +113,21 @@ int task(cl_context context, cl_device_id device, cl_command_queue queue, void*
 
   // Execution
 
-  cl_event ev;
+  cl_event ev, ev_read;
   size_t global_size = points_block_count;
-  err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size, NULL, 0, NULL, &ev);
+  err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &global_size,
+      data->local_size ? &data->local_size : NULL, 1, &ev_shifts, &ev);
   check_error(err, "cannot enqueue kernel");
+  profile_event("kernel", ev);
 
   err = clWaitForEvents(1, &ev);
   check_error(err, "error waiting for events");
 
   clqmc_fptype* output = (clqmc_fptype*) malloc(data->replications * points_block_count * sizeof(clqmc_fptype));
   err = clEnqueueReadBuffer(queue, output_buf, CL_TRUE, 0,
-      data->replications * points_block_count * sizeof(clqmc_fptype), output, 0, NULL, NULL);
+      data->replications * points_block_count * sizeof(clqmc_fptype), output, 0, NULL, &ev_read);
   check_error(err, "cannot read output buffer");
+  profile_event("read output", ev_read);
 
   printf("\nRandomized quasi-Monte Carlo integration:\n\n");
 
@@ -129,11 +140,15 @@ int task(cl_context context, cl_device_id device, cl_command_queue queue, void*
 
   // Clean up
 
+  clReleaseEvent(ev_shifts);
   clReleaseEvent(ev);
+  clReleaseEvent(ev_read);
   clReleaseMemObject(output_buf);
+  clReleaseMemObject(shifts_buf);
   clReleaseMemObject(pointset_buf);
   clReleaseKernel(kernel);
   clReleaseProgram(program);
+  clqmcRandomShiftGeneratorDestroy(generator);
 
   free(output);
   err = clqmcLatticeRuleDestroy(pointset);
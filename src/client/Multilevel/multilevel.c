@@ -0,0 +1,223 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+/* Multilevel RQMC for a European call option.
+ *
+ * Estimates the price of a European call option under a geometric Brownian
+ * motion, discretized with the Euler scheme with 2^(l+1) time steps at level
+ * l, with the multilevel driver of clQMC/multilevel.h.  Each level is
+ * evaluated by a kernel that simulates the fine and coarse paths of every
+ * point from the same Brownian increments; the driver measures the duration
+ * of that kernel to allocate the points among the levels.
+ *
+ * The exact Black-Scholes price is printed for comparison.
+ */
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common.h"
+
+#include <clQMC/multilevel.h>
+
+// the catalogue rules have at most 128 dimensions, i.e., 128 time steps
+#define MAX_LEVELS 7
+
+// at most this many work items per shift
+#define MAX_BLOCKS 1024
+
+typedef struct TaskData_ {
+  double epsilon;
+  cl_uint replications;
+  clqmc_fptype s0;
+  clqmc_fptype strike;
+  clqmc_fptype rate;
+  clqmc_fptype sigma;
+  clqmc_fptype maturity;
+} TaskData;
+
+typedef struct SamplerData_ {
+  const TaskData* task;
+  cl_context context;
+  cl_command_queue queue;
+  cl_kernel kernel;
+} SamplerData;
+
+static clqmcStatus sample_level(void* data_, cl_uint level, const clqmcLatticeRule* lattice, size_t lattice_size,
+    cl_uint replications, const void* shifts, double* estimates, cl_event* event)
+{
+  const SamplerData* data = (const SamplerData*) data_;
+  const TaskData* task = data->task;
+  cl_kernel kernel = data->kernel;
+  cl_int err;
+
+  cl_uint points = clqmcLatticeRuleNumPoints(lattice);
+  cl_uint steps  = clqmcLatticeRuleDimension(lattice);
+  cl_uint blocks = points < MAX_BLOCKS ? points : MAX_BLOCKS;
+  cl_uint coarse = level > 0;
+  size_t global_size = (size_t) replications * blocks;
+
+  cl_mem lattice_buf = clCreateBuffer(data->context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      lattice_size, (void*) lattice, &err);
+  check_error(err, "cannot create lattice buffer");
+  cl_mem shifts_buf = clCreateBuffer(data->context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      replications * steps * sizeof(clqmc_fptype), (void*) shifts, &err);
+  check_error(err, "cannot create shifts buffer");
+  cl_mem out_buf = clCreateBuffer(data->context, CL_MEM_WRITE_ONLY | CL_MEM_HOST_READ_ONLY,
+      global_size * sizeof(clqmc_fptype), NULL, &err);
+  check_error(err, "cannot create output buffer");
+
+  err  = clSetKernelArg(kernel,  0, sizeof(lattice_buf),    &lattice_buf);
+  err |= clSetKernelArg(kernel,  1, sizeof(shifts_buf),     &shifts_buf);
+  err |= clSetKernelArg(kernel,  2, sizeof(blocks),         &blocks);
+  err |= clSetKernelArg(kernel,  3, sizeof(steps),          &steps);
+  err |= clSetKernelArg(kernel,  4, sizeof(coarse),         &coarse);
+  err |= clSetKernelArg(kernel,  5, sizeof(task->s0),       &task->s0);
+  err |= clSetKernelArg(kernel,  6, sizeof(task->strike),   &task->strike);
+  err |= clSetKernelArg(kernel,  7, sizeof(task->rate),     &task->rate);
+  err |= clSetKernelArg(kernel,  8, sizeof(task->sigma),    &task->sigma);
+  err |= clSetKernelArg(kernel,  9, sizeof(task->maturity), &task->maturity);
+  err |= clSetKernelArg(kernel, 10, sizeof(out_buf),        &out_buf);
+  check_error(err, "cannot set kernel arguments");
+
+  // the driver measures the cost of the level with this event
+  err = clEnqueueNDRangeKernel(data->queue, kernel, 1, NULL, &global_size, NULL, 0, NULL, event);
+  check_error(err, "cannot enqueue kernel");
+
+  clqmc_fptype* out = (clqmc_fptype*) malloc(global_size * sizeof(clqmc_fptype));
+  err = clEnqueueReadBuffer(data->queue, out_buf, CL_TRUE, 0, global_size * sizeof(clqmc_fptype), out, 0, NULL, NULL);
+  check_error(err, "cannot read output buffer");
+
+  for (cl_uint r = 0; r < replications; r++) {
+    double sum = 0.0;
+    for (cl_uint b = 0; b < blocks; b++)
+      sum += out[r * blocks + b];
+    estimates[r] = sum / points;
+  }
+
+  free(out);
+  clReleaseMemObject(lattice_buf);
+  clReleaseMemObject(shifts_buf);
+  clReleaseMemObject(out_buf);
+
+  return CLQMC_SUCCESS;
+}
+
+static double black_scholes_call(const TaskData* data)
+{
+  double s0 = data->s0, k = data->strike, r = data->rate, sigma = data->sigma, t = data->maturity;
+  double d1 = (log(s0 / k) + (r + 0.5 * sigma * sigma) * t) / (sigma * sqrt(t));
+  double d2 = d1 - sigma * sqrt(t);
+  return s0 * 0.5 * erfc(-d1 / sqrt(2.0)) - k * exp(-r * t) * 0.5 * erfc(-d2 / sqrt(2.0));
+}
+
+int task(cl_context context, cl_device_id device, cl_command_queue queue, void* data_)
+{
+  const TaskData* data = (const TaskData*) data_;
+  cl_int err;
+
+  cl_program program = build_program_from_file(context, device, "client/Multilevel/multilevel_kernel.cl", NULL);
+
+  SamplerData sampler_data;
+  sampler_data.task = data;
+  sampler_data.context = context;
+  sampler_data.queue = queue;
+  sampler_data.kernel = clCreateKernel(program, "sampleLevel", &err);
+  check_error(err, "cannot create kernel");
+
+  // level l simulates 2^(l+1) time steps
+  cl_uint dimensions[MAX_LEVELS];
+  for (cl_uint l = 0; l < MAX_LEVELS; l++)
+    dimensions[l] = (cl_uint) 2 << l;
+
+  clqmcMultilevel* ml = clqmcMultilevelCreate(MAX_LEVELS, dimensions, CLQMC_LATTICE_CBC_POLY, data->replications,
+      12345, &sample_level, &sampler_data, (clqmcStatus*) &err);
+  check_error(err, NULL);
+  err = clqmcMultilevelSetProfiler(ml, get_profiler());
+  check_error(err, NULL);
+
+  double estimate, variance;
+  cl_bool converged;
+  err = clqmcMultilevelRun(ml, data->epsilon, &estimate, &variance, &converged);
+  check_error(err, NULL);
+
+  printf("\nMultilevel RQMC for a European call option (S0 = %g, K = %g, r = %g, sigma = %g, T = %g)\n\n",
+      (double) data->s0, (double) data->strike, (double) data->rate, (double) data->sigma, (double) data->maturity);
+  err = clqmcMultilevelWriteInfo(ml, stdout);
+  check_error(err, NULL);
+  printf("\n%16s%16s%16s%16s\n", "epsilon", "estimate", "std. error", "exact");
+  printf("%16.6g%16.6g%16.6g%16.6g\n", data->epsilon, estimate, sqrt(variance), black_scholes_call(data));
+  if (!converged)
+    printf("\nwarning: the target error was not reached within the maximum number of levels and points\n");
+
+  clqmcMultilevelDestroy(ml);
+  clReleaseKernel(sampler_data.kernel);
+  clReleaseProgram(program);
+
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+  cl_device_type device_type = CL_DEVICE_TYPE_CPU;
+
+  while (argc && (*argv)[0] == '-') {
+    if (strcmp(*argv, "--gpu") == 0) {
+      device_type = CL_DEVICE_TYPE_GPU;
+      argv++; argc--;
+    }
+    else
+      break;
+  }
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s [--gpu] <epsilon> <replications>\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  TaskData data;
+  data.epsilon      = atof(argv[0]);
+  data.replications = (cl_uint) atoi(argv[1]);
+  data.s0           = 100.0;
+  data.strike       = 100.0;
+  data.rate         = 0.05;
+  data.sigma        = 0.2;
+  data.maturity     = 1.0;
+
+  if (!(data.epsilon > 0) || data.replications < 2) {
+    fprintf(stderr, "%s: epsilon must be positive and at least 2 replications are required\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  return call_with_opencl(0, device_type, 0, &task, &data, CL_TRUE);
+}
@@ -0,0 +1,98 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include <clQMC/latticerule.clh>
+
+// Discounted payoff of a European call option under a geometric Brownian
+// motion, simulated with the Euler scheme over `steps` time steps, with the
+// fine Brownian increments read from the stream.  If `coarse` is nonzero,
+// also simulate the path with steps / 2 time steps driven by the same
+// Brownian motion, i.e., with the sums of pairs of fine increments, and
+// return the difference between the fine and the coarse payoffs.
+clqmc_fptype samplePayoffDifference(
+        clqmcLatticeRuleStream* stream,
+        uint steps,
+        uint coarse,
+        clqmc_fptype s0,
+        clqmc_fptype strike,
+        clqmc_fptype rate,
+        clqmc_fptype sigma,
+        clqmc_fptype maturity)
+{
+  clqmc_fptype h = maturity / steps;
+  clqmc_fptype sqrth = sqrt(h);
+  clqmc_fptype fine = s0;
+  clqmc_fptype coarseValue = s0;
+
+  for (uint k = 0; k < steps; k += 2) {
+    clqmc_fptype dw1 = sqrth * clqmcLatticeRuleNextNormal(stream);
+    clqmc_fptype dw2 = sqrth * clqmcLatticeRuleNextNormal(stream);
+    fine += fine * (rate * h + sigma * dw1);
+    fine += fine * (rate * h + sigma * dw2);
+    coarseValue += coarseValue * (rate * 2 * h + sigma * (dw1 + dw2));
+  }
+
+  clqmc_fptype discount = exp(-rate * maturity);
+  clqmc_fptype payoff = discount * fmax(fine - strike, (clqmc_fptype) 0);
+  if (coarse)
+    payoff -= discount * fmax(coarseValue - strike, (clqmc_fptype) 0);
+  return payoff;
+}
+
+// Work item i processes block i % blocks of the points of the lattice rule,
+// randomized with shift i / blocks, and writes the sum of its payoffs (or
+// payoff differences) to out[i].
+__kernel void sampleLevel(
+        __global const clqmcLatticeRule* lattice,
+        __global const clqmc_fptype* shifts,
+        uint blocks,
+        uint steps,
+        uint coarse,
+        clqmc_fptype s0,
+        clqmc_fptype strike,
+        clqmc_fptype rate,
+        clqmc_fptype sigma,
+        clqmc_fptype maturity,
+        __global clqmc_fptype* out)
+{
+  uint gid   = get_global_id(0);
+  uint block = gid % blocks;
+  uint rep   = gid / blocks;
+
+  clqmcLatticeRuleStream stream;
+  clqmcLatticeRuleCreateOverStream(&stream, lattice, blocks, block,
+      shifts + rep * clqmcLatticeRuleDimension(lattice));
+
+  uint pointsPerBlock = clqmcLatticeRuleNumPoints(lattice) / blocks;
+  clqmc_fptype sum = 0;
+  for (uint i = 0; i < pointsPerBlock; i++) {
+    sum += samplePayoffDifference(&stream, steps, coarse, s0, strike, rate, sigma, maturity);
+    clqmcLatticeRuleForwardToNextPoint(&stream);
+  }
+
+  out[gid] = sum;
+}
+
+/*
+vim: ft=c
+*/
@@ -0,0 +1,325 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Lattice rule specialized at run time.
+ *
+ * Integrates a product function with a randomly shifted lattice rule, first
+ * with a generic kernel that reads the lattice rule from global memory, then
+ * with a kernel built by clqmcLatticeRuleBuildSpecializedProgram(), in which
+ * the number of points, the dimension and the generating vector are
+ * compile-time constants.  The kernels are launched repeatedly, as for a
+ * small lattice rule reused over a long computation, and the build time of
+ * the specialized program is compared with the time saved per launch.
+ * The specialized program is then requested again, to show that it comes
+ * from the program cache.
+ */
+
+#if defined(__APPLE__) || defined(__MACOSX)
+#include <OpenCL/cl.h>
+#else
+#include <CL/cl.h>
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "../common.h"
+
+#include <clQMC/latticerule.h>
+#include <clQMC/randomshift.h>
+
+#define KERNEL_FILE     "client/Specialized/specialized_kernel.cl"
+#define SHIFTS_SEED     1234
+#define ITEMS           256
+
+typedef struct TaskData_ {
+  cl_uint log2_points;
+  cl_uint dimension;
+  cl_uint replications;
+  cl_uint launches;
+} TaskData;
+
+static double wall_time()
+{
+#ifdef _MSC_VER
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double) count.QuadPart / (double) freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#endif
+}
+
+static cl_ulong event_duration(cl_event ev)
+{
+  cl_ulong start, end;
+  cl_int err;
+  err  = clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  err |= clGetEventProfilingInfo(ev, CL_PROFILING_COMMAND_END,   sizeof(end),   &end,   NULL);
+  check_error(err, "cannot read event profiling info");
+  return end - start;
+}
+
+// Launch the kernel repeatedly, return the average kernel time in ms and the
+// mean and standard error of the estimates of the last launch.
+static double run(cl_command_queue queue, cl_kernel kernel, cl_mem out_buf, const TaskData* data, size_t items,
+    const char* name, double* mean, double* std_error)
+{
+  size_t global_size[2] = { items, data->replications };
+  size_t out_size = items * data->replications * sizeof(clqmc_fptype);
+  double total = 0.0;
+  cl_int err;
+
+  for (cl_uint k = 0; k < data->launches; k++) {
+    cl_event ev;
+    err = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, global_size, NULL, 0, NULL, &ev);
+    check_error(err, "cannot enqueue kernel");
+    err = clWaitForEvents(1, &ev);
+    check_error(err, "cannot wait for kernel");
+    profile_event(name, ev);
+    total += event_duration(ev) * 1e-6;
+    clReleaseEvent(ev);
+  }
+
+  clqmc_fptype* out = (clqmc_fptype*) malloc(out_size);
+  err = clEnqueueReadBuffer(queue, out_buf, CL_TRUE, 0, out_size, out, 0, NULL, NULL);
+  check_error(err, "cannot read output buffer");
+
+  cl_uint points = (cl_uint) 1 << data->log2_points;
+  *mean = 0.0;
+  double variance = 0.0;
+  double* estimates = (double*) calloc(data->replications, sizeof(double));
+  for (cl_uint r = 0; r < data->replications; r++) {
+    for (size_t i = 0; i < items; i++)
+      estimates[r] += out[r * items + i];
+    estimates[r] /= points;
+    *mean += estimates[r] / data->replications;
+  }
+  for (cl_uint r = 0; r < data->replications; r++)
+    variance += (estimates[r] - *mean) * (estimates[r] - *mean) / (data->replications - 1);
+  *std_error = sqrt(variance / data->replications);
+
+  free(estimates);
+  free(out);
+  return total / data->launches;
+}
+
+// Check that the line numbers of the kernel source are preserved in the
+// specialized program, whose source starts with the definitions of the
+// lattice rule: the #line directive that follows the expansion of the first
+// clQMC header must number the line after its include in the kernel source.
+// Return nonzero on mismatch.
+static int check_line_numbers(cl_program program, const char* source)
+{
+  size_t include_line = 1;
+  const char* p = source;
+  while (*p && strncmp(p, "#include <clQMC/", 16) != 0) {
+    const char* eol = strchr(p, '\n');
+    if (!eol)
+      return 0;
+    p = eol + 1;
+    include_line++;
+  }
+
+  size_t size = 0;
+  cl_int err = clGetProgramInfo(program, CL_PROGRAM_SOURCE, 0, NULL, &size);
+  check_error(err, "cannot get program source size");
+  if (!*p || size <= 1)
+    return 0;     // nothing to check, or the program was created from a binary
+  char* program_source = (char*) malloc(size);
+  err = clGetProgramInfo(program, CL_PROGRAM_SOURCE, size, program_source, NULL);
+  check_error(err, "cannot get program source");
+
+  unsigned long line = 0;
+  const char* directive = strstr(program_source, "\"<source>\"");
+  while (directive && directive > program_source && directive[-1] != '\n')
+    directive--;
+  int found = directive && sscanf(directive, "#line %lu", &line) == 1;
+  free(program_source);
+
+  if (!found || line != include_line + 1) {
+    fprintf(stderr, "error: the specialized program numbers line %lu of the source as %lu\n",
+        (unsigned long) include_line + 1, line);
+    return 1;
+  }
+  return 0;
+}
+
+int task(cl_context context, cl_device_id device, cl_command_queue queue, void* data_)
+{
+  const TaskData* data = (const TaskData*) data_;
+  cl_uint points = (cl_uint) 1 << data->log2_points;
+  size_t items = points < ITEMS ? points : ITEMS;
+  clqmc_fptype c = (clqmc_fptype) 0.5;
+  cl_int err;
+
+  // Lattice rule, shifts and buffers
+
+  size_t lattice_size;
+  clqmcLatticeRule* lattice = clqmcLatticeRuleCreateFromCatalogue(data->log2_points, data->dimension,
+      CLQMC_LATTICE_CBC_POLY, &lattice_size, (clqmcStatus*) &err);
+  check_error(err, NULL);
+
+  size_t shifts_size = data->replications * data->dimension * sizeof(clqmc_fptype);
+  clqmc_fptype* shifts = (clqmc_fptype*) malloc(shifts_size);
+  err = clqmcRandomShiftsGenerate(SHIFTS_SEED, 0, data->replications, data->dimension, shifts);
+  check_error(err, NULL);
+
+  cl_mem lattice_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      lattice_size, lattice, &err);
+  check_error(err, "cannot create lattice buffer");
+  cl_mem shifts_buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_HOST_WRITE_ONLY | CL_MEM_COPY_HOST_PTR,
+      shifts_size, shifts, &err);
+  check_error(err, "cannot create shifts buffer");
+  cl_mem out_buf = clCreateBuffer(context, CL_MEM_WRITE_ONLY | CL_MEM_HOST_READ_ONLY,
+      items * data->replications * sizeof(clqmc_fptype), NULL, &err);
+  check_error(err, "cannot create output buffer");
+
+
+  // Generic program
+
+  double start = wall_time();
+  cl_program program = build_program_from_file(context, device, KERNEL_FILE, NULL);
+  double generic_build = (wall_time() - start) * 1e3;
+  cl_kernel kernel = clCreateKernel(program, "integrate", &err);
+  check_error(err, "cannot create kernel");
+  err  = clSetKernelArg(kernel, 0, sizeof(lattice_buf), &lattice_buf);
+  err |= clSetKernelArg(kernel, 1, sizeof(shifts_buf),  &shifts_buf);
+  err |= clSetKernelArg(kernel, 2, sizeof(c),           &c);
+  err |= clSetKernelArg(kernel, 3, sizeof(out_buf),     &out_buf);
+  check_error(err, "cannot set kernel arguments");
+
+
+  // Specialized program, built twice: the second build comes from the cache
+
+  char path[1024];
+  snprintf(path, sizeof(path), "%s/%s", clqmcGetLibraryRoot(), KERNEL_FILE);
+  char* source;
+  err = read_file(path, &source);
+  check_error(err, "cannot read source file");
+
+  double specialized_build[2];
+  cl_program static_program[2];
+  for (int k = 0; k < 2; k++) {
+    profile_begin(k == 0 ? "build specialized program" : "build specialized program (cached)");
+    start = wall_time();
+    static_program[k] = clqmcLatticeRuleBuildSpecializedProgram(context, device, lattice,
+        1, (const char**) &source, NULL, NULL, (clqmcStatus*) &err);
+    specialized_build[k] = (wall_time() - start) * 1e3;
+    profile_end();
+    check_error(err, NULL);
+  }
+  int line_mismatch = check_line_numbers(static_program[0], source);
+  free(source);
+
+  cl_kernel static_kernel = clCreateKernel(static_program[0], "integrateStatic", &err);
+  check_error(err, "cannot create kernel");
+  err  = clSetKernelArg(static_kernel, 0, sizeof(shifts_buf), &shifts_buf);
+  err |= clSetKernelArg(static_kernel, 1, sizeof(c),          &c);
+  err |= clSetKernelArg(static_kernel, 2, sizeof(out_buf),    &out_buf);
+  check_error(err, "cannot set kernel arguments");
+
+
+  // Launches
+
+  double mean[2], std_error[2];
+  double time_generic = run(queue, kernel, out_buf, data, items, "generic kernel", &mean[0], &std_error[0]);
+  double time_static = run(queue, static_kernel, out_buf, data, items, "specialized kernel", &mean[1], &std_error[1]);
+
+  printf("\nIntegration of a product function (exact value 1) with %u replications of\n", data->replications);
+  err = clqmcLatticeRuleWriteInfo(lattice, stdout);
+  check_error(err, NULL);
+  printf("\n%14s%16s%16s%14s%14s\n", "kernel", "mean", "std. error", "build ms", "launch ms");
+  printf("%14s%16.8g%16.4g%14.2f%14.4f\n", "generic", mean[0], std_error[0], generic_build, time_generic);
+  printf("%14s%16.8g%16.4g%14.2f%14.4f\n", "specialized", mean[1], std_error[1], specialized_build[0], time_static);
+  printf("\nspecialized program from the cache: %.3f ms (%s program object)\n",
+      specialized_build[1], static_program[1] == static_program[0] ? "same" : "different");
+  if (time_static < time_generic)
+    printf("the specialized build pays off after %.0f launches\n",
+        ceil(specialized_build[0] / (time_generic - time_static)));
+  else
+    printf("the specialized kernel is not faster on this device\n");
+
+
+  // Clean up
+
+  free(shifts);
+  clReleaseKernel(kernel);
+  clReleaseKernel(static_kernel);
+  clReleaseProgram(program);
+  clReleaseProgram(static_program[0]);
+  clReleaseProgram(static_program[1]);
+  clReleaseMemObject(lattice_buf);
+  clReleaseMemObject(shifts_buf);
+  clReleaseMemObject(out_buf);
+  err = clqmcReleaseProgramCache();
+  check_error(err, NULL);
+  err = clqmcLatticeRuleDestroy(lattice);
+  check_error(err, NULL);
+
+  return line_mismatch ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  const char* prog = *argv++; argc--;
+  cl_device_type device_type = CL_DEVICE_TYPE_CPU;
+
+  while (argc && (*argv)[0] == '-') {
+    if (strcmp(*argv, "--gpu") == 0) {
+      device_type = CL_DEVICE_TYPE_GPU;
+      argv++; argc--;
+    }
+    else
+      break;
+  }
+
+  if (argc != 4) {
+    fprintf(stderr, "usage: %s [--gpu] <log2-points> <dimension> <replications> <launches>\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  TaskData data;
+  data.log2_points  = (cl_uint) atoi(argv[0]);
+  data.dimension    = (cl_uint) atoi(argv[1]);
+  data.replications = (cl_uint) atoi(argv[2]);
+  data.launches     = (cl_uint) atoi(argv[3]);
+
+  if (data.dimension < 1 || data.replications < 2 || data.launches < 1) {
+    fprintf(stderr, "%s: at least 1 dimension, 2 replications and 1 launch are required\n", prog);
+    return EXIT_FAILURE;
+  }
+
+  return call_with_opencl(0, device_type, 0, &task, &data, CL_TRUE);
+}
@@ -0,0 +1,93 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include <clQMC/latticerule.clh>
+
+// Integrates f(u) = prod_j (1 + c (3 u_j^2 - 1)), whose exact integral is 1,
+// with a randomly shifted lattice rule.  Work item i of replication r (the
+// second dimension of the NDRange) sums f over the i-th contiguous part of
+// the points shifted by shift r.
+
+// Generic kernel: the lattice rule is read from global memory.
+__kernel void integrate(
+        __global const clqmcLatticeRule* lattice,
+        __global const clqmc_fptype* shifts,
+        clqmc_fptype c,
+        __global clqmc_fptype* out)
+{
+  uint item  = get_global_id(0);
+  uint items = get_global_size(0);
+  uint rep   = get_global_id(1);
+  uint d     = clqmcLatticeRuleDimension(lattice);
+
+  clqmcLatticeRuleStream stream;
+  clqmcLatticeRuleCreateOverStream(&stream, lattice, items, item, shifts + rep * d);
+
+  clqmc_fptype sum = 0;
+  uint pointsPerItem = clqmcLatticeRuleNumPoints(lattice) / items;
+  for (uint i = 0; i < pointsPerItem; i++) {
+    clqmc_fptype f = 1;
+    for (uint j = 0; j < d; j++) {
+      clqmc_fptype u = clqmcLatticeRuleNextCoordinate(&stream);
+      f *= 1 + c * (3 * u * u - 1);
+    }
+    sum += f;
+    clqmcLatticeRuleForwardToNextPoint(&stream);
+  }
+
+  out[rep * items + item] = sum;
+}
+
+// Specialized kernel, built with clqmcLatticeRuleBuildSpecializedProgram():
+// the number of points, the dimension and the generating vector are
+// compile-time constants.
+#ifdef CLQMC_LATTICERULE_STATIC_DIMENSION
+__kernel void integrateStatic(
+        __global const clqmc_fptype* shifts,
+        clqmc_fptype c,
+        __global clqmc_fptype* out)
+{
+  uint item  = get_global_id(0);
+  uint items = get_global_size(0);
+  uint rep   = get_global_id(1);
+  __global const clqmc_fptype* shift = shifts + rep * CLQMC_LATTICERULE_STATIC_DIMENSION;
+
+  clqmc_fptype sum = 0;
+  uint pointsPerItem = CLQMC_LATTICERULE_STATIC_POINTS / items;
+  uint first = item * pointsPerItem;
+  for (uint i = first; i < first + pointsPerItem; i++) {
+    clqmc_fptype f = 1;
+    for (uint j = 0; j < CLQMC_LATTICERULE_STATIC_DIMENSION; j++) {
+      clqmc_fptype u = clqmcLatticeRuleStaticCoordinate(i, j, shift);
+      f *= 1 + c * (3 * u * u - 1);
+    }
+    sum += f;
+  }
+
+  out[rep * items + item] = sum;
+}
+#endif
+
+/*
+vim: ft=c
+*/
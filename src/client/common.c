@@ -139,6 +139,37 @@ void write_build_log(FILE* file, cl_program program, cl_device_id device)
     free(log);
 }
 
+static clqmcProfiler* profiler = NULL;
+
+clqmcProfiler* get_profiler()
+{
+    return profiler;
+}
+
+void profile_event(const char* name, cl_event event)
+{
+    if (profiler) {
+	cl_int err = clqmcProfilerRecordEvent(profiler, name, event);
+	check_error(err, NULL);
+    }
+}
+
+void profile_begin(const char* name)
+{
+    if (profiler) {
+	cl_int err = clqmcProfilerBeginSpan(profiler, name);
+	check_error(err, NULL);
+    }
+}
+
+void profile_end()
+{
+    if (profiler) {
+	cl_int err = clqmcProfilerEndSpan(profiler);
+	check_error(err, NULL);
+    }
+}
+
 static int call_with_opencl_helper(
 	cl_context context,
 	cl_device_id device,
@@ -161,7 +192,31 @@ static int call_with_opencl_helper(
 #endif
     check_error(err, "cannot create command queue");
 
+    const char* profile_path = getenv("CLQMC_PROFILE");
+    if (profile_path != NULL && profile_path[0] != 0) {
+	profiler = clqmcProfilerCreate(&err);
+	check_error(err, NULL);
+    }
+
+    profile_begin("task");
     int ret_val = task(context, device, queue, data);
+    profile_end();
+
+    if (profiler) {
+	err = clFinish(queue);
+	check_error(err, "cannot finish command queue");
+	FILE* file = fopen(profile_path, "w");
+	if (file == NULL)
+	    check_error(CLQMC_INVALID_VALUE, "cannot open profile file %s", profile_path);
+	err = clqmcProfilerWriteTrace(profiler, file);
+	check_error(err, NULL);
+	fclose(file);
+	fprintf(stderr, "\nProfile for device %s (trace written to %s):\n\n", get_device_name(device), profile_path);
+	err = clqmcProfilerWriteSummary(profiler, stderr);
+	check_error(err, NULL);
+	clqmcProfilerDestroy(profiler);
+	profiler = NULL;
+    }
 
     err = clReleaseCommandQueue(queue);
     check_error(err, "cannot release command queue");
@@ -231,6 +286,16 @@ cl_program build_program_from_file(
 	cl_device_id device,
 	const char* source_file,
 	const char* extra_options)
+{
+    return build_program_from_file_with_hash(context, device, source_file, extra_options, NULL);
+}
+
+cl_program build_program_from_file_with_hash(
+	cl_context context,
+	cl_device_id device,
+	const char* source_file,
+	const char* extra_options,
+	cl_ulong* hash)
 {
     cl_int err;
 
@@ -259,15 +324,19 @@ cl_program build_program_from_file(
 
     source_file = path;
 
+    profile_begin("build program");
+
     char *sources[1];
     err = read_file(path, &sources[0]);
     check_error(err, "cannot read source file\ncheck that the environment variable CLQMC_ROOT set to the library root directory");
 
-    cl_program program = clCreateProgramWithSource(context, 1, (const char**)sources, NULL, &err);
-    check_error(err, "cannot create program");
+    cl_program program = clqmcCreateProgramWithSource(context, 1, (const char**)sources, NULL, hash, (clqmcStatus*)&err);
+    check_error(err, NULL);
 
     free(sources[0]);
 
+    // the clQMC headers are embedded in the library, but the tutorial kernels
+    // also include files installed under CLQMC_ROOT
     const char* includes = clqmcGetLibraryDeviceIncludes(NULL);
     const char* options = includes;
     char* buf = NULL;
@@ -285,5 +354,7 @@ cl_program build_program_from_file(
 	write_build_log(stderr, program, device);
     check_error(err, "cannot build program");
 
+    profile_end();
+
     return program;
 }
@@ -32,6 +32,8 @@
 
 #include <stdio.h>
 
+#include <clQMC/profiling.h>
+
 #if defined ( WIN32 )
 #define __func__ __FUNCTION__
 #endif
@@ -109,6 +111,47 @@ cl_program build_program_from_file(
 	const char* source_file,
 	const char* extra_options);
 
+/*! @brief Create and build an OpenCL program from a source file, and return
+ *  the hash of its source.
+ *
+ *  Same as build_program_from_file(), but also stores in `hash` the hash of
+ *  the source returned by clqmcCreateProgramWithSource(), e.g., for
+ *  clqmcAutotunerCreate().
+ */
+cl_program build_program_from_file_with_hash(
+	cl_context context,
+	cl_device_id device,
+	const char* source_file,
+	const char* extra_options,
+	cl_ulong* hash);
+
+/*! @brief Return the profiler of the running task, or NULL.
+ *
+ *  A profiler is created by call_with_opencl() for each device when the
+ *  environment variable CLQMC_PROFILE is set.  After the task returns, a
+ *  Chrome trace is written to the file named by CLQMC_PROFILE (overwritten
+ *  for each device) and a summary table is written to standard error.
+ */
+clqmcProfiler* get_profiler();
+
+/*! @brief Record an OpenCL command with the profiler of the running task.
+ *
+ *  Does nothing if profiling is disabled.
+ */
+void profile_event(const char* name, cl_event event);
+
+/*! @brief Begin a host span with the profiler of the running task.
+ *
+ *  Does nothing if profiling is disabled.
+ */
+void profile_begin(const char* name);
+
+/*! @brief End the innermost host span of the profiler of the running task.
+ *
+ *  Does nothing if profiling is disabled.
+ */
+void profile_end();
+
 /*! Prepare the OpenCL environment and run a given task.
  *
  *  The task is specified as a callback function.
@@ -117,6 +160,7 @@ cl_program build_program_from_file(
  *  buffers and kernels.
  *  The context, device and command queue that are passed to the task function
  *  must not be released by the user; they are managed by call_with_opencl().
+ *  The command queue is created with profiling enabled; see get_profiler().
  *
  *  @param[in] platform_index   The OpenCL platform with corresponding index is selected.
  *  @param[in] task		Callback function.
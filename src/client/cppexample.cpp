@@ -0,0 +1,112 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/* Randomized quasi-Monte Carlo on the host with the C++ interface.
+ *
+ * Estimates the integral of f(u) = prod_j (1 + (u_j - 1/2) / j) over the
+ * unit cube, whose exact value is 1, with independent random shifts of a
+ * lattice rule from the catalogue.  The points of each replication are
+ * processed by a parallel standard algorithm, over their indices since the
+ * point iterators are not forward iterators.
+ */
+
+#include <clQMC/clqmc.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#if defined(__has_include)
+#  if __has_include(<execution>)
+#    include <execution>
+#  endif
+#endif
+
+#if defined(__cpp_lib_execution) && __cpp_lib_execution >= 201603L
+#  define EXEC_POLICY std::execution::par_unseq,
+#else
+#  define EXEC_POLICY
+#endif
+
+static constexpr std::size_t dimension = 16;
+
+template <typename Point>
+static double integrand(const Point& u)
+{
+  double prod = 1.0;
+  for (std::size_t j = 0; j < u.size(); j++)
+    prod *= 1.0 + (u[j] - 0.5) / (j + 1);
+  return prod;
+}
+
+int main(int argc, char** argv)
+{
+  unsigned log2NumPoints = argc > 1 ? (unsigned) std::atoi(argv[1]) : 16;
+  unsigned replications  = argc > 2 ? (unsigned) std::atoi(argv[2]) : 16;
+
+  try {
+    auto lattice = clqmc::LatticeRule<double, dimension>::fromCatalogue(log2NumPoints, CLQMC_LATTICE_CBC_POLY);
+
+    std::mt19937_64 rng(12345);
+    std::uniform_real_distribution<double> uniform;
+    std::array<double, dimension> shift;
+    std::vector<std::size_t> indices(lattice.numPoints());
+    std::iota(indices.begin(), indices.end(), std::size_t(0));
+
+    double sum = 0.0, sumSquares = 0.0;
+
+    for (unsigned r = 0; r < replications; r++) {
+
+      for (auto& x : shift)
+        x = uniform(rng);
+
+      auto points = lattice.points(shift.data());
+      double estimate = std::transform_reduce(EXEC_POLICY
+          indices.begin(), indices.end(), 0.0, std::plus<>(),
+          [&points](std::size_t i) { return integrand(points[i]); }) / lattice.numPoints();
+
+      sum += estimate;
+      sumSquares += estimate * estimate;
+    }
+
+    double mean = sum / replications;
+    double variance = replications > 1 ? (sumSquares - replications * mean * mean) / (replications - 1) : 0.0;
+
+    std::printf("lattice rule:      n = %u, s = %zu\n", lattice.numPoints(), lattice.dimension());
+    std::printf("replications:      %u\n", replications);
+    std::printf("estimate:          %.10f\n", mean);
+    std::printf("standard error:    %.3e\n", std::sqrt(std::fmax(variance, 0.0) / replications));
+    std::printf("exact value:       %.10f\n", 1.0);
+  }
+  catch (const clqmc::Error& e) {
+    std::fprintf(stderr, "error: %s\n", e.what());
+    return 1;
+  }
+
+  return 0;
+}
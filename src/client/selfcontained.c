@@ -37,7 +37,6 @@ int main( void )
     cl_event event = 0;
     cl_mem bufIn, bufOut;
     float *out;
-    const char *includes;
     char buildLog[4096];
     size_t numWorkItems = 64;
     size_t i, j;
@@ -82,14 +81,11 @@ int main( void )
     #endif
 
 
-    /* Make sure CLQMC_ROOT is specified to get library path */
-    includes = clqmcGetLibraryDeviceIncludes(&err);
-    if(err != CL_SUCCESS) printf("\n%s\nSpecify environment variable CLQMC_ROOT as described\n", clqmcGetErrorString());
-
-    /* Create sample kernel */
+    /* Create sample kernel; the clQMC device headers are inserted from the library */
     kernelLines = sizeof(kernelSrc) / sizeof(kernelSrc[0]);
-    program = clCreateProgramWithSource(ctx, kernelLines, kernelSrc, NULL, &err);
-    err = clBuildProgram(program, 1, &device, includes, NULL, NULL);
+    program = clqmcCreateProgramWithSource(ctx, kernelLines, kernelSrc, NULL, NULL, (clqmcStatus *)&err);
+    if(err != CL_SUCCESS) printf("\n%s\n", clqmcGetErrorString());
+    err = clBuildProgram(program, 1, &device, NULL, NULL, NULL);
     if(err != CL_SUCCESS)
     {
         printf("\nclBuildProgram has failed\n");
@@ -0,0 +1,202 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/*! @file arrayrqmc.h
+ *  @brief Host and device interface for array-RQMC
+ *
+ *  Array-RQMC @cite vLEC08a simulates @f$n@f$ copies (chains) of a Markov
+ *  chain @f$X_{j+1} = \varphi_j(X_j, \boldsymbol U_j)@f$ in parallel, where
+ *  @f$\boldsymbol U_j@f$ is uniform over @f$(0,1)^d@f$.
+ *  At each step @f$j@f$, the chains are sorted by a one-dimensional key
+ *  @f$h(X_j)@f$, and the chain of rank @f$i@f$ is advanced with point
+ *  @f$i@f$ of a fresh randomization of an @f$(1+d)@f$-dimensional point set
+ *  whose first coordinate is @f$i/n@f$.
+ *  Each chain then follows the exact distribution of the Markov chain, but
+ *  the empirical distribution of the @f$n@f$ states is much closer to the
+ *  true distribution of @f$X_j@f$ than with independent chains, and the
+ *  variance of the average of a function of the states over the chains often
+ *  decreases much faster than @f$O(n^{-1})@f$.
+ *
+ *  With rank-1 lattice rules, the first component of the generating vector
+ *  is 1, so that the first coordinate of point @f$i@f$ is @f$i/n@f$, and
+ *  only the other @f$d@f$ coordinates need to be stored;
+ *  clqmcArrayRQMCCreateLatticeRule() creates such a @f$d@f$-dimensional
+ *  lattice rule from the catalogue.
+ *  The point set is randomized at each step with an independent random
+ *  shift of its @f$d@f$ coordinates.
+ *
+ *  The engine consists of:
+ *
+ *  - a host object, created with clqmcArrayRQMCSorterCreate(), that sorts
+ *    the keys of the chains on the device along with a permutation vector,
+ *    with a bitonic sort;
+ *  - the device function clqmcArrayRQMCCreateStepStream(), that attaches a
+ *    stream to the point of a given rank for a given step, in a user kernel
+ *    that advances the chains.
+ *
+ *  A typical step kernel, with one work item per chain, reads the state of
+ *  the chain of rank `rank` at index `perm[rank]` of the state buffer,
+ *  advances it with the stream, writes the new state at index `rank` of a
+ *  second state buffer and the new key at index `rank` of the key buffer,
+ *  and resets `perm[rank]` to `rank`:
+ *  @code
+ *  __kernel void step(__global const clqmcLatticeRule* lattice,
+ *                     __global const clqmc_fptype* shifts, uint step,
+ *                     __global const State* statesIn, __global State* statesOut,
+ *                     __global clqmc_fptype* keys, __global uint* perm)
+ *  {
+ *      uint rank = get_global_id(0);
+ *      clqmcLatticeRuleStream stream;
+ *      clqmcArrayRQMCCreateStepStream(&stream, lattice, step, rank, shifts);
+ *      State x = advance(statesIn[perm[rank]], &stream);
+ *      statesOut[rank] = x;
+ *      keys[rank] = sortKey(x);
+ *      perm[rank] = rank;
+ *  }
+ *  @endcode
+ *  The host then alternates this kernel and clqmcArrayRQMCSorterEnqueue(),
+ *  swapping the state buffers at each step.
+ *  When the state itself is the key, the state buffer can be the key buffer.
+ *
+ *  The device functions are made available by including
+ *  `clQMC/arrayrqmc.clh` in device code; they are documented in
+ *  arrayrqmc.clh.
+ */
+
+#pragma once
+#ifndef CLQMC_ARRAYRQMC_H
+#define CLQMC_ARRAYRQMC_H
+
+#include <clQMC/clQMC.h>
+#include <clQMC/latticerule.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Sorter object for array-RQMC [**host-only**]
+ *
+ *  Holds the OpenCL program and kernels that sort the keys of the chains on
+ *  a device.
+ */
+typedef struct clqmcArrayRQMCSorter_ clqmcArrayRQMCSorter;
+
+#define clqmcArrayRQMCSorterCreate      _CLQMC_TAG_FPTYPE(clqmcArrayRQMCSorterCreate)
+#define clqmcArrayRQMCCreateLatticeRule _CLQMC_TAG_FPTYPE(clqmcArrayRQMCCreateLatticeRule)
+
+/*! @brief Create a sorter object [**host-only**]
+ *
+ *  Build the sorting kernels for the given device, for keys of type
+ *  `clqmc_fptype`.
+ *  The device headers are taken from the library (see
+ *  clqmcCreateProgramWithSource()), so `CLQMC_ROOT` need not be set.
+ *
+ *  @param[in]  context     OpenCL context.
+ *  @param[in]  device      OpenCL device of the context.
+ *  @param[in]  numChains   Number of chains @f$n@f$; must be a power of 2,
+ *                          with @f$n \geq 2@f$.
+ *  @param[in]  localSize   Work-group size of the sorting kernels; must be a
+ *                          power of 2 with `2 * localSize <= numChains`, or
+ *                          0 to select the largest such size supported by
+ *                          the device and the kernels.
+ *  @param[out] err         Error status variable, or `NULL`.  OpenCL errors
+ *                          are returned as is.
+ *
+ *  @return New sorter object, or `NULL` on error.
+ */
+CLQMCAPI clqmcArrayRQMCSorter* clqmcArrayRQMCSorterCreate             (cl_context context, cl_device_id device, cl_uint numChains, size_t localSize, clqmcStatus* err);
+CLQMCAPI clqmcArrayRQMCSorter* clqmcArrayRQMCSorterCreate_clqmc_float (cl_context context, cl_device_id device, cl_uint numChains, size_t localSize, clqmcStatus* err);
+CLQMCAPI clqmcArrayRQMCSorter* clqmcArrayRQMCSorterCreate_clqmc_double(cl_context context, cl_device_id device, cl_uint numChains, size_t localSize, clqmcStatus* err);
+
+/*! @brief Destroy a sorter object [**host-only**]
+ *
+ *  @param[in]  sorter      Sorter object, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcArrayRQMCSorterDestroy(clqmcArrayRQMCSorter* sorter);
+
+/*! @brief Return the work-group size used by a sorter [**host-only**]
+ */
+CLQMCAPI size_t clqmcArrayRQMCSorterLocalSize(const clqmcArrayRQMCSorter* sorter);
+
+/*! @brief Sort the keys of the chains on the device [**host-only**]
+ *
+ *  Enqueue the @f$O(\log^2 n)@f$ kernels that sort `keys` in increasing
+ *  order and apply the same permutation to `perm`.
+ *  Bitonic merges of sequences no longer than twice the work-group size are
+ *  done in local memory, so for @f$n \leq 2 \times@f$ `localSize`, a single
+ *  kernel is enqueued.
+ *  The kernels are chained with events, so the command queue can be
+ *  out-of-order.
+ *
+ *  The kernel arguments of the sorter are set by this function, so a sorter
+ *  object must not be used concurrently by multiple threads.
+ *
+ *  @param[in,out]  sorter      Sorter object.
+ *  @param[in]      queue       Command queue on the device of the sorter.
+ *  @param[in,out]  keys        Buffer of @f$n@f$ keys of type `clqmc_fptype`.
+ *  @param[in,out]  perm        Buffer of @f$n@f$ values of type `cl_uint`,
+ *                              usually the identity permutation.
+ *  @param[in]      numEventsInWaitList Number of events in `eventWaitList`.
+ *  @param[in]      eventWaitList       Events that must complete before the
+ *                              sort starts, or `NULL`.
+ *  @param[out]     event       Event of the last kernel of the sort, or
+ *                              `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcArrayRQMCSorterEnqueue(clqmcArrayRQMCSorter* sorter, cl_command_queue queue, cl_mem keys, cl_mem perm,
+    cl_uint numEventsInWaitList, const cl_event* eventWaitList, cl_event* event);
+
+/*! @brief Create the lattice rule of the steps of array-RQMC [**host-only**]
+ *
+ *  Take the lattice rule with @f$2^k@f$ points in dimension @f$d + 1@f$ from
+ *  the catalogue and drop its first coordinate, which is @f$i/n@f$ for point
+ *  @f$i@f$ and is implicitly given by the rank of the chains.
+ *  Equivalently, call clqmcLatticeRuleCreate() with all but the first
+ *  component of a @f$(d+1)@f$-dimensional generating vector whose first
+ *  component is 1.
+ *
+ *  @param[in]  log2NumChains   Base-2 logarithm @f$k@f$ of the number of
+ *                              chains.
+ *  @param[in]  stepDimension   Number @f$d@f$ of uniforms used to advance a
+ *                              chain by one step.
+ *  @param[in]  family          Family of lattice rules of the catalogue.
+ *  @param[out] objectSize      Size in bytes of the returned object.
+ *  @param[out] err             Error status variable, or `NULL`.
+ *
+ *  @return New lattice rule object, to be released with
+ *  clqmcLatticeRuleDestroy().
+ *
+ *  @see clqmcLatticeRuleCreateFromCatalogue()
+ */
+CLQMCAPI clqmcLatticeRule* clqmcArrayRQMCCreateLatticeRule             (cl_uint log2NumChains, cl_uint stepDimension, clqmcLatticeRuleFamily family, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcArrayRQMCCreateLatticeRule_clqmc_float (cl_uint log2NumChains, cl_uint stepDimension, clqmcLatticeRuleFamily family, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcArrayRQMCCreateLatticeRule_clqmc_double(cl_uint log2NumChains, cl_uint stepDimension, clqmcLatticeRuleFamily family, size_t* objectSize, clqmcStatus* err);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,272 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/*! @file autotune.h
+ *  @brief Autotuning of kernel launch configurations [**host-only**]
+ *
+ *  The fastest way of mapping the points and the random shifts of an RQMC
+ *  estimator to work items depends strongly on the device: the best number
+ *  of points per work item, number of replications per work item and
+ *  work-group size typically differ by a factor of several between a CPU
+ *  and a GPU.
+ *  An autotuner runs short calibration launches of a kernel over candidate
+ *  launch configurations (see clqmcLaunchConfig) and selects the fastest one
+ *  for the device.
+ *
+ *  The launches are performed by a user callback (see
+ *  clqmcAutotuneLauncher) that typically sets the kernel arguments that
+ *  depend on the configuration and enqueues the kernel with the global and
+ *  local sizes of the configuration.
+ *  When the callback returns the event of that kernel, its duration is
+ *  measured with OpenCL event profiling, so the command queue should have
+ *  been created with `CL_QUEUE_PROFILING_ENABLE`; otherwise, the host time
+ *  elapsed until the completion of the event is used.
+ *
+ *  The search proceeds in two stages, to keep the number of calibration
+ *  launches small:
+ *
+ *  1. Every combination of candidate numbers of points and of replications
+ *     per work item is timed with the work-group size chosen by the OpenCL
+ *     implementation.
+ *  2. Every candidate work-group size that divides the global size is timed
+ *     with the fastest combination found at the first stage.
+ *
+ *  Each configuration is launched up to a given number of times (see
+ *  clqmcAutotunerSetRepeats()) and is assigned its shortest duration; the
+ *  repetitions stop early for configurations that are more than twice as slow
+ *  as the fastest one so far.
+ *  A configuration whose launch fails (e.g., with
+ *  `CL_INVALID_WORK_GROUP_SIZE` because the kernel uses too many resources
+ *  for the work-group size) is skipped.
+ *
+ *  The selected configurations are stored in a small text file per device,
+ *  indexed by a key that identifies the kernel, by a hash of the source of
+ *  its program and by the number of points and of replications, so that
+ *  subsequent runs of a program reuse them without calibration, until the
+ *  kernel or the device headers of the library change.
+ *  By default, the cache file is in the directory given by the
+ *  `CLQMC_CACHE_DIR` environment variable if it is defined, or else in the
+ *  `clqmc` subdirectory of the user cache directory
+ *  (`$XDG_CACHE_HOME`, `$HOME/.cache` or `%LOCALAPPDATA%`), and its name is
+ *  derived from the name of the device and from a hash of the device and
+ *  driver versions, so that a new driver triggers a new calibration.
+ *  Failure to read or write the cache file is not an error: the
+ *  configuration is then simply selected by calibration.
+ *
+ *  An autotuner object must not be used concurrently by multiple threads.
+ */
+
+#pragma once
+#ifndef CLQMC_AUTOTUNE_H
+#define CLQMC_AUTOTUNE_H
+
+#include <clQMC/clQMC.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Kernel launch configuration [**host-only**]
+ *
+ *  With @f$n@f$ points and @f$R@f$ random shifts, the kernel is launched
+ *  with @f$(n / p) (R / r)@f$ work items (see
+ *  clqmcLaunchConfigGlobalSize()), where @f$p@f$ and @f$r@f$ are the numbers
+ *  of points and of replications per work item; for example, @f$r = R@f$
+ *  corresponds to work items that loop over all shifts for a subset of the
+ *  points, and @f$r = 1@f$ to work items that process a subset of the points
+ *  for a single shift.
+ */
+typedef struct clqmcLaunchConfig_ {
+  cl_uint pointsPerWorkItem;        //!< Number @f$p@f$ of points per work item, dividing @f$n@f$
+  cl_uint replicationsPerWorkItem;  //!< Number @f$r@f$ of replications per work item, dividing @f$R@f$
+  size_t localSize;                 //!< Work-group size, or 0 to let the OpenCL implementation choose it
+} clqmcLaunchConfig;
+
+/*! @brief Autotuner object [**host-only**]
+ */
+typedef struct clqmcAutotuner_ clqmcAutotuner;
+
+/*! @brief Callback that launches a kernel with a given configuration [**host-only**]
+ *
+ *  Enqueue the kernel being tuned with the global size returned by
+ *  clqmcLaunchConfigGlobalSize() and with the local size of `config`
+ *  (`NULL` if it is 0).
+ *  The results of the calibration launches are not used, but the kernel
+ *  must write to buffers large enough for every candidate configuration.
+ *
+ *  @param[in]  userData    Pointer given to clqmcAutotunerCreate().
+ *  @param[in]  config      Launch configuration.
+ *  @param[out] event       Event of the kernel, or `NULL` (the initial value)
+ *                          if the callback waits for the completion of the
+ *                          kernel; the event is released by the autotuner.
+ *
+ *  @return Error status; an error skips the configuration.
+ */
+typedef clqmcStatus (*clqmcAutotuneLauncher)(void* userData, const clqmcLaunchConfig* config, cl_event* event);
+
+/*! @brief Return the number of work items of a launch configuration [**host-only**]
+ *
+ *  @param[in]  config          Launch configuration.
+ *  @param[in]  numPoints       Number @f$n@f$ of points.
+ *  @param[in]  replications    Number @f$R@f$ of random shifts.
+ *
+ *  @return Global size @f$(n / p) (R / r)@f$, or 0 if @f$p@f$ does not divide
+ *  @f$n@f$ or @f$r@f$ does not divide @f$R@f$.
+ */
+CLQMCAPI size_t clqmcLaunchConfigGlobalSize(const clqmcLaunchConfig* config, cl_uint numPoints, cl_uint replications);
+
+/*! @brief Create an autotuner [**host-only**]
+ *
+ *  The default candidate numbers of points per work item are the powers of
+ *  2 up to 256 that divide `numPoints`; those of replications per work item
+ *  are 1, the powers of 2 that divide `replications` and `replications`
+ *  itself; those of work-group sizes are 0 and the powers of 2 from 16 to
+ *  the maximum work-group size of the device, up to 1024.
+ *
+ *  @param[in]  device          Device on which the kernel runs.
+ *  @param[in]  key             Identifier of the kernel in the cache file,
+ *                              without whitespace and of at most 255
+ *                              characters (e.g., the name of the kernel and
+ *                              the precision); it is copied.
+ *  @param[in]  sourceHash      Hash of the source of the program of the
+ *                              kernel, as returned by
+ *                              clqmcCreateProgramWithSource(), or 0 if the
+ *                              key alone identifies the kernel.
+ *  @param[in]  numPoints       Number @f$n@f$ of points of the lattice rule.
+ *  @param[in]  replications    Number @f$R@f$ of random shifts.
+ *  @param[in]  launcher        Callback that launches the kernel.
+ *  @param[in]  userData        Pointer passed to `launcher`.
+ *  @param[out] err             Error status variable, or `NULL`.
+ *
+ *  @return New autotuner object, or `NULL` on error.
+ */
+CLQMCAPI clqmcAutotuner* clqmcAutotunerCreate(cl_device_id device, const char* key, cl_ulong sourceHash, cl_uint numPoints, cl_uint replications,
+    clqmcAutotuneLauncher launcher, void* userData, clqmcStatus* err);
+
+/*! @brief Destroy an autotuner [**host-only**]
+ *
+ *  @param[in]  tuner   Autotuner object, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcAutotunerDestroy(clqmcAutotuner* tuner);
+
+/*! @brief Set the candidate launch configurations [**host-only**]
+ *
+ *  Each array is copied; a `NULL` array keeps the current candidates for
+ *  that parameter.
+ *  Candidate numbers of points or of replications per work item that do not
+ *  divide the number of points or of replications are ignored.
+ *
+ *  @param[in,out]  tuner                       Autotuner object.
+ *  @param[in]      numPointsPerWorkItem        Number of elements of
+ *                                              `pointsPerWorkItem`.
+ *  @param[in]      pointsPerWorkItem           Candidate numbers of points
+ *                                              per work item, or `NULL`.
+ *  @param[in]      numReplicationsPerWorkItem  Number of elements of
+ *                                              `replicationsPerWorkItem`.
+ *  @param[in]      replicationsPerWorkItem     Candidate numbers of
+ *                                              replications per work item, or
+ *                                              `NULL`.
+ *  @param[in]      numLocalSizes               Number of elements of
+ *                                              `localSizes`.
+ *  @param[in]      localSizes                  Candidate work-group sizes
+ *                                              (0 for the choice of the OpenCL
+ *                                              implementation), or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcAutotunerSetCandidates(clqmcAutotuner* tuner,
+    cl_uint numPointsPerWorkItem, const cl_uint* pointsPerWorkItem,
+    cl_uint numReplicationsPerWorkItem, const cl_uint* replicationsPerWorkItem,
+    cl_uint numLocalSizes, const size_t* localSizes);
+
+/*! @brief Set the maximum number of launches per configuration [**host-only**]
+ *
+ *  The default is 3.
+ *
+ *  @param[in,out]  tuner       Autotuner object.
+ *  @param[in]      repeats     Maximum number of timed launches of each
+ *                              configuration, at least 1.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcAutotunerSetRepeats(clqmcAutotuner* tuner, cl_uint repeats);
+
+/*! @brief Set the cache file [**host-only**]
+ *
+ *  @param[in,out]  tuner   Autotuner object.
+ *  @param[in]      path    Path of the cache file, which is created if
+ *                          needed, or `NULL` to disable the cache; it is
+ *                          copied.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcAutotunerSetCacheFile(clqmcAutotuner* tuner, const char* path);
+
+/*! @brief Return the path of the cache file [**host-only**]
+ *
+ *  @return Path of the cache file, or `NULL` if the cache is disabled or if
+ *  no default location could be determined.
+ */
+CLQMCAPI const char* clqmcAutotunerGetCacheFile(const clqmcAutotuner* tuner);
+
+/*! @brief Select the fastest launch configuration [**host-only**]
+ *
+ *  Return the configuration stored in the cache file for the key, the
+ *  source hash, the number of points and the number of replications of the
+ *  autotuner, if
+ *  any and if `retune` is `CL_FALSE`; otherwise, time the candidate
+ *  configurations and store the fastest one in the cache file.
+ *
+ *  @param[in,out]  tuner       Autotuner object.
+ *  @param[in]      retune      `CL_TRUE` to ignore the cache file.
+ *  @param[out]     best        Fastest launch configuration.
+ *  @param[out]     cached      `CL_TRUE` if `best` was read from the cache
+ *                              file, or `NULL`.
+ *
+ *  @return Error status; if no candidate configuration could be launched,
+ *  the error of the last launch.
+ */
+CLQMCAPI clqmcStatus clqmcAutotunerRun(clqmcAutotuner* tuner, cl_bool retune, clqmcLaunchConfig* best, cl_bool* cached);
+
+/*! @brief Write a table of the timed configurations [**host-only**]
+ *
+ *  Write the numbers of points and of replications per work item, the
+ *  work-group size and the shortest duration of each configuration timed by
+ *  the last call to clqmcAutotunerRun(), marking the fastest one, and the
+ *  total time spent in calibration launches.
+ *
+ *  @param[in]  tuner   Autotuner object.
+ *  @param[in]  file    Output file.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcAutotunerWriteInfo(const clqmcAutotuner* tuner, FILE* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
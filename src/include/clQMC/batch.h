@@ -0,0 +1,214 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+/*! @file batch.h
+ *  @brief Batches of small RQMC problems in a single kernel launch
+ *
+ *  When many small integrals must be estimated, each with its own lattice
+ *  rule and random shifts (e.g., the same model at many parameter values, or
+ *  independent risk factors), launching one kernel per problem is dominated
+ *  by launch overhead and leaves most of the device idle.
+ *  A batch object packs the lattice rules and the random shifts of all
+ *  problems into a single contiguous block of memory, preceded by a table of
+ *  offsets, so that it can be copied to the device with a single buffer and
+ *  all problems can be processed by a single kernel launch, typically with
+ *  one work group per problem.
+ *  The table also assigns to each replication of each problem a slot of a
+ *  common output array (see clqmcBatchOutputOffset()), so that the estimates
+ *  of all problems are read back with a single transfer.
+ *
+ *  The problems may have different numbers of points, dimensions and
+ *  numbers of replications, but their lattice rules and shifts must all be
+ *  of the same precision as the batch object.
+ *
+ *  Example kernel code, with one work group per problem:
+ *  @code
+ *  #include <clQMC/batch.clh>
+ *
+ *  __kernel void integrate(__global const clqmcBatch* batch,
+ *                          __global clqmc_fptype* out,
+ *                          __local clqmc_fptype* scratch)
+ *  {
+ *    uint problem = get_group_id(0);
+ *    uint n = clqmcLatticeRuleNumPoints(clqmcBatchLatticeRule(batch, problem));
+ *    for (uint r = 0; r < clqmcBatchReplications(batch, problem); r++) {
+ *      clqmc_fptype sum = 0;
+ *      for (uint i = get_local_id(0); i < n; i += get_local_size(0)) {
+ *        clqmcLatticeRuleStream stream;
+ *        clqmcBatchCreateOverStream(&stream, batch, problem, r, n, i);
+ *        sum += f(&stream);
+ *      }
+ *      sum = clqmcBatchWorkGroupSum(sum, scratch);
+ *      if (get_local_id(0) == 0)
+ *        out[clqmcBatchOutputOffset(batch, problem) + r] = sum / n;
+ *    }
+ *  }
+ *  @endcode
+ */
+
+#pragma once
+#ifndef CLQMC_BATCH_H
+#define CLQMC_BATCH_H
+
+#include <clQMC/clQMC.h>
+#include <clQMC/latticerule.h>
+
+struct clqmcBatch_;
+
+/*! @brief Batch object
+ *
+ *  Stores the lattice rules and random shifts of a number of problems, in
+ *  the precision of `clqmc_fptype`, along with a table of their locations
+ *  in the object.
+ */
+typedef struct clqmcBatch_ clqmcBatch;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define clqmcBatchCreate                _CLQMC_TAG_FPTYPE(clqmcBatchCreate)
+#define clqmcBatchShifts                _CLQMC_TAG_FPTYPE(clqmcBatchShifts)
+#define clqmcBatchCreateOverStream      _CLQMC_TAG_FPTYPE(clqmcBatchCreateOverStream)
+
+/*! @brief Create a batch object [**host-only**]
+ *
+ *  The lattice rules and the shifts are copied into the new object.
+ *
+ *  @param[in]  problems        Number of problems.
+ *  @param[in]  lattices        Lattice rules of the problems.
+ *  @param[in]  shifts          Random shifts of the problems, or `NULL` if
+ *                              no problem is randomized; the shifts of a
+ *                              problem of dimension @f$d@f$ consist of
+ *                              @f$d@f$ coordinates per replication, the shift
+ *                              of replication @f$r@f$ starting at index
+ *                              @f$rd@f$ (see clqmcRandomShiftsGenerate()); a
+ *                              `NULL` entry means that the problem is not
+ *                              randomized.
+ *  @param[in]  replications    Numbers of replications of the problems, or
+ *                              `NULL` for a single replication each; must be
+ *                              1 for the problems that are not randomized.
+ *  @param[out] objectSize      Size in bytes of the returned object, or
+ *                              `NULL`.
+ *  @param[out] err             Error status variable, or `NULL`.
+ *
+ *  @return New batch object, or `NULL` on error.
+ */
+CLQMCAPI clqmcBatch* clqmcBatchCreate             (cl_uint problems, const clqmcLatticeRule* const* lattices, const _CLQMC_FPTYPE* const* shifts,
+    const cl_uint* replications, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcBatch* clqmcBatchCreate_clqmc_float (cl_uint problems, const clqmcLatticeRule* const* lattices, const cl_float* const* shifts,
+    const cl_uint* replications, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcBatch* clqmcBatchCreate_clqmc_double(cl_uint problems, const clqmcLatticeRule* const* lattices, const cl_double* const* shifts,
+    const cl_uint* replications, size_t* objectSize, clqmcStatus* err);
+
+/*! @brief Destroy a batch object [**host-only**]
+ *
+ *  @param[in]  batch   Batch object, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcBatchDestroy(clqmcBatch* batch);
+
+/*! @brief Return the size of the output array [**host-only**]
+ *
+ *  @return Total number of replications of all problems of the batch, i.e.,
+ *  the number of elements of the output array indexed by
+ *  clqmcBatchOutputOffset().
+ */
+CLQMCAPI cl_uint clqmcBatchNumOutputs(const clqmcBatch* batch);
+
+/*! @brief Return the number of problems [**device**]
+ */
+CLQMCAPI cl_uint clqmcBatchNumProblems(const clqmcBatch* batch);
+
+/*! @brief Return the number of replications of a problem [**device**]
+ *
+ *  @param[in]  batch       Batch object.
+ *  @param[in]  problem     Problem index, smaller than
+ *                          clqmcBatchNumProblems().
+ */
+CLQMCAPI cl_uint clqmcBatchReplications(const clqmcBatch* batch, cl_uint problem);
+
+/*! @brief Return the output index of the first replication of a problem [**device**]
+ *
+ *  The estimate of replication @f$r@f$ of the problem goes at this index
+ *  plus @f$r@f$ in the output array; the indices of all replications of all
+ *  problems are distinct and range from 0 to clqmcBatchNumOutputs() minus 1.
+ *
+ *  @param[in]  batch       Batch object.
+ *  @param[in]  problem     Problem index, smaller than
+ *                          clqmcBatchNumProblems().
+ */
+CLQMCAPI cl_uint clqmcBatchOutputOffset(const clqmcBatch* batch, cl_uint problem);
+
+/*! @brief Return the lattice rule of a problem [**device**]
+ *
+ *  @param[in]  batch       Batch object.
+ *  @param[in]  problem     Problem index, smaller than
+ *                          clqmcBatchNumProblems().
+ *
+ *  @return Pointer to the lattice rule inside the batch object.
+ */
+CLQMCAPI const clqmcLatticeRule* clqmcBatchLatticeRule(const clqmcBatch* batch, cl_uint problem);
+
+/*! @brief Return the random shifts of a problem [**device**]
+ *
+ *  @param[in]  batch       Batch object.
+ *  @param[in]  problem     Problem index, smaller than
+ *                          clqmcBatchNumProblems().
+ *
+ *  @return Pointer to the shifts of all replications inside the batch
+ *  object, or `NULL` if the problem is not randomized.
+ */
+CLQMCAPI const _CLQMC_FPTYPE* clqmcBatchShifts             (const clqmcBatch* batch, cl_uint problem);
+CLQMCAPI const cl_float*      clqmcBatchShifts_clqmc_float (const clqmcBatch* batch, cl_uint problem);
+CLQMCAPI const cl_double*     clqmcBatchShifts_clqmc_double(const clqmcBatch* batch, cl_uint problem);
+
+/*! @brief Attach a stream to a replication of a problem [**device**]
+ *
+ *  Equivalent to clqmcLatticeRuleCreateOverStream() with the lattice rule of
+ *  the problem and the shift of the replication.
+ *
+ *  @param[out] stream          Stream object.
+ *  @param[in]  batch           Batch object.
+ *  @param[in]  problem         Problem index.
+ *  @param[in]  replication     Replication index.
+ *  @param[in]  partCount       Number of parts of the point set; must divide
+ *                              the number of points of the problem.
+ *  @param[in]  partIndex       Index of the part of the point set.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcBatchCreateOverStream             (clqmcLatticeRuleStream* stream, const clqmcBatch* batch, cl_uint problem, cl_uint replication,
+    cl_uint partCount, cl_uint partIndex);
+CLQMCAPI clqmcStatus clqmcBatchCreateOverStream_clqmc_float (clqmcLatticeRuleStream* stream, const clqmcBatch* batch, cl_uint problem, cl_uint replication,
+    cl_uint partCount, cl_uint partIndex);
+CLQMCAPI clqmcStatus clqmcBatchCreateOverStream_clqmc_double(clqmcLatticeRuleStream* stream, const clqmcBatch* batch, cl_uint problem, cl_uint replication,
+    cl_uint partCount, cl_uint partIndex);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
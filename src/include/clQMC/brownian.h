@@ -0,0 +1,175 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+/*! @file brownian.h
+ *  @brief Construction of Brownian paths from lattice rule points
+ *
+ *  A Brownian path @f$(W(t_1),\dots,W(t_d))@f$ at times
+ *  @f$0 < t_1 < \dots < t_d@f$ is a linear transformation of @f$d@f$
+ *  independent standard normal variates @f$z_0,\dots,z_{d-1}@f$, obtained
+ *  here from the coordinates of a lattice rule point with
+ *  clqmcLatticeRuleNextNormal().
+ *  The choice of the transformation does not change the distribution of the
+ *  path, but it determines how much of the variance of the integrand depends
+ *  on the first coordinates, where lattice rules are the most uniform:
+ *
+ *  - `CLQMC_BROWNIAN_SEQUENTIAL`: @f$W(t_i)@f$ is @f$W(t_{i-1})@f$ plus an
+ *    increment proportional to @f$z_i@f$, in time order, as when the
+ *    increments are read directly from the stream; all coordinates are
+ *    equally important.
+ *  - `CLQMC_BROWNIAN_BRIDGE`: @f$z_0@f$ determines @f$W(t_d)@f$, @f$z_1@f$
+ *    the value at the middle time index given the end points, and so on by
+ *    bisection @cite vMOS96a , so the first coordinates determine the overall
+ *    shape of the path.  Cost @f$O(d)@f$, for arbitrary times.
+ *  - `CLQMC_BROWNIAN_PCA`: the path is the sum of the principal components of
+ *    its covariance matrix weighted by @f$z_0, z_1, \dots@f$, in decreasing
+ *    order of variance @cite vACW98a , which maximizes the variance explained
+ *    by the first coordinates.  It requires equally spaced times, for which
+ *    the eigenvectors are sine functions, so only a table of @f$O(d)@f$
+ *    values is stored instead of a @f$d \times d@f$ matrix; the cost is
+ *    @f$O(d^2)@f$.
+ *
+ *  The path object holds the precomputed coefficients of the transformation.
+ *  Like lattice rules, it is a single block of memory of the size returned
+ *  by clqmcBrownianPathCreate(), which can be copied as is into a device
+ *  buffer and passed to kernels as a `__constant` argument (see
+ *  brownian.clh).
+ *  Constant memory is limited (64 KiB on most devices), which allows paths
+ *  of about 1600 steps for the PCA and 1800 steps for the bridge in double
+ *  precision.
+ *
+ *  Example kernel code:
+ *  @code
+ *  #include <clQMC/brownian.clh>
+ *
+ *  __kernel void simulate(__global const clqmcLatticeRule* lattice,
+ *                         __global const clqmc_fptype* shift,
+ *                         __constant const clqmcBrownianPath* path,
+ *                         __global clqmc_fptype* out)
+ *  {
+ *    clqmcLatticeRuleStream stream;
+ *    clqmcLatticeRuleCreateOverStream(&stream, lattice, get_global_size(0), get_global_id(0), shift);
+ *    clqmc_fptype w[STEPS];
+ *    clqmcBrownianPathNextPath(path, &stream, w);
+ *    ...
+ *  }
+ *  @endcode
+ */
+
+#pragma once
+#ifndef CLQMC_BROWNIAN_H
+#define CLQMC_BROWNIAN_H
+
+#include <clQMC/clQMC.h>
+#include <clQMC/latticerule.h>
+
+struct clqmcBrownianPath_;
+
+/*! @brief Brownian path construction object
+ *
+ *  Stores the number of steps, the construction method and the precomputed
+ *  coefficients of the construction, in the precision of `clqmc_fptype`.
+ */
+typedef struct clqmcBrownianPath_ clqmcBrownianPath;
+
+// the construction methods are needed by the declarations below
+#include <clQMC/private/brownian.types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define clqmcBrownianPathCreate         _CLQMC_TAG_FPTYPE(clqmcBrownianPathCreate)
+#define clqmcBrownianPathFromNormals    _CLQMC_TAG_FPTYPE(clqmcBrownianPathFromNormals)
+#define clqmcBrownianPathNextPath       _CLQMC_TAG_FPTYPE(clqmcBrownianPathNextPath)
+
+/*! @brief Create a Brownian path construction object [**host-only**]
+ *
+ *  @param[in]  steps           Number @f$d@f$ of time steps.
+ *  @param[in]  times           Increasing positive times
+ *                              @f$t_1,\dots,t_d@f$, or `NULL` for
+ *                              @f$t_i = i/d@f$.
+ *  @param[in]  construction    Construction method; `CLQMC_BROWNIAN_PCA`
+ *                              requires equally spaced times, i.e.,
+ *                              @f$t_i = i t_1@f$.
+ *  @param[out] objectSize      Size in bytes of the returned object, or
+ *                              `NULL`.
+ *  @param[out] err             Error status variable, or `NULL`.
+ *
+ *  @return New path object, or `NULL` on error.
+ */
+CLQMCAPI clqmcBrownianPath* clqmcBrownianPathCreate             (cl_uint steps, const cl_double* times, clqmcBrownianConstruction construction, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcBrownianPath* clqmcBrownianPathCreate_clqmc_float (cl_uint steps, const cl_double* times, clqmcBrownianConstruction construction, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcBrownianPath* clqmcBrownianPathCreate_clqmc_double(cl_uint steps, const cl_double* times, clqmcBrownianConstruction construction, size_t* objectSize, clqmcStatus* err);
+
+/*! @brief Destroy a Brownian path construction object [**host-only**]
+ *
+ *  @param[in]  path    Path object, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcBrownianPathDestroy(clqmcBrownianPath* path);
+
+/*! @brief Return the number of time steps [**device**]
+ */
+CLQMCAPI cl_uint clqmcBrownianPathSteps(const clqmcBrownianPath* path);
+
+/*! @brief Build a path from given standard normal variates [**device**]
+ *
+ *  @param[in]  path    Path object.
+ *  @param[in]  z       Array of @f$d@f$ standard normal variates, the most
+ *                      important first.
+ *  @param[out] w       Array of the @f$d@f$ values
+ *                      @f$W(t_1),\dots,W(t_d)@f$; it must not overlap `z`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcBrownianPathFromNormals             (const clqmcBrownianPath* path, const _CLQMC_FPTYPE* z, _CLQMC_FPTYPE* w);
+CLQMCAPI clqmcStatus clqmcBrownianPathFromNormals_clqmc_float (const clqmcBrownianPath* path, const cl_float*      z, cl_float*      w);
+CLQMCAPI clqmcStatus clqmcBrownianPathFromNormals_clqmc_double(const clqmcBrownianPath* path, const cl_double*     z, cl_double*     w);
+
+/*! @brief Build a path from the next coordinates of a stream [**device**]
+ *
+ *  Read @f$d@f$ coordinates from `stream` with clqmcLatticeRuleNextNormal()
+ *  and use them as @f$z_0,\dots,z_{d-1}@f$, without an intermediate array.
+ *  The stream is not forwarded to the next point.
+ *
+ *  @param[in]      path    Path object.
+ *  @param[in,out]  stream  Lattice rule stream, with at least @f$d@f$
+ *                          coordinates left in the current point (see also
+ *                          clqmcLatticeRuleSetPadding()).
+ *  @param[out]     w       Array of the @f$d@f$ values
+ *                          @f$W(t_1),\dots,W(t_d)@f$.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcBrownianPathNextPath             (const clqmcBrownianPath* path, clqmcLatticeRuleStream* stream, _CLQMC_FPTYPE* w);
+CLQMCAPI clqmcStatus clqmcBrownianPathNextPath_clqmc_float (const clqmcBrownianPath* path, clqmcLatticeRuleStream* stream, cl_float*      w);
+CLQMCAPI clqmcStatus clqmcBrownianPathNextPath_clqmc_double(const clqmcBrownianPath* path, clqmcLatticeRuleStream* stream, cl_double*     w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
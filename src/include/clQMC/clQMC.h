@@ -162,14 +162,23 @@
  *  The result is called a **randomly-shifted rank-1 lattice rule**.
  *  See @cite vLEC00b and @cite vLEC12a .
  *
+ *  The baker's transformation @f$u \mapsto 1 - |2u - 1|@f$ can be applied to
+ *  each coordinate after the random shift.
+ *  It is equivalent to periodizing the integrand and, for smooth integrands,
+ *  improves the convergence rate of the variance from @f$O(n^{-2+\epsilon})@f$
+ *  to @f$O(n^{-4+\epsilon})@f$ at the cost of a few arithmetic operations per
+ *  coordinate @cite vHIC02a .
+ *  It is enabled on a lattice rule stream with
+ *  clqmcLatticeRuleSetBakerTransform().
+ *
  *
  *  @section examples Usage Examples: From Monte Carlo to Randomized Quasi-Monte Carlo
  *
  *  We show here how existing Monte Carlo code that uses
  *  [clRNG](https://github.com/clMathLibraries/clRNG) streams can be adapted to
  *  quasi-Monte Carlo methods by using clQMC streams instead.
- *  We further show how to combine clQMC and clRNG streams to apply randomized
- *  quasi-Monte Carlo.
+ *  We further show how to apply randomized quasi-Monte Carlo with the random
+ *  shifts generated by clQMC.
  *
  *
  *  @subsection examples_model Example Model
@@ -314,6 +323,11 @@
  *  @endcode
  *  The resulting object `pointset`, of size `pointset_size` in bytes, can be
  *  copied to the device using standard OpenCL techniques (not shown here).
+ *  Alternatively, a generating vector for @f$n = 2^k@f$ points can be taken
+ *  from the catalogue of the library:
+ *  @code
+ *  clqmcLatticeRule* pointset = clqmcLatticeRuleCreateFromCatalogue(k, DIMENSION, CLQMC_LATTICE_CBC_POLY, &pointset_size, &err);
+ *  @endcode
  *
  *  The complete code for this example is given in @ref DocsTutorial/example2.c
  *  and @ref DocsTutorial/example2_kernel.cl.
@@ -330,10 +344,17 @@
  *  @f$\boldsymbol U_i@f$ it was assigned.
  *  Each realization requires a distinct random @f$\boldsymbol U@f$, and it is
  *  the same for all points, so it is the same for all work items.
- *  We thus store the random shifts in advance on the host and copy them into
- *  the device's global memory in an array named `shifts`, composed of
- *  `replications` tuples of `DIMENSION` values (one for each point and each
- *  coordinate).
+ *  We thus generate the random shifts in advance into the device's global
+ *  memory, in an array named `shifts` composed of `replications` tuples of
+ *  `DIMENSION` values (one for each replication and each coordinate), with
+ *  the generator of randomshift.h:
+ *  @code
+ *  clqmcRandomShiftGenerator* generator = clqmcRandomShiftGeneratorCreate(context, device, &err);
+ *  err = clqmcRandomShiftGeneratorEnqueue(generator, queue, SHIFTS_SEED,
+ *    0, replications, DIMENSION, shifts_buf, 0, NULL, &ev_shifts);
+ *  @endcode
+ *  The shifts never transit through the host, and the shift of replication
+ *  `k` depends only on the seed and on `k`.
  *
  *  In the kernel code, for each replication of index `k`, we create a new
  *  lattice rule stream using the `k`-th random shift vector:
@@ -356,8 +377,9 @@
  *  size `get_global_size(0)` (one for each replication).
  *
  *  In very high dimension, it might be preferable not to store all the random
- *  shifts in advance but to pass random streams to the kernel and let the work
- *  items generate the single shift they need at the moment they need it.
+ *  shifts in advance but to let the work items generate the shift coordinates
+ *  they need at the moment they need them, with
+ *  clqmcRandomShiftCoordinate() from `clQMC/randomshift.clh`.
  *
  *  The complete code for this example is given in @ref DocsTutorial/example3.c
  *  and @ref DocsTutorial/example3_kernel.cl.
@@ -399,6 +421,21 @@
  *  The complete code for this example is given in @ref DocsTutorial/example4.c
  *  and @ref DocsTutorial/example4_kernel.cl.
  *
+ *  The best values of `nw` and `rw` and the best work-group size depend on
+ *  the device.
+ *  With the `--autotune` option, examples 3 and 4 select them with an
+ *  autotuner (see `clQMC/autotune.h`), which times short launches of the
+ *  kernel over candidate values and stores the fastest configuration in a
+ *  cache file of the device for subsequent runs.
+ *
+ *  Instead of deriving the assignment from the global index in the kernel,
+ *  the host can also precompute it in an array of clqmcLatticeRuleHostStream
+ *  (e.g., with clqmcLatticeRuleCreateHostStreams()), copy it into a device
+ *  buffer `hostStreams`, and let each work item load its stream with
+ *  @code
+ *  clqmcLatticeRuleCopyOverStreamsFromGlobal(1, &stream, &hostStreams[gid], pointset, shifts);
+ *  @endcode
+ *
  *  This example is very general because it allows the extreme cases where each
  *  work item to takes care of all randomizations at single point and where
  *  each work item takes care of a single randomization at all points, and of
@@ -409,17 +446,95 @@
  *  estimate the variance of @f$\hat\mu_{\mathrm{rqmc}}@f$.
  *
  *
+ *  @subsection examples_rqmc_vec Example 5: Vector-Valued Integrands
+ *
+ *  When several functions must be integrated with the same point set, e.g.,
+ *  the payoffs of many financial instruments that depend on the same
+ *  simulated paths, each point should be generated once and used to evaluate
+ *  all functions, instead of running the simulation once per function.
+ *  We modify @ref examples_rqmc so that the model returns a vector of
+ *  `OUTPUTS` values per point, with the function `simulateOneRunVector()` of
+ *  @ref DocsTutorial/common.clh, where `OUTPUTS` is defined by the host
+ *  program when it builds the kernel (with the compiler option
+ *  `-DOUTPUTS=m`).
+ *  The kernel accumulates output `c` for replication `k` directly into
+ *  @code
+ *  out[(k * OUTPUTS + c) * get_global_size(0) + get_global_id(0)]
+ *  @endcode
+ *  and divides it by the number of points of the work item at the end, so
+ *  that the private memory used does not grow with the number of outputs,
+ *  consecutive work items access consecutive memory locations, and
+ *  the averages of each output and replication are contiguous for the
+ *  reduction on the host.
+ *  The host then reports the mean and the variance across replications of
+ *  each output.
+ *
+ *  The complete code for this example is given in @ref DocsTutorial/example5.c
+ *  and @ref DocsTutorial/example5_kernel.cl.
+ *
+ *
  *  @section configuration Configuration
  *
  *  @subsection environment Environment variables
  *
- *  For all features of the library to work properly, the `CLQMC_ROOT`
- *  environment variable must be set to point to the installation path of the
- *  clQMC package, that is, the directory under which lies the
+ *  The `CLQMC_ROOT` environment variable points to the installation path of
+ *  the clQMC package, that is, the directory under which lies the
  *  `include/clQMC` subdirectory.
+ *  It is used by clqmcGetLibraryDeviceIncludes() and by the client programs
+ *  distributed with clQMC to locate their kernel files.
+ *  The library itself does not need it: the device headers are compiled into
+ *  the library and inserted into the programs that it builds by
+ *  clqmcCreateProgramWithSource(), which user programs can also call instead
+ *  of passing the include option to the compiler.
  *  Means of setting an environment variable depend on the operating system
  *  used.
  *
+ *  The client programs distributed with clQMC also read the `CLQMC_PROFILE`
+ *  environment variable: if it is set, the OpenCL commands and the main host
+ *  steps (program builds, host reductions) are timed with the profiler
+ *  described in profiling.h; a Chrome trace is written to the file named by
+ *  `CLQMC_PROFILE` and a summary table is written to standard error.
+ *
+ *  @subsection device_options Device-side options
+ *
+ *  The following preprocessor symbols can be defined in device code before
+ *  including the clQMC device header files:
+ *
+ *  - `CLQMC_SINGLE_PRECISION`: use single precision (`float`) instead of
+ *    double precision for the floating-point types of the API;
+ *  - `CLQMC_DISABLE_CHECKS`: remove the validation of the arguments from the
+ *    device functions, e.g., clqmcLatticeRuleCreateOverStream(), which then
+ *    always return `CLQMC_SUCCESS`.
+ *    Invalid arguments result in undefined behavior.
+ *    Host functions always validate their arguments.
+ *
+ *  For example, the device code of @ref examples_rqmc could begin with:
+ *  @code
+ *  #define CLQMC_DISABLE_CHECKS
+ *  #include <clQMC/latticerule.clh>
+ *  @endcode
+ *  To skip the validation in a single call site only, use
+ *  clqmcLatticeRuleCreateOverStreamUnchecked() instead.
+ *
+ *  @subsection host_options Host-side options
+ *
+ *  The following preprocessor symbols can be defined in host code before
+ *  including the clQMC host header files:
+ *
+ *  - `CLQMC_INLINE_STREAMS`: define clqmcLatticeRuleNextCoordinate(),
+ *    clqmcLatticeRuleForwardToNextPoint(),
+ *    clqmcLatticeRuleCurrentPointIndex() and
+ *    clqmcLatticeRuleCurrentCoordIndex() as `static inline` functions in the
+ *    including translation unit, instead of calling those of the library, so
+ *    that the compiler can inline them into the loops that enumerate the
+ *    points.
+ *    The layouts of the lattice rule and stream objects then become part of
+ *    the compiled client code, which must be rebuilt when the library is
+ *    upgraded.
+ *  - `CLQMC_DLL`: on Windows, the client uses the clQMC DLL.
+ *    The `clQMC` CMake target defines it for its users when the library is
+ *    built with `BUILD_SHARED_LIBRARY`.
+ *
  *
  *  @section mem_types Device memory types
  *
@@ -486,6 +601,15 @@
  *  @see DocsTutorial/example4.c
  */
 
+/*! @example DocsTutorial/example5.c
+ *  @brief Host code for @ref examples_rqmc_vec
+ *  @see DocsTutorial/example5_kernel.cl
+ */
+/*! @example DocsTutorial/example5_kernel.cl
+ *  @brief Device code for @ref examples_rqmc_vec
+ *  @see DocsTutorial/example5.c
+ */
+
 
 /*! @file clQMC.h
  *  @brief Library definitions.
@@ -520,8 +644,21 @@ typedef cl_ulong    clqmc_ulong;
 #define _CLQMC_TAG_FPTYPE__(name,fptype)  name##_##fptype
 
 
+// Visibility of the library functions.  When the library is built as a
+// shared library, clQMC_EXPORTS is defined by CMake, and clients of the DLL
+// on Windows must define CLQMC_DLL (the clQMC CMake target does it).
+// Elsewhere, the library is compiled with hidden visibility by default, so
+// only the functions marked with CLQMCAPI are exported.
 #if defined( _WIN32 )
-	#define CLQMCAPI __declspec( dllexport )
+	#if defined( clQMC_EXPORTS )
+		#define CLQMCAPI __declspec( dllexport )
+	#elif defined( CLQMC_DLL )
+		#define CLQMCAPI __declspec( dllimport )
+	#else
+		#define CLQMCAPI
+	#endif
+#elif defined( __GNUC__ ) && __GNUC__ >= 4
+	#define CLQMCAPI __attribute__(( visibility( "default" ) ))
 #else
 	#define CLQMCAPI
 #endif
@@ -557,23 +694,43 @@ extern "C" {
  *
  *  The buffer containing the error message is internally allocated and must
  *  not be freed by the client.
+ *  Each thread has its own error message: the returned buffer contains the
+ *  last error that occurred in the calling thread, and it remains valid until
+ *  the thread exits.
  *
  *  @return     Error message or `NULL`.
  */
-const char* clqmcGetErrorString();
+CLQMCAPI const char* clqmcGetErrorString();
+
+/*! @brief Copy the last error message into a caller-provided buffer.
+ *
+ *  Reentrant variant of clqmcGetErrorString().
+ *  The message is truncated to fit into `bufSize` bytes, including the
+ *  terminating null character.
+ *
+ *  @param[out]     buf         Destination buffer.
+ *  @param[in]      bufSize     Size in bytes of `buf`.
+ *
+ *  @return Length of the complete message (excluding the terminating null
+ *  character); the message was truncated if this value is not smaller than
+ *  `bufSize`.
+ */
+CLQMCAPI size_t clqmcCopyErrorString(char* buf, size_t bufSize);
 
 /*! @brief Generate an include option string for use with the OpenCL C compiler
  *
  *  Generate and return "-I${CLQMC_ROOT}/include", where \c ${CLQMC_ROOT} is
  *  the value of the \c CLQMC_ROOT environment variable.
  *  This string is meant to be passed as an option to the OpenCL C compiler for
- *  programs that make use of the clQMC device-side headers.
+ *  programs that make use of the clQMC device-side headers; it is not needed
+ *  for programs created with clqmcCreateProgramWithSource(), unless they
+ *  include other files installed with clQMC.
  *  If the \c CLQMC_ROOT environment variable is not defined, it defaults
  *  `/usr` if the file `/usr/include/clQMC/clQMC.h` exists, else to the current
  *  directory of execution of the program.
  *
- *  A static buffer is return and need not be released; it could change upon
- *  successive calls to the function.
+ *  A thread-local buffer is returned and need not be released; it could
+ *  change upon successive calls to the function from the same thread.
  *
  *  An error is returned in \c err if the preallocated buffer is too small to
  *  contain the include string.
@@ -583,7 +740,93 @@ const char* clqmcGetErrorString();
  *  @return An OpenCL C compiler option to indicate where to find the
  *  device-side clQMC headers.
  */
-const char* clqmcGetLibraryDeviceIncludes(cl_int* err);
+CLQMCAPI const char* clqmcGetLibraryDeviceIncludes(cl_int* err);
+
+/*! @brief Write the include option string into a caller-provided buffer.
+ *
+ *  Reentrant variant of clqmcGetLibraryDeviceIncludes().
+ *
+ *  An error is returned in \c err if `buf` is too small to contain the
+ *  include string.
+ *
+ *  @param[out]     buf         Destination buffer.
+ *  @param[in]      bufSize     Size in bytes of `buf`.
+ *  @param[out]     err         Error status variable, or `NULL`.
+ *
+ *  @return `buf` on success, `NULL` on error.
+ */
+CLQMCAPI const char* clqmcCopyLibraryDeviceIncludes(char* buf, size_t bufSize, cl_int* err);
+
+/*! @brief Create a program with the device headers of the library
+ *
+ *  Create an OpenCL program from the given sources, as
+ *  clCreateProgramWithSource() does, after replacing each `#include`
+ *  directive that names a device header of clQMC (e.g.,
+ *  `#include <clQMC/latticerule.clh>`) with the contents of the header.
+ *  The headers are compiled into the library, so the program can be built
+ *  without the `-I` option returned by clqmcGetLibraryDeviceIncludes(),
+ *  without reading the headers from the file system and without setting
+ *  `CLQMC_ROOT`; other `#include` directives are left to the OpenCL C
+ *  compiler.
+ *  The inserted headers are delimited with `#line` directives, so the build
+ *  log refers to the lines of the headers and of the original sources (named
+ *  `<source>`, unless the sources name themselves with `#line`).
+ *
+ *  The hash returned in `hash` identifies the expanded source, including the
+ *  version of the headers; along with the device and the build options, it
+ *  can serve as the key of a cache of program binaries.
+ *
+ *  @param[in]  context     OpenCL context.
+ *  @param[in]  count       Number of source strings.
+ *  @param[in]  strings     Source strings, concatenated as by
+ *                          clCreateProgramWithSource().
+ *  @param[in]  lengths     Lengths of the source strings, or `NULL` if they
+ *                          are null-terminated; a zero length also denotes a
+ *                          null-terminated string.
+ *  @param[out] hash        64-bit FNV-1a hash of the expanded source, or
+ *                          `NULL`.
+ *  @param[out] err         Error status variable, or `NULL`.
+ *
+ *  @return New program object, to be released with clReleaseProgram(), or
+ *  `NULL` on error.
+ */
+CLQMCAPI cl_program clqmcCreateProgramWithSource(cl_context context, cl_uint count, const char** strings, const size_t* lengths,
+    cl_ulong* hash, clqmcStatus* err);
+
+/*! @brief Build a program with the device headers of the library, through a cache
+ *
+ *  Create a program as clqmcCreateProgramWithSource() does and build it for
+ *  `device` with `options`, unless a program with the same context, device,
+ *  expanded source (compared by hash) and options was already built by this
+ *  function, in which case that program is returned instead.
+ *  The cache lives in the memory of the process and is safe to use from
+ *  multiple threads; it holds a reference to each program, and thus to its
+ *  context, until clqmcReleaseProgramCache() is called.
+ *
+ *  @param[in]  context     OpenCL context.
+ *  @param[in]  device      OpenCL device of the context.
+ *  @param[in]  count       Number of source strings.
+ *  @param[in]  strings     Source strings.
+ *  @param[in]  lengths     Lengths of the source strings, or `NULL`; see
+ *                          clqmcCreateProgramWithSource().
+ *  @param[in]  options     Build options, or `NULL`.
+ *  @param[out] err         Error status variable, or `NULL`; the build log
+ *                          is included in the error string if the build
+ *                          fails.
+ *
+ *  @return Built program, to be released with clReleaseProgram(), or `NULL`
+ *  on error.
+ */
+CLQMCAPI cl_program clqmcBuildProgramWithSource(cl_context context, cl_device_id device, cl_uint count, const char** strings, const size_t* lengths,
+    const char* options, clqmcStatus* err);
+
+/*! @brief Release the programs of the cache of clqmcBuildProgramWithSource()
+ *
+ *  The programs that are still referenced elsewhere remain valid.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcReleaseProgramCache(void);
 
 /*! @brief Retrieve the library installation path
  *
@@ -591,7 +834,7 @@ const char* clqmcGetLibraryDeviceIncludes(cl_int* err);
  *  `/usr` if the file `/usr/include/clQMC/clQMC.h` exists; or, the current
  *  directory (.) of execution of the program otherwise.
  */
-const char* clqmcGetLibraryRoot();
+CLQMCAPI const char* clqmcGetLibraryRoot();
 
 #ifdef __cplusplus
 }
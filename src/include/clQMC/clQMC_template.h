@@ -101,7 +101,8 @@ cl_uint clqmcDimension(const clqmcPointset* pointset);
  *
  *  @return Newly created point set object.
  *
- *  @see clqmcLatticeRuleCreate(), clqmcLatticeRuleCreateKorobov()
+ *  @see clqmcLatticeRuleCreate(), clqmcLatticeRuleCreateKorobov(),
+ *  clqmcLatticeRuleCreateFromCatalogue()
  */
 clqmcPointset* clqmcCreate(..., size_t* objectSize, clqmcStatus* err);
 
@@ -167,6 +168,61 @@ clqmcStatus clqmcCreateOverStream(clqmcPointsetStream* stream, const clqmcPoints
 clqmcStatus clqmcDestroyStream(clqmcPointsetStream* stream);
 
 
+/*! @brief Attach an array of new streams to a point set object
+ *
+ *  This function performs a single allocation for `partCount * replications`
+ *  contiguous stream objects and calls clqmcCreateOverStreams() to actually
+ *  create them.
+ *  The returned array must be released with clqmcDestroyStreams().
+ *
+ *  @param[in]	pointset    	Point set object to attach the new streams to.
+ *  @param[in]	partCount   	Number of subsets of equal cardinality into which
+ *			    	pointset must be partitioned.
+ *  @param[in]	replications	Number of randomizations.
+ *  @param[in]  randomizations  Array of `replications` randomizations of an
+ *				appropriate type, or `NULL` for no randomization.
+ *  @param[out] bufSize		Size in bytes of the returned array (can be `NULL`).
+ *  @param[out] err         	Error status.
+ *
+ *  @return Array of `partCount * replications` stream objects.
+ *
+ *  @see clqmcCreateOverStreams()
+ */
+clqmcPointsetStream* clqmcCreateStreams(const clqmcPointset* pointset, cl_uint partCount, cl_uint replications, const RandType* randomizations, size_t* bufSize, clqmcStatus* err);
+
+
+/*! @brief Attach an array of new streams to a point set object in already allocated memory
+ *
+ *  This function does not allocate memory; it uses the caller-provided array
+ *  `streams`, which must have room for `partCount * replications` stream
+ *  objects (for example, a slice of a larger arena).
+ *  The stream of index `k * partCount + p` enumerates the subset of index `p`
+ *  of the point set, under the randomization of index `k`.
+ *  The arguments are validated once for the whole array.
+ *
+ *  @param[out]	streams		Memory location that will hold the new stream objects.
+ *  @param[in]	pointset    	Point set object to attach the new streams to.
+ *  @param[in]	partCount   	Number of subsets of equal cardinality into which
+ *			    	pointset must be partitioned.
+ *  @param[in]	replications	Number of randomizations.
+ *  @param[in]  randomizations  Array of `replications` randomizations of an
+ *				appropriate type, or `NULL` for no randomization.
+ *
+ *  @return Error status.
+ *
+ *  @see clqmcCreateOverStream()
+ */
+clqmcStatus clqmcCreateOverStreams(clqmcPointsetStream* streams, const clqmcPointset* pointset, cl_uint partCount, cl_uint replications, const RandType* randomizations);
+
+
+/*! @brief Destroy an array of stream objects
+ *
+ *  Release the resources associated to an array of stream objects created
+ *  with clqmcCreateStreams().
+ */
+clqmcStatus clqmcDestroyStreams(clqmcPointsetStream* streams);
+
+
 /*! @brief Return the value of the next coordinate [**device**]
  *
  *  Advance the stream to the next coordinate of the current point and return
@@ -0,0 +1,504 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/*! @file clqmc.hpp
+ *  @brief C++17 host interface for lattice rules [**host-only**]
+ *
+ *  Header-only wrapper around latticerule.h.
+ *  The floating-point type is a template parameter instead of being selected
+ *  with `CLQMC_SINGLE_PRECISION`, and the dimension can optionally be fixed
+ *  at compile time, in which case the loops over the coordinates have
+ *  constant bounds.
+ *  Errors are reported by throwing clqmc::Error.
+ *
+ *  The points of a lattice rule are accessed by index or through iterators
+ *  over a range of points.
+ *  Iterators dereference to point proxies returned by value, so they are
+ *  only input iterators to the algorithms of C++17, which cannot run them in
+ *  parallel; in C++20, they model std::random_access_iterator.
+ *  To process the points with the parallel algorithms of the standard
+ *  library, iterate over the point indices instead:
+ *  @code
+ *  #include <clQMC/clqmc.hpp>
+ *  #include <execution>
+ *  #include <numeric>
+ *  #include <vector>
+ *
+ *  auto lattice = clqmc::LatticeRule<double, 8>::fromCatalogue(16, CLQMC_LATTICE_CBC_POLY);
+ *  auto points  = lattice.points(shift);   // shift: array of 8 doubles, or nullptr
+ *  std::vector<std::size_t> indices(points.size());
+ *  std::iota(indices.begin(), indices.end(), std::size_t(0));
+ *  double sum = std::transform_reduce(std::execution::par_unseq,
+ *      indices.begin(), indices.end(), 0.0, std::plus<>(),
+ *      [&points](std::size_t i) {
+ *        auto u = points[i];
+ *        double prod = 1.0;
+ *        for (std::size_t j = 0; j < u.size(); j++)
+ *          prod *= 3 * u[j] * u[j];
+ *        return prod;
+ *      });
+ *  double estimate = sum / lattice.numPoints();
+ *  @endcode
+ *
+ *  The coordinates are computed in the same way as
+ *  clqmcLatticeRuleNextCoordinate(), so they are identical to those produced
+ *  by the C API on the host and on the device, for the same floating-point
+ *  type.
+ *  Iterators dereference to point proxies (clqmc::Point) that are returned by
+ *  value and compute the coordinates on demand; they hold no reference to
+ *  mutable state, so they can be used concurrently.
+ */
+
+#pragma once
+#ifndef CLQMC_HPP
+#define CLQMC_HPP
+
+#include <clQMC/latticerule.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace clqmc {
+
+/*! @brief Value of the dimension template parameter for a dimension selected at run time
+ */
+inline constexpr std::size_t dynamicDimension = static_cast<std::size_t>(-1);
+
+/*! @brief Exception thrown on errors of the C API
+ *
+ *  The message is the error string of the C API (see clqmcGetErrorString()).
+ */
+class Error : public std::runtime_error {
+public:
+  explicit Error(clqmcStatus status)
+    : std::runtime_error(clqmcGetErrorString() ? clqmcGetErrorString() : "clQMC error"),
+      status_(status)
+  {}
+
+  //! Error status of the C API
+  clqmcStatus status() const noexcept { return status_; }
+
+private:
+  clqmcStatus status_;
+};
+
+
+namespace detail {
+
+  inline void check(clqmcStatus err)
+  {
+    if (err != CLQMC_SUCCESS)
+      throw Error(err);
+  }
+
+  // Dispatch to the tagged functions of the C API
+  template <typename T> struct Api;
+
+  template <> struct Api<float> {
+    static clqmcLatticeRule* create(cl_uint n, cl_uint s, const cl_int* a, size_t* size, clqmcStatus* err)
+    { return clqmcLatticeRuleCreate_clqmc_float(n, s, a, size, err); }
+    static clqmcLatticeRule* createKorobov(cl_uint n, cl_uint s, cl_int a, size_t* size, clqmcStatus* err)
+    { return clqmcLatticeRuleCreateKorobov_clqmc_float(n, s, a, size, err); }
+    static clqmcLatticeRule* createFromCatalogue(cl_uint k, cl_uint s, clqmcLatticeRuleFamily family, size_t* size, clqmcStatus* err)
+    { return clqmcLatticeRuleCreateFromCatalogue_clqmc_float(k, s, family, size, err); }
+    static clqmcStatus createOverStream(clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const float* shift)
+    { return clqmcLatticeRuleCreateOverStream_clqmc_float(stream, lattice, partCount, partIndex, shift); }
+  };
+
+  template <> struct Api<double> {
+    static clqmcLatticeRule* create(cl_uint n, cl_uint s, const cl_int* a, size_t* size, clqmcStatus* err)
+    { return clqmcLatticeRuleCreate_clqmc_double(n, s, a, size, err); }
+    static clqmcLatticeRule* createKorobov(cl_uint n, cl_uint s, cl_int a, size_t* size, clqmcStatus* err)
+    { return clqmcLatticeRuleCreateKorobov_clqmc_double(n, s, a, size, err); }
+    static clqmcLatticeRule* createFromCatalogue(cl_uint k, cl_uint s, clqmcLatticeRuleFamily family, size_t* size, clqmcStatus* err)
+    { return clqmcLatticeRuleCreateFromCatalogue_clqmc_double(k, s, family, size, err); }
+    static clqmcStatus createOverStream(clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const double* shift)
+    { return clqmcLatticeRuleCreateOverStream_clqmc_double(stream, lattice, partCount, partIndex, shift); }
+  };
+
+  struct LatticeDeleter {
+    void operator()(clqmcLatticeRule* lattice) const noexcept { clqmcLatticeRuleDestroy(lattice); }
+  };
+
+  // Dimension, either fixed at compile time or stored
+  template <std::size_t Dim>
+  struct DimensionHolder {
+    explicit DimensionHolder(std::size_t) {}
+    static constexpr std::size_t value() noexcept { return Dim; }
+  };
+
+  template <>
+  struct DimensionHolder<dynamicDimension> {
+    explicit DimensionHolder(std::size_t dimension) : dimension_(dimension) {}
+    std::size_t value() const noexcept { return dimension_; }
+  private:
+    std::size_t dimension_;
+  };
+
+  // Coordinate j of point i; same arithmetic as clqmcLatticeRuleNextCoordinate()
+  template <typename T>
+  inline T coordinate(const T* genVecNormed, const T* shift, bool baker, cl_uint i, std::size_t j) noexcept
+  {
+    T u = genVecNormed[j] * static_cast<T>(i) + (shift ? shift[j] : T(0));
+    u -= std::floor(u);
+    if (baker)
+      u = T(1) - std::fabs(T(2) * u - T(1));
+    return u;
+  }
+
+} // namespace detail
+
+
+/*! @brief Point of a lattice rule
+ *
+ *  Proxy object that computes the coordinates of the point on demand.
+ *  It refers to the normalized generating vector of the lattice rule and to
+ *  the shift, which must outlive it.
+ */
+template <typename T, std::size_t Dim = dynamicDimension>
+class Point {
+public:
+  using value_type = T;
+
+  Point(const T* genVecNormed, const T* shift, std::size_t dimension, bool baker, cl_uint index) noexcept
+    : genVecNormed_(genVecNormed), shift_(shift), dimension_(dimension), baker_(baker), index_(index)
+  {}
+
+  //! Index of the point in the lattice rule
+  cl_uint index() const noexcept { return index_; }
+
+  //! Dimension (constant expression for a compile-time dimension)
+  constexpr std::size_t size() const noexcept { return dimension_.value(); }
+
+  //! Coordinate `j` of the point, with `j < size()`
+  T operator[](std::size_t j) const noexcept
+  {
+    return detail::coordinate(genVecNormed_, shift_, baker_, index_, j);
+  }
+
+  //! Write the `size()` coordinates of the point to `out`
+  template <typename OutputIt>
+  OutputIt copy(OutputIt out) const
+  {
+    for (std::size_t j = 0; j < size(); j++)
+      *out++ = (*this)[j];
+    return out;
+  }
+
+  //! Coordinates of the point, for a compile-time dimension
+  template <std::size_t D = Dim, typename = std::enable_if_t<D != dynamicDimension>>
+  std::array<T, D> toArray() const noexcept
+  {
+    std::array<T, D> u;
+    for (std::size_t j = 0; j < D; j++)
+      u[j] = (*this)[j];
+    return u;
+  }
+
+private:
+  const T* genVecNormed_;
+  const T* shift_;
+  detail::DimensionHolder<Dim> dimension_;
+  bool baker_;
+  cl_uint index_;
+};
+
+
+/*! @brief Iterator over the points of a lattice rule
+ *
+ *  Dereferencing returns a clqmc::Point by value.
+ *  Since the reference type is not a reference, the iterator is only an
+ *  input iterator to the algorithms of C++17 and earlier, although it
+ *  supports all the operations of a random-access iterator; in C++20, it
+ *  models std::random_access_iterator.
+ */
+template <typename T, std::size_t Dim = dynamicDimension>
+class PointIterator {
+public:
+  using iterator_category = std::input_iterator_tag;
+#if __cplusplus >= 202002L
+  using iterator_concept  = std::random_access_iterator_tag;
+#endif
+  using value_type        = Point<T, Dim>;
+  using difference_type   = std::ptrdiff_t;
+  using pointer           = void;
+  using reference         = Point<T, Dim>;
+
+  PointIterator() noexcept : genVecNormed_(nullptr), shift_(nullptr), dimension_(0), baker_(false), index_(0) {}
+
+  PointIterator(const T* genVecNormed, const T* shift, std::size_t dimension, bool baker, cl_uint index) noexcept
+    : genVecNormed_(genVecNormed), shift_(shift), dimension_(dimension), baker_(baker), index_(index)
+  {}
+
+  reference operator*() const noexcept { return Point<T, Dim>(genVecNormed_, shift_, dimension_.value(), baker_, index_); }
+  reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+  PointIterator& operator++() noexcept { ++index_; return *this; }
+  PointIterator& operator--() noexcept { --index_; return *this; }
+  PointIterator  operator++(int) noexcept { PointIterator it = *this; ++index_; return it; }
+  PointIterator  operator--(int) noexcept { PointIterator it = *this; --index_; return it; }
+  PointIterator& operator+=(difference_type n) noexcept { index_ = static_cast<cl_uint>(index_ + n); return *this; }
+  PointIterator& operator-=(difference_type n) noexcept { index_ = static_cast<cl_uint>(index_ - n); return *this; }
+
+  friend PointIterator operator+(PointIterator it, difference_type n) noexcept { return it += n; }
+  friend PointIterator operator+(difference_type n, PointIterator it) noexcept { return it += n; }
+  friend PointIterator operator-(PointIterator it, difference_type n) noexcept { return it -= n; }
+  friend difference_type operator-(const PointIterator& a, const PointIterator& b) noexcept
+  { return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_); }
+
+  friend bool operator==(const PointIterator& a, const PointIterator& b) noexcept { return a.index_ == b.index_; }
+  friend bool operator!=(const PointIterator& a, const PointIterator& b) noexcept { return a.index_ != b.index_; }
+  friend bool operator< (const PointIterator& a, const PointIterator& b) noexcept { return a.index_ <  b.index_; }
+  friend bool operator> (const PointIterator& a, const PointIterator& b) noexcept { return a.index_ >  b.index_; }
+  friend bool operator<=(const PointIterator& a, const PointIterator& b) noexcept { return a.index_ <= b.index_; }
+  friend bool operator>=(const PointIterator& a, const PointIterator& b) noexcept { return a.index_ >= b.index_; }
+
+private:
+  const T* genVecNormed_;
+  const T* shift_;
+  detail::DimensionHolder<Dim> dimension_;
+  bool baker_;
+  cl_uint index_;
+};
+
+
+/*! @brief Range of consecutive points of a lattice rule
+ *
+ *  Returned by LatticeRule::points().
+ *  It refers to the lattice rule and to the shift, which must outlive it.
+ */
+template <typename T, std::size_t Dim = dynamicDimension>
+class PointRange {
+public:
+  using iterator   = PointIterator<T, Dim>;
+  using value_type = Point<T, Dim>;
+
+  PointRange(iterator first, iterator last) noexcept : first_(first), last_(last) {}
+
+  iterator begin() const noexcept { return first_; }
+  iterator end()   const noexcept { return last_; }
+  std::size_t size() const noexcept { return static_cast<std::size_t>(last_ - first_); }
+  value_type operator[](std::size_t i) const noexcept { return first_[static_cast<std::ptrdiff_t>(i)]; }
+
+private:
+  iterator first_;
+  iterator last_;
+};
+
+
+/*! @brief Rank-1 lattice rule
+ *
+ *  Owns a lattice rule object of the C API, which is destroyed with the
+ *  wrapper; the wrapper can be moved but not copied.
+ *
+ *  @tparam T       Floating-point type of the coordinates (`float` or
+ *                  `double`); it is also the type of the normalized
+ *                  generating vector stored in the C object, so that the
+ *                  object can be copied to a device where the same type is
+ *                  selected.
+ *  @tparam Dim     Dimension, or clqmc::dynamicDimension to select it at run
+ *                  time.
+ */
+template <typename T, std::size_t Dim = dynamicDimension>
+class LatticeRule {
+  static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+                "clqmc::LatticeRule: T must be float or double");
+  static_assert(Dim > 0, "clqmc::LatticeRule: the dimension must be positive");
+
+public:
+  using value_type = T;
+  using point_type = Point<T, Dim>;
+  using iterator   = PointIterator<T, Dim>;
+  using range_type = PointRange<T, Dim>;
+
+  //! Dimension fixed at compile time, or clqmc::dynamicDimension
+  static constexpr std::size_t staticDimension = Dim;
+
+  /*! @brief Create a rank-1 lattice rule with a compile-time dimension
+   *
+   *  @see clqmcLatticeRuleCreate()
+   */
+  template <std::size_t D = Dim, typename = std::enable_if_t<D != dynamicDimension>>
+  LatticeRule(cl_uint numPoints, const std::array<cl_int, D>& genVec)
+    : LatticeRule(wrap(detail::Api<T>::create, numPoints, static_cast<cl_uint>(D), genVec.data()))
+  {}
+
+  /*! @brief Create a rank-1 lattice rule with a run-time dimension
+   *
+   *  With a compile-time dimension, `genVec.size()` must be equal to `Dim`.
+   *
+   *  @see clqmcLatticeRuleCreate()
+   */
+  LatticeRule(cl_uint numPoints, const std::vector<cl_int>& genVec)
+    : LatticeRule(wrap(detail::Api<T>::create, numPoints, checkedDimension(genVec.size()), genVec.data()))
+  {}
+
+  /*! @brief Create a Korobov lattice rule
+   *
+   *  For a compile-time dimension, `dimension` must be omitted or equal to
+   *  `Dim`.
+   *
+   *  @see clqmcLatticeRuleCreateKorobov()
+   */
+  static LatticeRule korobov(cl_uint numPoints, cl_int gen, std::size_t dimension = Dim)
+  {
+    return LatticeRule(wrap(detail::Api<T>::createKorobov, numPoints, checkedDimension(dimension), gen));
+  }
+
+  /*! @brief Create a lattice rule with @f$2^k@f$ points from the catalogue
+   *
+   *  For a compile-time dimension, `dimension` must be omitted or equal to
+   *  `Dim`.
+   *
+   *  @see clqmcLatticeRuleCreateFromCatalogue()
+   */
+  static LatticeRule fromCatalogue(cl_uint log2NumPoints, clqmcLatticeRuleFamily family, std::size_t dimension = Dim)
+  {
+    return LatticeRule(wrap(detail::Api<T>::createFromCatalogue, log2NumPoints, checkedDimension(dimension), family));
+  }
+
+  LatticeRule(LatticeRule&&) noexcept = default;
+  LatticeRule& operator=(LatticeRule&&) noexcept = default;
+  LatticeRule(const LatticeRule&) = delete;
+  LatticeRule& operator=(const LatticeRule&) = delete;
+
+  //! Number of points
+  cl_uint numPoints() const noexcept { return lattice_->numPoints; }
+
+  //! Dimension (constant expression for a compile-time dimension)
+  constexpr std::size_t dimension() const noexcept
+  {
+    if constexpr (Dim != dynamicDimension)
+      return Dim;
+    else
+      return lattice_->dimension;
+  }
+
+  //! Underlying object of the C API, e.g., to copy it to a device buffer
+  const clqmcLatticeRule* get() const noexcept { return lattice_.get(); }
+
+  //! Size in bytes of the underlying object
+  std::size_t objectSize() const noexcept { return objectSize_; }
+
+  //! Generating vector
+  const cl_int* genVec() const noexcept { return _CLQMC_LATTICE_GENVEC(lattice_.get(), const); }
+
+  /*! @brief Range of all points
+   *
+   *  @param[in]  shift   Random shift of `dimension()` coordinates, or
+   *                      `nullptr`; it is not copied.
+   *  @param[in]  baker   Apply the baker's transformation after the shift
+   *                      (see clqmcLatticeRuleSetBakerTransform()).
+   */
+  range_type points(const T* shift = nullptr, bool baker = false) const noexcept
+  {
+    return points(1, 0, shift, baker);
+  }
+
+  /*! @brief Range of the points of a part of the lattice rule
+   *
+   *  Same partition as clqmcLatticeRuleCreateOverStream(): part `partIndex`
+   *  contains the `numPoints() / partCount` consecutive points that start at
+   *  index `partIndex * numPoints() / partCount`.
+   *  The number of points must be a multiple of `partCount`, and `partIndex`
+   *  must be smaller than `partCount`.
+   */
+  range_type points(cl_uint partCount, cl_uint partIndex, const T* shift = nullptr, bool baker = false) const
+  {
+    if (partCount == 0 || partIndex >= partCount || numPoints() % partCount != 0)
+      throw std::invalid_argument("clqmc::LatticeRule::points(): invalid partition");
+    cl_uint partSize = numPoints() / partCount;
+    return range_type(makeIterator(shift, baker, partSize * partIndex),
+                      makeIterator(shift, baker, partSize * (partIndex + 1)));
+  }
+
+  //! Point `i` without shift
+  point_type operator[](cl_uint i) const noexcept
+  {
+    return point_type(genVecNormed(), nullptr, dimension(), false, i);
+  }
+
+  /*! @brief Create a stream of the C API over part of the lattice rule
+   *
+   *  @see clqmcLatticeRuleCreateOverStream()
+   */
+  clqmcLatticeRuleStream stream(cl_uint partCount = 1, cl_uint partIndex = 0, const T* shift = nullptr) const
+  {
+    clqmcLatticeRuleStream s;
+    detail::check(detail::Api<T>::createOverStream(&s, lattice_.get(), partCount, partIndex, shift));
+    return s;
+  }
+
+private:
+  using Handle = std::unique_ptr<clqmcLatticeRule, detail::LatticeDeleter>;
+
+  struct Created {
+    Handle lattice;
+    std::size_t objectSize;
+  };
+
+  explicit LatticeRule(Created created)
+    : lattice_(std::move(created.lattice)), objectSize_(created.objectSize)
+  {}
+
+  template <typename F, typename... Args>
+  static Created wrap(F create, Args... args)
+  {
+    std::size_t size = 0;
+    clqmcStatus err = CLQMC_SUCCESS;
+    Handle lattice(create(args..., &size, &err));
+    detail::check(err);
+    return Created{ std::move(lattice), size };
+  }
+
+  static cl_uint checkedDimension(std::size_t dimension)
+  {
+    if constexpr (Dim != dynamicDimension) {
+      if (dimension != Dim)
+        throw std::invalid_argument("clqmc::LatticeRule: the dimension does not match the template argument");
+    }
+    if (dimension == 0 || dimension == dynamicDimension)
+      throw std::invalid_argument("clqmc::LatticeRule: the dimension must be positive");
+    return static_cast<cl_uint>(dimension);
+  }
+
+  const T* genVecNormed() const noexcept { return _CLQMC_LATTICE_GENVECNORMED(lattice_.get(), const, T); }
+
+  iterator makeIterator(const T* shift, bool baker, cl_uint index) const noexcept
+  {
+    return iterator(genVecNormed(), shift, dimension(), baker, index);
+  }
+
+  Handle lattice_;
+  std::size_t objectSize_;
+};
+
+} // namespace clqmc
+
+#endif
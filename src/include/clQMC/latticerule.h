@@ -54,6 +54,52 @@ struct clqmcLatticeRuleStream_;
 typedef struct clqmcLatticeRuleStream_ clqmcLatticeRuleStream;
 
 
+struct clqmcLatticeRuleHostStream_;
+
+/*! @brief Transferable lattice rule stream state
+ *
+ *  Unlike clqmcLatticeRuleStream, this structure contains no pointer, so an
+ *  array of host streams can be prepared on the host, copied into a device
+ *  buffer and turned into streams in a kernel with
+ *  clqmcLatticeRuleCopyOverStreamsFromGlobal(), which attaches the lattice
+ *  rule and the shifts given as arguments.
+ *  Its members are public:
+ *  - `pointIndex`: index of the current point;
+ *  - `coordinateIndex`: index of the next coordinate of the current point;
+ *  - `replication`: index of the shift vector in the array of shifts passed
+ *    to clqmcLatticeRuleCopyOverStreamsFromGlobal();
+ *  - `baker`: nonzero to apply the baker's transformation (see
+ *    clqmcLatticeRuleSetBakerTransform()).
+ *
+ *  All members are of type `cl_uint`, so each host stream occupies 16 bytes
+ *  and is loaded by a work item with a single read.
+ *  To keep it that small, a host stream does not record the point stride set
+ *  by clqmcLatticeRuleCreateStridedOverStream() nor the padding set by
+ *  clqmcLatticeRuleSetPadding(): streams obtained from host streams advance
+ *  by one point at a time and have no padding.
+ *  This allows the host to precompute arbitrary assignments of points and
+ *  replications to work items, e.g., to balance the load, instead of deriving
+ *  them from the NDRange in every kernel.
+ */
+typedef struct clqmcLatticeRuleHostStream_ clqmcLatticeRuleHostStream;
+
+
+struct clqmcLatticeRulePaddingState_;
+
+/*! @brief Padding state of a lattice rule stream
+ *
+ *  Storage for the seed, the replication and the cached permutation of the
+ *  padding of a stream, set by clqmcLatticeRuleSetPadding().
+ *  It is kept out of clqmcLatticeRuleStream, which only points to it, so
+ *  that streams without padding remain small.
+ *  Its members are private.
+ */
+typedef struct clqmcLatticeRulePaddingState_ clqmcLatticeRulePaddingState;
+
+// the layout of the stream type is needed to allocate arrays of streams
+#include <clQMC/private/latticerule.types.h>
+
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -61,12 +107,12 @@ extern "C" {
 /*! @copybrief clqmcNumPoints()
 *  @see clqmcNumPoints()
 */
-cl_uint clqmcLatticeRuleNumPoints(const clqmcLatticeRule* lattice);
+CLQMCAPI cl_uint clqmcLatticeRuleNumPoints(const clqmcLatticeRule* lattice);
 
 /*! @copybrief clqmcDimension()
 *  @see clqmcDimension()
 */
-cl_uint clqmcLatticeRuleDimension(const clqmcLatticeRule* lattice);
+CLQMCAPI cl_uint clqmcLatticeRuleDimension(const clqmcLatticeRule* lattice);
 
 #define clqmcLatticeRuleCreate _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreate)
 
@@ -82,14 +128,17 @@ cl_uint clqmcLatticeRuleDimension(const clqmcLatticeRule* lattice);
  *
  *  @return New rank-1 lattice rule object.
  */
-clqmcLatticeRule* clqmcLatticeRuleCreate             (cl_uint numPoints, cl_uint dimension, const cl_int* genVec, size_t* objectSize, clqmcStatus* err);
-clqmcLatticeRule* clqmcLatticeRuleCreate_clqmc_float (cl_uint numPoints, cl_uint dimension, const cl_int* genVec, size_t* objectSize, clqmcStatus* err);
-clqmcLatticeRule* clqmcLatticeRuleCreate_clqmc_double(cl_uint numPoints, cl_uint dimension, const cl_int* genVec, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreate             (cl_uint numPoints, cl_uint dimension, const cl_int* genVec, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreate_clqmc_float (cl_uint numPoints, cl_uint dimension, const cl_int* genVec, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreate_clqmc_double(cl_uint numPoints, cl_uint dimension, const cl_int* genVec, size_t* objectSize, clqmcStatus* err);
+
+#define clqmcLatticeRuleCreateKorobov       _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreateKorobov)
+#define clqmcLatticeRuleCreateFromCatalogue _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreateFromCatalogue)
 
 /*! @brief Create a new Korobov lattice rule.
  *
  *  For a Korobov lattice rule, the generating vector @f$\boldsymbol a = (1, a,
- *  a^2 \bmod n, \dots, a^s \bmod n)@f$ is parameterized by a single number
+ *  a^2 \bmod n, \dots, a^{s-1} \bmod n)@f$ is parameterized by a single number
  *  @f$a@f$.
  *
  *  @param[in]  numPoints   Number of points.
@@ -103,22 +152,239 @@ clqmcLatticeRule* clqmcLatticeRuleCreate_clqmc_double(cl_uint numPoints, cl_uint
  *  @see clqmcLatticeRuleCreate()
  *
  */
-clqmcLatticeRule* clqmcLatticeRuleCreateKorobov(cl_uint numPoints, cl_uint dimension, cl_int gen, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreateKorobov             (cl_uint numPoints, cl_uint dimension, cl_int gen, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreateKorobov_clqmc_float (cl_uint numPoints, cl_uint dimension, cl_int gen, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreateKorobov_clqmc_double(cl_uint numPoints, cl_uint dimension, cl_int gen, size_t* objectSize, clqmcStatus* err);
+
+/*! @brief Families of lattice rules of the catalogue
+ *
+ *  All generating vectors of the catalogue minimize the @f$\mathcal P_2@f$
+ *  criterion, i.e., the worst-case error of the randomly shifted rule in the
+ *  weighted Korobov space of smoothness 1 (or, equivalently, in the weighted
+ *  Sobolev space of smoothness 1 with the baker's transformation), with
+ *  product weights @f$\gamma_j@f$ for coordinate @f$j = 1, 2, \dots@f$.
+ *  The number of points @f$n@f$ is always a power of 2.
+ *
+ *  For the component-by-component (CBC) and embedded families, the first
+ *  @f$s@f$ components of the generating vector for dimension @f$s' > s@f$ are
+ *  the generating vector for dimension @f$s@f$.
+ *
+ *  @see clqmcLatticeRuleCreateFromCatalogue()
+ */
+typedef enum clqmcLatticeRuleFamily_ {
+    /*! @brief Rank-1 lattice rules constructed CBC with @f$\gamma_j = j^{-2}@f$,
+     *  for @f$2^4 \leq n \leq 2^{22}@f$ and dimensions up to 128.
+     */
+    CLQMC_LATTICE_CBC_POLY,
+    /*! @brief Rank-1 lattice rules constructed CBC with @f$\gamma_j = 0.9^j@f$,
+     *  for @f$2^4 \leq n \leq 2^{22}@f$ and dimensions up to 128.
+     */
+    CLQMC_LATTICE_CBC_GEOM,
+    /*! @brief Korobov lattice rules with @f$\gamma_j = j^{-2}@f$, for
+     *  @f$2^4 \leq n \leq 2^{20}@f$ and dimensions up to 32.
+     *
+     *  The parameter @f$a@f$ is selected for the smallest dimension among
+     *  4, 8, 16 and 32 that is not smaller than the requested dimension.
+     */
+    CLQMC_LATTICE_KOROBOV_POLY,
+    /*! @brief Embedded rank-1 lattice rules with @f$\gamma_j = j^{-2}@f$, for
+     *  @f$2^4 \leq n \leq 2^{22}@f$ and dimensions up to 128.
+     *
+     *  A single generating vector @f$\boldsymbol z@f$ is used for all numbers
+     *  of points, reduced modulo @f$n@f$, so that the rule with @f$n@f$ points
+     *  contains the rule with @f$n/2@f$ points; it was constructed CBC to
+     *  minimize the sum of @f$n^2 \mathcal P_2@f$ over all @f$n@f$ in the
+     *  range.
+     */
+    CLQMC_LATTICE_EMBEDDED_POLY
+} clqmcLatticeRuleFamily;
+
+/*! @brief Create a new rank-1 lattice rule from the catalogue [**host-only**]
+ *
+ *  The catalogue is compiled into the library, so the lookup requires
+ *  neither a search nor file accesses, and takes constant time.
+ *  The catalogue was generated with `src/tools/gencatalogue.c`.
+ *
+ *  @param[in]  log2NumPoints   Base-2 logarithm of the number of points.
+ *  @param[in]  dimension       Dimension.
+ *  @param[in]  family          Family of lattice rules.
+ *  @param[out] objectSize      Size in bytes of the returned object.
+ *  @param[out] err             Error status: #CLQMC_INVALID_VALUE if the
+ *                              catalogue has no entry for the arguments.
+ *
+ *  @return New rank-1 lattice rule object, or `NULL` on error.
+ *
+ *  @see clqmcLatticeRuleCreate()
+ */
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreateFromCatalogue             (cl_uint log2NumPoints, cl_uint dimension, clqmcLatticeRuleFamily family, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreateFromCatalogue_clqmc_float (cl_uint log2NumPoints, cl_uint dimension, clqmcLatticeRuleFamily family, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleCreateFromCatalogue_clqmc_double(cl_uint log2NumPoints, cl_uint dimension, clqmcLatticeRuleFamily family, size_t* objectSize, clqmcStatus* err);
 
 /*! @copybrief clqmcDestroy()
 *  @see clqmcDestroy()
 */
-clqmcStatus       clqmcLatticeRuleDestroy(clqmcLatticeRule* lattice);
+CLQMCAPI clqmcStatus       clqmcLatticeRuleDestroy(clqmcLatticeRule* lattice);
 
 /*! @copybrief clqmcWriteInfo()
 *  @see clqmcWriteInfo()
 */
-clqmcStatus       clqmcLatticeRuleWriteInfo(const clqmcLatticeRule* lattice, FILE* file);
+CLQMCAPI clqmcStatus       clqmcLatticeRuleWriteInfo(const clqmcLatticeRule* lattice, FILE* file);
+
+#define clqmcLatticeRuleSave   _CLQMC_TAG_FPTYPE(clqmcLatticeRuleSave)
+#define clqmcLatticeRuleLoad   _CLQMC_TAG_FPTYPE(clqmcLatticeRuleLoad)
+#define clqmcLatticeRuleMap    _CLQMC_TAG_FPTYPE(clqmcLatticeRuleMap)
+
+/*! @brief Save a lattice rule to a binary file [**host-only**]
+ *
+ *  The file contains a header followed by the lattice rule object exactly as
+ *  it is stored in memory, at an offset of 4096 bytes from the beginning of
+ *  the file.
+ *  The header contains a magic string, a format version number, a byte-order
+ *  mark, the size of the floating-point type of the normalized generating
+ *  vector, the offset and size of the object, the number of points and the
+ *  dimension; all are stored in the byte order of the host.
+ *
+ *  The floating-point type of the saved object is selected by the tag of the
+ *  function (`_clqmc_float` or `_clqmc_double`) and must match that used to
+ *  create `lattice`.
+ *
+ *  @param[in]  lattice     Lattice rule object.
+ *  @param[in]  path        Path of the output file.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcLatticeRuleSave             (const clqmcLatticeRule* lattice, const char* path);
+CLQMCAPI clqmcStatus clqmcLatticeRuleSave_clqmc_float (const clqmcLatticeRule* lattice, const char* path);
+CLQMCAPI clqmcStatus clqmcLatticeRuleSave_clqmc_double(const clqmcLatticeRule* lattice, const char* path);
+
+/*! @brief Load a lattice rule from a binary file [**host-only**]
+ *
+ *  If the file was written with the same byte order and floating-point type
+ *  as requested, the object is read as is.
+ *  Otherwise, the generating vector is converted to the byte order of the host
+ *  and the normalized generating vector is recomputed as in
+ *  clqmcLatticeRuleCreate().
+ *  The returned object must be released with clqmcLatticeRuleDestroy().
+ *
+ *  @param[in]  path        Path of the file written by clqmcLatticeRuleSave().
+ *  @param[out] objectSize  Size in bytes of the returned object.
+ *  @param[out] err         Error status.
+ *
+ *  @return New rank-1 lattice rule object, or `NULL` on error.
+ */
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleLoad             (const char* path, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleLoad_clqmc_float (const char* path, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleLoad_clqmc_double(const char* path, size_t* objectSize, clqmcStatus* err);
+
+/*! @brief Map a lattice rule file into memory [**host-only**]
+ *
+ *  The file is mapped privately (modifications are not written back) and the
+ *  returned object points directly into the mapping, without copying nor
+ *  conversion, so the file must have been written with the same byte order
+ *  and floating-point type as requested; use clqmcLatticeRuleLoad()
+ *  otherwise.
+ *  The object is aligned on 4 KiB (it starts 4 KiB after the beginning of
+ *  the file, whatever the page size of the system), which satisfies the
+ *  alignment that OpenCL implementations usually require for zero-copy
+ *  buffers, so it can be passed directly to `clCreateBuffer()` with
+ *  `CL_MEM_USE_HOST_PTR`:
+ *  @code
+ *  size_t size;
+ *  clqmcLatticeRule* lattice = clqmcLatticeRuleMap("lattice.bin", &size, &err);
+ *  cl_mem buf = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_USE_HOST_PTR, size, lattice, &err);
+ *  @endcode
+ *  The returned object must be released with clqmcLatticeRuleUnmap(), after
+ *  any buffer that uses it, and not with clqmcLatticeRuleDestroy().
+ *
+ *  @param[in]  path        Path of the file written by clqmcLatticeRuleSave().
+ *  @param[out] objectSize  Size in bytes of the returned object.
+ *  @param[out] err         Error status.
+ *
+ *  @return Rank-1 lattice rule object, or `NULL` on error.
+ */
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleMap             (const char* path, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleMap_clqmc_float (const char* path, size_t* objectSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRule* clqmcLatticeRuleMap_clqmc_double(const char* path, size_t* objectSize, clqmcStatus* err);
+
+/*! @brief Unmap a lattice rule mapped with clqmcLatticeRuleMap() [**host-only**]
+ *
+ *  @param[in]  lattice     Lattice rule object returned by clqmcLatticeRuleMap().
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcLatticeRuleUnmap(clqmcLatticeRule* lattice);
+
+/*! @brief Generate device source that specializes kernels for a lattice rule [**host-only**]
+ *
+ *  Generate OpenCL C source that defines the following macros, to be placed
+ *  before the kernel source:
+ *  - `CLQMC_LATTICERULE_STATIC_POINTS`: the number of points @f$n@f$;
+ *  - `CLQMC_LATTICERULE_STATIC_DIMENSION`: the dimension @f$s@f$;
+ *  - `CLQMC_LATTICERULE_STATIC_MASK`: @f$n - 1@f$, only if @f$n@f$ is a
+ *    power of 2;
+ *  - `CLQMC_LATTICERULE_STATIC_GENVEC`: an initializer of the generating
+ *    vector, with components reduced modulo @f$n@f$.
+ *
+ *  When these macros are defined, latticerule.clh defines the generating
+ *  vector as a `__constant` array and provides the device-only functions
+ *  clqmcLatticeRuleStaticCoordinate() and clqmcLatticeRuleStaticPoint(),
+ *  which compute the coordinates of the points without reading the lattice
+ *  rule object, with the number of points and the dimension as literals.
+ *  The source ends with a `#line 1` directive, so that the compiler reports
+ *  the lines of the kernel source that follows it.
+ *
+ *  @param[in]  lattice     Lattice rule.
+ *  @param[out] length      Length of the generated source, or `NULL`.
+ *  @param[out] err         Error status variable, or `NULL`.
+ *
+ *  @return Null-terminated source, to be released with free(), or `NULL` on
+ *  error.
+ *
+ *  @see clqmcLatticeRuleBuildSpecializedProgram()
+ */
+CLQMCAPI char* clqmcLatticeRuleSpecializedSource(const clqmcLatticeRule* lattice, size_t* length, clqmcStatus* err);
+
+/*! @brief Build a program specialized for a lattice rule [**host-only**]
+ *
+ *  Build the given kernel source preceded by the source generated by
+ *  clqmcLatticeRuleSpecializedSource() for `lattice`, with
+ *  clqmcBuildProgramWithSource(), so the device headers are taken from the
+ *  library and the program is built only once per lattice rule, device and
+ *  options for the lifetime of the program cache.
+ *  The kernel source must include `clQMC/latticerule.clh` to obtain the
+ *  specialized functions.
+ *
+ *  Specialization pays off when a small lattice rule is used by many kernel
+ *  launches: the program must be built again for each new lattice rule.
+ *
+ *  @param[in]  context     OpenCL context.
+ *  @param[in]  device      OpenCL device of the context.
+ *  @param[in]  lattice     Lattice rule.
+ *  @param[in]  count       Number of kernel source strings.
+ *  @param[in]  strings     Kernel source strings.
+ *  @param[in]  lengths     Lengths of the source strings, or `NULL`; see
+ *                          clqmcCreateProgramWithSource().
+ *  @param[in]  options     Build options, or `NULL`.
+ *  @param[out] err         Error status variable, or `NULL`.
+ *
+ *  @return Built program, to be released with clReleaseProgram(), or `NULL`
+ *  on error.
+ */
+CLQMCAPI cl_program clqmcLatticeRuleBuildSpecializedProgram(cl_context context, cl_device_id device, const clqmcLatticeRule* lattice,
+    cl_uint count, const char** strings, const size_t* lengths, const char* options, clqmcStatus* err);
 
 #define clqmcLatticeRuleCreateStream       _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreateStream)
 #define clqmcLatticeRuleCreateOverStream   _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreateOverStream)
+#define clqmcLatticeRuleCreateOverStreamUnchecked _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreateOverStreamUnchecked)
+#define clqmcLatticeRuleCreateStridedOverStream _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreateStridedOverStream)
+#define clqmcLatticeRuleCreateStreams      _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreateStreams)
+#define clqmcLatticeRuleCreateOverStreams  _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCreateOverStreams)
+#define clqmcLatticeRuleCopyOverStreams    _CLQMC_TAG_FPTYPE(clqmcLatticeRuleCopyOverStreams)
 #define clqmcLatticeRuleNextCoordinate     _CLQMC_TAG_FPTYPE(clqmcLatticeRuleNextCoordinate)
 #define clqmcLatticeRuleNextPoint          _CLQMC_TAG_FPTYPE(clqmcLatticeRuleNextPoint)
+#define clqmcLatticeRuleNextNormal         _CLQMC_TAG_FPTYPE(clqmcLatticeRuleNextNormal)
+#define clqmcLatticeRuleNextExponential    _CLQMC_TAG_FPTYPE(clqmcLatticeRuleNextExponential)
+#define clqmcLatticeRuleNextGamma          _CLQMC_TAG_FPTYPE(clqmcLatticeRuleNextGamma)
 
 /*! @copybrief clqmcCreateStream()
 *  @see clqmcCreateStream()
@@ -138,6 +404,205 @@ CLQMCAPI clqmcStatus clqmcLatticeRuleCreateOverStream             (clqmcLatticeR
 CLQMCAPI clqmcStatus clqmcLatticeRuleCreateOverStream_clqmc_float (clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const cl_float*      shift);
 CLQMCAPI clqmcStatus clqmcLatticeRuleCreateOverStream_clqmc_double(clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const cl_double*     shift);
 
+/*! @brief Initialize a stream without validating the arguments [**device**]
+ *
+ *  Same as clqmcLatticeRuleCreateOverStream(), but `stream` must not be
+ *  `NULL`, `partIndex` must be smaller than `partCount` and the number of
+ *  points in `lattice` must be a multiple of `partCount`; none of this is
+ *  checked.
+ *  On the device, this avoids the branches and the error status in kernels
+ *  where the arguments are known to be valid, e.g., when `partCount` and
+ *  `partIndex` are derived from the NDRange.
+ *
+ *  Alternatively, defining `CLQMC_DISABLE_CHECKS` before including the device
+ *  header files of clQMC removes the argument checks from all device functions,
+ *  which then always return `CLQMC_SUCCESS`.
+ */
+CLQMCAPI void clqmcLatticeRuleCreateOverStreamUnchecked             (clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const _CLQMC_FPTYPE* shift);
+CLQMCAPI void clqmcLatticeRuleCreateOverStreamUnchecked_clqmc_float (clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const cl_float*      shift);
+CLQMCAPI void clqmcLatticeRuleCreateOverStreamUnchecked_clqmc_double(clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const cl_double*     shift);
+
+/*! @brief Initialize a stream over an interleaved part of a lattice rule [**device**]
+ *
+ *  Same as clqmcLatticeRuleCreateOverStream(), except that part @f$p@f$ of
+ *  @f$P@f$ = `partCount` parts contains the points of indices
+ *  @f$p, p + P, p + 2P, \dots@f$ instead of a contiguous block of indices.
+ *  The points of each part then form a shifted rank-1 lattice rule with
+ *  @f$n/P@f$ points and generating vector @f$P\boldsymbol a \bmod n@f$, so
+ *  each part is well distributed by itself, e.g., for an estimate computed
+ *  by a work item before all points are processed.
+ *  The contiguous parts of clqmcLatticeRuleCreateOverStream() are only
+ *  slices of the point set along its first coordinate.
+ *
+ *  clqmcLatticeRuleForwardToNextPoint() advances the point index by
+ *  @f$P@f$, so the kernels that iterate over the @f$n/P@f$ points of their
+ *  part are unchanged.
+ */
+CLQMCAPI clqmcStatus clqmcLatticeRuleCreateStridedOverStream             (clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const _CLQMC_FPTYPE* shift);
+CLQMCAPI clqmcStatus clqmcLatticeRuleCreateStridedOverStream_clqmc_float (clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const cl_float*      shift);
+CLQMCAPI clqmcStatus clqmcLatticeRuleCreateStridedOverStream_clqmc_double(clqmcLatticeRuleStream* stream, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint partIndex, const cl_double*     shift);
+
+/*! @copybrief clqmcCreateStreams()
+ *  @see clqmcCreateStreams()
+ *
+ *  The argument `shifts`, if not `NULL`, must contain `replications`
+ *  consecutive shift vectors of the same dimension as the lattice.
+ *  Both `partCount` and `replications` must be positive, otherwise
+ *  `CLQMC_INVALID_VALUE` is returned through `err`.
+ */
+CLQMCAPI clqmcLatticeRuleStream* clqmcLatticeRuleCreateStreams             (const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint replications, const _CLQMC_FPTYPE* shifts, size_t* bufSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRuleStream* clqmcLatticeRuleCreateStreams_clqmc_float (const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint replications, const cl_float*      shifts, size_t* bufSize, clqmcStatus* err);
+CLQMCAPI clqmcLatticeRuleStream* clqmcLatticeRuleCreateStreams_clqmc_double(const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint replications, const cl_double*     shifts, size_t* bufSize, clqmcStatus* err);
+
+/*! @copybrief clqmcCreateOverStreams()
+ *  @see clqmcCreateOverStreams()
+ */
+CLQMCAPI clqmcStatus clqmcLatticeRuleCreateOverStreams             (clqmcLatticeRuleStream* streams, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint replications, const _CLQMC_FPTYPE* shifts);
+CLQMCAPI clqmcStatus clqmcLatticeRuleCreateOverStreams_clqmc_float (clqmcLatticeRuleStream* streams, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint replications, const cl_float*      shifts);
+CLQMCAPI clqmcStatus clqmcLatticeRuleCreateOverStreams_clqmc_double(clqmcLatticeRuleStream* streams, const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint replications, const cl_double*     shifts);
+
+/*! @copybrief clqmcDestroyStreams()
+*  @see clqmcDestroyStreams()
+*/
+CLQMCAPI clqmcStatus clqmcLatticeRuleDestroyStreams(clqmcLatticeRuleStream* streams);
+
+/*! @brief Create transferable host streams [**host-only**]
+ *
+ *  Allocate and initialize `partCount` times `replications` host streams,
+ *  in the same order as clqmcLatticeRuleCreateStreams(): the host stream of
+ *  index `k * partCount + p` is positioned at the first point of part `p` of
+ *  the lattice rule, for replication `k`.
+ *  The members of the host streams can be modified afterwards to obtain other
+ *  assignments.
+ *
+ *  @param[in]  lattice         Lattice rule object.
+ *  @param[in]  partCount       Number of parts of the point set; the number of
+ *                              points must be a multiple of it.
+ *  @param[in]  replications    Number of replications (positive).
+ *  @param[out] bufSize         Size in bytes of the returned array, or `NULL`.
+ *  @param[out] err             Error status variable, or `NULL`.
+ *
+ *  @return Array of host streams, to be released with
+ *  clqmcLatticeRuleDestroyHostStreams(), or `NULL` on error.
+ */
+CLQMCAPI clqmcLatticeRuleHostStream* clqmcLatticeRuleCreateHostStreams(const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint replications, size_t* bufSize, clqmcStatus* err);
+
+/*! @brief Destroy host streams [**host-only**]
+ *
+ *  @param[in]  hostStreams     Array returned by
+ *                              clqmcLatticeRuleCreateHostStreams(), or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcLatticeRuleDestroyHostStreams(clqmcLatticeRuleHostStream* hostStreams);
+
+/*! @brief Initialize streams from host streams [**device**]
+ *
+ *  Initialize `count` streams over `lattice` from the first `count` host
+ *  streams, with the shift of host stream `i` starting at index
+ *  `hostStreams[i].replication` times the dimension of `lattice` in
+ *  `shifts`.
+ *  The point stride of the streams is reset to 1 and their padding to
+ *  `CLQMC_PADDING_NONE`, since host streams do not record them; call
+ *  clqmcLatticeRuleSetPadding() afterwards to restore the padding.
+ *  On the device, this function is named
+ *  clqmcLatticeRuleCopyOverStreamsFromGlobal() and `hostStreams` is in global
+ *  memory:
+ *  @code
+ *  clqmcLatticeRuleStream stream;
+ *  clqmcLatticeRuleCopyOverStreamsFromGlobal(1, &stream, &hostStreams[get_global_id(0)], lattice, shifts);
+ *  @endcode
+ *
+ *  @param[in]  count       Number of streams.
+ *  @param[out] streams     Array of `count` stream objects.
+ *  @param[in]  hostStreams Array of `count` host streams.
+ *  @param[in]  lattice     Lattice rule object.
+ *  @param[in]  shifts      Array of shift vectors, or `NULL` for no
+ *                          randomization.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcLatticeRuleCopyOverStreams             (cl_uint count, clqmcLatticeRuleStream* streams, const clqmcLatticeRuleHostStream* hostStreams, const clqmcLatticeRule* lattice, const _CLQMC_FPTYPE* shifts);
+CLQMCAPI clqmcStatus clqmcLatticeRuleCopyOverStreams_clqmc_float (cl_uint count, clqmcLatticeRuleStream* streams, const clqmcLatticeRuleHostStream* hostStreams, const clqmcLatticeRule* lattice, const cl_float*      shifts);
+CLQMCAPI clqmcStatus clqmcLatticeRuleCopyOverStreams_clqmc_double(cl_uint count, clqmcLatticeRuleStream* streams, const clqmcLatticeRuleHostStream* hostStreams, const clqmcLatticeRule* lattice, const cl_double*     shifts);
+
+/*! @brief Enable or disable the baker's transformation on a stream [**device**]
+ *
+ *  When enabled, the baker's (tent) transformation @f$u \mapsto 1 - |2u - 1|@f$
+ *  is applied to every coordinate returned by the stream, after the random
+ *  shift, including the coordinates consumed by clqmcLatticeRuleNextNormal()
+ *  and the other transformed outputs.
+ *  For smooth integrands that are not periodic, a randomly-shifted lattice
+ *  rule with the baker's transformation converges at rate
+ *  @f$O(n^{-2+\epsilon})@f$ instead of @f$O(n^{-1+\epsilon})@f$
+ *  @cite vHIC02a .
+ *
+ *  The transformation is disabled by clqmcLatticeRuleCreateOverStream(), so
+ *  this function must be called after the stream is created.
+ *
+ *  @param[in,out]  stream  Lattice rule stream object.
+ *  @param[in]      enable  `CL_TRUE` to enable the transformation, `CL_FALSE`
+ *                          to disable it.
+ *
+ *  @return Error status.
+ *
+ *  @see clqmcBakerTransform()
+ */
+CLQMCAPI clqmcStatus clqmcLatticeRuleSetBakerTransform(clqmcLatticeRuleStream* stream, cl_bool enable);
+
+/*! @brief Enable coordinates beyond the dimension of the lattice rule [**device**]
+ *
+ *  By default, clqmcLatticeRuleNextCoordinate() returns -1 once the
+ *  @f$s@f$ coordinates of the current point have been read.
+ *  With padding, the stream instead returns an unlimited number of
+ *  coordinates per point, the first @f$s@f$ from the lattice rule and the
+ *  subsequent ones:
+ *  - with `CLQMC_PADDING_RANDOM`, from independent uniform random numbers,
+ *    determined by `seed`, `replication`, the point index and the coordinate
+ *    index;
+ *  - with `CLQMC_PADDING_LATIN_SUPERCUBE`, by blocks of @f$s@f$, from the
+ *    lattice rule again, with a random permutation of the points for each
+ *    block, determined by `seed`, `replication` and the block index, and
+ *    shifted by the corresponding coordinates of the random shift of
+ *    replication `replication` generated from `seed` (see
+ *    clqmcRandomShiftCoordinate()) @cite vOWE98a .
+ *
+ *  This allows lattice rules to be sized for the effective dimension of
+ *  problems whose number of random variates is unbounded or varies from one
+ *  point to the other (e.g., paths stopped at a random time): the important
+ *  first coordinates are integrated with the lattice rule and the rest still
+ *  yield an unbiased estimator.
+ *  Within a replication, the padding coordinates of a point are the same for
+ *  all streams and do not depend on the order in which they are read, so
+ *  their values can be reproduced on the host and on the device.
+ *  With Latin supercube padding, `seed` should be the one used to generate
+ *  the shifts with clqmcRandomShiftsGenerate(), so that the shift of every
+ *  block is the continuation of that of the first @f$s@f$ coordinates.
+ *  Padding costs nothing as long as only the first @f$s@f$ coordinates are
+ *  read.
+ *
+ *  The padding is disabled by clqmcLatticeRuleCreateOverStream() and the
+ *  other stream constructors, so this function must be called after the
+ *  stream is created; it is preserved by clqmcLatticeRuleForwardToNextPoint().
+ *  The padding parameters are stored in `state`, which the stream points to
+ *  and which must therefore outlive it and not be shared with other streams
+ *  (on the device, a variable in private memory, e.g., next to the stream).
+ *
+ *  @param[in,out]  stream      Lattice rule stream object.
+ *  @param[out]     state       Padding state of the stream; may be `NULL`
+ *                              only with `CLQMC_PADDING_NONE`.
+ *  @param[in]      padding     Padding mode.
+ *  @param[in]      seed        Seed of the padding.
+ *  @param[in]      replication Index of the replication.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcLatticeRuleSetPadding(clqmcLatticeRuleStream* stream, clqmcLatticeRulePaddingState* state, clqmcLatticeRulePadding padding, cl_ulong seed, cl_uint replication);
+
+// Used by clqmcLatticeRuleNextCoordinate() beyond the dimension of the lattice rule.
+CLQMCAPI cl_float  clqmcLatticeRulePaddedCoordinate_clqmc_float (clqmcLatticeRuleStream* stream);
+CLQMCAPI cl_double clqmcLatticeRulePaddedCoordinate_clqmc_double(clqmcLatticeRuleStream* stream);
+
 /*! @copybrief clqmcDestroyStream()
 *  @see clqmcDestroyStream()
 */
@@ -146,9 +611,50 @@ CLQMCAPI clqmcStatus clqmcLatticeRuleDestroyStream(clqmcLatticeRuleStream* strea
 /*! @copybrief clqmcNextCoordinate()
 *  @see clqmcNextCoordinate()
 */
+#ifndef CLQMC_INLINE_STREAMS
 CLQMCAPI _CLQMC_FPTYPE clqmcLatticeRuleNextCoordinate         (clqmcLatticeRuleStream* stream);
 CLQMCAPI cl_float  clqmcLatticeRuleNextCoordinate_clqmc_float (clqmcLatticeRuleStream* stream);
 CLQMCAPI cl_double clqmcLatticeRuleNextCoordinate_clqmc_double(clqmcLatticeRuleStream* stream);
+#endif
+
+/*! @brief Return the next coordinate transformed into a standard normal variate [**device**]
+ *
+ *  Equivalent to applying clqmcStdNormalInverseCDF() to the output of
+ *  clqmcLatticeRuleNextCoordinate(), but the two steps are fused so that the
+ *  generator and the transformation share registers in device code.
+ *
+ *  @warning Without a random shift, the first point of a lattice rule is the
+ *  origin, for which the returned value is @f$-\infty@f$.
+ *
+ *  @return Standard normal variate, or NaN if no further coordinate is
+ *  available.
+ */
+CLQMCAPI _CLQMC_FPTYPE clqmcLatticeRuleNextNormal             (clqmcLatticeRuleStream* stream);
+CLQMCAPI cl_float      clqmcLatticeRuleNextNormal_clqmc_float (clqmcLatticeRuleStream* stream);
+CLQMCAPI cl_double     clqmcLatticeRuleNextNormal_clqmc_double(clqmcLatticeRuleStream* stream);
+
+/*! @brief Return the next coordinate transformed into an exponential variate with rate 1 [**device**]
+ *
+ *  @return Exponential variate, or NaN if no further coordinate is available.
+ *
+ *  @see clqmcExponentialInverseCDF()
+ */
+CLQMCAPI _CLQMC_FPTYPE clqmcLatticeRuleNextExponential             (clqmcLatticeRuleStream* stream);
+CLQMCAPI cl_float      clqmcLatticeRuleNextExponential_clqmc_float (clqmcLatticeRuleStream* stream);
+CLQMCAPI cl_double     clqmcLatticeRuleNextExponential_clqmc_double(clqmcLatticeRuleStream* stream);
+
+/*! @brief Return the next coordinate transformed into a gamma variate with scale 1 [**device**]
+ *
+ *  @param[in,out]  stream  Lattice rule stream object.
+ *  @param[in]      shape   Shape parameter of the gamma distribution.
+ *
+ *  @return Gamma variate, or NaN if no further coordinate is available.
+ *
+ *  @see clqmcGammaInverseCDF()
+ */
+CLQMCAPI _CLQMC_FPTYPE clqmcLatticeRuleNextGamma             (clqmcLatticeRuleStream* stream, _CLQMC_FPTYPE shape);
+CLQMCAPI cl_float      clqmcLatticeRuleNextGamma_clqmc_float (clqmcLatticeRuleStream* stream, cl_float      shape);
+CLQMCAPI cl_double     clqmcLatticeRuleNextGamma_clqmc_double(clqmcLatticeRuleStream* stream, cl_double     shape);
 
 /*! @copybrief clqmcNextPoint()
 *  @see clqmcNextPoint()
@@ -160,20 +666,35 @@ CLQMCAPI cl_uint clqmcLatticeRuleNextPoint_clqmc_double(clqmcLatticeRuleStream*
 /*! @copybrief clqmcForwardToNextPoint()
 *  @see clqmcForwardToNextPoint()
 */
+#ifndef CLQMC_INLINE_STREAMS
 CLQMCAPI cl_uint clqmcLatticeRuleForwardToNextPoint(clqmcLatticeRuleStream* stream);
+#endif
 
 /*! @copybrief clqmcCurrentPointIndex()
 *  @see clqmcCurrentPointIndex()
 */
+#ifndef CLQMC_INLINE_STREAMS
 CLQMCAPI cl_uint clqmcLatticeRuleCurrentPointIndex(const clqmcLatticeRuleStream* stream);
+#endif
 
 /*! @copybrief clqmcCurrentCoordIndex()
 *  @see clqmcCurrentCoordIndex()
 */
+#ifndef CLQMC_INLINE_STREAMS
 CLQMCAPI cl_uint clqmcLatticeRuleCurrentCoordIndex(const clqmcLatticeRuleStream* stream);
+#endif
 
 #ifdef __cplusplus
 }
 #endif
 
+// Header-inline mode: static inline definitions of the stream hot path.
+#ifdef CLQMC_INLINE_STREAMS
+  #include <clQMC/transforms.h>
+  #include <math.h>
+  #define _CLQMC_INLINE_HOT_PATH
+  #include <clQMC/private/latticerule.c.h>
+  #undef _CLQMC_INLINE_HOT_PATH
+#endif
+
 #endif
@@ -0,0 +1,249 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/*! @file multilevel.h
+ *  @brief Host driver for multilevel randomized quasi-Monte Carlo [**host-only**]
+ *
+ *  Multilevel RQMC @cite vGIL09a estimates @f$\mathbb E[P_L]@f$, where
+ *  @f$P_\ell@f$ is an approximation of a quantity of interest at level of
+ *  discretization @f$\ell@f$ (e.g., an SDE path with @f$2^\ell@f$ times more
+ *  time steps than at level 0), with the telescoping sum
+ *  @f[
+ *    \mathbb E[P_L] = \mathbb E[P_0] + \sum_{\ell=1}^L \mathbb E[P_\ell - P_{\ell-1}].
+ *  @f]
+ *  Each term is estimated independently with its own randomly shifted
+ *  lattice rule, with @f$n_\ell@f$ points and @f$R@f$ independent random
+ *  shifts.
+ *  The fine and coarse approximations @f$P_\ell@f$ and @f$P_{\ell-1}@f$ of
+ *  a same point must be computed from the same coordinates: typically, the
+ *  kernel reads the uniforms of the fine path from the stream and combines
+ *  them to obtain those of the coarse path (e.g., the Brownian increment of
+ *  a coarse time step is the sum of the increments of the two corresponding
+ *  fine time steps).
+ *  The variance of the terms then decreases with @f$\ell@f$, so few points
+ *  are needed on the costly fine levels.
+ *
+ *  The driver adapts the number of levels and the numbers of points
+ *  following @cite vGIL09a :
+ *
+ *  1. The first levels are evaluated with the minimum number of points.
+ *  2. While the total variance @f$\sum_\ell V_\ell@f$ of the estimator
+ *     exceeds @f$\varepsilon^2/2@f$, the number of points is doubled on the
+ *     level with the largest ratio @f$V_\ell / (n_\ell C_\ell)@f$, where
+ *     @f$V_\ell@f$ is the estimated variance of the level estimator and
+ *     @f$C_\ell@f$ is the measured cost per point and per shift.
+ *  3. If the estimated bias
+ *     @f$\max(|m_L|, |m_{L-1}| 2^{-\alpha}) / (2^\alpha - 1)@f$, where
+ *     @f$m_\ell@f$ is the estimated mean of level @f$\ell@f$ and the weak
+ *     order @f$\alpha \geq 1/2@f$ is estimated by regression, exceeds
+ *     @f$\varepsilon/\sqrt2@f$, a level is added and the algorithm returns to
+ *     step 2.
+ *
+ *  The levels are evaluated by a user callback (see clqmcMultilevelSampler)
+ *  that typically copies the lattice rule and the shifts to the device and
+ *  enqueues a kernel.
+ *  When the callback returns the event of that kernel, the cost of the
+ *  level is measured with OpenCL event profiling, so the command queue must
+ *  have been created with `CL_QUEUE_PROFILING_ENABLE`; otherwise, the host
+ *  time spent in the callback is used.
+ *
+ *  A driver object must not be used concurrently by multiple threads.
+ */
+
+#pragma once
+#ifndef CLQMC_MULTILEVEL_H
+#define CLQMC_MULTILEVEL_H
+
+#include <clQMC/clQMC.h>
+#include <clQMC/latticerule.h>
+#include <clQMC/profiling.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Multilevel driver object [**host-only**]
+ */
+typedef struct clqmcMultilevel_ clqmcMultilevel;
+
+/*! @brief Callback that evaluates one level [**host-only**]
+ *
+ *  Compute, for each of the `replications` random shifts, the average of
+ *  @f$P_\ell - P_{\ell-1}@f$ (or of @f$P_0@f$ for level 0) over the points of
+ *  the shifted lattice rule.
+ *
+ *  @param[in]  userData        Pointer given to clqmcMultilevelCreate().
+ *  @param[in]  level           Level @f$\ell@f$.
+ *  @param[in]  lattice         Lattice rule of the level, whose dimension is
+ *                              the one given for the level to
+ *                              clqmcMultilevelCreate(); it is destroyed after
+ *                              the callback returns.
+ *  @param[in]  latticeSize     Size in bytes of `lattice`.
+ *  @param[in]  replications    Number @f$R@f$ of random shifts.
+ *  @param[in]  shifts          Random shifts, of the floating-point type of
+ *                              the variant of clqmcMultilevelCreate() that
+ *                              was called (`cl_float` for `_clqmc_float`,
+ *                              `cl_double` for `_clqmc_double`), with
+ *                              the dimension of the lattice rule times
+ *                              @f$R@f$ coordinates; the shift of replication
+ *                              @f$r@f$ starts at index @f$r@f$ times the
+ *                              dimension.
+ *  @param[out] estimates       Array of @f$R@f$ averages.
+ *  @param[out] event           Event of the command whose duration is the
+ *                              cost of the level, or `NULL` (the initial
+ *                              value) to use the host time spent in the
+ *                              callback; the event is released by the driver.
+ *
+ *  @return Error status; an error interrupts clqmcMultilevelRun() and is
+ *  returned by it.
+ */
+typedef clqmcStatus (*clqmcMultilevelSampler)(void* userData, cl_uint level, const clqmcLatticeRule* lattice, size_t latticeSize,
+    cl_uint replications, const void* shifts, double* estimates, cl_event* event);
+
+#define clqmcMultilevelCreate _CLQMC_TAG_FPTYPE(clqmcMultilevelCreate)
+
+/*! @brief Create a multilevel driver [**host-only**]
+ *
+ *  The lattice rules are taken from the catalogue, so the dimension of the
+ *  levels cannot exceed that of the selected family.
+ *  The random shifts are generated with clqmcRandomShiftsGenerate() from
+ *  `seed`, with new replication indices for each evaluation of a level.
+ *
+ *  @param[in]  maxLevels       Maximum number of levels.
+ *  @param[in]  dimensions      Dimensions of the lattice rules of levels
+ *                              @f$0,\dots,@f$ `maxLevels - 1`; the array is
+ *                              copied.
+ *  @param[in]  family          Family of lattice rules of the catalogue.
+ *  @param[in]  replications    Number @f$R \geq 2@f$ of random shifts per
+ *                              level, used to estimate the variances.
+ *  @param[in]  seed            Seed of the random shifts.
+ *  @param[in]  sampler         Callback that evaluates the levels.
+ *  @param[in]  userData        Pointer passed to `sampler`.
+ *  @param[out] err             Error status variable, or `NULL`.
+ *
+ *  @return New driver object, or `NULL` on error.
+ */
+CLQMCAPI clqmcMultilevel* clqmcMultilevelCreate             (cl_uint maxLevels, const cl_uint* dimensions, clqmcLatticeRuleFamily family, cl_uint replications,
+    cl_ulong seed, clqmcMultilevelSampler sampler, void* userData, clqmcStatus* err);
+CLQMCAPI clqmcMultilevel* clqmcMultilevelCreate_clqmc_float (cl_uint maxLevels, const cl_uint* dimensions, clqmcLatticeRuleFamily family, cl_uint replications,
+    cl_ulong seed, clqmcMultilevelSampler sampler, void* userData, clqmcStatus* err);
+CLQMCAPI clqmcMultilevel* clqmcMultilevelCreate_clqmc_double(cl_uint maxLevels, const cl_uint* dimensions, clqmcLatticeRuleFamily family, cl_uint replications,
+    cl_ulong seed, clqmcMultilevelSampler sampler, void* userData, clqmcStatus* err);
+
+/*! @brief Destroy a multilevel driver [**host-only**]
+ *
+ *  @param[in]  ml      Driver object, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcMultilevelDestroy(clqmcMultilevel* ml);
+
+/*! @brief Set the range of numbers of points per level [**host-only**]
+ *
+ *  The numbers of points are powers of 2, from @f$2^4@f$ to @f$2^{20}@f$ by
+ *  default.
+ *  Both bounds must lie in the range of the catalogue for the family of the
+ *  driver: from @f$2^4@f$ to @f$2^{22}@f$ points for the CBC and embedded
+ *  families, and to @f$2^{20}@f$ points for ::CLQMC_LATTICE_KOROBOV_POLY;
+ *  CLQMC_INVALID_VALUE is returned otherwise.
+ *  Must be called before clqmcMultilevelRun().
+ *
+ *  @param[in,out]  ml              Driver object.
+ *  @param[in]      log2MinPoints   Base-2 logarithm of the initial number of
+ *                                  points of each level.
+ *  @param[in]      log2MaxPoints   Base-2 logarithm of the maximum number of
+ *                                  points of each level.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcMultilevelSetPointRange(clqmcMultilevel* ml, cl_uint log2MinPoints, cl_uint log2MaxPoints);
+
+/*! @brief Record the level evaluations with a profiler [**host-only**]
+ *
+ *  The events returned by the callback are recorded with the names
+ *  `level 0`, `level 1`, etc.
+ *
+ *  @param[in,out]  ml          Driver object.
+ *  @param[in]      profiler    Profiler object, or `NULL` to disable
+ *                              recording; it must outlive the driver or be
+ *                              detached before it is destroyed.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcMultilevelSetProfiler(clqmcMultilevel* ml, clqmcProfiler* profiler);
+
+/*! @brief Run the adaptive multilevel algorithm [**host-only**]
+ *
+ *  Evaluate levels until the estimated root mean square error is at most
+ *  `epsilon`, or until the maximum number of levels and points is reached.
+ *  Calling this function again with a smaller `epsilon` continues from the
+ *  current levels.
+ *
+ *  @param[in,out]  ml          Driver object.
+ *  @param[in]      epsilon     Target root mean square error.
+ *  @param[out]     estimate    Multilevel estimate, or `NULL`.
+ *  @param[out]     variance    Estimated variance of the estimate, or `NULL`.
+ *  @param[out]     converged   `CL_TRUE` if both the variance and the bias
+ *                              targets were reached, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcMultilevelRun(clqmcMultilevel* ml, double epsilon, double* estimate, double* variance, cl_bool* converged);
+
+/*! @brief Return the current number of levels [**host-only**]
+ */
+CLQMCAPI cl_uint clqmcMultilevelNumLevels(const clqmcMultilevel* ml);
+
+/*! @brief Retrieve the statistics of a level [**host-only**]
+ *
+ *  @param[in]  ml          Driver object.
+ *  @param[in]  level       Level, smaller than clqmcMultilevelNumLevels().
+ *  @param[out] numPoints   Current number of points, or `NULL`.
+ *  @param[out] mean        Estimated mean of the level, or `NULL`.
+ *  @param[out] variance    Estimated variance of the level estimator, or
+ *                          `NULL`.
+ *  @param[out] cost        Measured cost per point and per shift, in
+ *                          nanoseconds, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcMultilevelGetLevel(const clqmcMultilevel* ml, cl_uint level, cl_uint* numPoints, double* mean, double* variance, double* cost);
+
+/*! @brief Write a table of the levels [**host-only**]
+ *
+ *  Write the dimension, number of points, mean, variance and cost of each
+ *  level, and the total time spent evaluating the levels.
+ *
+ *  @param[in]  ml      Driver object.
+ *  @param[in]  file    Output file.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcMultilevelWriteInfo(const clqmcMultilevel* ml, FILE* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
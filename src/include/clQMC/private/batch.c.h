@@ -0,0 +1,102 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+
+// type definitions shared with the host header
+#include <clQMC/private/batch.types.h>
+
+/********************************************************************************
+ * Implementation                                                               *
+ ********************************************************************************/
+
+// Argument checks.  On the device, they are compiled out if
+// CLQMC_DISABLE_CHECKS is defined.
+#if defined(__OPENCL_C_VERSION__) && defined(CLQMC_DISABLE_CHECKS)
+  #define _CLQMC_CHECK(cond, err, ...)
+#else
+  #define _CLQMC_CHECK(cond, err, ...) if (cond) return clqmcSetErrorString(err, __VA_ARGS__)
+#endif
+
+#define IMPLEMENT_BATCH_FOR_TYPE(fptype) \
+  \
+  _CLQMC_BATCH_MEM const fptype* clqmcBatchShifts_##fptype(_CLQMC_BATCH_MEM const clqmcBatch* batch, clqmc_uint problem) \
+  { \
+    clqmc_uint offset = _CLQMC_BATCH_TABLE(batch,_CLQMC_BATCH_MEM const)[problem].shiftsOffset; \
+    return offset ? _CLQMC_BATCH_AT(batch,_CLQMC_BATCH_MEM const,fptype,offset) : 0; \
+  } \
+  \
+  clqmcStatus clqmcBatchCreateOverStream_##fptype(clqmcLatticeRuleStream* stream, _CLQMC_BATCH_MEM const clqmcBatch* batch, clqmc_uint problem, \
+      clqmc_uint replication, clqmc_uint partCount, clqmc_uint partIndex) \
+  { \
+    _CLQMC_CHECK(!batch, CLQMC_INVALID_VALUE, "%s(): batch cannot be NULL", __func__); \
+    _CLQMC_CHECK(problem >= batch->problems, CLQMC_INVALID_VALUE, "%s(): problem >= number of problems", __func__); \
+    _CLQMC_CHECK(replication >= _CLQMC_BATCH_TABLE(batch,_CLQMC_BATCH_MEM const)[problem].replications, \
+        CLQMC_INVALID_VALUE, "%s(): replication >= number of replications of the problem", __func__); \
+    _CLQMC_BATCH_MEM const clqmcLatticeRule* lattice = clqmcBatchLatticeRule(batch, problem); \
+    _CLQMC_BATCH_MEM const fptype* shifts = clqmcBatchShifts_##fptype(batch, problem); \
+    return clqmcLatticeRuleCreateOverStream_##fptype(stream, lattice, partCount, partIndex, \
+        shifts ? shifts + replication * lattice->dimension : shifts); \
+  }
+
+clqmc_uint clqmcBatchNumProblems(_CLQMC_BATCH_MEM const clqmcBatch* batch)
+{
+  return batch->problems;
+}
+
+clqmc_uint clqmcBatchReplications(_CLQMC_BATCH_MEM const clqmcBatch* batch, clqmc_uint problem)
+{
+  return _CLQMC_BATCH_TABLE(batch,_CLQMC_BATCH_MEM const)[problem].replications;
+}
+
+clqmc_uint clqmcBatchOutputOffset(_CLQMC_BATCH_MEM const clqmcBatch* batch, clqmc_uint problem)
+{
+  return _CLQMC_BATCH_TABLE(batch,_CLQMC_BATCH_MEM const)[problem].outputOffset;
+}
+
+_CLQMC_BATCH_MEM const clqmcLatticeRule* clqmcBatchLatticeRule(_CLQMC_BATCH_MEM const clqmcBatch* batch, clqmc_uint problem)
+{
+  return _CLQMC_BATCH_AT(batch,_CLQMC_BATCH_MEM const,clqmcLatticeRule,
+      _CLQMC_BATCH_TABLE(batch,_CLQMC_BATCH_MEM const)[problem].latticeOffset);
+}
+
+#ifdef __OPENCL_C_VERSION__
+  // On the device, implement only what is required to avoid cluttering memory.
+  #ifdef CLQMC_SINGLE_PRECISION
+    IMPLEMENT_BATCH_FOR_TYPE(float)
+  #else
+    IMPLEMENT_BATCH_FOR_TYPE(double)
+  #endif
+#else
+  // On the host, implement everything.
+  IMPLEMENT_BATCH_FOR_TYPE(clqmc_float)
+  IMPLEMENT_BATCH_FOR_TYPE(clqmc_double)
+#endif
+
+// Clean up macros, especially to avoid polluting device code.
+#undef IMPLEMENT_BATCH_FOR_TYPE
+#undef _CLQMC_CHECK
+
+/*
+    vim: ft=c sw=2
+*/
@@ -0,0 +1,71 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+
+// Definitions of the batch types, shared by the host and device headers and
+// by private/batch.c.h.
+
+#pragma once
+#ifndef CLQMC_PRIVATE_BATCH_TYPES_H
+#define CLQMC_PRIVATE_BATCH_TYPES_H
+
+#ifndef _CLQMC_BATCH_MEM
+#define _CLQMC_BATCH_MEM
+#endif
+
+// The actual batch object is the following structure followed by a table of
+// one entry per problem, then by the lattice rules and random shifts of the
+// problems, each starting at a multiple of _CLQMC_BATCH_ALIGNMENT bytes from
+// the beginning of the object.
+// The offsets are in bytes from the beginning of the object; a shift offset
+// of 0 means that the problem is not randomized.
+// The estimates of replication r of problem p are expected at index
+// outputOffset + r of the output array of the kernel.
+
+#define _CLQMC_BATCH_ALIGNMENT 16
+
+struct clqmcBatch_ {
+  clqmc_uint problems;
+  clqmc_uint outputs;
+  /* hidden members: */
+  /* struct clqmcBatchProblem_ table[problems]; */
+  /* data (lattice rules and shifts) */
+};
+
+struct clqmcBatchProblem_ {
+  clqmc_uint latticeOffset;
+  clqmc_uint shiftsOffset;
+  clqmc_uint replications;
+  clqmc_uint outputOffset;
+};
+
+// macros for hidden member access
+#define _CLQMC_BATCH_TABLE(batch,mem)                 ((mem struct clqmcBatchProblem_*)(&(batch)[1]))
+#define _CLQMC_BATCH_AT(batch,mem,type,offset)        ((mem type*)((mem char*)(batch) + (offset)))
+
+#endif
+
+/*
+    vim: ft=c sw=2
+*/
@@ -0,0 +1,121 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+// type definitions shared with the host header
+#include <clQMC/private/brownian.types.h>
+
+/********************************************************************************
+ * Implementation                                                               *
+ ********************************************************************************/
+
+// Argument checks.  On the device, they are compiled out if
+// CLQMC_DISABLE_CHECKS is defined.
+#if defined(__OPENCL_C_VERSION__) && defined(CLQMC_DISABLE_CHECKS)
+  #define _CLQMC_CHECK(cond, err, ...)
+#else
+  #define _CLQMC_CHECK(cond, err, ...) if (cond) return clqmcSetErrorString(err, __VA_ARGS__)
+#endif
+
+// Build the path into w from the normal variates obtained by evaluating
+// `normal` for k = 0, 1, ..., steps - 1, in that order.
+#define _CLQMC_BROWNIAN_BUILD(fptype, path, w, normal) \
+  do { \
+    clqmc_uint steps = (path)->steps; \
+    if ((path)->construction == CLQMC_BROWNIAN_PCA) { \
+      _CLQMC_BROWNIAN_MEM const fptype* scale = _CLQMC_BROWNIAN_SCALE(path,_CLQMC_BROWNIAN_MEM const,fptype); \
+      _CLQMC_BROWNIAN_MEM const fptype* sine  = _CLQMC_BROWNIAN_SINE(path,_CLQMC_BROWNIAN_MEM const,fptype); \
+      clqmc_uint period = 4 * steps + 2; \
+      for (clqmc_uint i = 0; i < steps; i++) \
+        (w)[i] = 0; \
+      for (clqmc_uint k = 0; k < steps; k++) { \
+        fptype zk = scale[k] * (normal); \
+        clqmc_uint m = 0; \
+        for (clqmc_uint i = 0; i < steps; i++) { \
+          m += 2 * k + 1; \
+          if (m >= period) \
+            m -= period; \
+          (w)[i] += zk * sine[m]; \
+        } \
+      } \
+    } \
+    else { \
+      _CLQMC_BROWNIAN_MEM const fptype* leftWeight  = _CLQMC_BROWNIAN_LEFTWEIGHT(path,_CLQMC_BROWNIAN_MEM const,fptype); \
+      _CLQMC_BROWNIAN_MEM const fptype* rightWeight = _CLQMC_BROWNIAN_RIGHTWEIGHT(path,_CLQMC_BROWNIAN_MEM const,fptype); \
+      _CLQMC_BROWNIAN_MEM const fptype* stdDev      = _CLQMC_BROWNIAN_STDDEV(path,_CLQMC_BROWNIAN_MEM const,fptype); \
+      _CLQMC_BROWNIAN_MEM const clqmc_uint* index   = _CLQMC_BROWNIAN_INDEX(path,_CLQMC_BROWNIAN_MEM const,fptype); \
+      _CLQMC_BROWNIAN_MEM const clqmc_uint* left    = _CLQMC_BROWNIAN_LEFT(path,_CLQMC_BROWNIAN_MEM const,fptype); \
+      _CLQMC_BROWNIAN_MEM const clqmc_uint* right   = _CLQMC_BROWNIAN_RIGHT(path,_CLQMC_BROWNIAN_MEM const,fptype); \
+      for (clqmc_uint k = 0; k < steps; k++) { \
+        fptype x = stdDev[k] * (normal); \
+        if (left[k] < steps) \
+          x += leftWeight[k] * (w)[left[k]]; \
+        if (right[k] < steps) \
+          x += rightWeight[k] * (w)[right[k]]; \
+        (w)[index[k]] = x; \
+      } \
+    } \
+  } while (0)
+
+#define IMPLEMENT_BROWNIAN_FOR_TYPE(fptype) \
+  \
+  clqmcStatus clqmcBrownianPathFromNormals_##fptype(_CLQMC_BROWNIAN_MEM const clqmcBrownianPath* path, const fptype* z, fptype* w) \
+  { \
+    _CLQMC_CHECK(!path || !z || !w, CLQMC_INVALID_VALUE, "%s(): path, z and w cannot be NULL", __func__); \
+    _CLQMC_BROWNIAN_BUILD(fptype, path, w, z[k]); \
+    return CLQMC_SUCCESS; \
+  } \
+  \
+  clqmcStatus clqmcBrownianPathNextPath_##fptype(_CLQMC_BROWNIAN_MEM const clqmcBrownianPath* path, clqmcLatticeRuleStream* stream, fptype* w) \
+  { \
+    _CLQMC_CHECK(!path || !stream || !w, CLQMC_INVALID_VALUE, "%s(): path, stream and w cannot be NULL", __func__); \
+    _CLQMC_BROWNIAN_BUILD(fptype, path, w, clqmcLatticeRuleNextNormal_##fptype(stream)); \
+    return CLQMC_SUCCESS; \
+  }
+
+#ifdef __OPENCL_C_VERSION__
+  // On the device, implement only what is required to avoid cluttering memory.
+  #ifdef CLQMC_SINGLE_PRECISION
+    IMPLEMENT_BROWNIAN_FOR_TYPE(float)
+  #else
+    IMPLEMENT_BROWNIAN_FOR_TYPE(double)
+  #endif
+#else
+  // On the host, implement everything.
+  IMPLEMENT_BROWNIAN_FOR_TYPE(clqmc_float)
+  IMPLEMENT_BROWNIAN_FOR_TYPE(clqmc_double)
+#endif
+
+clqmc_uint clqmcBrownianPathSteps(_CLQMC_BROWNIAN_MEM const clqmcBrownianPath* path)
+{
+  return path->steps;
+}
+
+// Clean up macros, especially to avoid polluting device code.
+#undef IMPLEMENT_BROWNIAN_FOR_TYPE
+#undef _CLQMC_BROWNIAN_BUILD
+#undef _CLQMC_CHECK
+
+/*
+    vim: ft=c sw=2
+*/
@@ -0,0 +1,90 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+// Definitions of the Brownian path types, shared by the host and device
+// headers and by private/brownian.c.h.
+
+#pragma once
+#ifndef CLQMC_PRIVATE_BROWNIAN_TYPES_H
+#define CLQMC_PRIVATE_BROWNIAN_TYPES_H
+
+#ifndef _CLQMC_BROWNIAN_MEM
+#define _CLQMC_BROWNIAN_MEM
+#endif
+
+/*! @brief Construction of Brownian paths from standard normal variates [**device**]
+ *
+ *  @see clqmcBrownianPathCreate()
+ */
+typedef enum clqmcBrownianConstruction_ {
+  CLQMC_BROWNIAN_SEQUENTIAL = 0,    /*!< Increments in time order (random walk). */
+  CLQMC_BROWNIAN_BRIDGE,            /*!< Brownian bridge, by bisection. */
+  CLQMC_BROWNIAN_PCA                /*!< Principal component analysis. */
+} clqmcBrownianConstruction;
+
+// The actual path object is the following structure followed by arrays whose
+// locations in memory are computed using macros, as for lattice rules.
+//
+// For the sequential and bridge constructions, step k sets the value at time
+// index index[k] to
+//   leftWeight[k] * w[left[k]] + rightWeight[k] * w[right[k]] + stdDev[k] * z[k],
+// where a left or right index equal to the number of steps stands for the
+// origin or for no point, with a zero weight.
+//
+// For the PCA (equally spaced times only), the value at time index i is
+//   sum over k of scale[k] * sine[(2k + 1)(i + 1) mod (4d + 2)] * z[k],
+// where sine[m] = sin(pi m / (2d + 1)) and scale[k] is the square root of the
+// k-th eigenvalue of the covariance matrix times the normalization of the
+// eigenvectors.
+
+struct clqmcBrownianPath_ {
+  clqmc_uint steps;
+  clqmc_uint construction;
+  /* hidden members (sequential and bridge): */
+  /* _CLQMC_FPTYPE leftWeight[steps]; */
+  /* _CLQMC_FPTYPE rightWeight[steps]; */
+  /* _CLQMC_FPTYPE stdDev[steps]; */
+  /* clqmc_uint    index[steps]; */
+  /* clqmc_uint    left[steps]; */
+  /* clqmc_uint    right[steps]; */
+  /* hidden members (PCA): */
+  /* _CLQMC_FPTYPE scale[steps]; */
+  /* _CLQMC_FPTYPE sine[4 * steps + 2]; */
+};
+
+// macros for hidden member access
+#define _CLQMC_BROWNIAN_LEFTWEIGHT(path,mem,fptype)   ((mem fptype*)(&(path)[1]))
+#define _CLQMC_BROWNIAN_RIGHTWEIGHT(path,mem,fptype)  (&_CLQMC_BROWNIAN_LEFTWEIGHT(path,mem,fptype)[(path)->steps])
+#define _CLQMC_BROWNIAN_STDDEV(path,mem,fptype)       (&_CLQMC_BROWNIAN_LEFTWEIGHT(path,mem,fptype)[2 * (path)->steps])
+#define _CLQMC_BROWNIAN_INDEX(path,mem,fptype)        ((mem clqmc_uint*)(&_CLQMC_BROWNIAN_LEFTWEIGHT(path,mem,fptype)[3 * (path)->steps]))
+#define _CLQMC_BROWNIAN_LEFT(path,mem,fptype)         (&_CLQMC_BROWNIAN_INDEX(path,mem,fptype)[(path)->steps])
+#define _CLQMC_BROWNIAN_RIGHT(path,mem,fptype)        (&_CLQMC_BROWNIAN_INDEX(path,mem,fptype)[2 * (path)->steps])
+#define _CLQMC_BROWNIAN_SCALE(path,mem,fptype)        ((mem fptype*)(&(path)[1]))
+#define _CLQMC_BROWNIAN_SINE(path,mem,fptype)         (&_CLQMC_BROWNIAN_SCALE(path,mem,fptype)[(path)->steps])
+
+#endif
+
+/*
+    vim: ft=c sw=2
+*/
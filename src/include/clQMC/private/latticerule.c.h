@@ -21,76 +21,216 @@
  *
  */
 
-// The actual distribution object is the following structure followed by an
-// array of type clqmc_int[].
-// The array is neither named nor pointed to by any member of the structure.
-// Its location in memory is computed using a macro.
+// type definitions shared with the host header
+#include <clQMC/private/latticerule.types.h>
 
-// macros for hidden member access
-#define _CLQMC_LATTICE_GENVEC(lat,mem)                   ((mem clqmc_int*)(&(lat)[1]))
-#define _CLQMC_LATTICE_GENVECNORMED(lat,mem,fptype)      ((mem fptype*)(&_CLQMC_LATTICE_GENVEC(lat,mem)[lat->dimension]))
+/********************************************************************************
+ * Implementation                                                               *
+ ********************************************************************************/
 
-#ifndef _CLQMC_LATTICE_MEM
-#define _CLQMC_LATTICE_MEM
+// Hot path of the streams.
+// When CLQMC_INLINE_STREAMS is defined on the host, latticerule.h includes
+// this file with _CLQMC_INLINE_HOT_PATH defined, to obtain only the following
+// functions as static inline functions that can be inlined into client loops.
+#ifdef _CLQMC_INLINE_HOT_PATH
+  #define _CLQMC_HOT static inline
+#else
+  #define _CLQMC_HOT
 #endif
 
-#ifndef _CLQMC_SHIFT_MEM
-#define _CLQMC_SHIFT_MEM
+#define IMPLEMENT_STREAM_HOT_PATH_FOR_TYPE(fptype) \
+  \
+  fptype clqmcLatticeRulePaddedCoordinate_##fptype(clqmcLatticeRuleStream* stream); \
+  \
+  _CLQMC_HOT fptype clqmcLatticeRuleNextCoordinate_##fptype(clqmcLatticeRuleStream* stream) { \
+    if (stream->coordinateIndex >= stream->lattice->dimension) \
+      return stream->padding ? clqmcLatticeRulePaddedCoordinate_##fptype(stream) : -1.0; \
+    fptype ret = fmod( \
+        _CLQMC_LATTICE_GENVECNORMED(stream->lattice,_CLQMC_LATTICE_MEM const,fptype)[stream->coordinateIndex] * stream->pointIndex \
+        + (stream->shift ? ((_CLQMC_SHIFT_MEM const fptype*)stream->shift)[stream->coordinateIndex] : (fptype) 0.0), \
+        (fptype) 1.0); \
+    if (stream->baker) \
+      ret = clqmcBakerTransform_##fptype(ret); \
+    stream->coordinateIndex++; \
+    return ret; \
+  }
+
+#ifdef __OPENCL_C_VERSION__
+  #ifdef CLQMC_SINGLE_PRECISION
+    IMPLEMENT_STREAM_HOT_PATH_FOR_TYPE(float)
+  #else
+    IMPLEMENT_STREAM_HOT_PATH_FOR_TYPE(double)
+  #endif
+#else
+  IMPLEMENT_STREAM_HOT_PATH_FOR_TYPE(clqmc_float)
+  IMPLEMENT_STREAM_HOT_PATH_FOR_TYPE(clqmc_double)
 #endif
 
-/********************************************************************************
- * Functions and types declarations                                             *
- ********************************************************************************/
+#undef IMPLEMENT_STREAM_HOT_PATH_FOR_TYPE
+
+_CLQMC_HOT clqmc_uint clqmcLatticeRuleForwardToNextPoint(clqmcLatticeRuleStream* stream) {
+  stream->coordinateIndex = 0;
+  stream->pointIndex += stream->pointStride;
+  return stream->pointIndex;
+}
 
-struct clqmcLatticeRule_ {
-    clqmc_uint   numPoints;
-    clqmc_uint   dimension;
-    // TODO: in the docs, mention device & host must use same FPTYPE
-    /* hidden members: */
-    /* clqmc_int     genVec[dimension]; */
-    /* _CLQMC_FPTYPE genVecNormed[dimension]; */
-};
-
-// IMPORTANT: cannot be transferred to device
-struct clqmcLatticeRuleStream_ {
-  _CLQMC_LATTICE_MEM const clqmcLatticeRule* lattice;
-  clqmc_uint pointIndex;
-  clqmc_uint coordinateIndex;
-  _CLQMC_SHIFT_MEM const void* shift;
-};
+// FIXME: maybe as a macro?
+_CLQMC_HOT clqmc_uint clqmcLatticeRuleCurrentPointIndex(const clqmcLatticeRuleStream* stream)
+{
+  return stream->pointIndex;
+}
 
-/********************************************************************************
- * Implementation                                                               *
- ********************************************************************************/
+// FIXME: maybe as a macro?
+_CLQMC_HOT clqmc_uint clqmcLatticeRuleCurrentCoordIndex(const clqmcLatticeRuleStream* stream)
+{
+  return stream->coordinateIndex;
+}
+
+#undef _CLQMC_HOT
+
+#ifndef _CLQMC_INLINE_HOT_PATH
 
 // We use an underscore on the r.h.s. to avoid potential recursion with certain
 // preprocessors.
+// Argument checks.  On the device, they are compiled out if
+// CLQMC_DISABLE_CHECKS is defined.
+#if defined(__OPENCL_C_VERSION__) && defined(CLQMC_DISABLE_CHECKS)
+  #define _CLQMC_CHECK(cond, err, ...)
+#else
+  #define _CLQMC_CHECK(cond, err, ...) if (cond) return clqmcSetErrorString(err, __VA_ARGS__)
+#endif
+
+// Streams are copied from host streams in global memory on the device and
+// from host streams in host memory on the host.
+#ifdef __OPENCL_C_VERSION__
+  #define _CLQMC_HOST_STREAM_MEM                __global
+  #define _CLQMC_COPY_OVER_STREAMS(fptype)      clqmcLatticeRuleCopyOverStreamsFromGlobal_##fptype
+#else
+  #define _CLQMC_HOST_STREAM_MEM
+  #define _CLQMC_COPY_OVER_STREAMS(fptype)      clqmcLatticeRuleCopyOverStreams_##fptype
+#endif
+
+// Padding beyond the dimension s of the lattice rule.
+//
+// Random padding: coordinate j of point i for replication k is the uniform
+// value obtained from Philox4x32-10 for the counter (j, k, 1, i).
+//
+// Latin supercube padding: coordinates bs to (b+1)s-1 of point i form the
+// point pi_b(i mod n) of the lattice rule, shifted by coordinates bs to
+// (b+1)s-1 of the random shift of replication k, where pi_b is a random
+// permutation of {0,...,n-1}.  The permutation is a balanced Feistel network
+// of 4 rounds on the smallest domain of 4^h >= n elements, whose round
+// function uses Philox4x32-10 for the counter (half, k, 2, 4b + round),
+// restricted to {0,...,n-1} by cycle walking.
+clqmc_uint clqmcLatticeRulePaddingPermutation(clqmc_ulong seed, clqmc_uint replication, clqmc_uint block, clqmc_uint n, clqmc_uint i)
+{
+  clqmc_uint h = 0;
+  while (h < 16 && ((clqmc_ulong) 1 << (2 * h)) < n)
+    h++;
+  clqmc_uint mask = ((clqmc_uint) 1 << h) - 1;
+  do {
+    clqmc_uint left  = i >> h;
+    clqmc_uint right = i & mask;
+    for (clqmc_uint round = 0; round < 4; round++) {
+      clqmc_uint ctr[4] = { right, replication, 2, 4 * block + round };
+      clqmcPhilox4x32_10(ctr, (clqmc_uint) seed, (clqmc_uint) (seed >> 32));
+      clqmc_uint next = left ^ (ctr[0] & mask);
+      left = right;
+      right = next;
+    }
+    i = (left << h) | right;
+  } while (i >= n);
+  return i;
+}
+
 #define IMPLEMENT_STREAM_FOR_TYPE(fptype) \
   \
-  clqmcStatus clqmcLatticeRuleCreateOverStream_##fptype(clqmcLatticeRuleStream* stream, _CLQMC_LATTICE_MEM const clqmcLatticeRule* lattice, clqmc_uint partCount, clqmc_uint partIndex, _CLQMC_SHIFT_MEM const fptype* shift) \
+  void clqmcLatticeRuleCreateOverStreamUnchecked_##fptype(clqmcLatticeRuleStream* stream, _CLQMC_LATTICE_MEM const clqmcLatticeRule* lattice, clqmc_uint partCount, clqmc_uint partIndex, _CLQMC_SHIFT_MEM const fptype* shift) \
   { \
-    if (!stream) \
-      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): stream cannot be NULL", __func__); \
-    if (partIndex >= partCount) \
-      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): partIndex >= partCount", __func__); \
-    if (lattice->numPoints % partCount != 0) \
-      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): number of points must be a multiple of partCount", __func__); \
     stream->lattice = lattice; \
     stream->pointIndex = (lattice->numPoints / partCount) * partIndex; \
     stream->coordinateIndex = 0; \
     stream->shift = shift; \
+    stream->baker = 0; \
+    stream->pointStride = 1; \
+    stream->padding = NULL; \
+  } \
+  \
+  clqmcStatus clqmcLatticeRuleCreateOverStream_##fptype(clqmcLatticeRuleStream* stream, _CLQMC_LATTICE_MEM const clqmcLatticeRule* lattice, clqmc_uint partCount, clqmc_uint partIndex, _CLQMC_SHIFT_MEM const fptype* shift) \
+  { \
+    _CLQMC_CHECK(!stream, CLQMC_INVALID_VALUE, "%s(): stream cannot be NULL", __func__); \
+    _CLQMC_CHECK(partIndex >= partCount, CLQMC_INVALID_VALUE, "%s(): partIndex >= partCount", __func__); \
+    _CLQMC_CHECK(lattice->numPoints % partCount != 0, CLQMC_INVALID_VALUE, "%s(): number of points must be a multiple of partCount", __func__); \
+    clqmcLatticeRuleCreateOverStreamUnchecked_##fptype(stream, lattice, partCount, partIndex, shift); \
     return CLQMC_SUCCESS; \
   } \
   \
-  fptype clqmcLatticeRuleNextCoordinate_##fptype(clqmcLatticeRuleStream* stream) { \
-    if (stream->coordinateIndex >= stream->lattice->dimension) \
-      return -1.0; \
-    fptype ret = fmod( \
-        _CLQMC_LATTICE_GENVECNORMED(stream->lattice,_CLQMC_LATTICE_MEM const,fptype)[stream->coordinateIndex] * stream->pointIndex \
-        + (stream->shift ? ((_CLQMC_SHIFT_MEM const fptype*)stream->shift)[stream->coordinateIndex] : (fptype) 0.0), \
-        (fptype) 1.0); \
-    stream->coordinateIndex++; \
+  clqmcStatus clqmcLatticeRuleCreateStridedOverStream_##fptype(clqmcLatticeRuleStream* stream, _CLQMC_LATTICE_MEM const clqmcLatticeRule* lattice, clqmc_uint partCount, clqmc_uint partIndex, _CLQMC_SHIFT_MEM const fptype* shift) \
+  { \
+    _CLQMC_CHECK(!stream, CLQMC_INVALID_VALUE, "%s(): stream cannot be NULL", __func__); \
+    _CLQMC_CHECK(partIndex >= partCount, CLQMC_INVALID_VALUE, "%s(): partIndex >= partCount", __func__); \
+    _CLQMC_CHECK(lattice->numPoints % partCount != 0, CLQMC_INVALID_VALUE, "%s(): number of points must be a multiple of partCount", __func__); \
+    clqmcLatticeRuleCreateOverStreamUnchecked_##fptype(stream, lattice, partCount, partIndex, shift); \
+    stream->pointIndex = partIndex; \
+    stream->pointStride = partCount; \
+    return CLQMC_SUCCESS; \
+  } \
+  \
+  clqmcStatus _CLQMC_COPY_OVER_STREAMS(fptype)(clqmc_uint count, clqmcLatticeRuleStream* streams, _CLQMC_HOST_STREAM_MEM const clqmcLatticeRuleHostStream* hostStreams, _CLQMC_LATTICE_MEM const clqmcLatticeRule* lattice, _CLQMC_SHIFT_MEM const fptype* shifts) \
+  { \
+    _CLQMC_CHECK(!streams || !hostStreams, CLQMC_INVALID_VALUE, "%s(): streams and hostStreams cannot be NULL", __func__); \
+    for (clqmc_uint i = 0; i < count; i++) { \
+      clqmcLatticeRuleHostStream hostStream = hostStreams[i]; \
+      streams[i].lattice = lattice; \
+      streams[i].pointIndex = hostStream.pointIndex; \
+      streams[i].coordinateIndex = hostStream.coordinateIndex; \
+      streams[i].shift = shifts ? shifts + (size_t) hostStream.replication * lattice->dimension : shifts; \
+      streams[i].baker = hostStream.baker; \
+      streams[i].pointStride = 1; \
+      streams[i].padding = NULL; \
+    } \
+    return CLQMC_SUCCESS; \
+  } \
+  \
+  fptype clqmcLatticeRulePaddedCoordinate_##fptype(clqmcLatticeRuleStream* stream) \
+  { \
+    clqmcLatticeRulePaddingState* state = stream->padding; \
+    clqmc_uint dimension = stream->lattice->dimension; \
+    clqmc_uint coord = stream->coordinateIndex++; \
+    fptype ret; \
+    if (state->padding == CLQMC_PADDING_RANDOM) \
+      ret = clqmcPhiloxUniform_##fptype(state->seed, coord, state->replication, 1, stream->pointIndex); \
+    else { \
+      clqmc_uint block = coord / dimension; \
+      if (block != state->block || stream->pointIndex != state->point) { \
+        state->block = block; \
+        state->point = stream->pointIndex; \
+        state->image = clqmcLatticeRulePaddingPermutation(state->seed, state->replication, block, \
+            stream->lattice->numPoints, stream->pointIndex % stream->lattice->numPoints); \
+      } \
+      ret = fmod( \
+          _CLQMC_LATTICE_GENVECNORMED(stream->lattice,_CLQMC_LATTICE_MEM const,fptype)[coord - block * dimension] * state->image \
+          + clqmcRandomShiftCoordinate_##fptype(state->seed, state->replication, coord), \
+          (fptype) 1.0); \
+    } \
+    if (stream->baker) \
+      ret = clqmcBakerTransform_##fptype(ret); \
     return ret; \
+  } \
+  \
+  fptype clqmcLatticeRuleNextNormal_##fptype(clqmcLatticeRuleStream* stream) { \
+    fptype u = clqmcLatticeRuleNextCoordinate_##fptype(stream); \
+    return u < (fptype) 0.0 ? (fptype) NAN : clqmcStdNormalInverseCDF_##fptype(u); \
+  } \
+  \
+  fptype clqmcLatticeRuleNextExponential_##fptype(clqmcLatticeRuleStream* stream) { \
+    fptype u = clqmcLatticeRuleNextCoordinate_##fptype(stream); \
+    return u < (fptype) 0.0 ? (fptype) NAN : clqmcExponentialInverseCDF_##fptype(u); \
+  } \
+  \
+  fptype clqmcLatticeRuleNextGamma_##fptype(clqmcLatticeRuleStream* stream, fptype shape) { \
+    fptype u = clqmcLatticeRuleNextCoordinate_##fptype(stream); \
+    return u < (fptype) 0.0 ? (fptype) NAN : clqmcGammaInverseCDF_##fptype(shape, u); \
   }
 
 #ifdef __OPENCL_C_VERSION__
@@ -108,11 +248,32 @@ struct clqmcLatticeRuleStream_ {
 
 // Clean up macros, especially to avoid polluting device code.
 #undef IMPLEMENT_STREAM_FOR_TYPE
+#undef _CLQMC_HOST_STREAM_MEM
+#undef _CLQMC_COPY_OVER_STREAMS
 
-clqmc_uint clqmcLatticeRuleForwardToNextPoint(clqmcLatticeRuleStream* stream) {
-  stream->coordinateIndex = 0;
-  stream->pointIndex++;
-  return stream->pointIndex;
+clqmcStatus clqmcLatticeRuleSetBakerTransform(clqmcLatticeRuleStream* stream, clqmc_uint enable)
+{
+  _CLQMC_CHECK(!stream, CLQMC_INVALID_VALUE, "%s(): stream cannot be NULL", __func__);
+  stream->baker = enable ? 1 : 0;
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcLatticeRuleSetPadding(clqmcLatticeRuleStream* stream, clqmcLatticeRulePaddingState* state, clqmcLatticeRulePadding padding, clqmc_ulong seed, clqmc_uint replication)
+{
+  _CLQMC_CHECK(!stream, CLQMC_INVALID_VALUE, "%s(): stream cannot be NULL", __func__);
+  _CLQMC_CHECK(padding > CLQMC_PADDING_LATIN_SUPERCUBE, CLQMC_INVALID_VALUE, "%s(): invalid padding", __func__);
+  _CLQMC_CHECK(!state && padding != CLQMC_PADDING_NONE, CLQMC_INVALID_VALUE, "%s(): state cannot be NULL with padding", __func__);
+  if (padding == CLQMC_PADDING_NONE) {
+    stream->padding = NULL;
+    return CLQMC_SUCCESS;
+  }
+  state->padding = padding;
+  state->seed = seed;
+  state->replication = replication;
+  // no padding coordinate belongs to block 0, so the cache starts empty
+  state->block = 0;
+  stream->padding = state;
+  return CLQMC_SUCCESS;
 }
 
 // FIXME: maybe as a macro?
@@ -127,17 +288,8 @@ clqmc_uint clqmcLatticeRuleDimension(_CLQMC_LATTICE_MEM const clqmcLatticeRule*
   return lattice->dimension;
 }
 
+#undef _CLQMC_CHECK
 
-// FIXME: maybe as a macro?
-clqmc_uint clqmcLatticeRuleCurrentPointIndex(const clqmcLatticeRuleStream* stream)
-{
-  return stream->pointIndex;
-}
-
-// FIXME: maybe as a macro?
-clqmc_uint clqmcLatticeRuleCurrentCoordIndex(const clqmcLatticeRuleStream* stream)
-{
-  return stream->coordinateIndex;
-}
+#endif // _CLQMC_INLINE_HOT_PATH
 
 
@@ -0,0 +1,106 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+// Definitions of the lattice rule types, shared by the host and device
+// headers and by private/latticerule.c.h.
+
+#pragma once
+#ifndef CLQMC_PRIVATE_LATTICERULE_TYPES_H
+#define CLQMC_PRIVATE_LATTICERULE_TYPES_H
+
+// The actual distribution object is the following structure followed by an
+// array of type clqmc_int[].
+// The array is neither named nor pointed to by any member of the structure.
+// Its location in memory is computed using a macro.
+
+// macros for hidden member access
+#define _CLQMC_LATTICE_GENVEC(lat,mem)                   ((mem clqmc_int*)(&(lat)[1]))
+#define _CLQMC_LATTICE_GENVECNORMED(lat,mem,fptype)      ((mem fptype*)(&_CLQMC_LATTICE_GENVEC(lat,mem)[lat->dimension]))
+
+#ifndef _CLQMC_LATTICE_MEM
+#define _CLQMC_LATTICE_MEM
+#endif
+
+#ifndef _CLQMC_SHIFT_MEM
+#define _CLQMC_SHIFT_MEM
+#endif
+
+/********************************************************************************
+ * Functions and types declarations                                             *
+ ********************************************************************************/
+
+struct clqmcLatticeRule_ {
+    clqmc_uint   numPoints;
+    clqmc_uint   dimension;
+    // TODO: in the docs, mention device & host must use same FPTYPE
+    /* hidden members: */
+    /* clqmc_int     genVec[dimension]; */
+    /* _CLQMC_FPTYPE genVecNormed[dimension]; */
+};
+
+/*! @brief Padding of lattice rule streams beyond the dimension [**device**]
+ *
+ *  @see clqmcLatticeRuleSetPadding()
+ */
+typedef enum clqmcLatticeRulePadding_ {
+  CLQMC_PADDING_NONE = 0,           /*!< No coordinates beyond the dimension (the default). */
+  CLQMC_PADDING_RANDOM,             /*!< Independent uniform random numbers. */
+  CLQMC_PADDING_LATIN_SUPERCUBE     /*!< Randomly permuted copies of the lattice rule. */
+} clqmcLatticeRulePadding;
+
+// Padding beyond the dimension of the lattice rule, kept out of the stream
+// so that streams without padding only carry a null pointer.
+struct clqmcLatticeRulePaddingState_ {
+  clqmc_uint padding;
+  clqmc_uint replication;
+  clqmc_ulong seed;
+  // cached Latin supercube permutation: block, point index and its image
+  clqmc_uint block;
+  clqmc_uint point;
+  clqmc_uint image;
+};
+
+// IMPORTANT: cannot be transferred to device; see clqmcLatticeRuleHostStream_
+struct clqmcLatticeRuleStream_ {
+  _CLQMC_LATTICE_MEM const clqmcLatticeRule* lattice;
+  clqmc_uint pointIndex;
+  clqmc_uint coordinateIndex;
+  _CLQMC_SHIFT_MEM const void* shift;
+  clqmc_uint baker;
+  clqmc_uint pointStride;
+  clqmcLatticeRulePaddingState* padding;   // NULL without padding
+};
+
+// Pointer-free stream state that can be copied to the device, 16 bytes.
+struct clqmcLatticeRuleHostStream_ {
+  clqmc_uint pointIndex;
+  clqmc_uint coordinateIndex;
+  clqmc_uint replication;
+  clqmc_uint baker;
+};
+
+#endif
+
+/*
+    vim: ft=c sw=2
+*/
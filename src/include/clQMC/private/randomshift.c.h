@@ -0,0 +1,119 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+// Random shifts, shared by the host and the device.
+//
+// Coordinate j of the shift of replication k is obtained from the output of
+// Philox4x32-10 for the counter (j, k, 0, 0) and the key (low and high
+// halves of the seed).  The third counter word selects the purpose of the
+// random numbers: 0 for random shifts, 1 for the random padding of lattice
+// rule streams and 2 for the permutations of Latin supercube padding (see
+// private/latticerule.c.h).  The double-precision value uses the 53 high bits
+// of the first two output words and the single-precision value uses the 24
+// high bits of the first word, so it is the double-precision value truncated
+// to single precision.
+
+/********************************************************************************
+ * Implementation                                                               *
+ ********************************************************************************/
+
+#define CLQMC_PHILOX_M0   0xD2511F53U
+#define CLQMC_PHILOX_M1   0xCD9E8D57U
+#define CLQMC_PHILOX_W0   0x9E3779B9U
+#define CLQMC_PHILOX_W1   0xBB67AE85U
+
+// Apply the 10 rounds of Philox4x32 to `ctr` in place.
+void clqmcPhilox4x32_10(clqmc_uint ctr[4], clqmc_uint key0, clqmc_uint key1)
+{
+  for (int round = 0; round < 10; round++) {
+    clqmc_ulong p0 = (clqmc_ulong) CLQMC_PHILOX_M0 * ctr[0];
+    clqmc_ulong p1 = (clqmc_ulong) CLQMC_PHILOX_M1 * ctr[2];
+    clqmc_uint x0 = (clqmc_uint) (p1 >> 32) ^ ctr[1] ^ key0;
+    clqmc_uint x1 = (clqmc_uint) p1;
+    clqmc_uint x2 = (clqmc_uint) (p0 >> 32) ^ ctr[3] ^ key1;
+    clqmc_uint x3 = (clqmc_uint) p0;
+    ctr[0] = x0;
+    ctr[1] = x1;
+    ctr[2] = x2;
+    ctr[3] = x3;
+    key0 += CLQMC_PHILOX_W0;
+    key1 += CLQMC_PHILOX_W1;
+  }
+}
+
+// Single precision: 24 bits of the first output word.
+#define IMPLEMENT_RANDOM_SHIFT_24_FOR_TYPE(fptype) \
+  \
+  fptype clqmcPhiloxUniform_##fptype(clqmc_ulong seed, clqmc_uint c0, clqmc_uint c1, clqmc_uint c2, clqmc_uint c3) \
+  { \
+    clqmc_uint ctr[4] = { c0, c1, c2, c3 }; \
+    clqmcPhilox4x32_10(ctr, (clqmc_uint) seed, (clqmc_uint) (seed >> 32)); \
+    return (ctr[0] >> 8) * (1.0f / 16777216.0f); \
+  } \
+  \
+  IMPLEMENT_RANDOM_SHIFT_COORDINATE_FOR_TYPE(fptype)
+
+// Double precision: 53 bits of the first two output words.
+#define IMPLEMENT_RANDOM_SHIFT_53_FOR_TYPE(fptype) \
+  \
+  fptype clqmcPhiloxUniform_##fptype(clqmc_ulong seed, clqmc_uint c0, clqmc_uint c1, clqmc_uint c2, clqmc_uint c3) \
+  { \
+    clqmc_uint ctr[4] = { c0, c1, c2, c3 }; \
+    clqmcPhilox4x32_10(ctr, (clqmc_uint) seed, (clqmc_uint) (seed >> 32)); \
+    return ((((clqmc_ulong) ctr[0]) << 21) | (ctr[1] >> 11)) * (1.0 / 9007199254740992.0); \
+  } \
+  \
+  IMPLEMENT_RANDOM_SHIFT_COORDINATE_FOR_TYPE(fptype)
+
+#define IMPLEMENT_RANDOM_SHIFT_COORDINATE_FOR_TYPE(fptype) \
+  \
+  fptype clqmcRandomShiftCoordinate_##fptype(clqmc_ulong seed, clqmc_uint replication, clqmc_uint coord) \
+  { \
+    return clqmcPhiloxUniform_##fptype(seed, coord, replication, 0, 0); \
+  }
+
+#ifdef __OPENCL_C_VERSION__
+  // On the device, implement only what is required to avoid cluttering memory.
+  #ifdef CLQMC_SINGLE_PRECISION
+    IMPLEMENT_RANDOM_SHIFT_24_FOR_TYPE(float)
+  #else
+    IMPLEMENT_RANDOM_SHIFT_53_FOR_TYPE(double)
+  #endif
+#else
+  // On the host, implement everything.
+  IMPLEMENT_RANDOM_SHIFT_24_FOR_TYPE(clqmc_float)
+  IMPLEMENT_RANDOM_SHIFT_53_FOR_TYPE(clqmc_double)
+#endif
+
+// Clean up macros, especially to avoid polluting device code.
+#undef IMPLEMENT_RANDOM_SHIFT_24_FOR_TYPE
+#undef IMPLEMENT_RANDOM_SHIFT_53_FOR_TYPE
+#undef IMPLEMENT_RANDOM_SHIFT_COORDINATE_FOR_TYPE
+#undef CLQMC_PHILOX_M0
+#undef CLQMC_PHILOX_M1
+#undef CLQMC_PHILOX_W0
+#undef CLQMC_PHILOX_W1
+
+/*
+    vim: ft=c sw=2
+*/
@@ -0,0 +1,235 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+// Transformations of uniform coordinates, shared by the host and the device.
+//
+// The standard normal inverse CDF is Wichura's algorithm AS241: PPND16 (about
+// 16 significant digits) in double precision and PPND7 (about 7 significant
+// digits) in single precision.  Both use a single rational approximation per
+// region and no iteration, which keeps divergence low across work items.
+
+/********************************************************************************
+ * Implementation                                                               *
+ ********************************************************************************/
+
+// PPND16, for double precision.
+#define IMPLEMENT_NORMAL_PPND16_FOR_TYPE(fptype) \
+  \
+  fptype clqmcStdNormalInverseCDF_##fptype(fptype u) \
+  { \
+    fptype q = u - (fptype) 0.5; \
+    fptype r, num, den; \
+    if (fabs(q) <= (fptype) 0.425) { \
+      r = (fptype) 0.180625 - q * q; \
+      num = (((((((2.5090809287301226727e+3 * r + 3.3430575583588128105e+4) * r \
+              + 6.7265770927008700853e+4) * r + 4.5921953931549871457e+4) * r \
+              + 1.3731693765509461125e+4) * r + 1.9715909503065514427e+3) * r \
+              + 1.3314166789178437745e+2) * r + 3.3871328727963666080e+0); \
+      den = (((((((5.2264952788528545610e+3 * r + 2.8729085735721942674e+4) * r \
+              + 3.9307895800092710610e+4) * r + 2.1213794301586595867e+4) * r \
+              + 5.3941960214247511077e+3) * r + 6.8718700749205790830e+2) * r \
+              + 4.2313330701600911252e+1) * r + 1.0); \
+      return q * num / den; \
+    } \
+    r = q < 0 ? u : (fptype) 1.0 - u; \
+    if (r <= (fptype) 0.0) \
+      return q < 0 ? -INFINITY : INFINITY; \
+    r = sqrt(-log(r)); \
+    if (r <= (fptype) 5.0) { \
+      r -= (fptype) 1.6; \
+      num = (((((((7.74545014278341407640e-4 * r + 2.27238449892691845833e-2) * r \
+              + 2.41780725177450611770e-1) * r + 1.27045825245236838258e+0) * r \
+              + 3.64784832476320460504e+0) * r + 5.76949722146069140550e+0) * r \
+              + 4.63033784615654529590e+0) * r + 1.42343711074968357734e+0); \
+      den = (((((((1.05075007164441684324e-9 * r + 5.47593808499534494600e-4) * r \
+              + 1.51986665636164571966e-2) * r + 1.48103976427480074590e-1) * r \
+              + 6.89767334985100004550e-1) * r + 1.67638483018380384940e+0) * r \
+              + 2.05319162663775882187e+0) * r + 1.0); \
+    } \
+    else { \
+      r -= (fptype) 5.0; \
+      num = (((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r \
+              + 1.24266094738807843860e-3) * r + 2.65321895265761230930e-2) * r \
+              + 2.96560571828504891230e-1) * r + 1.78482653991729133580e+0) * r \
+              + 5.46378491116411436990e+0) * r + 6.65790464350110377720e+0); \
+      den = (((((((2.04426310338993978564e-15 * r + 1.42151175831644588870e-7) * r \
+              + 1.84631831751005468180e-5) * r + 7.86869131145613259100e-4) * r \
+              + 1.48753612908506148525e-2) * r + 1.36929880922735805310e-1) * r \
+              + 5.99832206555887937690e-1) * r + 1.0); \
+    } \
+    return q < 0 ? -num / den : num / den; \
+  }
+
+// PPND7, for single precision.
+#define IMPLEMENT_NORMAL_PPND7_FOR_TYPE(fptype) \
+  \
+  fptype clqmcStdNormalInverseCDF_##fptype(fptype u) \
+  { \
+    fptype q = u - 0.5f; \
+    fptype r, num, den; \
+    if (fabs(q) <= 0.425f) { \
+      r = 0.180625f - q * q; \
+      num = ((5.9109374720e+1f * r + 1.5929113202e+2f) * r + 5.0434271938e+1f) * r + 3.3871327179e+0f; \
+      den = ((6.7187563600e+1f * r + 7.8757757664e+1f) * r + 1.7895169469e+1f) * r + 1.0f; \
+      return q * num / den; \
+    } \
+    r = q < 0 ? u : 1.0f - u; \
+    if (r <= 0.0f) \
+      return q < 0 ? -INFINITY : INFINITY; \
+    r = sqrt(-log(r)); \
+    if (r <= 5.0f) { \
+      r -= 1.6f; \
+      num = ((1.7023821103e-1f * r + 1.3067284816e+0f) * r + 2.7568153900e+0f) * r + 1.4234372777e+0f; \
+      den = (1.2021132975e-1f * r + 7.3700164250e-1f) * r + 1.0f; \
+    } \
+    else { \
+      r -= 5.0f; \
+      num = ((1.7337203997e-2f * r + 4.2868294337e-1f) * r + 3.0812263860e+0f) * r + 6.6579051150e+0f; \
+      den = (1.2258202635e-2f * r + 2.4197894225e-1f) * r + 1.0f; \
+    } \
+    return q < 0 ? -num / den : num / den; \
+  }
+
+// Transformations that do not depend on the approximation order.
+// The gamma inverse CDF is obtained by safeguarded Halley iterations on the
+// regularized incomplete gamma function, starting from the Wilson-Hilferty
+// approximation for shape > 1 and from the small-argument expansion otherwise.
+#define IMPLEMENT_TRANSFORMS_FOR_TYPE(fptype, eps) \
+  \
+  fptype clqmcExponentialInverseCDF_##fptype(fptype u) \
+  { \
+    return -log1p(-u); \
+  } \
+  \
+  fptype clqmcBakerTransform_##fptype(fptype u) \
+  { \
+    return (fptype) 1.0 - fabs((fptype) 2.0 * u - (fptype) 1.0); \
+  } \
+  \
+  fptype clqmcGammaP_##fptype(fptype shape, fptype x, fptype lgammaShape) \
+  { \
+    if (x <= (fptype) 0.0) \
+      return (fptype) 0.0; \
+    fptype logPrefactor = shape * log(x) - x - lgammaShape; \
+    if (x < shape + (fptype) 1.0) { \
+      /* series expansion */ \
+      fptype term = (fptype) 1.0 / shape; \
+      fptype sum = term; \
+      for (int n = 1; n < 500; n++) { \
+        term *= x / (shape + n); \
+        sum += term; \
+        if (fabs(term) < fabs(sum) * (eps)) \
+          break; \
+      } \
+      return sum * exp(logPrefactor); \
+    } \
+    else { \
+      /* continued fraction (modified Lentz) */ \
+      const fptype tiny = (fptype) 1e-30; \
+      fptype b = x + (fptype) 1.0 - shape; \
+      fptype c = (fptype) 1.0 / tiny; \
+      fptype d = (fptype) 1.0 / b; \
+      fptype h = d; \
+      for (int n = 1; n < 500; n++) { \
+        fptype an = -n * (n - shape); \
+        b += (fptype) 2.0; \
+        d = an * d + b; \
+        if (fabs(d) < tiny) d = tiny; \
+        c = b + an / c; \
+        if (fabs(c) < tiny) c = tiny; \
+        d = (fptype) 1.0 / d; \
+        fptype delta = d * c; \
+        h *= delta; \
+        if (fabs(delta - (fptype) 1.0) < (eps)) \
+          break; \
+      } \
+      return (fptype) 1.0 - exp(logPrefactor) * h; \
+    } \
+  } \
+  \
+  fptype clqmcGammaInverseCDF_##fptype(fptype shape, fptype u) \
+  { \
+    if (u <= (fptype) 0.0) \
+      return (fptype) 0.0; \
+    if (u >= (fptype) 1.0) \
+      return INFINITY; \
+    fptype lgammaShape = lgamma(shape); \
+    fptype x; \
+    if (shape > (fptype) 1.0) { \
+      fptype t = (fptype) 1.0 / ((fptype) 9.0 * shape); \
+      x = (fptype) 1.0 - t + clqmcStdNormalInverseCDF_##fptype(u) * sqrt(t); \
+      x = shape * x * x * x; \
+      if (x < (fptype) 1e-3) \
+        x = (fptype) 1e-3; \
+    } \
+    else { \
+      fptype t = (fptype) 1.0 - shape * ((fptype) 0.253 + shape * (fptype) 0.12); \
+      if (u < t) \
+        x = pow(u / t, (fptype) 1.0 / shape); \
+      else \
+        x = (fptype) 1.0 - log1p(-(u - t) / ((fptype) 1.0 - t)); \
+    } \
+    for (int it = 0; it < 12; it++) { \
+      if (x <= (fptype) 0.0) \
+        return (fptype) 0.0; \
+      fptype f = clqmcGammaP_##fptype(shape, x, lgammaShape) - u; \
+      fptype density = exp((shape - (fptype) 1.0) * log(x) - x - lgammaShape); \
+      if (density <= (fptype) 0.0) \
+        break; \
+      fptype ratio = f / density; \
+      fptype halley = ratio * ((shape - (fptype) 1.0) / x - (fptype) 1.0); \
+      fptype step = ratio / ((fptype) 1.0 - (fptype) 0.5 * (halley < (fptype) 1.0 ? halley : (fptype) 1.0)); \
+      x -= step; \
+      if (x <= (fptype) 0.0) \
+        x = (fptype) 0.5 * (x + step); \
+      if (fabs(step) < (eps) * x) \
+        break; \
+    } \
+    return x; \
+  }
+
+#ifdef __OPENCL_C_VERSION__
+  // On the device, implement only what is required to avoid cluttering memory.
+  #ifdef CLQMC_SINGLE_PRECISION
+    IMPLEMENT_NORMAL_PPND7_FOR_TYPE(float)
+    IMPLEMENT_TRANSFORMS_FOR_TYPE(float, 1e-6f)
+  #else
+    IMPLEMENT_NORMAL_PPND16_FOR_TYPE(double)
+    IMPLEMENT_TRANSFORMS_FOR_TYPE(double, 1e-14)
+  #endif
+#else
+  // On the host, implement everything.
+  IMPLEMENT_NORMAL_PPND7_FOR_TYPE(clqmc_float)
+  IMPLEMENT_TRANSFORMS_FOR_TYPE(clqmc_float, 1e-6f)
+  IMPLEMENT_NORMAL_PPND16_FOR_TYPE(clqmc_double)
+  IMPLEMENT_TRANSFORMS_FOR_TYPE(clqmc_double, 1e-14)
+#endif
+
+// Clean up macros, especially to avoid polluting device code.
+#undef IMPLEMENT_NORMAL_PPND16_FOR_TYPE
+#undef IMPLEMENT_NORMAL_PPND7_FOR_TYPE
+#undef IMPLEMENT_TRANSFORMS_FOR_TYPE
+
+/*
+    vim: ft=c sw=2
+*/
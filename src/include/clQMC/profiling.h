@@ -0,0 +1,154 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/*! @file profiling.h
+ *  @brief Host interface for timing OpenCL commands and host code
+ *
+ *  A profiler object collects two kinds of records:
+ *
+ *  - OpenCL events, whose `CL_PROFILING_COMMAND_QUEUED`, `START` and `END`
+ *    timestamps are read when the records are written (the command queue
+ *    must have been created with `CL_QUEUE_PROFILING_ENABLE`);
+ *  - host spans, delimited by clqmcProfilerBeginSpan() and
+ *    clqmcProfilerEndSpan(), e.g., around program builds or host-side
+ *    reductions.
+ *
+ *  The records can be written as a trace in the Chrome trace event format,
+ *  that can be opened in `chrome://tracing` or in Perfetto, or as a summary
+ *  table with the total time per record name.
+ *
+ *  Device timestamps are measured with the device clock, which is not
+ *  synchronized with the host clock.  In traces, the device timeline is
+ *  aligned on the host timeline using the host time at which each event was
+ *  recorded, which is an upper bound on the time at which the command was
+ *  queued; the tightest of these bounds is used.
+ *
+ *  A profiler object must not be used concurrently by multiple threads.
+ */
+
+#pragma once
+#ifndef CLQMC_PROFILING_H
+#define CLQMC_PROFILING_H
+
+#include <clQMC/clQMC.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! @brief Profiler object [**host-only**]
+ */
+typedef struct clqmcProfiler_ clqmcProfiler;
+
+/*! @brief Create a profiler object [**host-only**]
+ *
+ *  @param[out]     err         Error status variable, or `NULL`.
+ *
+ *  @return New profiler object, or `NULL` on error.
+ */
+CLQMCAPI clqmcProfiler* clqmcProfilerCreate(clqmcStatus* err);
+
+/*! @brief Destroy a profiler object [**host-only**]
+ *
+ *  Release the OpenCL events retained by the profiler and the profiler
+ *  object.
+ *
+ *  @param[in]      profiler    Profiler object, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcProfilerDestroy(clqmcProfiler* profiler);
+
+/*! @brief Record an OpenCL command [**host-only**]
+ *
+ *  The event is retained by the profiler until it is destroyed; its
+ *  timestamps are read by clqmcProfilerWriteTrace() and
+ *  clqmcProfilerWriteSummary(), so the command must have completed by then.
+ *  It is recommended to call this function right after enqueuing the
+ *  command.
+ *
+ *  @param[in,out]  profiler    Profiler object.
+ *  @param[in]      name        Name of the record; the string is copied.
+ *  @param[in]      event       Event associated to the command.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcProfilerRecordEvent(clqmcProfiler* profiler, const char* name, cl_event event);
+
+/*! @brief Begin a host span [**host-only**]
+ *
+ *  Spans can be nested; each call must be matched by a call to
+ *  clqmcProfilerEndSpan().
+ *
+ *  @param[in,out]  profiler    Profiler object.
+ *  @param[in]      name        Name of the record; the string is copied.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcProfilerBeginSpan(clqmcProfiler* profiler, const char* name);
+
+/*! @brief End the innermost open host span [**host-only**]
+ *
+ *  @param[in,out]  profiler    Profiler object.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcProfilerEndSpan(clqmcProfiler* profiler);
+
+/*! @brief Write the records as a Chrome trace [**host-only**]
+ *
+ *  Host spans and device commands are written as complete events (phase
+ *  `X`) in two distinct tracks, with timestamps in microseconds relative to
+ *  the creation of the profiler.
+ *  For device commands, the time spent between the queued and the start
+ *  timestamps is reported as an argument of the event.
+ *
+ *  @param[in]      profiler    Profiler object.
+ *  @param[in]      file        Output file.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcProfilerWriteTrace(const clqmcProfiler* profiler, FILE* file);
+
+/*! @brief Write a summary table of the records [**host-only**]
+ *
+ *  Records with the same name are aggregated; the count, total, mean,
+ *  minimum and maximum durations are written for each name, for host spans
+ *  and device commands separately.
+ *  For device commands, the duration is from the start to the end
+ *  timestamps, and the total time between the queued and start timestamps
+ *  is also written.
+ *
+ *  @param[in]      profiler    Profiler object.
+ *  @param[in]      file        Output file.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcProfilerWriteSummary(const clqmcProfiler* profiler, FILE* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,148 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/*! @file randomshift.h
+ *  @brief Generation of random shifts
+ *
+ *  Random shifts are generated with the counter-based generator
+ *  Philox4x32-10 @cite rSAL11a : coordinate @f$j@f$ of the shift of
+ *  replication @f$k@f$ is a function of the seed, of @f$k@f$ and of @f$j@f$
+ *  only.
+ *  Any replication can thus be reproduced from the seed and its index alone,
+ *  independently of the other replications, of the order in which the
+ *  coordinates are generated and of where they are generated: the host
+ *  functions, the device kernel enqueued by clqmcRandomShiftGeneratorEnqueue()
+ *  and the device function clqmcRandomShiftCoordinate() return the same
+ *  values for the same precision.
+ *  The single-precision coordinates are the double-precision ones truncated
+ *  to 24 bits.
+ *
+ *  The shifts are stored as in the rest of the library: the @f$d@f$
+ *  coordinates of each replication are contiguous, as expected by
+ *  clqmcLatticeRuleCreateOverStream() and clqmcLatticeRuleCreateStreams().
+ */
+
+#pragma once
+#ifndef CLQMC_RANDOMSHIFT_H
+#define CLQMC_RANDOMSHIFT_H
+
+#include <clQMC/clQMC.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define clqmcRandomShiftCoordinate      _CLQMC_TAG_FPTYPE(clqmcRandomShiftCoordinate)
+#define clqmcRandomShiftsGenerate       _CLQMC_TAG_FPTYPE(clqmcRandomShiftsGenerate)
+#define clqmcRandomShiftGeneratorCreate _CLQMC_TAG_FPTYPE(clqmcRandomShiftGeneratorCreate)
+
+/*! @brief Coordinate of a random shift [**device**]
+ *
+ *  @param[in]  seed        Seed.
+ *  @param[in]  replication Index @f$k@f$ of the replication.
+ *  @param[in]  coord       Index @f$j@f$ of the coordinate.
+ *
+ *  @return Uniform value in @f$[0,1)@f$.
+ */
+CLQMCAPI _CLQMC_FPTYPE clqmcRandomShiftCoordinate             (cl_ulong seed, cl_uint replication, cl_uint coord);
+CLQMCAPI cl_float      clqmcRandomShiftCoordinate_clqmc_float (cl_ulong seed, cl_uint replication, cl_uint coord);
+CLQMCAPI cl_double     clqmcRandomShiftCoordinate_clqmc_double(cl_ulong seed, cl_uint replication, cl_uint coord);
+
+/*! @brief Generate random shifts on the host [**host-only**]
+ *
+ *  Store the shifts of replications `firstReplication` to
+ *  `firstReplication + replications - 1` into `shifts`.
+ *  When the library is built with OpenMP, the replications are distributed
+ *  among threads and the coordinates are generated with SIMD instructions.
+ *
+ *  @param[in]  seed                Seed.
+ *  @param[in]  firstReplication    Index of the first replication.
+ *  @param[in]  replications        Number of replications.
+ *  @param[in]  dimension           Dimension @f$d@f$ of the shifts.
+ *  @param[out] shifts              Array of `replications` times @f$d@f$
+ *                                  values.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcRandomShiftsGenerate             (cl_ulong seed, cl_uint firstReplication, cl_uint replications, cl_uint dimension, _CLQMC_FPTYPE* shifts);
+CLQMCAPI clqmcStatus clqmcRandomShiftsGenerate_clqmc_float (cl_ulong seed, cl_uint firstReplication, cl_uint replications, cl_uint dimension, cl_float*      shifts);
+CLQMCAPI clqmcStatus clqmcRandomShiftsGenerate_clqmc_double(cl_ulong seed, cl_uint firstReplication, cl_uint replications, cl_uint dimension, cl_double*     shifts);
+
+/*! @brief Device generator of random shifts [**host-only**]
+ *
+ *  Holds the program and kernel that generate random shifts on a device.
+ */
+typedef struct clqmcRandomShiftGenerator_ clqmcRandomShiftGenerator;
+
+/*! @brief Create a device generator of random shifts [**host-only**]
+ *
+ *  Build the kernel for `device` in the precision of `clqmc_fptype`.
+ *
+ *  @param[in]  context     OpenCL context.
+ *  @param[in]  device      Device to build the kernel for.
+ *  @param[out] err         Error status variable, or `NULL`.
+ *
+ *  @return New generator object, or `NULL` on error.
+ */
+CLQMCAPI clqmcRandomShiftGenerator* clqmcRandomShiftGeneratorCreate             (cl_context context, cl_device_id device, clqmcStatus* err);
+CLQMCAPI clqmcRandomShiftGenerator* clqmcRandomShiftGeneratorCreate_clqmc_float (cl_context context, cl_device_id device, clqmcStatus* err);
+CLQMCAPI clqmcRandomShiftGenerator* clqmcRandomShiftGeneratorCreate_clqmc_double(cl_context context, cl_device_id device, clqmcStatus* err);
+
+/*! @brief Destroy a device generator of random shifts [**host-only**]
+ *
+ *  @param[in]  generator   Generator object, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcRandomShiftGeneratorDestroy(clqmcRandomShiftGenerator* generator);
+
+/*! @brief Generate random shifts on the device [**host-only**]
+ *
+ *  Enqueue a kernel that writes the same values as
+ *  clqmcRandomShiftsGenerate() into the buffer `shifts`, so that the shifts
+ *  need not be generated on the host and copied to the device.
+ *
+ *  @param[in]  generator           Generator object.
+ *  @param[in]  queue               Command queue of a device of the context
+ *                                  the generator was created with.
+ *  @param[in]  seed                Seed.
+ *  @param[in]  firstReplication    Index of the first replication.
+ *  @param[in]  replications        Number of replications.
+ *  @param[in]  dimension           Dimension @f$d@f$ of the shifts.
+ *  @param[out] shifts              Buffer of at least `replications` times
+ *                                  @f$d@f$ values of type `clqmc_fptype`.
+ *  @param[in]  numEventsInWaitList Number of events in `eventWaitList`.
+ *  @param[in]  eventWaitList       Events to wait for before the kernel.
+ *  @param[out] event               Event of the kernel, or `NULL`.
+ *
+ *  @return Error status.
+ */
+CLQMCAPI clqmcStatus clqmcRandomShiftGeneratorEnqueue(clqmcRandomShiftGenerator* generator, cl_command_queue queue, cl_ulong seed,
+    cl_uint firstReplication, cl_uint replications, cl_uint dimension, cl_mem shifts,
+    cl_uint numEventsInWaitList, const cl_event* eventWaitList, cl_event* event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
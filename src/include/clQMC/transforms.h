@@ -0,0 +1,115 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+/*! @file transforms.h
+ *  @brief Host interface for transformations of uniform coordinates
+ *
+ *  These functions map a uniform coordinate in @f$[0,1)@f$ to a nonuniform
+ *  variate by inversion, so that a single coordinate of a quasi-Monte Carlo
+ *  point is consumed per variate and the structure of the point set is
+ *  preserved.
+ *  The same functions are available on the device by including
+ *  `clQMC/transforms.clh`, in the precision selected with
+ *  `CLQMC_SINGLE_PRECISION`.
+ *
+ *  The point-set-specific shortcuts, e.g., clqmcLatticeRuleNextNormal(),
+ *  return transformed coordinates directly from a stream.
+ */
+
+#pragma once
+#ifndef CLQMC_TRANSFORMS_H
+#define CLQMC_TRANSFORMS_H
+
+#include <clQMC/clQMC.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define clqmcStdNormalInverseCDF    _CLQMC_TAG_FPTYPE(clqmcStdNormalInverseCDF)
+#define clqmcExponentialInverseCDF  _CLQMC_TAG_FPTYPE(clqmcExponentialInverseCDF)
+#define clqmcGammaInverseCDF        _CLQMC_TAG_FPTYPE(clqmcGammaInverseCDF)
+#define clqmcBakerTransform         _CLQMC_TAG_FPTYPE(clqmcBakerTransform)
+
+/*! @brief Inverse of the standard normal distribution function [**device**]
+ *
+ *  Uses Wichura's algorithm AS241 @cite sWIC88a (PPND16 in double
+ *  precision, PPND7 in single precision), with a relative accuracy of about
+ *  @f$10^{-16}@f$ and @f$10^{-7}@f$, respectively.
+ *
+ *  @param[in]  u   Uniform value in @f$(0,1)@f$.
+ *
+ *  @return Standard normal variate, or @f$\pm\infty@f$ if `u` is @f$0@f$ or
+ *  @f$1@f$.
+ */
+CLQMCAPI _CLQMC_FPTYPE clqmcStdNormalInverseCDF             (_CLQMC_FPTYPE u);
+CLQMCAPI cl_float      clqmcStdNormalInverseCDF_clqmc_float (cl_float      u);
+CLQMCAPI cl_double     clqmcStdNormalInverseCDF_clqmc_double(cl_double     u);
+
+/*! @brief Inverse of the exponential distribution function with rate 1 [**device**]
+ *
+ *  @param[in]  u   Uniform value in @f$[0,1)@f$.
+ *
+ *  @return Exponential variate @f$-\log(1-u)@f$.
+ */
+CLQMCAPI _CLQMC_FPTYPE clqmcExponentialInverseCDF             (_CLQMC_FPTYPE u);
+CLQMCAPI cl_float      clqmcExponentialInverseCDF_clqmc_float (cl_float      u);
+CLQMCAPI cl_double     clqmcExponentialInverseCDF_clqmc_double(cl_double     u);
+
+/*! @brief Inverse of the gamma distribution function with scale 1 [**device**]
+ *
+ *  The inverse is computed with at most 12 Halley iterations on the
+ *  regularized incomplete gamma function.
+ *  Multiply the result by the scale parameter to obtain a gamma variate with
+ *  a different scale.
+ *
+ *  @param[in]  shape   Shape parameter @f$\alpha > 0@f$.
+ *  @param[in]  u       Uniform value in @f$[0,1)@f$.
+ *
+ *  @return Gamma variate, or @f$+\infty@f$ if @f$u \geq 1@f$.
+ */
+CLQMCAPI _CLQMC_FPTYPE clqmcGammaInverseCDF             (_CLQMC_FPTYPE shape, _CLQMC_FPTYPE u);
+CLQMCAPI cl_float      clqmcGammaInverseCDF_clqmc_float (cl_float      shape, cl_float      u);
+CLQMCAPI cl_double     clqmcGammaInverseCDF_clqmc_double(cl_double     shape, cl_double     u);
+
+/*! @brief Baker's (tent) transformation [**device**]
+ *
+ *  Return @f$1 - |2u - 1|@f$.
+ *  Applied to the coordinates of a randomly-shifted lattice rule, it
+ *  periodizes the integrand and improves the convergence rate for smooth
+ *  integrands.
+ *  See @cite vHIC02a .
+ *
+ *  @param[in]  u   Uniform value in @f$[0,1)@f$.
+ *
+ *  @return Transformed value in @f$[0,1]@f$.
+ */
+CLQMCAPI _CLQMC_FPTYPE clqmcBakerTransform             (_CLQMC_FPTYPE u);
+CLQMCAPI cl_float      clqmcBakerTransform_clqmc_float (cl_float      u);
+CLQMCAPI cl_double     clqmcBakerTransform_clqmc_double(cl_double     u);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,254 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include "clQMC/arrayrqmc.h"
+#include "private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct clqmcArrayRQMCSorter_ {
+  cl_uint numChains;
+  size_t localSize;
+  size_t keySize;
+  cl_program program;
+  cl_kernel sortLocal;
+  cl_kernel mergeGlobal;
+  cl_kernel mergeLocal;
+};
+
+// Kernels that wrap the device functions of arrayrqmc.clh.
+static const char clqmcArrayRQMCSorterSource[] =
+  "#include <clQMC/arrayrqmc.clh>\n"
+  "__kernel void clqmcArrayRQMCSortLocalKernel(__global clqmc_fptype* keys, __global uint* perm,\n"
+  "    __local clqmc_fptype* localKeys, __local uint* localPerm)\n"
+  "{ clqmcArrayRQMCBitonicSortLocal(keys, perm, localKeys, localPerm); }\n"
+  "__kernel void clqmcArrayRQMCMergeGlobalKernel(__global clqmc_fptype* keys, __global uint* perm,\n"
+  "    uint size, uint stride)\n"
+  "{ clqmcArrayRQMCBitonicMergeGlobal(keys, perm, size, stride); }\n"
+  "__kernel void clqmcArrayRQMCMergeLocalKernel(__global clqmc_fptype* keys, __global uint* perm,\n"
+  "    uint size, __local clqmc_fptype* localKeys, __local uint* localPerm)\n"
+  "{ clqmcArrayRQMCBitonicMergeLocal(keys, perm, size, localKeys, localPerm); }\n";
+
+static int clqmcIsPowerOfTwo(size_t n)
+{
+  return n && (n & (n - 1)) == 0;
+}
+
+static clqmcArrayRQMCSorter* clqmcArrayRQMCSorterCreate_(cl_context context, cl_device_id device, cl_uint numChains, size_t localSize,
+    size_t keySize, const char* precisionOption, clqmcStatus* err, const char* caller)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  cl_int clerr;
+  clqmcArrayRQMCSorter* sorter = NULL;
+
+  if (numChains < 2 || !clqmcIsPowerOfTwo(numChains))
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the number of chains must be a power of 2 larger than 1", caller);
+  else if (localSize && (!clqmcIsPowerOfTwo(localSize) || 2 * localSize > numChains))
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the local size must be a power of 2 not larger than half the number of chains", caller);
+  else if ((sorter = (clqmcArrayRQMCSorter*) calloc(1, sizeof(clqmcArrayRQMCSorter))) == NULL)
+    err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for sorter", caller);
+
+  if (err_ == CLQMC_SUCCESS) {
+    sorter->numChains = numChains;
+    sorter->keySize = keySize;
+
+    const char* source = clqmcArrayRQMCSorterSource;
+    sorter->program = clqmcCreateProgramWithSource(context, 1, &source, NULL, NULL, &err_);
+    if (err_ == CLQMC_SUCCESS && (clerr = clBuildProgram(sorter->program, 1, &device, precisionOption, NULL, NULL)) != CL_SUCCESS) {
+      char log[512] = "";
+      clGetProgramBuildInfo(sorter->program, device, CL_PROGRAM_BUILD_LOG, sizeof(log) - 1, log, NULL);
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot build program:\n%s", caller, log);
+    }
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    sorter->sortLocal = clCreateKernel(sorter->program, "clqmcArrayRQMCSortLocalKernel", &clerr);
+    if (clerr == CL_SUCCESS)
+      sorter->mergeGlobal = clCreateKernel(sorter->program, "clqmcArrayRQMCMergeGlobalKernel", &clerr);
+    if (clerr == CL_SUCCESS)
+      sorter->mergeLocal = clCreateKernel(sorter->program, "clqmcArrayRQMCMergeLocalKernel", &clerr);
+    if (clerr != CL_SUCCESS)
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot create kernels", caller);
+  }
+
+  if (err_ == CLQMC_SUCCESS && localSize == 0) {
+    // Largest power of 2 supported by both local kernels and by the local
+    // memory of the device, with 2 keys and 2 permutation values per work item.
+    size_t maxSize = numChains / 2;
+    size_t groupSize;
+    cl_ulong localMemSize;
+    clerr = clGetKernelWorkGroupInfo(sorter->sortLocal, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(groupSize), &groupSize, NULL);
+    if (clerr == CL_SUCCESS && groupSize < maxSize)
+      maxSize = groupSize;
+    if (clerr == CL_SUCCESS)
+      clerr = clGetKernelWorkGroupInfo(sorter->mergeLocal, device, CL_KERNEL_WORK_GROUP_SIZE, sizeof(groupSize), &groupSize, NULL);
+    if (clerr == CL_SUCCESS && groupSize < maxSize)
+      maxSize = groupSize;
+    if (clerr == CL_SUCCESS)
+      clerr = clGetDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(localMemSize), &localMemSize, NULL);
+    if (clerr != CL_SUCCESS)
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot query the work-group size", caller);
+    else {
+      if (localMemSize / (2 * (keySize + sizeof(cl_uint))) < maxSize)
+        maxSize = (size_t) (localMemSize / (2 * (keySize + sizeof(cl_uint))));
+      for (localSize = 1; 2 * localSize <= maxSize; localSize *= 2)
+        ;
+    }
+  }
+  if (sorter)
+    sorter->localSize = localSize;
+
+  if (err_ != CLQMC_SUCCESS) {
+    clqmcArrayRQMCSorterDestroy(sorter);
+    sorter = NULL;
+  }
+  if (err)
+    *err = err_;
+  return sorter;
+}
+
+#define IMPLEMENT_SORTER_CREATE_FOR_TYPE(fptype, precisionOption) \
+  clqmcArrayRQMCSorter* clqmcArrayRQMCSorterCreate_##fptype(cl_context context, cl_device_id device, cl_uint numChains, size_t localSize, clqmcStatus* err) \
+  { \
+    return clqmcArrayRQMCSorterCreate_(context, device, numChains, localSize, sizeof(fptype), precisionOption, err, __func__); \
+  }
+
+IMPLEMENT_SORTER_CREATE_FOR_TYPE(clqmc_float, "-DCLQMC_SINGLE_PRECISION")
+IMPLEMENT_SORTER_CREATE_FOR_TYPE(clqmc_double, "")
+#undef IMPLEMENT_SORTER_CREATE_FOR_TYPE
+
+clqmcStatus clqmcArrayRQMCSorterDestroy(clqmcArrayRQMCSorter* sorter)
+{
+  if (sorter == NULL)
+    return CLQMC_SUCCESS;
+  if (sorter->sortLocal)
+    clReleaseKernel(sorter->sortLocal);
+  if (sorter->mergeGlobal)
+    clReleaseKernel(sorter->mergeGlobal);
+  if (sorter->mergeLocal)
+    clReleaseKernel(sorter->mergeLocal);
+  if (sorter->program)
+    clReleaseProgram(sorter->program);
+  free(sorter);
+  return CLQMC_SUCCESS;
+}
+
+size_t clqmcArrayRQMCSorterLocalSize(const clqmcArrayRQMCSorter* sorter)
+{
+  return sorter ? sorter->localSize : 0;
+}
+
+// Enqueue a kernel after the previous one, with the previous event as the
+// wait list if there is one.
+static cl_int clqmcArrayRQMCEnqueueKernel(cl_command_queue queue, cl_kernel kernel, size_t globalSize, size_t localSize,
+    cl_uint numEventsInWaitList, const cl_event* eventWaitList, cl_event* event)
+{
+  cl_event previous = *event;
+  cl_int err;
+  if (previous)
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize, &localSize, 1, &previous, event);
+  else
+    err = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize, &localSize, numEventsInWaitList, eventWaitList, event);
+  if (previous)
+    clReleaseEvent(previous);
+  if (err != CL_SUCCESS)
+    *event = NULL;
+  return err;
+}
+
+clqmcStatus clqmcArrayRQMCSorterEnqueue(clqmcArrayRQMCSorter* sorter, cl_command_queue queue, cl_mem keys, cl_mem perm,
+    cl_uint numEventsInWaitList, const cl_event* eventWaitList, cl_event* event)
+{
+  if (!sorter)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): sorter cannot be NULL", __func__);
+  if (!keys || !perm)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): keys and perm cannot be NULL", __func__);
+
+  size_t globalSize = sorter->numChains / 2;
+  size_t localSize = sorter->localSize;
+  size_t localKeysSize = 2 * localSize * sorter->keySize;
+  size_t localPermSize = 2 * localSize * sizeof(cl_uint);
+  cl_event last = NULL;
+  cl_int err;
+
+  err  = clSetKernelArg(sorter->sortLocal, 0, sizeof(keys), &keys);
+  err |= clSetKernelArg(sorter->sortLocal, 1, sizeof(perm), &perm);
+  err |= clSetKernelArg(sorter->sortLocal, 2, localKeysSize, NULL);
+  err |= clSetKernelArg(sorter->sortLocal, 3, localPermSize, NULL);
+  err |= clSetKernelArg(sorter->mergeGlobal, 0, sizeof(keys), &keys);
+  err |= clSetKernelArg(sorter->mergeGlobal, 1, sizeof(perm), &perm);
+  err |= clSetKernelArg(sorter->mergeLocal, 0, sizeof(keys), &keys);
+  err |= clSetKernelArg(sorter->mergeLocal, 1, sizeof(perm), &perm);
+  err |= clSetKernelArg(sorter->mergeLocal, 3, localKeysSize, NULL);
+  err |= clSetKernelArg(sorter->mergeLocal, 4, localPermSize, NULL);
+  if (err != CL_SUCCESS)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): cannot set kernel arguments", __func__);
+
+  err = clqmcArrayRQMCEnqueueKernel(queue, sorter->sortLocal, globalSize, localSize, numEventsInWaitList, eventWaitList, &last);
+
+  for (cl_uint size = 4 * (cl_uint) localSize; err == CL_SUCCESS && size <= sorter->numChains; size <<= 1) {
+    for (cl_uint stride = size / 2; err == CL_SUCCESS && stride >= 2 * localSize; stride >>= 1) {
+      err  = clSetKernelArg(sorter->mergeGlobal, 2, sizeof(size), &size);
+      err |= clSetKernelArg(sorter->mergeGlobal, 3, sizeof(stride), &stride);
+      if (err == CL_SUCCESS)
+        err = clqmcArrayRQMCEnqueueKernel(queue, sorter->mergeGlobal, globalSize, localSize, 0, NULL, &last);
+    }
+    if (err == CL_SUCCESS)
+      err = clSetKernelArg(sorter->mergeLocal, 2, sizeof(size), &size);
+    if (err == CL_SUCCESS)
+      err = clqmcArrayRQMCEnqueueKernel(queue, sorter->mergeLocal, globalSize, localSize, 0, NULL, &last);
+  }
+
+  if (err != CL_SUCCESS) {
+    if (last)
+      clReleaseEvent(last);
+    return clqmcSetErrorString(err, "%s(): cannot enqueue kernel", __func__);
+  }
+  if (event)
+    *event = last;
+  else
+    clReleaseEvent(last);
+  return CLQMC_SUCCESS;
+}
+
+
+#define IMPLEMENT_CREATE_LATTICE_RULE_FOR_TYPE(fptype) \
+  clqmcLatticeRule* clqmcArrayRQMCCreateLatticeRule_##fptype(cl_uint log2NumChains, cl_uint stepDimension, clqmcLatticeRuleFamily family, size_t* objectSize, clqmcStatus* err) \
+  { \
+    clqmcStatus err_; \
+    clqmcLatticeRule* lattice = NULL; \
+    clqmcLatticeRule* full = clqmcLatticeRuleCreateFromCatalogue_##fptype(log2NumChains, stepDimension + 1, family, NULL, &err_); \
+    if (err_ == CLQMC_SUCCESS) { \
+      lattice = clqmcLatticeRuleCreate_##fptype(full->numPoints, stepDimension, _CLQMC_LATTICE_GENVEC(full,const) + 1, objectSize, &err_); \
+      clqmcLatticeRuleDestroy(full); \
+    } \
+    if (err) \
+      *err = err_; \
+    return lattice; \
+  }
+
+IMPLEMENT_CREATE_LATTICE_RULE_FOR_TYPE(clqmc_float)
+IMPLEMENT_CREATE_LATTICE_RULE_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_CREATE_LATTICE_RULE_FOR_TYPE
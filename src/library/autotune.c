@@ -0,0 +1,550 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+#include "clQMC/autotune.h"
+#include "private.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define clqmcMakeDirectory(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define clqmcMakeDirectory(path) mkdir(path, 0777)
+#endif
+
+#define CLQMC_AUTOTUNE_MAX_KEY 255
+#define CLQMC_AUTOTUNE_FAILED  ((cl_ulong) -1)
+
+typedef struct clqmcAutotuneRecord_ {
+  clqmcLaunchConfig config;
+  cl_ulong time;        // shortest duration in ns
+} clqmcAutotuneRecord;
+
+struct clqmcAutotuner_ {
+  char key[CLQMC_AUTOTUNE_MAX_KEY + 1];
+  cl_ulong sourceHash;
+  char deviceName[256];
+  cl_uint numPoints;
+  cl_uint replications;
+  clqmcAutotuneLauncher launcher;
+  void* userData;
+  cl_uint numPointsPerWorkItem;
+  cl_uint* pointsPerWorkItem;
+  cl_uint numReplicationsPerWorkItem;
+  cl_uint* replicationsPerWorkItem;
+  cl_uint numLocalSizes;
+  size_t* localSizes;
+  cl_uint repeats;
+  char* cacheFile;
+  cl_uint numRecords;
+  clqmcAutotuneRecord* records;
+  cl_ulong totalTime;   // ns
+};
+
+size_t clqmcLaunchConfigGlobalSize(const clqmcLaunchConfig* config, cl_uint numPoints, cl_uint replications)
+{
+  if (!config || config->pointsPerWorkItem == 0 || config->replicationsPerWorkItem == 0
+      || numPoints % config->pointsPerWorkItem || replications % config->replicationsPerWorkItem)
+    return 0;
+  return (size_t) (numPoints / config->pointsPerWorkItem) * (replications / config->replicationsPerWorkItem);
+}
+
+// Return CL_TRUE if the configuration can be launched with the numbers of
+// points and of replications of the autotuner.
+static cl_bool clqmcAutotunerIsValid(const clqmcAutotuner* tuner, const clqmcLaunchConfig* config)
+{
+  size_t globalSize = clqmcLaunchConfigGlobalSize(config, tuner->numPoints, tuner->replications);
+  return globalSize > 0 && (config->localSize == 0 || globalSize % config->localSize == 0);
+}
+
+// Return the default path of the cache file of a device, or NULL.
+static char* clqmcAutotuneDefaultCacheFile(cl_device_id device, const char* deviceName)
+{
+  const char* dir = getenv("CLQMC_CACHE_DIR");
+  const char* subdir = "";
+  if (dir == NULL || dir[0] == 0) {
+#ifdef _WIN32
+    dir = getenv("LOCALAPPDATA");
+    subdir = "/clqmc";
+#else
+    dir = getenv("XDG_CACHE_HOME");
+    subdir = "/clqmc";
+    if (dir == NULL || dir[0] == 0) {
+      dir = getenv("HOME");
+      subdir = "/.cache/clqmc";
+    }
+#endif
+  }
+  if (dir == NULL || dir[0] == 0)
+    return NULL;
+
+  // a new device or driver version changes the name of the file
+  static const cl_device_info params[] = { CL_DEVICE_VENDOR, CL_DEVICE_VERSION, CL_DRIVER_VERSION };
+  cl_ulong hash = clqmcHashBytes(CLQMC_HASH_INIT, deviceName, strlen(deviceName) + 1);
+  for (size_t i = 0; i < sizeof(params) / sizeof(params[0]); i++) {
+    char value[256] = "";
+    clGetDeviceInfo(device, params[i], sizeof(value) - 1, value, NULL);
+    hash = clqmcHashBytes(hash, value, strlen(value) + 1);
+  }
+
+  char name[49];
+  size_t length = 0;
+  for (const char* c = deviceName; *c && length < sizeof(name) - 1; c++)
+    name[length++] = isalnum((unsigned char) *c) || *c == '-' ? *c : '_';
+  name[length] = 0;
+
+  size_t size = strlen(dir) + strlen(subdir) + length + 32;
+  char* path = (char*) malloc(size);
+  if (path)
+    snprintf(path, size, "%s%s/tune-%s-%016llx.txt", dir, subdir, name, (unsigned long long) hash);
+  return path;
+}
+
+clqmcAutotuner* clqmcAutotunerCreate(cl_device_id device, const char* key, cl_ulong sourceHash, cl_uint numPoints, cl_uint replications,
+    clqmcAutotuneLauncher launcher, void* userData, clqmcStatus* err)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  clqmcAutotuner* tuner = NULL;
+  size_t maxLocalSize = 0;
+
+  if (!device || !key || !launcher)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): device, key and launcher cannot be NULL", __func__);
+  else if (numPoints == 0 || replications == 0)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): numPoints and replications must be positive", __func__);
+  else if (key[0] == 0 || strlen(key) > CLQMC_AUTOTUNE_MAX_KEY || strpbrk(key, " \t\r\n\v\f"))
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): key must be a nonempty string of at most %d characters without whitespace",
+        __func__, CLQMC_AUTOTUNE_MAX_KEY);
+  else {
+    cl_int clerr = clGetDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(maxLocalSize), &maxLocalSize, NULL);
+    if (clerr != CL_SUCCESS)
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot query the maximum work-group size", __func__);
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    tuner = (clqmcAutotuner*) calloc(1, sizeof(clqmcAutotuner));
+    if (tuner) {
+      // room for the default candidates
+      tuner->pointsPerWorkItem = (cl_uint*) malloc(9 * sizeof(cl_uint));
+      tuner->replicationsPerWorkItem = (cl_uint*) malloc(34 * sizeof(cl_uint));
+      tuner->localSizes = (size_t*) malloc(8 * sizeof(size_t));
+    }
+    if (!tuner || !tuner->pointsPerWorkItem || !tuner->replicationsPerWorkItem || !tuner->localSizes) {
+      clqmcAutotunerDestroy(tuner);
+      tuner = NULL;
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for autotuner", __func__);
+    }
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    strcpy(tuner->key, key);
+    tuner->sourceHash = sourceHash;
+    if (clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(tuner->deviceName) - 1, tuner->deviceName, NULL) != CL_SUCCESS)
+      strcpy(tuner->deviceName, "unknown");
+    tuner->numPoints = numPoints;
+    tuner->replications = replications;
+    tuner->launcher = launcher;
+    tuner->userData = userData;
+    for (cl_uint p = 1; p <= 256 && numPoints % p == 0; p *= 2)
+      tuner->pointsPerWorkItem[tuner->numPointsPerWorkItem++] = p;
+    for (cl_uint r = 1; r < replications && replications % r == 0; r *= 2)
+      tuner->replicationsPerWorkItem[tuner->numReplicationsPerWorkItem++] = r;
+    tuner->replicationsPerWorkItem[tuner->numReplicationsPerWorkItem++] = replications;
+    tuner->localSizes[tuner->numLocalSizes++] = 0;
+    for (size_t l = 16; l <= maxLocalSize && l <= 1024; l *= 2)
+      tuner->localSizes[tuner->numLocalSizes++] = l;
+    tuner->repeats = 3;
+    tuner->cacheFile = clqmcAutotuneDefaultCacheFile(device, tuner->deviceName);
+  }
+
+  if (err)
+    *err = err_;
+  return tuner;
+}
+
+clqmcStatus clqmcAutotunerDestroy(clqmcAutotuner* tuner)
+{
+  if (tuner == NULL)
+    return CLQMC_SUCCESS;
+  free(tuner->pointsPerWorkItem);
+  free(tuner->replicationsPerWorkItem);
+  free(tuner->localSizes);
+  free(tuner->cacheFile);
+  free(tuner->records);
+  free(tuner);
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcAutotunerSetCandidates(clqmcAutotuner* tuner,
+    cl_uint numPointsPerWorkItem, const cl_uint* pointsPerWorkItem,
+    cl_uint numReplicationsPerWorkItem, const cl_uint* replicationsPerWorkItem,
+    cl_uint numLocalSizes, const size_t* localSizes)
+{
+  if (!tuner)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): tuner cannot be NULL", __func__);
+  if ((pointsPerWorkItem && numPointsPerWorkItem == 0)
+      || (replicationsPerWorkItem && numReplicationsPerWorkItem == 0)
+      || (localSizes && numLocalSizes == 0))
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the arrays of candidates cannot be empty", __func__);
+
+  cl_uint* p = NULL;
+  cl_uint* r = NULL;
+  size_t* l = NULL;
+  if (pointsPerWorkItem)
+    p = (cl_uint*) malloc(numPointsPerWorkItem * sizeof(cl_uint));
+  if (replicationsPerWorkItem)
+    r = (cl_uint*) malloc(numReplicationsPerWorkItem * sizeof(cl_uint));
+  if (localSizes)
+    l = (size_t*) malloc(numLocalSizes * sizeof(size_t));
+  if ((pointsPerWorkItem && !p) || (replicationsPerWorkItem && !r) || (localSizes && !l)) {
+    free(p);
+    free(r);
+    free(l);
+    return clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for candidates", __func__);
+  }
+
+  if (p) {
+    memcpy(p, pointsPerWorkItem, numPointsPerWorkItem * sizeof(cl_uint));
+    free(tuner->pointsPerWorkItem);
+    tuner->pointsPerWorkItem = p;
+    tuner->numPointsPerWorkItem = numPointsPerWorkItem;
+  }
+  if (r) {
+    memcpy(r, replicationsPerWorkItem, numReplicationsPerWorkItem * sizeof(cl_uint));
+    free(tuner->replicationsPerWorkItem);
+    tuner->replicationsPerWorkItem = r;
+    tuner->numReplicationsPerWorkItem = numReplicationsPerWorkItem;
+  }
+  if (l) {
+    memcpy(l, localSizes, numLocalSizes * sizeof(size_t));
+    free(tuner->localSizes);
+    tuner->localSizes = l;
+    tuner->numLocalSizes = numLocalSizes;
+  }
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcAutotunerSetRepeats(clqmcAutotuner* tuner, cl_uint repeats)
+{
+  if (!tuner)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): tuner cannot be NULL", __func__);
+  if (repeats == 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): repeats must be positive", __func__);
+  tuner->repeats = repeats;
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcAutotunerSetCacheFile(clqmcAutotuner* tuner, const char* path)
+{
+  if (!tuner)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): tuner cannot be NULL", __func__);
+  char* copy = NULL;
+  if (path) {
+    copy = (char*) malloc(strlen(path) + 1);
+    if (!copy)
+      return clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for the path", __func__);
+    strcpy(copy, path);
+  }
+  free(tuner->cacheFile);
+  tuner->cacheFile = copy;
+  return CLQMC_SUCCESS;
+}
+
+const char* clqmcAutotunerGetCacheFile(const clqmcAutotuner* tuner)
+{
+  return tuner ? tuner->cacheFile : NULL;
+}
+
+
+/*! Cache file
+ *
+ *  Each line that does not start with '#' holds the key, the source hash in
+ *  hexadecimal, the number of points, the number of replications, the numbers of points and of
+ *  replications per work item, the work-group size and the duration in
+ *  nanoseconds of a selected configuration, separated by spaces.
+ */
+
+// Parse an entry of the cache file; return CL_FALSE on a comment or an
+// invalid line.
+static cl_bool clqmcAutotuneParseEntry(const char* line, char* key, cl_ulong* sourceHash, cl_uint* numPoints, cl_uint* replications,
+    clqmcLaunchConfig* config, cl_ulong* time)
+{
+  unsigned long localSize;
+  unsigned long long sourceHash_, time_;
+  if (line[0] == '#' || sscanf(line, "%255s %llx %u %u %u %u %lu %llu", key, &sourceHash_, numPoints, replications,
+        &config->pointsPerWorkItem, &config->replicationsPerWorkItem, &localSize, &time_) != 8)
+    return CL_FALSE;
+  *sourceHash = (cl_ulong) sourceHash_;
+  config->localSize = (size_t) localSize;
+  *time = (cl_ulong) time_;
+  return CL_TRUE;
+}
+
+// Return CL_TRUE if the line is the entry of the autotuner in the cache file.
+static cl_bool clqmcAutotunerMatchEntry(const clqmcAutotuner* tuner, const char* line, clqmcLaunchConfig* config)
+{
+  char key[CLQMC_AUTOTUNE_MAX_KEY + 1];
+  cl_ulong sourceHash, time;
+  cl_uint numPoints, replications;
+  return clqmcAutotuneParseEntry(line, key, &sourceHash, &numPoints, &replications, config, &time)
+    && strcmp(key, tuner->key) == 0 && sourceHash == tuner->sourceHash
+    && numPoints == tuner->numPoints && replications == tuner->replications;
+}
+
+static cl_bool clqmcAutotunerLoad(const clqmcAutotuner* tuner, clqmcLaunchConfig* config)
+{
+  FILE* file = tuner->cacheFile ? fopen(tuner->cacheFile, "r") : NULL;
+  if (!file)
+    return CL_FALSE;
+  char line[512];
+  cl_bool found = CL_FALSE;
+  while (!found && fgets(line, sizeof(line), file))
+    found = clqmcAutotunerMatchEntry(tuner, line, config) && clqmcAutotunerIsValid(tuner, config);
+  fclose(file);
+  return found;
+}
+
+// Replace the entry of the autotuner in the cache file; failures are ignored.
+static void clqmcAutotunerSave(const clqmcAutotuner* tuner, const clqmcAutotuneRecord* best)
+{
+  if (!tuner->cacheFile)
+    return;
+
+  // keep the other entries
+  char* contents = NULL;
+  size_t length = 0, capacity = 0;
+  FILE* file = fopen(tuner->cacheFile, "r");
+  if (file) {
+    char line[512];
+    clqmcLaunchConfig config;
+    while (fgets(line, sizeof(line), file)) {
+      if (clqmcAutotunerMatchEntry(tuner, line, &config))
+        continue;
+      size_t lineLength = strlen(line);
+      if (length + lineLength + 1 > capacity) {
+        capacity = 2 * capacity + lineLength + 1;
+        char* larger = (char*) realloc(contents, capacity);
+        if (!larger)
+          break;
+        contents = larger;
+      }
+      memcpy(contents + length, line, lineLength + 1);
+      length += lineLength;
+    }
+    fclose(file);
+  }
+
+  // create the missing directories
+  size_t pathLength = strlen(tuner->cacheFile);
+  char* path = (char*) malloc(pathLength + 5);
+  if (!path) {
+    free(contents);
+    return;
+  }
+  strcpy(path, tuner->cacheFile);
+  for (size_t i = 1; i < pathLength; i++) {
+    if (path[i] == '/' || path[i] == '\\') {
+      char c = path[i];
+      path[i] = 0;
+      clqmcMakeDirectory(path);
+      path[i] = c;
+    }
+  }
+
+  // write to a temporary file first, so that readers never see a partial file
+  strcat(path, ".tmp");
+  file = fopen(path, "w");
+  if (file) {
+    if (length == 0)
+      fprintf(file, "# clQMC launch configurations for %s\n"
+          "# key source-hash points replications points-per-work-item replications-per-work-item local-size time-ns\n",
+          tuner->deviceName);
+    else
+      fputs(contents, file);
+    fprintf(file, "%s %016llx %u %u %u %u %lu %llu\n", tuner->key, (unsigned long long) tuner->sourceHash,
+        tuner->numPoints, tuner->replications,
+        best->config.pointsPerWorkItem, best->config.replicationsPerWorkItem,
+        (unsigned long) best->config.localSize, (unsigned long long) best->time);
+    int failed = ferror(file);
+    failed |= fclose(file);
+#ifdef _WIN32
+    if (!failed)
+      remove(tuner->cacheFile);
+#endif
+    if (failed || rename(path, tuner->cacheFile) != 0)
+      remove(path);
+  }
+
+  free(path);
+  free(contents);
+}
+
+
+/*! Calibration
+ */
+
+// Launch a configuration once and return its duration in ns.
+static clqmcStatus clqmcAutotunerLaunch(clqmcAutotuner* tuner, const clqmcLaunchConfig* config, cl_ulong* time)
+{
+  cl_event event = NULL;
+  cl_ulong start = clqmcHostTime();
+  clqmcStatus err = tuner->launcher(tuner->userData, config, &event);
+
+  if (event) {
+    if (err == CLQMC_SUCCESS) {
+      cl_int clerr = clWaitForEvents(1, &event);
+      if (clerr != CL_SUCCESS)
+        err = clqmcSetErrorString(clerr, "%s(): error while waiting for a calibration launch", __func__);
+    }
+    *time = clqmcHostTime() - start;
+    cl_ulong deviceStart, deviceEnd;
+    if (err == CLQMC_SUCCESS
+        && clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(deviceStart), &deviceStart, NULL) == CL_SUCCESS
+        && clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,   sizeof(deviceEnd),   &deviceEnd,   NULL) == CL_SUCCESS)
+      *time = deviceEnd - deviceStart;
+    clReleaseEvent(event);
+  }
+  else
+    *time = clqmcHostTime() - start;
+
+  tuner->totalTime += *time;
+  return err;
+}
+
+// Time a configuration and record its shortest duration, or
+// CLQMC_AUTOTUNE_FAILED if it could not be launched.
+static clqmcStatus clqmcAutotunerMeasure(clqmcAutotuner* tuner, const clqmcLaunchConfig* config, cl_ulong bestTime)
+{
+  clqmcAutotuneRecord* record = &tuner->records[tuner->numRecords++];
+  record->config = *config;
+  record->time = CLQMC_AUTOTUNE_FAILED;
+
+  for (cl_uint k = 0; k < tuner->repeats; k++) {
+    cl_ulong time;
+    clqmcStatus err = clqmcAutotunerLaunch(tuner, config, &time);
+    if (err != CLQMC_SUCCESS) {
+      record->time = CLQMC_AUTOTUNE_FAILED;
+      return err;
+    }
+    if (time < record->time)
+      record->time = time;
+    // do not insist on slow configurations
+    if (bestTime != CLQMC_AUTOTUNE_FAILED && record->time > 2 * bestTime)
+      break;
+  }
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcAutotunerRun(clqmcAutotuner* tuner, cl_bool retune, clqmcLaunchConfig* best, cl_bool* cached)
+{
+  if (!tuner || !best)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): tuner and best cannot be NULL", __func__);
+
+  if (cached)
+    *cached = CL_FALSE;
+  if (!retune && clqmcAutotunerLoad(tuner, best)) {
+    if (cached)
+      *cached = CL_TRUE;
+    return CLQMC_SUCCESS;
+  }
+
+  size_t maxRecords = (size_t) tuner->numPointsPerWorkItem * tuner->numReplicationsPerWorkItem + tuner->numLocalSizes;
+  clqmcAutotuneRecord* records = (clqmcAutotuneRecord*) realloc(tuner->records, maxRecords * sizeof(clqmcAutotuneRecord));
+  if (!records)
+    return clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for the measurements", __func__);
+  tuner->records = records;
+  tuner->numRecords = 0;
+  tuner->totalTime = 0;
+
+  clqmcStatus err = CLQMC_SUCCESS;
+  const clqmcAutotuneRecord* fastest = NULL;
+  cl_bool warm = CL_FALSE;
+
+  // first stage: work-group size chosen by the implementation
+  for (cl_uint i = 0; i < tuner->numPointsPerWorkItem; i++) {
+    for (cl_uint j = 0; j < tuner->numReplicationsPerWorkItem; j++) {
+      clqmcLaunchConfig config = { tuner->pointsPerWorkItem[i], tuner->replicationsPerWorkItem[j], 0 };
+      if (!clqmcAutotunerIsValid(tuner, &config))
+        continue;
+      if (!warm) {
+        // the first launch of a kernel is often slower
+        cl_ulong time;
+        warm = clqmcAutotunerLaunch(tuner, &config, &time) == CLQMC_SUCCESS;
+      }
+      clqmcStatus err_ = clqmcAutotunerMeasure(tuner, &config, fastest ? fastest->time : CLQMC_AUTOTUNE_FAILED);
+      if (err_ != CLQMC_SUCCESS)
+        err = err_;
+      else if (!fastest || tuner->records[tuner->numRecords - 1].time < fastest->time)
+        fastest = &tuner->records[tuner->numRecords - 1];
+    }
+  }
+  if (!fastest)
+    return err != CLQMC_SUCCESS ? err
+      : clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): no candidate configuration divides the points and replications", __func__);
+
+  // second stage: explicit work-group sizes
+  clqmcLaunchConfig base = fastest->config;
+  for (cl_uint k = 0; k < tuner->numLocalSizes; k++) {
+    clqmcLaunchConfig config = base;
+    config.localSize = tuner->localSizes[k];
+    if (config.localSize == 0 || !clqmcAutotunerIsValid(tuner, &config))
+      continue;
+    if (clqmcAutotunerMeasure(tuner, &config, fastest->time) == CLQMC_SUCCESS
+        && tuner->records[tuner->numRecords - 1].time < fastest->time)
+      fastest = &tuner->records[tuner->numRecords - 1];
+  }
+
+  *best = fastest->config;
+  clqmcAutotunerSave(tuner, fastest);
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcAutotunerWriteInfo(const clqmcAutotuner* tuner, FILE* file)
+{
+  if (!tuner || !file)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): tuner and file cannot be NULL", __func__);
+
+  const clqmcAutotuneRecord* fastest = NULL;
+  for (cl_uint i = 0; i < tuner->numRecords; i++) {
+    if (tuner->records[i].time != CLQMC_AUTOTUNE_FAILED && (!fastest || tuner->records[i].time < fastest->time))
+      fastest = &tuner->records[i];
+  }
+
+  fprintf(file, "%12s %12s %12s %14s\n", "points/WI", "reps/WI", "local size", "time (ms)");
+  for (cl_uint i = 0; i < tuner->numRecords; i++) {
+    const clqmcAutotuneRecord* record = &tuner->records[i];
+    char local[24] = "auto";
+    if (record->config.localSize)
+      snprintf(local, sizeof(local), "%lu", (unsigned long) record->config.localSize);
+    fprintf(file, "%12u %12u %12s ", record->config.pointsPerWorkItem, record->config.replicationsPerWorkItem, local);
+    if (record->time == CLQMC_AUTOTUNE_FAILED)
+      fprintf(file, "%14s\n", "failed");
+    else
+      fprintf(file, "%14.6g%s\n", record->time * 1e-6, record == fastest ? "  *" : "");
+  }
+  fprintf(file, "device:           %s\n", tuner->deviceName);
+  fprintf(file, "calibration time: %.6g s\n", tuner->totalTime * 1e-9);
+  return CLQMC_SUCCESS;
+}
@@ -0,0 +1,154 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+
+#include "clQMC/batch.h"
+#include "private.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// code that is common to the host and to the device
+#include "../include/clQMC/private/batch.c.h"
+
+static size_t clqmcBatchAlign_(size_t offset)
+{
+  return (offset + _CLQMC_BATCH_ALIGNMENT - 1) / _CLQMC_BATCH_ALIGNMENT * _CLQMC_BATCH_ALIGNMENT;
+}
+
+// Check the arguments, fill the table of problems of `header` and return the
+// total size of the batch object, or 0 on error.
+static size_t clqmcBatchLayout_(cl_uint problems, const clqmcLatticeRule* const* lattices, const void* const* shifts,
+    const cl_uint* replications, size_t fpsize, clqmcBatch* header, struct clqmcBatchProblem_* table, clqmcStatus* err, const char* caller)
+{
+  if (problems == 0) {
+    *err = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the number of problems must be positive", caller);
+    return 0;
+  }
+  if (!lattices) {
+    *err = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): lattices cannot be NULL", caller);
+    return 0;
+  }
+
+  size_t offset = clqmcBatchAlign_(sizeof(clqmcBatch) + problems * sizeof(struct clqmcBatchProblem_));
+  cl_ulong outputs = 0;
+
+  for (cl_uint p = 0; p < problems; p++) {
+    const clqmcLatticeRule* lattice = lattices[p];
+    cl_uint reps = replications ? replications[p] : 1;
+    cl_bool shifted = shifts && shifts[p];
+    if (!lattice) {
+      *err = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the lattice rule of problem %u is NULL", caller, p);
+      return 0;
+    }
+    if (reps == 0 || (!shifted && reps != 1)) {
+      *err = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): problem %u must have %s", caller, p,
+          shifted ? "at least one replication" : "a single replication because it is not randomized");
+      return 0;
+    }
+    table[p].latticeOffset = (cl_uint) offset;
+    offset = clqmcBatchAlign_(offset + sizeof(clqmcLatticeRule) + lattice->dimension * (sizeof(cl_int) + fpsize));
+    table[p].shiftsOffset = shifted ? (cl_uint) offset : 0;
+    if (shifted)
+      offset = clqmcBatchAlign_(offset + (size_t) reps * lattice->dimension * fpsize);
+    table[p].replications = reps;
+    table[p].outputOffset = (cl_uint) outputs;
+    outputs += reps;
+    // the offsets are stored as 32-bit integers
+    if (offset > (cl_uint) -1 || outputs > (cl_uint) -1) {
+      *err = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the batch exceeds 4 GiB or 2^32 outputs", caller);
+      return 0;
+    }
+  }
+
+  header->problems = problems;
+  header->outputs = (cl_uint) outputs;
+  *err = CLQMC_SUCCESS;
+  return offset;
+}
+
+static clqmcBatch* clqmcBatchCreate_(cl_uint problems, const clqmcLatticeRule* const* lattices, const void* const* shifts,
+    const cl_uint* replications, size_t fpsize, size_t* objectSize, clqmcStatus* err, const char* caller)
+{
+  clqmcStatus err_;
+  clqmcBatch* batch = NULL;
+  clqmcBatch header;
+  struct clqmcBatchProblem_* table = (struct clqmcBatchProblem_*) malloc((problems ? problems : 1) * sizeof(struct clqmcBatchProblem_));
+
+  if (!table) {
+    err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate work space", caller);
+    if (err)
+      *err = err_;
+    return NULL;
+  }
+
+  size_t size = clqmcBatchLayout_(problems, lattices, shifts, replications, fpsize, &header, table, &err_, caller);
+
+  if (size > 0) {
+    // zero the alignment padding so that the object has deterministic contents
+    batch = (clqmcBatch*) calloc(1, size);
+    if (!batch)
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for batch", caller);
+  }
+
+  if (batch) {
+    *batch = header;
+    memcpy(_CLQMC_BATCH_TABLE(batch,), table, problems * sizeof(struct clqmcBatchProblem_));
+    for (cl_uint p = 0; p < problems; p++) {
+      cl_uint dimension = lattices[p]->dimension;
+      memcpy(_CLQMC_BATCH_AT(batch,,char,table[p].latticeOffset), lattices[p],
+          sizeof(clqmcLatticeRule) + dimension * (sizeof(cl_int) + fpsize));
+      if (table[p].shiftsOffset)
+        memcpy(_CLQMC_BATCH_AT(batch,,char,table[p].shiftsOffset), shifts[p], (size_t) table[p].replications * dimension * fpsize);
+    }
+    if (objectSize)
+      *objectSize = size;
+  }
+
+  free(table);
+  if (err)
+    *err = err_;
+  return batch;
+}
+
+#define IMPLEMENT_CREATE_FOR_TYPE(fptype) \
+  clqmcBatch* clqmcBatchCreate_##fptype(cl_uint problems, const clqmcLatticeRule* const* lattices, const fptype* const* shifts, \
+      const cl_uint* replications, size_t* objectSize, clqmcStatus* err) \
+  { \
+    return clqmcBatchCreate_(problems, lattices, (const void* const*) shifts, replications, sizeof(fptype), objectSize, err, __func__); \
+  }
+
+IMPLEMENT_CREATE_FOR_TYPE(clqmc_float)
+IMPLEMENT_CREATE_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_CREATE_FOR_TYPE
+
+clqmcStatus clqmcBatchDestroy(clqmcBatch* batch)
+{
+  free(batch);
+  return CLQMC_SUCCESS;
+}
+
+cl_uint clqmcBatchNumOutputs(const clqmcBatch* batch)
+{
+  return batch->outputs;
+}
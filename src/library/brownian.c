@@ -0,0 +1,180 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include "clQMC/brownian.h"
+#include "private.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// code that is common to the host and to the device
+#include "../include/clQMC/private/brownian.c.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static size_t clqmcBrownianPathSize_(cl_uint steps, clqmcBrownianConstruction construction, size_t fpsize)
+{
+  if (construction == CLQMC_BROWNIAN_PCA)
+    return sizeof(clqmcBrownianPath) + (5 * (size_t) steps + 2) * fpsize;
+  return sizeof(clqmcBrownianPath) + 3 * (size_t) steps * (fpsize + sizeof(cl_uint));
+}
+
+// Check the arguments, and fill `t` with the times or with the default times.
+static clqmcStatus clqmcBrownianPathTimes_(cl_uint steps, const cl_double* times, clqmcBrownianConstruction construction, cl_double* t, const char* caller)
+{
+  if (steps == 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the number of steps must be positive", caller);
+  if (construction > CLQMC_BROWNIAN_PCA)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): invalid construction", caller);
+  for (cl_uint i = 0; i < steps; i++) {
+    t[i] = times ? times[i] : (cl_double) (i + 1) / steps;
+    if (!(t[i] > (i ? t[i - 1] : 0.0)))
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the times must be positive and increasing", caller);
+  }
+  if (construction == CLQMC_BROWNIAN_PCA) {
+    for (cl_uint i = 0; i < steps; i++) {
+      if (fabs(t[i] - (i + 1) * t[0]) > 1e-9 * t[steps - 1])
+        return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the PCA construction requires equally spaced times", caller);
+    }
+  }
+  return CLQMC_SUCCESS;
+}
+
+// Order of the bridge construction: breadth-first bisection of the time
+// indices, each interval being stored as its filled end points (steps for
+// the origin).  Fills index, left and right, and the weights and standard
+// deviations in double precision.
+static void clqmcBrownianPathBridge_(cl_uint steps, const cl_double* t, cl_uint* index, cl_uint* left, cl_uint* right,
+    cl_double* leftWeight, cl_double* rightWeight, cl_double* stdDev, cl_uint* queue)
+{
+  // the first step sets the end point
+  index[0] = steps - 1;
+  left[0] = right[0] = steps;
+  leftWeight[0] = rightWeight[0] = 0.0;
+  stdDev[0] = sqrt(t[steps - 1]);
+
+  // queue of intervals (l, r) with unfilled indices between them
+  cl_uint head = 0, tail = 0, k = 1;
+  queue[tail++] = steps;
+  queue[tail++] = steps - 1;
+  while (head < tail) {
+    cl_uint l = queue[head++];
+    cl_uint r = queue[head++];
+    cl_uint first = l == steps ? 0 : l + 1;
+    if (first >= r)
+      continue;
+    cl_uint m = first + (r - first) / 2;
+    cl_double tl = l == steps ? 0.0 : t[l];
+    index[k] = m;
+    left[k] = l;
+    right[k] = r;
+    leftWeight[k]  = (t[r] - t[m]) / (t[r] - tl);
+    rightWeight[k] = (t[m] - tl) / (t[r] - tl);
+    stdDev[k] = sqrt((t[m] - tl) * (t[r] - t[m]) / (t[r] - tl));
+    k++;
+    queue[tail++] = l;
+    queue[tail++] = m;
+    queue[tail++] = m;
+    queue[tail++] = r;
+  }
+}
+
+#define IMPLEMENT_CREATE_FOR_TYPE(fptype) \
+  clqmcBrownianPath* clqmcBrownianPathCreate_##fptype(cl_uint steps, const cl_double* times, clqmcBrownianConstruction construction, size_t* objectSize, clqmcStatus* err) \
+  { \
+    clqmcBrownianPath* path = NULL; \
+    size_t size = clqmcBrownianPathSize_(steps, construction, sizeof(fptype)); \
+    /* work space: times, then 3 arrays of doubles and the bridge queue */ \
+    cl_double* t = (cl_double*) malloc((steps ? steps : 1) * 4 * sizeof(cl_double)); \
+    cl_uint* queue = (cl_uint*) malloc((steps ? steps : 1) * 4 * sizeof(cl_uint)); \
+    clqmcStatus err_ = CLQMC_SUCCESS; \
+    if (!t || !queue) \
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate work space", __func__); \
+    if (err_ == CLQMC_SUCCESS) \
+      err_ = clqmcBrownianPathTimes_(steps, times, construction, t, __func__); \
+    if (err_ == CLQMC_SUCCESS) { \
+      path = (clqmcBrownianPath*) malloc(size); \
+      if (!path) \
+        err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for path", __func__); \
+    } \
+    if (err_ == CLQMC_SUCCESS) { \
+      path->steps = steps; \
+      path->construction = construction; \
+      if (construction == CLQMC_BROWNIAN_PCA) { \
+        /* eigenvalues of min(t_i, t_j) = t_1 min(i, j) and normalization of the sine eigenvectors */ \
+        fptype* scale = _CLQMC_BROWNIAN_SCALE(path,,fptype); \
+        fptype* sine  = _CLQMC_BROWNIAN_SINE(path,,fptype); \
+        cl_double period = 2.0 * steps + 1.0; \
+        for (cl_uint k = 0; k < steps; k++) { \
+          cl_double s = sin((2.0 * k + 1.0) * M_PI / (2.0 * period)); \
+          scale[k] = (fptype) (sqrt(t[0] / (4.0 * s * s)) * 2.0 / sqrt(period)); \
+        } \
+        for (cl_uint m = 0; m < 4 * steps + 2; m++) \
+          sine[m] = (fptype) sin(M_PI * m / period); \
+      } \
+      else { \
+        cl_double* leftWeight  = t + steps; \
+        cl_double* rightWeight = t + 2 * steps; \
+        cl_double* stdDev      = t + 3 * steps; \
+        cl_uint* index = _CLQMC_BROWNIAN_INDEX(path,,fptype); \
+        cl_uint* left  = _CLQMC_BROWNIAN_LEFT(path,,fptype); \
+        cl_uint* right = _CLQMC_BROWNIAN_RIGHT(path,,fptype); \
+        if (construction == CLQMC_BROWNIAN_BRIDGE) \
+          clqmcBrownianPathBridge_(steps, t, index, left, right, leftWeight, rightWeight, stdDev, queue); \
+        else { \
+          for (cl_uint k = 0; k < steps; k++) { \
+            index[k] = k; \
+            left[k] = k ? k - 1 : steps; \
+            right[k] = steps; \
+            leftWeight[k] = 1.0; \
+            rightWeight[k] = 0.0; \
+            stdDev[k] = sqrt(t[k] - (k ? t[k - 1] : 0.0)); \
+          } \
+        } \
+        for (cl_uint k = 0; k < steps; k++) { \
+          _CLQMC_BROWNIAN_LEFTWEIGHT(path,,fptype)[k]  = (fptype) leftWeight[k]; \
+          _CLQMC_BROWNIAN_RIGHTWEIGHT(path,,fptype)[k] = (fptype) rightWeight[k]; \
+          _CLQMC_BROWNIAN_STDDEV(path,,fptype)[k]      = (fptype) stdDev[k]; \
+        } \
+      } \
+      if (objectSize) \
+        *objectSize = size; \
+    } \
+    free(t); \
+    free(queue); \
+    if (err) \
+      *err = err_; \
+    return path; \
+  }
+
+IMPLEMENT_CREATE_FOR_TYPE(clqmc_float)
+IMPLEMENT_CREATE_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_CREATE_FOR_TYPE
+
+clqmcStatus clqmcBrownianPathDestroy(clqmcBrownianPath* path)
+{
+  free(path);
+  return CLQMC_SUCCESS;
+}
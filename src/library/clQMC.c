@@ -30,19 +30,29 @@
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef _MSC_VER
 #include <io.h>
 #else
 #include <unistd.h>
 #endif
 
-extern char clqmcErrorString[1024];
-
 const char* clqmcGetErrorString()
 {
     return clqmcErrorString;
 }
 
+size_t clqmcCopyErrorString(char* buf, size_t bufSize)
+{
+    size_t len = strlen(clqmcErrorString);
+    if (buf != NULL && bufSize > 0) {
+        size_t n = len < bufSize ? len : bufSize - 1;
+        memcpy(buf, clqmcErrorString, n);
+        buf[n] = '\0';
+    }
+    return len;
+}
+
 
 static char lib_path_default1[] = "/usr";
 static char lib_path_default1_check[] = "/usr/include/clQMC/clQMC.h";
@@ -80,9 +90,14 @@ const char* clqmcGetLibraryRoot()
 }
 
 
-static char lib_includes[1024];
+static CLQMC_THREAD_LOCAL char lib_includes[1024];
 
 const char* clqmcGetLibraryDeviceIncludes(cl_int* err)
+{
+    return clqmcCopyLibraryDeviceIncludes(lib_includes, sizeof(lib_includes), err);
+}
+
+const char* clqmcCopyLibraryDeviceIncludes(char* buf, size_t bufSize, cl_int* err)
 {
     int nbytes;
     const char* root = clqmcGetLibraryRoot();
@@ -100,19 +115,19 @@ const char* clqmcGetLibraryDeviceIncludes(cl_int* err)
 #else
     nbytes = snprintf(
 #endif
-	lib_includes,
-	sizeof(lib_includes),
+	buf,
+	bufSize,
 	"-I\"%s/include\"",
 	root);
 
 #ifdef _MSC_VER
     if (nbytes < 0) {
 #else
-    if (nbytes >= sizeof(lib_includes)) {
+    if (nbytes < 0 || (size_t) nbytes >= bufSize) {
 #endif
 	if (err)
-	    *err = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "value of CLQMC_ROOT too long (max = %u)", sizeof(lib_includes) - 16);
+	    *err = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "value of CLQMC_ROOT too long (max = %u)", (unsigned) (bufSize > 16 ? bufSize - 16 : 0));
 	return NULL;
     }
-    return lib_includes;
+    return buf;
 }
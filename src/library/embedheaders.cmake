@@ -0,0 +1,56 @@
+# ########################################################################
+# Copyright 2013 Advanced Micro Devices, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+# ########################################################################
+
+# Generate a C source file that defines the table clqmcEmbeddedHeaders[]
+# (see private.h) with the contents of the device headers.
+#
+# Usage:
+#   cmake -DINCLUDE_DIR=<dir> -DHEADERS=<a|b|...> -DOUTPUT=<file> -P embedheaders.cmake
+#
+# HEADERS lists the headers relative to INCLUDE_DIR, separated by `|`; each
+# is registered under its path relative to INCLUDE_DIR (e.g.,
+# clQMC/latticerule.clh), which is the name used in #include directives.
+# The contents are written as byte arrays rather than string literals to
+# avoid the length limits of string literals of some compilers.
+
+string( REPLACE "|" ";" HEADERS "${HEADERS}" )
+
+set( body "" )
+set( table "" )
+set( index 0 )
+foreach( header ${HEADERS} )
+  file( READ "${INCLUDE_DIR}/${header}" hex HEX )
+  string( REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}" )
+  # break the lines every 16 bytes
+  string( REGEX REPLACE "((0x[0-9a-f][0-9a-f],){16})" "\\1\n  " bytes "${bytes}" )
+  set( body "${body}static const char clqmcEmbeddedHeader${index}[] = {\n  ${bytes}0x00\n};\n\n" )
+  set( table "${table}  { \"${header}\", clqmcEmbeddedHeader${index}, sizeof(clqmcEmbeddedHeader${index}) - 1 },\n" )
+  math( EXPR index "${index} + 1" )
+endforeach( )
+
+file( WRITE "${OUTPUT}.tmp"
+  "// Generated by embedheaders.cmake from the device headers; do not edit.\n\n"
+  "#include \"clQMC/clQMC.h\"\n"
+  "#include \"private.h\"\n\n"
+  "${body}"
+  "const clqmcEmbeddedHeader clqmcEmbeddedHeaders[] = {\n"
+  "${table}"
+  "  { NULL, NULL, 0 }\n"
+  "};\n" )
+
+# avoid recompiling when the contents did not change
+execute_process( COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}" )
+file( REMOVE "${OUTPUT}.tmp" )
@@ -0,0 +1,359 @@
+// Catalogue of lattice rules
+//
+// This file was generated by src/tools/gencatalogue.c; do not edit.
+
+#define CATALOGUE_CBC_MIN_LOG2      4
+#define CATALOGUE_CBC_MAX_LOG2      22
+#define CATALOGUE_CBC_MAX_DIM       128
+#define CATALOGUE_KOROBOV_MIN_LOG2  4
+#define CATALOGUE_KOROBOV_MAX_LOG2  20
+#define CATALOGUE_KOROBOV_NUM_DIMS  4
+#define CATALOGUE_EMBEDDED_MIN_LOG2 4
+#define CATALOGUE_EMBEDDED_MAX_LOG2 22
+#define CATALOGUE_EMBEDDED_MAX_DIM  128
+
+static const cl_uint catalogueKorobovDims[CATALOGUE_KOROBOV_NUM_DIMS] = { 4, 8, 16, 32 };
+
+// Generating vectors for the CBC families, for each log2 of the number of
+// points m and each coordinate j, stored as (z_j - 1) / 2 on m - 2 bits,
+// starting at bit offset Offset[m - CATALOGUE_CBC_MIN_LOG2] + j (m - 2).
+static const cl_uint catalogueCbcPolyData[] = {
+  0x79d9556cu, 0x6f6def7bu, 0xef6f6f6fu, 0xf9ef6dedu, 0xedf9ededu, 0xf9edf9f9u,
+  0xdbdbdbedu, 0x7bdbdbdbu, 0xbde97518u, 0x74beebacu, 0x5bae97ddu, 0xbae97dd7u,
+  0xaeb75d75u, 0xdd75d6ebu, 0xd75f2ebau, 0xadd74be5u, 0x5d75baebu, 0xd7cbaeb7u,
+  0x2ebaf975u, 0xebaf975fu, 0xb73c5e90u, 0x627d32f8u, 0x82b3dfc8u, 0xf82bcdf3u,
+  0x8d2fbc3du, 0x82fdbc73u, 0x83cbf2d3u, 0xd23cfb7du, 0x82d3cbf8u, 0x8c32bdf7u,
+  0xf8c23bdfu, 0xfd2cb73du, 0x82dfcb38u, 0x8cf2d7b3u, 0x8dc2fdb3u, 0x32dcf7b3u,
+  0x0705cb00u, 0xc6a0ed51u, 0x9da822bdu, 0xf16fa828u, 0x4369e228u, 0x68a888e6u,
+  0x711228f3u, 0x195ee51au, 0xc7145b44u, 0x3fa8de13u, 0xa8d40a2au, 0x469c9cf1u,
+  0x37ca8891u, 0xa2e20f43u, 0xf1151a79u, 0x914145a7u, 0x7a37dc51u, 0xf9a4e204u,
+  0x02328f48u, 0x5123ea35u, 0xe5377c40u, 0x9f47aca7u, 0xecfb7c80u, 0xbc4c86a1u,
+  0x9d7dae08u, 0x21e6953cu, 0x53ae0b7cu, 0x83d5bdafu, 0x6ab262f0u, 0x60b4f4fdu,
+  0xaac8bfc5u, 0xf093fd4du, 0xe268856du, 0xff53ae0bu, 0x4c855af0u, 0x093f5b6bu,
+  0xbf6f6a0fu, 0x68f4c88au, 0x3d26d57cu, 0x3235beb8u, 0xf6bf0f69u, 0x1a889b55u,
+  0xf3c8f138u, 0x4d56bdaeu, 0xfc0e2500u, 0x22cb47c8u, 0xbfbb0539u, 0x8413d0b0u,
+  0xae2b47bbu, 0xd9c5324cu, 0x10f6231bu, 0x61538dc6u, 0x67574f72u, 0xc348ad99u,
+  0xbb089cf4u, 0x1a21b157u, 0xd4d5b34du, 0x68f62b16u, 0xa114371du, 0x98273ae8u,
+  0x96f4d133u, 0x051b7aadu, 0x2e8348c2u, 0xd4f75e3au, 0x4cca2ceeu, 0xa30d843du,
+  0xb4ba7558u, 0x86fce6c5u, 0xdec6624eu, 0xcf74e894u, 0xa295a610u, 0x3a2da5e8u,
+  0xc9538900u, 0x94335a9eu, 0xe0f76018u, 0x38d081c5u, 0x736ad383u, 0x72469012u,
+  0x4e0dd1a3u, 0x2177b61eu, 0x280e3cb3u, 0xb913b742u, 0xf0236f20u, 0x8f7a68d4u,
+  0x79c02cbeu, 0x2b1a3a48u, 0xb9b311cbu, 0x6ff013d4u, 0x69773c0eu, 0x28b72343u,
+  0x8f484efbu, 0x42f3efc0u, 0x3aa468beu, 0x1f2bd46fu, 0x130eb3b9u, 0x2c9a3c7eu,
+  0x481af020u, 0x79238ffbu, 0x4328c04eu, 0x77d40dbeu, 0x7aa46885u, 0x42726fb9u,
+  0xeff33ab3u, 0x0e48cb13u, 0xd21b5800u, 0x59deadceu, 0x1b7f71a1u, 0x5f93b62eu,
+  0x393fb7abu, 0x67da966du, 0xb260c584u, 0xe0a28864u, 0x33fc3c11u, 0xc654b9a2u,
+  0x5d4ae40au, 0x426f5111u, 0xf3060691u, 0xff653225u, 0x21a8d74eu, 0xec5cbc7eu,
+  0xe487ea97u, 0xd09d4360u, 0x185ce61eu, 0x567f8f83u, 0x6b088b78u, 0x12ec8231u,
+  0xa4eeb9e6u, 0x95bbf961u, 0x4b0d243du, 0x118d441du, 0xf899234fu, 0x9d3c36b9u,
+  0x142ca1e1u, 0xdc81a1fdu, 0xcf8728acu, 0x0860fd85u, 0x48b3a9cfu, 0xd3f3d644u,
+  0xe31d61e1u, 0xcc680572u, 0xa1fc2800u, 0x82824557u, 0x679119f3u, 0xd8e9bc79u,
+  0xd8d6f254u, 0xd139ff45u, 0x942783fbu, 0x0917632cu, 0x67078447u, 0x3f9cedaeu,
+  0xe8ffc8abu, 0x5aca0fb3u, 0x23f82654u, 0x28a12026u, 0x11ca9174u, 0xc2b6cee8u,
+  0x9ed832c5u, 0x2fdf4f35u, 0x0bd1fdb9u, 0x2e9cc6fau, 0x6cd4050cu, 0xab88a6a9u,
+  0xdc297f7bu, 0x31bb7edeu, 0xb1e651cbu, 0x2b9be725u, 0x10c45e75u, 0xcdb537f4u,
+  0x1808fb89u, 0x18e900a8u, 0x56773c52u, 0xb9c3b3b0u, 0x1fe96bbdu, 0xe1a964b8u,
+  0xf7d94116u, 0xd482e81cu, 0x1f6b3cc5u, 0x70a65410u, 0x2ed65bedu, 0x6cab3733u,
+  0xd365f800u, 0x701ecc67u, 0xaba57c4du, 0x13bd4178u, 0x2c9112ccu, 0xe40a3648u,
+  0x4f387211u, 0xe69f6c64u, 0x88a43ff8u, 0x779a0973u, 0x355df997u, 0x9b7922c3u,
+  0x3437f833u, 0xdbfa7488u, 0x0630fba4u, 0x2d962bb3u, 0x8df02b22u, 0x1d27e51bu,
+  0xc9a69064u, 0xa08ca4c1u, 0xc4dca119u, 0xbe4f4ac7u, 0xb33d72a0u, 0x62dcbbfdu,
+  0xafd151bcu, 0x0917aa62u, 0xed260f0fu, 0xae9c4249u, 0x47d2514eu, 0x994f3a7eu,
+  0xac4a68b7u, 0x5149e65eu, 0x82072b0eu, 0x5f550eb6u, 0xd2284edau, 0x6139f406u,
+  0xf9353e74u, 0x2dee0248u, 0x87f2189au, 0x1ee38697u, 0x1b98f228u, 0x6b1e779fu,
+  0xddb10432u, 0x1a372960u, 0x41c2a000u, 0x72289ad5u, 0x2cd0e887u, 0x507e81f5u,
+  0x36f6a3e2u, 0xc9a8c8abu, 0x1a212418u, 0xc4317cc7u, 0xcfd2e36au, 0x96dcd9f7u,
+  0x477ed420u, 0xbe137749u, 0x8babaf00u, 0xe56c8375u, 0x3a998e63u, 0x79fee6bbu,
+  0x94a773fbu, 0xbf2d92a6u, 0x07306ba0u, 0x2da7707bu, 0x964bca17u, 0x7593897eu,
+  0x7b4949ddu, 0xa1b497aeu, 0xc959efe4u, 0x584e1e2eu, 0xf3634297u, 0x09324ac6u,
+  0x916d9c55u, 0x61f8bbccu, 0x48829cb0u, 0x9de04671u, 0xa611240cu, 0xe606217eu,
+  0x8823561cu, 0x5cbda08au, 0xfe525490u, 0x02410885u, 0x7d3c63b2u, 0x9e88e38bu,
+  0x41904023u, 0xc6d0d910u, 0x18d34987u, 0x88d21599u, 0x246146bau, 0xf708ccbdu,
+  0x5930bb58u, 0x2dff6fbfu, 0x9ef00000u, 0x4fdf76bau, 0xb36b27a2u, 0x32240768u,
+  0x2f3ad8eeu, 0x39b92483u, 0xc474caa3u, 0x3af135e2u, 0x3c64baddu, 0x6066c77au,
+  0x3c8c689cu, 0x66164f4fu, 0xe0f9c277u, 0x8ad00adcu, 0x0b0c8b0bu, 0x5877c26cu,
+  0x6f61b7c8u, 0xc31bd3b9u, 0x5098761fu, 0x34631936u, 0x1aa3cc87u, 0xd3063608u,
+  0x9231e4e4u, 0x7ac2e1feu, 0xff33130eu, 0xe915598du, 0xf0e59821u, 0xd960fca3u,
+  0x75c2626cu, 0xb56ae7e7u, 0xf3ccd793u, 0xae3f122fu, 0x496184e1u, 0x2ba409eau,
+  0x937dfbddu, 0x2e8e1811u, 0x244face1u, 0x830988b6u, 0xbe98df4eu, 0x79fe4f35u,
+  0x494b626bu, 0xa2a19c1bu, 0x35c11c22u, 0x4c8dfc1au, 0x378da0eeu, 0xaaeed874u,
+  0xbc5d09cbu, 0x830ec44eu, 0x17ce0e03u, 0xe5923a7au, 0x336e7859u, 0x97c47d1fu,
+  0xdc36c000u, 0x1c3a016cu, 0xd61367d4u, 0x7970640du, 0x7e73d3bfu, 0x7372af0du,
+  0x9b224816u, 0x0fe233f4u, 0xf625a624u, 0xec71ca10u, 0xcaaf97e4u, 0x2d160090u,
+  0x19391b18u, 0xa0999ec8u, 0xe1c3c6f0u, 0x356bb7e9u, 0xc58d64b1u, 0x47c75881u,
+  0x3521f230u, 0x1deeff48u, 0x29ac7f4bu, 0x381d1659u, 0x9f868d80u, 0x0056eab2u,
+  0xf82cf7a5u, 0x70c926e0u, 0x575851bfu, 0x493bb26bu, 0x24ade9e2u, 0x4da8bd12u,
+  0x573543d9u, 0x6e8dd183u, 0x40b48e57u, 0x23c91defu, 0xb4bf163bu, 0xc8d66615u,
+  0xe83ed25du, 0xad4cd587u, 0xa083f431u, 0xdf33a14cu, 0x55cb2bb8u, 0xfc9f35cfu,
+  0x65e5b7d1u, 0xa82a8167u, 0x31bda7bdu, 0x7d7e4279u, 0x1ce25f2bu, 0x53d359bau,
+  0xaf54c63du, 0x5334e8c1u, 0xd4aefafeu, 0xbb27d758u, 0x359a4759u, 0x8bc65c64u,
+  0x86d66ba8u, 0xeace207eu, 0x257f8000u, 0x5f8c0eb8u, 0xcd4c55bdu, 0x2817e1c9u,
+  0x57927e1au, 0x6446e76eu, 0xe4c7b36cu, 0x6d68c389u, 0x7d330b7fu, 0xa68b16aau,
+  0xba8d269fu, 0xe1cca8feu, 0x0063954du, 0x447638b3u, 0x603acef5u, 0x3c10cbddu,
+  0x6149c9a4u, 0xf33995d2u, 0x1d0c5fccu, 0x09d3a6dcu, 0xad66b0eeu, 0x7c3b3afeu,
+  0x404ac9c1u, 0x597d0f52u, 0xb437c92eu, 0x5638695eu, 0xc558661fu, 0xb708193cu,
+  0xdae88337u, 0xaa73335du, 0xd1523696u, 0x89d2b5c3u, 0xa46fc20au, 0x9db97cfbu,
+  0x7a7347a8u, 0x7337041cu, 0xa4b8fa35u, 0x2563f518u, 0xc59c1168u, 0xbccfbdfau,
+  0xde3d081au, 0x8bedbff5u, 0x6acdb3b3u, 0x613af563u, 0xe473e24au, 0x9423be9du,
+  0x61932ac6u, 0xc44dca90u, 0xe3547984u, 0xd2f48dcdu, 0x11e0b0a2u, 0xaa558407u,
+  0x0e0f7921u, 0xa0665e9eu, 0x0b609eabu, 0xc78c92dbu, 0x8294fbdfu, 0x0c03acf3u,
+  0x025aefeeu, 0xcf42cc1fu, 0xbc4b0000u, 0xa7fd64e1u, 0xdb33b2cfu, 0x67b85932u,
+  0x4c422d70u, 0xd2c524f0u, 0x60b313f7u, 0xa41b2979u, 0x1bc84503u, 0x96b0841cu,
+  0xa5c63db5u, 0xd83e30bau, 0xce287617u, 0x98f9083cu, 0x25c5f20fu, 0xed69c383u,
+  0xe5f93fa0u, 0x9cf3ad4du, 0xfcc7e68au, 0xe47e1ec6u, 0xab7fb0f0u, 0x641176cbu,
+  0x465ef63eu, 0x42d6aa73u, 0xda1b1211u, 0x0a54d271u, 0xb355f921u, 0xaefc0fa3u,
+  0x0e231d79u, 0x83ecc495u, 0x47df2991u, 0xcb111e3bu, 0x3fd6be8eu, 0x84cf4234u,
+  0x170fd52eu, 0x090c08d6u, 0x1d3029c1u, 0x9ddb5cc6u, 0xd6e53f6cu, 0x5f27bf46u,
+  0x3542ca53u, 0x9019cddeu, 0x048f8e89u, 0x05411aaeu, 0x6b2e44b4u, 0x1cca91aeu,
+  0x23ebd77cu, 0xc56fd70eu, 0x62da85ecu, 0x5c8b14f6u, 0x86549f0du, 0xd72398c3u,
+  0x267842bdu, 0xcc37fc5cu, 0xfe8d6d71u, 0x5ead224bu, 0x6c33c963u, 0xf9837d71u,
+  0x13e2af48u, 0x50278d64u, 0x5d93a226u, 0x4bd01b5bu, 0xc2cd5250u, 0x5a2c3986u,
+  0x4e620000u, 0x0269ceebu, 0xcead8b89u, 0xa440769fu, 0x679b24bbu, 0xb43e884cu,
+  0x8a3fe8d7u, 0x7084d8ddu, 0x8d3fc2f8u, 0x5d2cd6dfu, 0xa2d2c0c8u, 0x7a586fe5u,
+  0x78a95630u, 0x70ad8284u, 0x7f77318eu, 0x119a0b87u, 0x5bfc54c0u, 0xcd3bdb78u,
+  0xc5d25567u, 0xb216a338u, 0x922413a3u, 0x47f5a5cau, 0x744f0487u, 0xd6ee4513u,
+  0xde91cdfcu, 0x938f914bu, 0x969cb4b8u, 0xaa35030du, 0x93e2bf69u, 0x346efb2au,
+  0x9da63e7bu, 0x4b77c315u, 0x3e3b6770u, 0xb05fd10eu, 0x8f9e03aau, 0xda5c2e23u,
+  0xaa391627u, 0x7d9f955fu, 0xcddaea9du, 0xb7491128u, 0x5807e76au, 0x1e416b9eu,
+  0xfe83f380u, 0xf9353cc5u, 0x31e1fc26u, 0x38d2ed84u, 0x7c786ddbu, 0x386e06e2u,
+  0xc58436f8u, 0xd3669618u, 0x63d2f87du, 0x7e34c472u, 0x879871d2u, 0xd5531075u,
+  0xb5122a8cu, 0xc107d0eeu, 0xa26b8f12u, 0x19a53386u, 0x7f574092u, 0x9eb008dcu,
+  0xcc2329c9u, 0x22b8d948u, 0xd7b79b2bu, 0x2e072595u, 0xae1482a0u, 0x66057c5fu,
+  0x7768c5d2u, 0xc85b8c21u, 0x86380000u, 0x9fcb056du, 0xe0bbe1b7u, 0x067f8d6fu,
+  0x2ee2c22cu, 0xa534a1ebu, 0x10ce12e4u, 0x8df1f98bu, 0x8b3c08e0u, 0x3018126bu,
+  0x2941e8d9u, 0xc28db6ceu, 0x0db5c12fu, 0xdfff409cu, 0x99bb898bu, 0x3fbc28e4u,
+  0x8d1f3e04u, 0xe06e431au, 0x94cdd4a5u, 0xa385a79eu, 0x864e5854u, 0x2ed7faccu,
+  0xdf41e2a8u, 0x37d91040u, 0x70b20974u, 0x1abb218du, 0x525cb1f6u, 0xcdb2c2b3u,
+  0x178e54d6u, 0x43972fa4u, 0x6b58524eu, 0xddd7b513u, 0x868101a8u, 0x3c29daf5u,
+  0x8fdb9130u, 0xbfec42adu, 0x0f52b70cu, 0x47156fecu, 0x6f28e247u, 0xee7973ecu,
+  0x876abb13u, 0xde46d06du, 0xe1ea2c75u, 0x8948f6b8u, 0x719c44bau, 0x734c50dcu,
+  0x09ebde39u, 0x1201c4a6u, 0x8dfc4a78u, 0x62e48855u, 0x00d8fa8eu, 0xb67d2dc6u,
+  0x6e569dc7u, 0x0737c65du, 0x30e539b6u, 0x27e6d514u, 0x072b37bbu, 0x590b81e2u,
+  0xee5d5ef5u, 0x14c9bdf4u, 0xdbfca754u, 0x7765df1cu, 0xe2d14972u, 0xe407167fu,
+  0xfbfe92edu, 0x057f5e31u, 0xd9130c0cu, 0x785aa5d5u, 0x15c5ee2au, 0x6b474e20u,
+  0x91de6cc6u, 0xaf21ca29u, 0xe2900000u, 0x38e04feeu, 0x0f89339fu, 0x608c3430u,
+  0x39465888u, 0xc51d2f52u, 0xdf56796fu, 0x5d0d2ec9u, 0xac97d8bcu, 0xb335136du,
+  0x4b0f4938u, 0x5ed7a5b4u, 0xe516c170u, 0x14e939f6u, 0x1e375fbau, 0xd5a3a5c0u,
+  0xd63984a1u, 0x7f5e9f88u, 0xe9c3391fu, 0xb875776fu, 0x13fd9e8du, 0x7913f27au,
+  0xefe0a554u, 0x6b851b2du, 0x394a6882u, 0xe2537a64u, 0xac4bbc3cu, 0x7ad8c53eu,
+  0xb12984c2u, 0x5338b263u, 0x7e5b4d2fu, 0x373f1cbeu, 0xed2b1f70u, 0x19cb5a1du,
+  0xabfed830u, 0xbb2d76dau, 0x71bb9673u, 0x6ba6156fu, 0x164b7c91u, 0xcabf520au,
+  0x62a1c44au, 0xfa61fdc7u, 0xce112c9du, 0x1ae50f12u, 0x9eb5b147u, 0x1302c962u,
+  0x468ac410u, 0xe8313c94u, 0xf0471bf7u, 0x7d5d0665u, 0x130023f9u, 0x0649f480u,
+  0x53f06537u, 0x4bab709fu, 0x6c226ee6u, 0x7d46ff55u, 0xb83909adu, 0x4f5823fau,
+  0x3e2b3cb6u, 0x6b285e11u, 0x40ebe1d3u, 0xa16a3e0cu, 0xca40d905u, 0x0c54951cu,
+  0x3b3849e9u, 0x93fcd453u, 0x6f77f3afu, 0xbd1ff404u, 0x8bcc8b4bu, 0x8e8a2c5bu,
+  0x8470f0fau, 0x4afcf141u, 0xbb1728efu, 0x3c33238eu, 0x45427818u, 0xe084bdd1u,
+  0x14500000u, 0x4f3e89d4u, 0xf059a4adu, 0xb9f66babu, 0x1f5cd282u, 0xb894dfebu,
+  0x9aca666au, 0xbab3daf6u, 0x240ede49u, 0x45bb9633u, 0x22bbb4a3u, 0xc204e156u,
+  0x0380d6fbu, 0xd2e68d3fu, 0xb7128105u, 0xb118f56au, 0x91b34538u, 0xaec930b1u,
+  0xd9b7fdd3u, 0x4188c19du, 0xa3eaf429u, 0x776883fbu, 0xc4522e98u, 0x628eae79u,
+  0x593fa816u, 0x3f0eb821u, 0x825ea8a5u, 0x66ec024fu, 0xebe8fd54u, 0x3c8bf981u,
+  0x6c11c311u, 0xeae0709bu, 0x7e541a4du, 0xdf01c937u, 0xc7a36046u, 0x7beb913au,
+  0x75446f0fu, 0x5a0a2532u, 0x7bad1c5eu, 0x10ac62d3u, 0x7f199136u, 0x7ce8ac9eu,
+  0x1db924fbu, 0x9fdb447fu, 0x0545b7d5u, 0xf9eeff9cu, 0xd0dfd07bu, 0xfb3a4365u,
+  0x087b7b77u, 0xc15ecea3u, 0xceeda024u, 0xa55cd14fu, 0x1b7e6d15u, 0x9827d48au,
+  0xe3266843u, 0x94089759u, 0xa8d3731bu, 0x7d25294au, 0xed27b686u, 0xc5974d54u,
+  0x10acf225u, 0x94992e87u, 0x9457504du, 0xf376d158u, 0xbf911f24u, 0xbfed3a2au,
+  0xe03d8d05u, 0x817ae90cu, 0x19393cdbu, 0x05b01a98u, 0xd12638ecu, 0x9ca0d31du,
+  0x486e4782u, 0x7ee9d89bu, 0xf27dc725u, 0x2a8c5b33u, 0x5bc58d51u, 0x146c65bfu,
+  0x0de840cbu, 0x4b1a6f0du,
+};
+
+static const cl_uint catalogueCbcPolyOffset[] = {
+  0, 256, 640, 1152, 1792, 2560, 3456, 4480,
+  5632, 6912, 8320, 9856, 11520, 13312, 15232, 17280,
+  19456, 21760, 24192,
+};
+
+static const cl_uint catalogueCbcGeomData[] = {
+  0xffffffecu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu,
+  0xffffffffu, 0xffffffffu, 0x07e3fe60u, 0x80381c0eu, 0x00000003u, 0x00000000u,
+  0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+  0x00000000u, 0x00000000u, 0xfffdfe90u, 0xffffffffu, 0xffffffffu, 0xffffffffu,
+  0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu,
+  0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu,
+  0x0e62a6e0u, 0x83a0e83au, 0x1d083a0eu, 0xe841d074u, 0x420e83a0u, 0x0e841d07u,
+  0x83a10742u, 0xa107420eu, 0xe841d083u, 0x41d07420u, 0x0e8420e8u, 0x841d083au,
+  0xa107420eu, 0xe841d083u, 0x3a107420u, 0x10741d08u, 0x83a1083au, 0xa107420eu,
+  0xe841d083u, 0x3a107420u, 0xc670b940u, 0xebaeba9fu, 0xbaebaebau, 0xaebaebaeu,
+  0xebaebaebu, 0xbaebaebau, 0xaebaebaeu, 0xebaebaebu, 0xbaebaebau, 0xaebaebaeu,
+  0xebaebaebu, 0xbaebaebau, 0xaebaebaeu, 0xebaebaebu, 0xbaebaebau, 0xaebaebaeu,
+  0xebaebaebu, 0xbaebaebau, 0xaebaebaeu, 0xebaebaebu, 0xbaebaebau, 0xaebaebaeu,
+  0xebaebaebu, 0xbaebaebau, 0x3d326f00u, 0xb20af03bu, 0x9d3a74f4u, 0xe9d3a74eu,
+  0x4e9d3a74u, 0x74e9d3a7u, 0xa74e9d3au, 0x3a74e9d3u, 0xd3a74e9du, 0x9d3a74e9u,
+  0xe9d3a74eu, 0x4e9d3a74u, 0x74e9d3a7u, 0xa74e9d3au, 0x3a74e9d3u, 0xd3a74e9du,
+  0x9d3a74e9u, 0xe9d3a74eu, 0x4e9d3a74u, 0x74e9d3a7u, 0xa74e9d3au, 0x3a74e9d3u,
+  0xd3a74e9du, 0x9d3a74e9u, 0xe9d3a74eu, 0x4e9d3a74u, 0x74e9d3a7u, 0xa74e9d3au,
+  0xc14e8d00u, 0x09b4cd94u, 0xcd942216u, 0x94949494u, 0x94949494u, 0x94949494u,
+  0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u,
+  0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u,
+  0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u,
+  0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u, 0x94949494u,
+  0x94949494u, 0x94949494u, 0xd21b5800u, 0xcafddc8eu, 0x8f45ed4bu, 0x7dbedf6eu,
+  0xdbedf6fbu, 0xbedf6fb7u, 0xedf6fb7du, 0xdf6fb7dbu, 0xf6fb7dbeu, 0x6fb7dbedu,
+  0xfb7dbedfu, 0xb7dbedf6u, 0x7dbedf6fu, 0xdbedf6fbu, 0xbedf6fb7u, 0xedf6fb7du,
+  0xdf6fb7dbu, 0xf6fb7dbeu, 0x6fb7dbedu, 0xfb7dbedfu, 0xb7dbedf6u, 0x7dbedf6fu,
+  0xdbedf6fbu, 0xbedf6fb7u, 0xedf6fb7du, 0xdf6fb7dbu, 0xf6fb7dbeu, 0x6fb7dbedu,
+  0xfb7dbedfu, 0xb7dbedf6u, 0x7dbedf6fu, 0xdbedf6fbu, 0xbedf6fb7u, 0xedf6fb7du,
+  0xdf6fb7dbu, 0xf6fb7dbeu, 0x366c2800u, 0x8afd07eau, 0x8e623cc3u, 0xc6ca91b2u,
+  0x41f2aacau, 0xd0741d07u, 0x741d0741u, 0x1d0741d0u, 0x0741d074u, 0x41d0741du,
+  0xd0741d07u, 0x741d0741u, 0x1d0741d0u, 0x0741d074u, 0x41d0741du, 0xd0741d07u,
+  0x741d0741u, 0x1d0741d0u, 0x0741d074u, 0x41d0741du, 0xd0741d07u, 0x741d0741u,
+  0x1d0741d0u, 0x0741d074u, 0x41d0741du, 0xd0741d07u, 0x741d0741u, 0x1d0741d0u,
+  0x0741d074u, 0x41d0741du, 0xd0741d07u, 0x741d0741u, 0x1d0741d0u, 0x0741d074u,
+  0x41d0741du, 0xd0741d07u, 0x741d0741u, 0x1d0741d0u, 0x0741d074u, 0x41d0741du,
+  0x4665f800u, 0x31445402u, 0x908538cdu, 0xb4ba96f8u, 0xbbbe8d53u, 0x752eefb4u,
+  0xea5ddf69u, 0xd4ba9752u, 0xa9752ea5u, 0x52ea5d4bu, 0xa5d4ba97u, 0x4ba9752eu,
+  0x9752ea5du, 0x2ea5d4bau, 0x5d4ba975u, 0xba9752eau, 0x752ea5d4u, 0xea5d4ba9u,
+  0xd4ba9752u, 0xa9752ea5u, 0x52ea5d4bu, 0xa5d4ba97u, 0x4ba9752eu, 0x9752ea5du,
+  0x2ea5d4bau, 0x5d4ba975u, 0xba9752eau, 0x752ea5d4u, 0xea5d4ba9u, 0xd4ba9752u,
+  0xa9752ea5u, 0x52ea5d4bu, 0xa5d4ba97u, 0x4ba9752eu, 0x9752ea5du, 0x2ea5d4bau,
+  0x5d4ba975u, 0xba9752eau, 0x752ea5d4u, 0xea5d4ba9u, 0xd4ba9752u, 0xa9752ea5u,
+  0x52ea5d4bu, 0xa5d4ba97u, 0xbbd81000u, 0x8fe56517u, 0xf03e57bcu, 0x706ff67au,
+  0xea39e205u, 0xc5b817bfu, 0xd70ce4b5u, 0x5a394b56u, 0x4b5a394bu, 0xb54b54b5u,
+  0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u, 0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u,
+  0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u, 0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u,
+  0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u, 0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u,
+  0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u, 0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u,
+  0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u, 0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u,
+  0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u, 0x54b54b54u, 0x4b54b54bu, 0xb54b54b5u,
+  0x54b54b54u, 0x4b54b54bu, 0x9eefe000u, 0x6b4236b8u, 0x9c78fa44u, 0xa7250c41u,
+  0x1dab221fu, 0xd3b65087u, 0x300043c6u, 0xb529701eu, 0x2b46695cu, 0x2a16ab87u,
+  0xd68d4b9du, 0x555a316au, 0x16aa973au, 0xaab462d5u, 0x2d552e74u, 0xaf4a85aau,
+  0x5ab5a316u, 0x5e952970u, 0xb545aa2du, 0xb5a3e950u, 0x950b545au, 0x45aaa5ceu,
+  0xd5e950b5u, 0x0b56b462u, 0xb82d5e95u, 0x16af4a94u, 0x57a542d5u, 0xd2a16a8bu,
+  0xa8b554b9u, 0x5abd2a16u, 0x516ad68cu, 0xb57a542du, 0x62d5e950u, 0x6a8b56b4u,
+  0x45abd2a1u, 0x2aad18b5u, 0x0b545abdu, 0xaaa5ce95u, 0xe950b545u, 0x8c5aa2d5u,
+  0x2d5e9556u, 0xaf4a85aau, 0x4b82d516u, 0x516af4a9u, 0x4a85aa2du, 0xa2d5ad1fu,
+  0x6af4a85au, 0xfa542d51u, 0xd516ad68u, 0x8b57a542u, 0xabd2a16au, 0x16ad68c5u,
+  0x8c36c000u, 0x9ecc28a9u, 0x9a171e04u, 0x4bb31689u, 0x1d5a02f6u, 0xd10c2e80u,
+  0x755aaf84u, 0x734c9c2cu, 0xed9dc50eu, 0x0e733781u, 0xe77170b1u, 0xb10e7f7eu,
+  0xdc50e770u, 0x439c5a29u, 0x71689c2cu, 0xa216890eu, 0x5a2439c5u, 0xc5a270b0u,
+  0x885a2439u, 0x6890e716u, 0x16890e71u, 0x716885a2u, 0x2c16890eu, 0x0e71689cu,
+  0xc5a21689u, 0x885a2439u, 0x6890e716u, 0x439c5a21u, 0x716885a2u, 0xa216890eu,
+  0x5a2439c5u, 0x90e71688u, 0x9c5a2168u, 0x6885a243u, 0x16890e71u, 0x716885a2u,
+  0xa216890eu, 0x5a2439c5u, 0x90e71688u, 0x9c5a2168u, 0x6885a243u, 0x16890e71u,
+  0x2439c5a2u, 0xe716885au, 0x5a216890u, 0x85a2439cu, 0x890e7168u, 0x39c5a216u,
+  0x16885a24u, 0x216890e7u, 0xa2439c5au, 0x0e716885u, 0x85a21689u, 0x890e7168u,
+  0x39c5a216u, 0x16885a24u, 0xb1800000u, 0x328891a0u, 0x1a1df4b2u, 0xcaca859au,
+  0xaf827b77u, 0x6d84d8a5u, 0x9f432f6fu, 0xdd12dd1eu, 0xd2c0e9d2u, 0x5e55ba7bu,
+  0xf4e69985u, 0x14047d2bu, 0x900e4b61u, 0x2bdee56bu, 0x1ab07b57u, 0xb72b4228u,
+  0x63dab4ffu, 0x561146e5u, 0x28dcac7bu, 0x8a29ff42u, 0xed5dcad0u, 0x08a372b1u,
+  0x1ed53dabu, 0xd08a372bu, 0x46e56a7fu, 0xac7b5611u, 0x141ed5dcu, 0xcad4ffa1u,
+  0x1141ed5du, 0x3dabb95au, 0x772b4228u, 0x684507b5u, 0xa0f6aee5u, 0xd5dcad08u,
+  0x95a1141eu, 0x2283dabbu, 0x4ffb72b4u, 0x6e563dabu, 0xbb95a114u, 0xb42283dau,
+  0x507b5772u, 0x2b53fe84u, 0x4507b577u, 0xf6aee568u, 0xdcad08a0u, 0xa1141ed5u,
+  0x83dabb95u, 0x5772b422u, 0x563daa7bu, 0xffa1146eu, 0x228dcad4u, 0xb958f6acu,
+  0x1ed58451u, 0xb08a372bu, 0xaee563dau, 0xfd08a0f6u, 0x6aee56a7u, 0xcad08a0fu,
+  0x1141ed5du, 0x3dabb95au, 0xc3930000u, 0x4ddc3725u, 0x057f542fu, 0x20a54762u,
+  0x6ccdb3dcu, 0x08b2c347u, 0xc2a04c7au, 0x4e70e6e2u, 0x35e849edu, 0xe6cfaf56u,
+  0x98b218dcu, 0xb5be0a02u, 0x58c775d3u, 0xd89d1309u, 0xbb917ba6u, 0x2ce1f5a9u,
+  0x58c7a78cu, 0x270ed89du, 0x75d398b2u, 0xe777fb7cu, 0x98b258c7u, 0x98b2d89du,
+  0x75d358c7u, 0x98b2bb91u, 0x58c7d89du, 0xe77798b2u, 0x75d358c7u, 0xd89d98b2u,
+  0x98b258c7u, 0xd89d75d3u, 0x58c798b2u, 0x98b2e777u, 0x98b258c7u, 0x58c775d3u,
+  0x98b2d89du, 0x98b258c7u, 0xd89d18dcu, 0x98b275d3u, 0x98b258c7u, 0x58c7e777u,
+  0x98b218dcu, 0x75d3d89du, 0x98b258c7u, 0xd89d98b2u, 0x18dc58c7u, 0x75d398b2u,
+  0x98b258c7u, 0x58c7d89du, 0x75d398b2u, 0x98b218dcu, 0x75d358c7u, 0x58c798b2u,
+  0x18dcd89du, 0x58c798b2u, 0xd89d98b2u, 0x98b258c7u, 0x18dc75d3u, 0x58c798b2u,
+  0x75d398b2u, 0x58c718dcu, 0xd89d98b2u, 0x98b258c7u, 0x75d3d89du, 0x58c798b2u,
+  0x4e620000u, 0x8dd1ceebu, 0xb45afcceu, 0xc73bd25du, 0xeb9f7846u, 0x790f3446u,
+  0x436d80aau, 0x68f94038u, 0x4e499e6eu, 0x8537874au, 0xa4ab7074u, 0x0d92ee4cu,
+  0xc2d4282fu, 0x613363e9u, 0x21416068u, 0x9963ac6bu, 0xc448751fu, 0x4efad78bu,
+  0xae8dfeebu, 0x9aeab5dcu, 0x36373241u, 0x14d3f304u, 0xdb091dd4u, 0x80daac67u,
+  0xb3e217bbu, 0xd3f311e0u, 0x1005b992u, 0x10261238u, 0xc759f103u, 0xfb5eee32u,
+  0x45d4158cu, 0x969f9e57u, 0x19f10dccu, 0x6123ddb9u, 0xa7e6cb1du, 0xfdd37325u,
+  0xf118cfbbu, 0x9a657459u, 0xe6cb1d70u, 0xe37325a7u, 0x4c2475eeu, 0xba82aff7u,
+  0xcf88bda7u, 0x2c75a7e6u, 0x6e4709a3u, 0x91db9937u, 0xba67c430u, 0x458d657fu,
+  0xd69f9e57u, 0x17bb8cb1u, 0xbda7b84du, 0xd41576e4u, 0x58eb3e21u, 0x7e6c6b26u,
+  0xe8b7325au, 0x68d3f3cau, 0x4b1ac9c2u, 0x4cb1d6e6u, 0xb3e22ff7u, 0x7b4fcae8u,
+  0x3e22edc9u, 0x6b2658ebu, 0xfcdb992cu, 0xba5eee34u, 0xd1963b7fu, 0x367c4384u,
+  0x9848ed3fu, 0x6e64b1acu, 0x86380000u, 0xdacbae6du, 0x29cb4510u, 0xa6ecc9aeu,
+  0xc7dce0f7u, 0xcbb69623u, 0xabb21aecu, 0xfd6971d0u, 0x46c695e5u, 0x0ccd1e7bu,
+  0x8423b10bu, 0x696cd263u, 0xd325c341u, 0xfb7db946u, 0xd4185646u, 0x64199a7au,
+  0x465b7e5du, 0x4be959feu, 0xf2bd23e9u, 0x05888872u, 0x1ad05ab7u, 0xab0f36d9u,
+  0x4350a9fbu, 0xa6e7a9bbu, 0xa5c8fa7eu, 0xc027572fu, 0x370594f0u, 0x759396dfu,
+  0x20a34f81u, 0x6d7778c1u, 0x67ccb68au, 0x49b98f7fu, 0x8872c3ceu, 0x285b9ce8u,
+  0x6db9cf0fu, 0x17590dc1u, 0x26e57778u, 0x20bc2021u, 0xcda29bc1u, 0x63dfd2c3u,
+  0x545f8275u, 0xf0c41208u, 0xb98d3e14u, 0xd9f32e49u, 0xe5b7e3dfu, 0x221d4f0cu,
+  0x754b0f3au, 0x6c5d6482u, 0x1048268au, 0x77788d3eu, 0x62a37059u, 0x82f080bfu,
+  0x31759304u, 0x82754b0fu, 0x221da29bu, 0xc310482au, 0xe5777853u, 0x8dc16926u,
+  0x34f8fd8au, 0x7782c3ceu, 0x0c926e57u, 0x4a221d4fu, 0x370585d6u, 0x8a6fc202u,
+  0x75504826u, 0x0bf62a82u, 0xf96dfc12u, 0xb0f31517u, 0x29b8f7f4u, 0x1653c31au,
+  0x7f0808dcu, 0x4120a888u, 0xbcb00000u, 0x1aef5635u, 0x768bf7ccu, 0xf5fc4e5fu,
+  0xc6bd1db6u, 0x248b01edu, 0x4fefc4c3u, 0x64883cbau, 0xa54fcf38u, 0x902408d7u,
+  0x1e10973cu, 0x6d18a9d0u, 0x029be5ddu, 0x0107742cu, 0x218bb9b4u, 0xaea70bf1u,
+  0xe61535b2u, 0x64649e15u, 0xb125730bu, 0x864e7d99u, 0x25af2f7du, 0x23bf2095u,
+  0xc4afc8b4u, 0xb2016ddeu, 0xbad6461eu, 0xd4ab0b54u, 0x3550a810u, 0xf953c1bcu,
+  0xbdaa81b1u, 0x942ff779u, 0x0fe09f87u, 0x461c9086u, 0xc5cf39aeu, 0xb3502338u,
+  0xbef87139u, 0x6f90676bu, 0x209411e4u, 0x152f2de0u, 0xe7d2649bu, 0x6bbef874u,
+  0x48bd7067u, 0x3d1ce317u, 0x21210c0eu, 0xe461cd41u, 0xfddef39au, 0x9b3f6b2bu,
+  0x44a08f13u, 0xfeefd39fu, 0x8b9fb595u, 0xb9187271u, 0x06c7bce6u, 0x7c242182u,
+  0x0d21c0dfu, 0x2a5e6a09u, 0x02371e8eu, 0x8c843035u, 0x0676a4a0u, 0x090c0d8fu,
+  0xdfbef86au, 0x3ce6bbfdu, 0x30e74e7du, 0x39a43812u, 0x9e735c8cu, 0x8c5da73eu,
+  0xc7dfeef3u, 0x3bef8606u, 0x2823a824u, 0x70084301u, 0x7152f348u, 0xff77b8f4u,
+  0x7c24a08eu, 0x7d4121dfu, 0x718ba06cu, 0x860d39f4u, 0x3de73590u, 0xbfddf036u,
+  0x14500000u, 0x91fe3fd4u, 0xf4d2baf9u, 0x39f457c6u, 0xbadbbf92u, 0x36fb9dc5u,
+  0x638c0b7du, 0xff29f7b6u, 0x1a07113au, 0x28194912u, 0x11f9b4eau, 0x424e990au,
+  0xb68e3675u, 0xf01b2b8au, 0x27dcd3e3u, 0x7359e48au, 0x907f248cu, 0x1bdde7fdu,
+  0x2c34a921u, 0xcb8fe5b7u, 0xbb4e0ef9u, 0x0e1b5a92u, 0x1d3001e0u, 0x95fe590au,
+  0xd7ea1e8fu, 0x60837f71u, 0xc947d155u, 0x80a97b99u, 0xb257e864u, 0x9b8b1eabu,
+  0x3ec51d62u, 0x18bad4eeu, 0x80f6f811u, 0xd3653e57u, 0xb1b0d87eu, 0x673d1d7du,
+  0xa147b62bu, 0x1bf8daa7u, 0xbe4e5289u, 0xee45867fu, 0xedef0075u, 0x5b7f2060u,
+  0xe3375e30u, 0x64a45ae0u, 0x81e1b6b8u, 0x30567fbeu, 0x8a81af5eu, 0x2aaeee45u,
+  0x3a60ede3u, 0xf0075771u, 0x8640e337u, 0x0b7f206bu, 0xaa7a454du, 0x28a45aedu,
+  0x67fbe4e5u, 0xe1b0e337u, 0xa32aae81u, 0xaa7a7713u, 0x05a45aedu, 0x60ede5e3u,
+  0x4d06b864u, 0x8f007545u, 0x7fbe4e52u, 0xde7713a6u, 0x6b86460eu, 0x0755e305u,
+  0xa32aaef0u, 0x54d0daa7u, 0x37b7f204u, 0xce4d70e3u, 0xfbe4e528u, 0x532aae67u,
+  0xaa7af007u, 0x37454d0du, 0xb7f200e3u, 0xede5e305u, 0x767fbe60u, 0x713ace4du,
+  0x7a4e5287u, 0x5e305daau,
+};
+
+static const cl_uint catalogueCbcGeomOffset[] = {
+  0, 256, 640, 1152, 1792, 2560, 3456, 4480,
+  5632, 6912, 8320, 9856, 11520, 13312, 15232, 17280,
+  19456, 21760, 24192,
+};
+
+// Generating vector for the embedded family, stored as (z_j - 1) / 2 on
+// CATALOGUE_EMBEDDED_MAX_LOG2 - 1 bits, starting at bit offset
+// j (CATALOGUE_EMBEDDED_MAX_LOG2 - 1).
+static const cl_uint catalogueEmbeddedPolyData[] = {
+  0x8d800000u, 0x4a8ce06cu, 0x10c14985u, 0x27ab7db5u, 0xff13e0b9u, 0x037628a2u,
+  0xc3393dacu, 0x45e1062du, 0xd69d8997u, 0xe7439830u, 0xdf54bb5au, 0x21bf00c6u,
+  0xf4f470b6u, 0x11822320u, 0xb29c0fc5u, 0xfeef9be7u, 0x3873ce0bu, 0xaa38e928u,
+  0x4093819du, 0x4a811d4du, 0x5292c439u, 0xe44b8a18u, 0x014782f2u, 0x25af6eb6u,
+  0x885814b2u, 0xa314878cu, 0xc9b89e67u, 0xd67908fdu, 0x26c19142u, 0x4d6886d2u,
+  0x20f01014u, 0x281a438fu, 0x3a5b5b8cu, 0x91bb4babu, 0xb08fdecau, 0x915c2774u,
+  0x64df5016u, 0xf1761c2bu, 0xf5671ebau, 0xd4d66f73u, 0x99353349u, 0xa60ea7a1u,
+  0x978f5bd2u, 0x2798aa1du, 0x7dacb3ecu, 0x3f2ab9fau, 0xd7f7b87fu, 0x9edbb662u,
+  0xf5513948u, 0xc0926928u, 0xf688c70bu, 0xf6d2f131u, 0xcfdce279u, 0x81a0f08bu,
+  0x686b33c2u, 0x3436e3a5u, 0xe7b00b96u, 0x1e748aa1u, 0x05ac8171u, 0xa373dfcau,
+  0x34856c1bu, 0x489d1609u, 0x708fc04fu, 0x0909fda0u, 0x49625a12u, 0x760e40c9u,
+  0x8ec38828u, 0xd1a4fb0cu, 0xde1a2a74u, 0x28222fdbu, 0x65f8b369u, 0xc4c5152fu,
+  0xe47515bfu, 0x42d0ed04u, 0x7b449614u, 0x1ead1070u, 0x500fc743u, 0x6c7d261bu,
+  0xa2873a17u, 0x19d20308u, 0xb77abf50u, 0x265b2316u, 0xe011a498u, 0x87b6c06cu,
+};
+
+// Korobov parameters for each log2 of the number of points and each
+// dimension in catalogueKorobovDims.
+static const cl_uint catalogueKorobovPolyData[][4] = {
+  { 3, 5, 5, 5 },
+  { 9, 13, 13, 13 },
+  { 25, 25, 19, 19 },
+  { 61, 61, 61, 61 },
+  { 119, 61, 55, 55 },
+  { 187, 227, 201, 43 },
+  { 399, 43, 43, 469 },
+  { 977, 691, 519, 389 },
+  { 1573, 1077, 1939, 1939 },
+  { 3761, 4009, 2103, 1079 },
+  { 7857, 2033, 7057, 4815 },
+  { 8865, 4959, 8993, 2719 },
+  { 18369, 9791, 11329, 9791 },
+  { 36479, 10369, 29057, 45439 },
+  { 113921, 113921, 89855, 106751 },
+  { 205311, 56831, 118271, 118271 },
+  { 281601, 281599, 281601, 183295 },
+};
+
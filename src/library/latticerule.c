@@ -22,9 +22,22 @@
  */
 
 #include "clQMC/latticerule.h"
+#include "clQMC/randomshift.h"
+#include "clQMC/transforms.h"
 #include "private.h"
 
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // code that is common to the host and to the device
 #include "../include/clQMC/private/latticerule.c.h"
@@ -88,6 +101,154 @@ IMPLEMENT_CREATE_FOR_TYPE(clqmc_double)
 #undef IMPLEMENT_CREATE_FOR_TYPE
 
 
+// Korobov generating vector (1, a, a^2 mod n, ...)
+static clqmcStatus clqmcLatticeRuleKorobovGenVec_(cl_uint numPoints, cl_uint dimension, cl_int gen, cl_int* genVec, const char* caller)
+{
+  if (numPoints == 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the number of points must be positive", caller);
+  cl_long r = gen % (cl_long) numPoints;
+  cl_ulong a = (cl_ulong) (r < 0 ? r + (cl_long) numPoints : r);
+  cl_ulong z = 1 % numPoints;
+  for (cl_uint j = 0; j < dimension; j++) {
+    genVec[j] = (cl_int) z;
+    z = (z * a) % numPoints;
+  }
+  return CLQMC_SUCCESS;
+}
+
+#define IMPLEMENT_CREATE_KOROBOV_FOR_TYPE(fptype) \
+  clqmcLatticeRule* clqmcLatticeRuleCreateKorobov_##fptype(cl_uint numPoints, cl_uint dimension, cl_int gen, size_t *objectSize, clqmcStatus* err) { \
+    clqmcLatticeRule* lattice = NULL; \
+    cl_int* genVec = (cl_int*) malloc((dimension ? dimension : 1) * sizeof(cl_int)); \
+    clqmcStatus err_; \
+    if (!genVec) \
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for the generating vector", __func__); \
+    else { \
+      err_ = clqmcLatticeRuleKorobovGenVec_(numPoints, dimension, gen, genVec, __func__); \
+      if (err_ == CLQMC_SUCCESS) \
+        lattice = clqmcLatticeRuleCreate_##fptype(numPoints, dimension, genVec, objectSize, &err_); \
+      free(genVec); \
+    } \
+    if (err) \
+      *err = err_; \
+    return lattice; \
+  }
+
+IMPLEMENT_CREATE_KOROBOV_FOR_TYPE(clqmc_float)
+IMPLEMENT_CREATE_KOROBOV_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_CREATE_KOROBOV_FOR_TYPE
+
+
+// Catalogue of lattice rules
+
+#include "latticecatalogue.h"
+
+// Extract the value of `width` bits at bit offset `offset` of a bit-packed array
+static cl_uint catalogueUnpack_(const cl_uint* data, size_t offset, cl_uint width)
+{
+  size_t word = offset / 32;
+  cl_uint shift = (cl_uint) (offset % 32);
+  cl_ulong bits = data[word] >> shift;
+  if (shift + width > 32)
+    bits |= (cl_ulong) data[word + 1] << (32 - shift);
+  return (cl_uint) (bits & (((cl_ulong) 1 << width) - 1));
+}
+
+clqmcStatus clqmcLatticeRuleCatalogueRange_(clqmcLatticeRuleFamily family, cl_uint* log2MinPoints, cl_uint* log2MaxPoints, const char* caller)
+{
+  switch (family) {
+  case CLQMC_LATTICE_CBC_POLY:
+  case CLQMC_LATTICE_CBC_GEOM:
+    *log2MinPoints = CATALOGUE_CBC_MIN_LOG2;
+    *log2MaxPoints = CATALOGUE_CBC_MAX_LOG2;
+    return CLQMC_SUCCESS;
+  case CLQMC_LATTICE_EMBEDDED_POLY:
+    *log2MinPoints = CATALOGUE_EMBEDDED_MIN_LOG2;
+    *log2MaxPoints = CATALOGUE_EMBEDDED_MAX_LOG2;
+    return CLQMC_SUCCESS;
+  case CLQMC_LATTICE_KOROBOV_POLY:
+    *log2MinPoints = CATALOGUE_KOROBOV_MIN_LOG2;
+    *log2MaxPoints = CATALOGUE_KOROBOV_MAX_LOG2;
+    return CLQMC_SUCCESS;
+  default:
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): invalid family", caller);
+  }
+}
+
+static clqmcStatus clqmcLatticeRuleCatalogueGenVec_(cl_uint log2NumPoints, cl_uint dimension, clqmcLatticeRuleFamily family, cl_int* genVec, const char* caller)
+{
+  if (dimension == 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the dimension must be positive", caller);
+
+  switch (family) {
+
+  case CLQMC_LATTICE_CBC_POLY:
+  case CLQMC_LATTICE_CBC_GEOM: {
+    if (log2NumPoints < CATALOGUE_CBC_MIN_LOG2 || log2NumPoints > CATALOGUE_CBC_MAX_LOG2)
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): no CBC lattice rule with 2^%u points in the catalogue (range: 2^%d to 2^%d)",
+                                 caller, log2NumPoints, CATALOGUE_CBC_MIN_LOG2, CATALOGUE_CBC_MAX_LOG2);
+    if (dimension > CATALOGUE_CBC_MAX_DIM)
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): no CBC lattice rule in dimension %u in the catalogue (maximum: %d)",
+                                 caller, dimension, CATALOGUE_CBC_MAX_DIM);
+    const cl_uint* data   = family == CLQMC_LATTICE_CBC_POLY ? catalogueCbcPolyData   : catalogueCbcGeomData;
+    const cl_uint* offset = family == CLQMC_LATTICE_CBC_POLY ? catalogueCbcPolyOffset : catalogueCbcGeomOffset;
+    cl_uint width = log2NumPoints - 2;
+    size_t base = offset[log2NumPoints - CATALOGUE_CBC_MIN_LOG2];
+    for (cl_uint j = 0; j < dimension; j++)
+      genVec[j] = (cl_int) (2 * catalogueUnpack_(data, base + (size_t) j * width, width) + 1);
+    return CLQMC_SUCCESS;
+  }
+
+  case CLQMC_LATTICE_EMBEDDED_POLY: {
+    if (log2NumPoints < CATALOGUE_EMBEDDED_MIN_LOG2 || log2NumPoints > CATALOGUE_EMBEDDED_MAX_LOG2)
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): no embedded lattice rule with 2^%u points in the catalogue (range: 2^%d to 2^%d)",
+                                 caller, log2NumPoints, CATALOGUE_EMBEDDED_MIN_LOG2, CATALOGUE_EMBEDDED_MAX_LOG2);
+    if (dimension > CATALOGUE_EMBEDDED_MAX_DIM)
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): no embedded lattice rule in dimension %u in the catalogue (maximum: %d)",
+                                 caller, dimension, CATALOGUE_EMBEDDED_MAX_DIM);
+    cl_uint width = CATALOGUE_EMBEDDED_MAX_LOG2 - 1;
+    cl_uint mask = ((cl_uint) 1 << log2NumPoints) - 1;
+    for (cl_uint j = 0; j < dimension; j++)
+      genVec[j] = (cl_int) ((2 * catalogueUnpack_(catalogueEmbeddedPolyData, (size_t) j * width, width) + 1) & mask);
+    return CLQMC_SUCCESS;
+  }
+
+  case CLQMC_LATTICE_KOROBOV_POLY: {
+    if (log2NumPoints < CATALOGUE_KOROBOV_MIN_LOG2 || log2NumPoints > CATALOGUE_KOROBOV_MAX_LOG2)
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): no Korobov lattice rule with 2^%u points in the catalogue (range: 2^%d to 2^%d)",
+                                 caller, log2NumPoints, CATALOGUE_KOROBOV_MIN_LOG2, CATALOGUE_KOROBOV_MAX_LOG2);
+    int i = 0;
+    while (i < CATALOGUE_KOROBOV_NUM_DIMS && catalogueKorobovDims[i] < dimension)
+      i++;
+    if (i == CATALOGUE_KOROBOV_NUM_DIMS)
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): no Korobov lattice rule in dimension %u in the catalogue (maximum: %u)",
+                                 caller, dimension, catalogueKorobovDims[CATALOGUE_KOROBOV_NUM_DIMS - 1]);
+    cl_uint gen = catalogueKorobovPolyData[log2NumPoints - CATALOGUE_KOROBOV_MIN_LOG2][i];
+    return clqmcLatticeRuleKorobovGenVec_((cl_uint) 1 << log2NumPoints, dimension, (cl_int) gen, genVec, caller);
+  }
+
+  default:
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): invalid family", caller);
+  }
+}
+
+#define IMPLEMENT_CREATE_FROM_CATALOGUE_FOR_TYPE(fptype) \
+  clqmcLatticeRule* clqmcLatticeRuleCreateFromCatalogue_##fptype(cl_uint log2NumPoints, cl_uint dimension, clqmcLatticeRuleFamily family, size_t *objectSize, clqmcStatus* err) { \
+    clqmcLatticeRule* lattice = NULL; \
+    cl_int genVec[CATALOGUE_CBC_MAX_DIM]; \
+    clqmcStatus err_ = clqmcLatticeRuleCatalogueGenVec_(log2NumPoints, dimension, family, genVec, __func__); \
+    if (err_ == CLQMC_SUCCESS) \
+      lattice = clqmcLatticeRuleCreate_##fptype((cl_uint) 1 << log2NumPoints, dimension, genVec, objectSize, &err_); \
+    if (err) \
+      *err = err_; \
+    return lattice; \
+  }
+
+IMPLEMENT_CREATE_FROM_CATALOGUE_FOR_TYPE(clqmc_float)
+IMPLEMENT_CREATE_FROM_CATALOGUE_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_CREATE_FROM_CATALOGUE_FOR_TYPE
+
+
 #define IMPLEMENT_STREAM_FOR_TYPE(fptype) \
   \
   clqmcLatticeRuleStream* clqmcLatticeRuleCreateStream_##fptype(const clqmcLatticeRule* lattice, clqmc_uint partCount, clqmc_uint partIndex, const fptype* shift, clqmcStatus* err) \
@@ -101,10 +262,50 @@ IMPLEMENT_CREATE_FOR_TYPE(clqmc_double)
     if (err != NULL) \
       *err = err_; \
     return stream; \
+  } \
+  \
+  clqmcStatus clqmcLatticeRuleCreateOverStreams_##fptype(clqmcLatticeRuleStream* streams, const clqmcLatticeRule* lattice, clqmc_uint partCount, clqmc_uint replications, const fptype* shifts) \
+  { \
+    if (!streams) \
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): streams cannot be NULL", __func__); \
+    if (!lattice) \
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): lattice cannot be NULL", __func__); \
+    if (partCount == 0 || lattice->numPoints % partCount != 0) \
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): number of points must be a multiple of partCount", __func__); \
+    for (clqmc_uint k = 0; k < replications; k++) { \
+      const fptype* shift = shifts ? &shifts[(size_t) k * lattice->dimension] : NULL; \
+      for (clqmc_uint p = 0; p < partCount; p++) \
+        clqmcLatticeRuleCreateOverStreamUnchecked_##fptype(&streams[(size_t) k * partCount + p], lattice, partCount, p, shift); \
+    } \
+    return CLQMC_SUCCESS; \
+  } \
+  \
+  clqmcLatticeRuleStream* clqmcLatticeRuleCreateStreams_##fptype(const clqmcLatticeRule* lattice, clqmc_uint partCount, clqmc_uint replications, const fptype* shifts, size_t* bufSize, clqmcStatus* err) \
+  { \
+    clqmcStatus err_ = CLQMC_SUCCESS; \
+    size_t bufSize_ = (size_t) partCount * replications * sizeof(clqmcLatticeRuleStream); \
+    clqmcLatticeRuleStream* streams = NULL; \
+    if (partCount == 0 || replications == 0) \
+      err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): partCount and replications must be positive", __func__); \
+    else if ((streams = (clqmcLatticeRuleStream*) malloc(bufSize_)) == NULL) \
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for streams", __func__); \
+    else { \
+      err_ = clqmcLatticeRuleCreateOverStreams_##fptype(streams, lattice, partCount, replications, shifts); \
+      if (err_ != CLQMC_SUCCESS) { \
+        free(streams); \
+        streams = NULL; \
+      } \
+      else if (bufSize != NULL) \
+        *bufSize = bufSize_; \
+    } \
+    if (err != NULL) \
+      *err = err_; \
+    return streams; \
   }
 
 IMPLEMENT_STREAM_FOR_TYPE(clqmc_float)
 IMPLEMENT_STREAM_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_STREAM_FOR_TYPE
 
 clqmcStatus clqmcLatticeRuleDestroyStream(clqmcLatticeRuleStream* stream)
 {
@@ -113,6 +314,56 @@ clqmcStatus clqmcLatticeRuleDestroyStream(clqmcLatticeRuleStream* stream)
   return CLQMC_SUCCESS;
 }
 
+clqmcStatus clqmcLatticeRuleDestroyStreams(clqmcLatticeRuleStream* streams)
+{
+  if (streams != NULL)
+    free(streams);
+  return CLQMC_SUCCESS;
+}
+
+clqmcLatticeRuleHostStream* clqmcLatticeRuleCreateHostStreams(const clqmcLatticeRule* lattice, cl_uint partCount, cl_uint replications, size_t* bufSize, clqmcStatus* err)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  clqmcLatticeRuleHostStream* hostStreams = NULL;
+  size_t bufSize_ = (size_t) partCount * replications * sizeof(clqmcLatticeRuleHostStream);
+
+  if (!lattice)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): lattice cannot be NULL", __func__);
+  else if (partCount == 0 || replications == 0)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): partCount and replications must be positive", __func__);
+  else if (lattice->numPoints % partCount != 0)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): number of points must be a multiple of partCount", __func__);
+  else if ((hostStreams = (clqmcLatticeRuleHostStream*) malloc(bufSize_)) == NULL)
+    err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for host streams", __func__);
+  else {
+    // initialize through a stream so that both start at the same position
+    clqmcLatticeRuleStream stream;
+    for (clqmc_uint k = 0; k < replications; k++) {
+      for (clqmc_uint p = 0; p < partCount; p++) {
+        clqmcLatticeRuleHostStream* hostStream = &hostStreams[(size_t) k * partCount + p];
+        clqmcLatticeRuleCreateOverStreamUnchecked_clqmc_double(&stream, lattice, partCount, p, NULL);
+        hostStream->pointIndex = stream.pointIndex;
+        hostStream->coordinateIndex = stream.coordinateIndex;
+        hostStream->replication = k;
+        hostStream->baker = stream.baker;
+      }
+    }
+    if (bufSize)
+      *bufSize = bufSize_;
+  }
+
+  if (err)
+    *err = err_;
+  return hostStreams;
+}
+
+clqmcStatus clqmcLatticeRuleDestroyHostStreams(clqmcLatticeRuleHostStream* hostStreams)
+{
+  if (hostStreams != NULL)
+    free(hostStreams);
+  return CLQMC_SUCCESS;
+}
+
 
 clqmcStatus clqmcLatticeRuleDestroy(clqmcLatticeRule* lattice)
 {
@@ -134,3 +385,371 @@ clqmcStatus clqmcLatticeRuleWriteInfo(const clqmcLatticeRule* lattice, FILE* fil
   fprintf(file, " ]\n");
   return CLQMC_SUCCESS;
 }
+
+
+/********************************************************************************
+ * Binary files                                                                 *
+ ********************************************************************************/
+
+#define CLQMC_LATTICE_FILE_MAGIC        "CLQMCLR"
+#define CLQMC_LATTICE_FILE_VERSION      1
+#define CLQMC_LATTICE_FILE_BYTE_ORDER   0x01020304u
+#define CLQMC_LATTICE_FILE_DATA_OFFSET  4096
+
+// Header at the beginning of a lattice rule file.
+// The lattice rule object follows at offset dataOffset, exactly as stored in
+// memory by the writer.
+typedef struct clqmcLatticeRuleFileHeader_ {
+  char     magic[8];      // CLQMC_LATTICE_FILE_MAGIC, null-terminated
+  cl_uint  version;
+  cl_uint  byteOrder;     // CLQMC_LATTICE_FILE_BYTE_ORDER in the byte order of the writer
+  cl_uint  fpSize;        // size in bytes of the elements of genVecNormed
+  cl_uint  dataOffset;    // offset of the object from the beginning of the file
+  cl_ulong objectSize;    // size in bytes of the object
+  cl_uint  numPoints;
+  cl_uint  dimension;
+} clqmcLatticeRuleFileHeader;
+
+static cl_uint clqmcSwap32(cl_uint x)
+{
+  return (x >> 24) | ((x >> 8) & 0xff00u) | ((x << 8) & 0xff0000u) | (x << 24);
+}
+
+static cl_ulong clqmcSwap64(cl_ulong x)
+{
+  return ((cl_ulong) clqmcSwap32((cl_uint) x) << 32) | clqmcSwap32((cl_uint) (x >> 32));
+}
+
+static size_t clqmcLatticeRuleObjectSize(cl_uint dimension, size_t fpsize)
+{
+  return sizeof(clqmcLatticeRule) + dimension * (sizeof(cl_int) + fpsize);
+}
+
+// Validate the header and convert it to the native byte order.
+// Set *swap to 1 if the file was written with the opposite byte order.
+static clqmcStatus clqmcLatticeRuleCheckHeader(clqmcLatticeRuleFileHeader* header, int* swap, const char* path, const char* caller)
+{
+  if (memcmp(header->magic, CLQMC_LATTICE_FILE_MAGIC, sizeof(CLQMC_LATTICE_FILE_MAGIC)) != 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): %s is not a lattice rule file", caller, path);
+  *swap = header->byteOrder != CLQMC_LATTICE_FILE_BYTE_ORDER;
+  if (*swap) {
+    if (header->byteOrder != clqmcSwap32(CLQMC_LATTICE_FILE_BYTE_ORDER))
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): %s: invalid byte order mark", caller, path);
+    header->version    = clqmcSwap32(header->version);
+    header->fpSize     = clqmcSwap32(header->fpSize);
+    header->dataOffset = clqmcSwap32(header->dataOffset);
+    header->objectSize = clqmcSwap64(header->objectSize);
+    header->numPoints  = clqmcSwap32(header->numPoints);
+    header->dimension  = clqmcSwap32(header->dimension);
+  }
+  if (header->version > CLQMC_LATTICE_FILE_VERSION)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): %s: unsupported file version %u", caller, path, header->version);
+  if (header->numPoints == 0 || header->dimension == 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): %s: the number of points and the dimension must be positive", caller, path);
+  if (header->fpSize != sizeof(cl_float) && header->fpSize != sizeof(cl_double))
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): %s: invalid floating-point size %u", caller, path, header->fpSize);
+  if (header->dataOffset < sizeof(clqmcLatticeRuleFileHeader)
+      || header->objectSize != clqmcLatticeRuleObjectSize(header->dimension, header->fpSize))
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): %s: inconsistent header", caller, path);
+  return CLQMC_SUCCESS;
+}
+
+static clqmcStatus clqmcLatticeRuleSave_(const clqmcLatticeRule* lattice, size_t fpsize, const char* path)
+{
+  if (!lattice || !path)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleSave(): lattice and path cannot be NULL");
+
+  clqmcLatticeRuleFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, CLQMC_LATTICE_FILE_MAGIC, sizeof(CLQMC_LATTICE_FILE_MAGIC));
+  header.version    = CLQMC_LATTICE_FILE_VERSION;
+  header.byteOrder  = CLQMC_LATTICE_FILE_BYTE_ORDER;
+  header.fpSize     = (cl_uint) fpsize;
+  header.dataOffset = CLQMC_LATTICE_FILE_DATA_OFFSET;
+  header.objectSize = clqmcLatticeRuleObjectSize(lattice->dimension, fpsize);
+  header.numPoints  = lattice->numPoints;
+  header.dimension  = lattice->dimension;
+
+  FILE* file = fopen(path, "wb");
+  if (file == NULL)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleSave(): cannot open %s for writing", path);
+
+  // the object is aligned on 4 KiB so that it can be mapped
+  static const char padding[CLQMC_LATTICE_FILE_DATA_OFFSET] = { 0 };
+  int ok = fwrite(&header, sizeof(header), 1, file) == 1
+    && fwrite(padding, CLQMC_LATTICE_FILE_DATA_OFFSET - sizeof(header), 1, file) == 1
+    && fwrite(lattice, (size_t) header.objectSize, 1, file) == 1;
+  ok = (fclose(file) == 0) && ok;
+
+  if (!ok)
+    return clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "clqmcLatticeRuleSave(): cannot write %s", path);
+  return CLQMC_SUCCESS;
+}
+
+static clqmcLatticeRule* clqmcLatticeRuleLoad_(const char* path, size_t fpsize, size_t* objectSize, clqmcStatus* err)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  clqmcLatticeRule* lattice = NULL;
+  clqmcLatticeRuleFileHeader header;
+  int swap = 0;
+
+  FILE* file = path ? fopen(path, "rb") : NULL;
+  if (file == NULL)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleLoad(): cannot open %s", path ? path : "(null)");
+  else if (fread(&header, sizeof(header), 1, file) != 1)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleLoad(): %s: truncated header", path);
+  else
+    err_ = clqmcLatticeRuleCheckHeader(&header, &swap, path, "clqmcLatticeRuleLoad");
+
+  if (err_ == CLQMC_SUCCESS && fseek(file, (long) header.dataOffset, SEEK_SET) != 0)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleLoad(): %s: truncated file", path);
+
+  if (err_ == CLQMC_SUCCESS && !swap && header.fpSize == fpsize) {
+    // same layout: read the object as is
+    lattice = (clqmcLatticeRule*) malloc((size_t) header.objectSize);
+    if (lattice == NULL)
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "clqmcLatticeRuleLoad(): could not allocate memory for lattice");
+    else if (fread(lattice, (size_t) header.objectSize, 1, file) != 1)
+      err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleLoad(): %s: truncated file", path);
+    else if (lattice->numPoints != header.numPoints || lattice->dimension != header.dimension)
+      err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleLoad(): %s: inconsistent header", path);
+    else if (objectSize)
+      *objectSize = (size_t) header.objectSize;
+  }
+  else if (err_ == CLQMC_SUCCESS) {
+    // different byte order or precision: convert the generating vector and
+    // recompute its normalized version
+    clqmcLatticeRule stored;
+    cl_int* genVec = (cl_int*) malloc((size_t) header.dimension * sizeof(cl_int));
+    if (genVec == NULL)
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "clqmcLatticeRuleLoad(): could not allocate memory");
+    else if (fread(&stored, sizeof(stored), 1, file) != 1
+        || fread(genVec, sizeof(cl_int), header.dimension, file) != header.dimension)
+      err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleLoad(): %s: truncated file", path);
+    else if ((swap ? clqmcSwap32(stored.numPoints) : stored.numPoints) != header.numPoints
+        || (swap ? clqmcSwap32(stored.dimension) : stored.dimension) != header.dimension)
+      err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleLoad(): %s: inconsistent header", path);
+    else {
+      if (swap)
+        for (cl_uint j = 0; j < header.dimension; j++)
+          genVec[j] = (cl_int) clqmcSwap32((cl_uint) genVec[j]);
+      lattice = fpsize == sizeof(cl_float)
+        ? clqmcLatticeRuleCreate_clqmc_float (header.numPoints, header.dimension, genVec, objectSize, &err_)
+        : clqmcLatticeRuleCreate_clqmc_double(header.numPoints, header.dimension, genVec, objectSize, &err_);
+    }
+    free(genVec);
+  }
+
+  if (file)
+    fclose(file);
+
+  if (err_ != CLQMC_SUCCESS && lattice) {
+    free(lattice);
+    lattice = NULL;
+  }
+
+  if (err)
+    *err = err_;
+  return lattice;
+}
+
+static clqmcLatticeRule* clqmcLatticeRuleMap_(const char* path, size_t fpsize, size_t* objectSize, clqmcStatus* err)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  clqmcLatticeRule* lattice = NULL;
+  clqmcLatticeRuleFileHeader header;
+  int swap = 0;
+
+  FILE* file = path ? fopen(path, "rb") : NULL;
+  if (file == NULL)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleMap(): cannot open %s", path ? path : "(null)");
+  else {
+    if (fread(&header, sizeof(header), 1, file) != 1)
+      err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleMap(): %s: truncated header", path);
+    else
+      err_ = clqmcLatticeRuleCheckHeader(&header, &swap, path, "clqmcLatticeRuleMap");
+    fclose(file);
+  }
+
+  if (err_ == CLQMC_SUCCESS && (swap || header.fpSize != fpsize))
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE,
+        "clqmcLatticeRuleMap(): %s: byte order or precision differs from the host; use clqmcLatticeRuleLoad()", path);
+  if (err_ == CLQMC_SUCCESS && header.dataOffset > CLQMC_LATTICE_FILE_DATA_OFFSET)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleMap(): %s: unsupported data offset", path);
+
+  if (err_ == CLQMC_SUCCESS) {
+    size_t length = header.dataOffset + (size_t) header.objectSize;
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    HANDLE mapping = fileHandle == INVALID_HANDLE_VALUE ? NULL
+      : CreateFileMappingA(fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    char* base = mapping ? (char*) MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, length) : NULL;
+    if (mapping)
+      CloseHandle(mapping);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+      CloseHandle(fileHandle);
+    if (base == NULL)
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    char* base = NULL;
+    if (fd >= 0 && fstat(fd, &st) == 0 && (size_t) st.st_size >= length) {
+      // private mapping: the pages are copied if the host writes to them
+      base = (char*) mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (base == (char*) MAP_FAILED)
+        base = NULL;
+    }
+    if (fd >= 0)
+      close(fd);
+    if (base == NULL)
+#endif
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "clqmcLatticeRuleMap(): cannot map %s", path);
+    else {
+      lattice = (clqmcLatticeRule*) (base + header.dataOffset);
+      if (lattice->numPoints != header.numPoints || lattice->dimension != header.dimension) {
+        err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "clqmcLatticeRuleMap(): %s: inconsistent header", path);
+        lattice = NULL;
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+#else
+        munmap(base, length);
+#endif
+      }
+      else if (objectSize)
+        *objectSize = (size_t) header.objectSize;
+    }
+  }
+
+  if (err)
+    *err = err_;
+  return lattice;
+}
+
+#define IMPLEMENT_FILE_FOR_TYPE(fptype) \
+  clqmcStatus clqmcLatticeRuleSave_##fptype(const clqmcLatticeRule* lattice, const char* path) { \
+    return clqmcLatticeRuleSave_(lattice, sizeof(fptype), path); \
+  } \
+  clqmcLatticeRule* clqmcLatticeRuleLoad_##fptype(const char* path, size_t* objectSize, clqmcStatus* err) { \
+    return clqmcLatticeRuleLoad_(path, sizeof(fptype), objectSize, err); \
+  } \
+  clqmcLatticeRule* clqmcLatticeRuleMap_##fptype(const char* path, size_t* objectSize, clqmcStatus* err) { \
+    return clqmcLatticeRuleMap_(path, sizeof(fptype), objectSize, err); \
+  }
+
+IMPLEMENT_FILE_FOR_TYPE(clqmc_float)
+IMPLEMENT_FILE_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_FILE_FOR_TYPE
+
+clqmcStatus clqmcLatticeRuleUnmap(clqmcLatticeRule* lattice)
+{
+  if (!lattice)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): lattice cannot be NULL", __func__);
+  // The object starts 4 KiB after the beginning of the mapping, which is
+  // aligned on the (allocation) page size; pages are at least 4 KiB, so the
+  // mapping starts at the last page boundary strictly before the object.
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  size_t pageSize = info.dwAllocationGranularity;
+#else
+  size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+#endif
+  char* base = (char*) (((size_t) lattice - 1) / pageSize * pageSize);
+  const clqmcLatticeRuleFileHeader* header = (const clqmcLatticeRuleFileHeader*) base;
+  if (memcmp(header->magic, CLQMC_LATTICE_FILE_MAGIC, sizeof(CLQMC_LATTICE_FILE_MAGIC)) != 0
+      || base + header->dataOffset != (char*) lattice)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): lattice was not mapped with clqmcLatticeRuleMap()", __func__);
+#ifdef _WIN32
+  if (!UnmapViewOfFile(base))
+#else
+  if (munmap(base, header->dataOffset + (size_t) header->objectSize) != 0)
+#endif
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): cannot unmap lattice", __func__);
+  return CLQMC_SUCCESS;
+}
+
+
+/********************************************************************************
+ * Specialized programs                                                         *
+ ********************************************************************************/
+
+char* clqmcLatticeRuleSpecializedSource(const clqmcLatticeRule* lattice, size_t* length, clqmcStatus* err)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  char* source = NULL;
+  size_t size = 0;
+
+  if (!lattice)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): lattice cannot be NULL", __func__);
+  else {
+    // at most 10 digits, a suffix, a separator and a share of a line break
+    // per component
+    size_t capacity = 512 + 20 * (size_t) lattice->dimension;
+    source = (char*) malloc(capacity);
+    if (!source)
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for source", __func__);
+    else {
+      cl_uint n = lattice->numPoints;
+      const cl_int* genVec = _CLQMC_LATTICE_GENVEC(lattice,const);
+      size += (size_t) sprintf(source + size,
+          "// lattice rule specialized by clqmcLatticeRuleSpecializedSource()\n"
+          "#define CLQMC_LATTICERULE_STATIC_POINTS    %uu\n"
+          "#define CLQMC_LATTICERULE_STATIC_DIMENSION %uu\n",
+          n, lattice->dimension);
+      if ((n & (n - 1)) == 0)
+        size += (size_t) sprintf(source + size, "#define CLQMC_LATTICERULE_STATIC_MASK      %uu\n", n - 1);
+      size += (size_t) sprintf(source + size, "#define CLQMC_LATTICERULE_STATIC_GENVEC    {");
+      for (cl_uint j = 0; j < lattice->dimension; j++) {
+        // the components of user-supplied generating vectors may be negative
+        cl_uint a = (cl_uint) (((cl_long) genVec[j] % n + n) % n);
+        size += (size_t) sprintf(source + size, "%s%uu%s", j % 8 == 0 ? " \\\n    " : " ", a,
+            j + 1 < lattice->dimension ? "," : "");
+      }
+      size += (size_t) sprintf(source + size, " }\n#line 1\n");
+    }
+  }
+
+  if (length)
+    *length = size;
+  if (err)
+    *err = err_;
+  return source;
+}
+
+cl_program clqmcLatticeRuleBuildSpecializedProgram(cl_context context, cl_device_id device, const clqmcLatticeRule* lattice,
+    cl_uint count, const char** strings, const size_t* lengths, const char* options, clqmcStatus* err)
+{
+  clqmcStatus err_;
+  cl_program program = NULL;
+  size_t prefixLength;
+  char* prefix = clqmcLatticeRuleSpecializedSource(lattice, &prefixLength, &err_);
+  const char** allStrings = NULL;
+  size_t* allLengths = NULL;
+
+  if (err_ == CLQMC_SUCCESS && (count == 0 || !strings))
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): at least one source string is required", __func__);
+
+  if (err_ == CLQMC_SUCCESS) {
+    allStrings = (const char**) malloc((count + 1) * sizeof(const char*));
+    allLengths = (size_t*) malloc((count + 1) * sizeof(size_t));
+    if (!allStrings || !allLengths)
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for source strings", __func__);
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    allStrings[0] = prefix;
+    allLengths[0] = prefixLength;
+    for (cl_uint i = 0; i < count; i++) {
+      allStrings[i + 1] = strings[i];
+      allLengths[i + 1] = lengths ? lengths[i] : 0;
+    }
+    program = clqmcBuildProgramWithSource(context, device, count + 1, allStrings, allLengths, options, &err_);
+  }
+
+  free(prefix);
+  free(allStrings);
+  free(allLengths);
+  if (err)
+    *err = err_;
+  return program;
+}
@@ -0,0 +1,372 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include "clQMC/multilevel.h"
+#include "clQMC/randomshift.h"
+#include "private.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef clqmcLatticeRule* (*clqmcMultilevelCreateLattice)(cl_uint log2NumPoints, cl_uint dimension, clqmcLatticeRuleFamily family,
+    size_t* objectSize, clqmcStatus* err);
+
+typedef struct clqmcMultilevelLevel_ {
+  cl_uint dimension;
+  cl_uint log2NumPoints;
+  double mean;
+  double variance;
+  double cost;          // ns per point and per shift
+} clqmcMultilevelLevel;
+
+struct clqmcMultilevel_ {
+  cl_uint maxLevels;
+  cl_uint numLevels;
+  clqmcMultilevelLevel* levels;
+  clqmcLatticeRuleFamily family;
+  cl_uint replications;
+  cl_uint log2MinPoints;
+  cl_uint log2MaxPoints;
+  cl_ulong seed;
+  cl_uint nextReplication;
+  clqmcMultilevelSampler sampler;
+  void* userData;
+  clqmcProfiler* profiler;
+  clqmcMultilevelCreateLattice createLattice;
+  size_t fpsize;
+  double* estimates;
+  void* shifts;
+  cl_ulong totalTime;   // ns
+};
+
+static clqmcMultilevel* clqmcMultilevelCreate_(cl_uint maxLevels, const cl_uint* dimensions, clqmcLatticeRuleFamily family, cl_uint replications,
+    cl_ulong seed, clqmcMultilevelSampler sampler, void* userData, clqmcMultilevelCreateLattice createLattice, size_t fpsize,
+    clqmcStatus* err, const char* caller)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  clqmcMultilevel* ml = NULL;
+  cl_uint maxDimension = 0;
+
+  if (maxLevels == 0 || !dimensions || !sampler)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): maxLevels must be positive and dimensions and sampler cannot be NULL", caller);
+  else if (replications < 2)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): at least 2 replications are required", caller);
+  else {
+    for (cl_uint l = 0; l < maxLevels; l++) {
+      if (dimensions[l] == 0) {
+        err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the dimension of level %u must be positive", caller, l);
+        break;
+      }
+      if (dimensions[l] > maxDimension)
+        maxDimension = dimensions[l];
+    }
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    ml = (clqmcMultilevel*) calloc(1, sizeof(clqmcMultilevel));
+    if (ml) {
+      ml->levels = (clqmcMultilevelLevel*) calloc(maxLevels, sizeof(clqmcMultilevelLevel));
+      ml->estimates = (double*) malloc(replications * sizeof(double));
+      ml->shifts = malloc((size_t) replications * maxDimension * fpsize);
+    }
+    if (!ml || !ml->levels || !ml->estimates || !ml->shifts) {
+      clqmcMultilevelDestroy(ml);
+      ml = NULL;
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for multilevel driver", caller);
+    }
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    ml->maxLevels = maxLevels;
+    ml->numLevels = 0;
+    for (cl_uint l = 0; l < maxLevels; l++)
+      ml->levels[l].dimension = dimensions[l];
+    ml->family = family;
+    ml->replications = replications;
+    ml->log2MinPoints = 4;
+    ml->log2MaxPoints = 20;
+    ml->seed = seed;
+    ml->nextReplication = 0;
+    ml->sampler = sampler;
+    ml->userData = userData;
+    ml->profiler = NULL;
+    ml->createLattice = createLattice;
+    ml->fpsize = fpsize;
+    ml->totalTime = 0;
+  }
+
+  if (err)
+    *err = err_;
+  return ml;
+}
+
+#define IMPLEMENT_CREATE_FOR_TYPE(fptype) \
+  clqmcMultilevel* clqmcMultilevelCreate_##fptype(cl_uint maxLevels, const cl_uint* dimensions, clqmcLatticeRuleFamily family, cl_uint replications, \
+      cl_ulong seed, clqmcMultilevelSampler sampler, void* userData, clqmcStatus* err) \
+  { \
+    return clqmcMultilevelCreate_(maxLevels, dimensions, family, replications, seed, sampler, userData, \
+        clqmcLatticeRuleCreateFromCatalogue_##fptype, sizeof(fptype), err, __func__); \
+  }
+
+IMPLEMENT_CREATE_FOR_TYPE(clqmc_float)
+IMPLEMENT_CREATE_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_CREATE_FOR_TYPE
+
+clqmcStatus clqmcMultilevelDestroy(clqmcMultilevel* ml)
+{
+  if (ml == NULL)
+    return CLQMC_SUCCESS;
+  free(ml->levels);
+  free(ml->estimates);
+  free(ml->shifts);
+  free(ml);
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcMultilevelSetPointRange(clqmcMultilevel* ml, cl_uint log2MinPoints, cl_uint log2MaxPoints)
+{
+  if (!ml)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): ml cannot be NULL", __func__);
+  if (log2MinPoints > log2MaxPoints)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): invalid range of points", __func__);
+  cl_uint catalogueMin, catalogueMax;
+  clqmcStatus err = clqmcLatticeRuleCatalogueRange_(ml->family, &catalogueMin, &catalogueMax, __func__);
+  if (err != CLQMC_SUCCESS)
+    return err;
+  if (log2MinPoints < catalogueMin || log2MaxPoints > catalogueMax)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the catalogue has lattice rules of this family with 2^%u to 2^%u points only",
+                               __func__, catalogueMin, catalogueMax);
+  if (ml->numLevels > 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): the levels have already been evaluated", __func__);
+  ml->log2MinPoints = log2MinPoints;
+  ml->log2MaxPoints = log2MaxPoints;
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcMultilevelSetProfiler(clqmcMultilevel* ml, clqmcProfiler* profiler)
+{
+  if (!ml)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): ml cannot be NULL", __func__);
+  ml->profiler = profiler;
+  return CLQMC_SUCCESS;
+}
+
+// Evaluate a level with its current number of points, with new shifts.
+static clqmcStatus clqmcMultilevelEvaluate(clqmcMultilevel* ml, cl_uint l)
+{
+  clqmcMultilevelLevel* level = &ml->levels[l];
+  clqmcStatus err;
+  size_t latticeSize;
+
+  clqmcLatticeRule* lattice = ml->createLattice(level->log2NumPoints, level->dimension, ml->family, &latticeSize, &err);
+  if (err != CLQMC_SUCCESS)
+    return err;
+
+  // every evaluation uses new replications of the shifts
+  if (ml->fpsize == sizeof(cl_float))
+    err = clqmcRandomShiftsGenerate_clqmc_float(ml->seed, ml->nextReplication, ml->replications, level->dimension, (cl_float*) ml->shifts);
+  else
+    err = clqmcRandomShiftsGenerate_clqmc_double(ml->seed, ml->nextReplication, ml->replications, level->dimension, (cl_double*) ml->shifts);
+  ml->nextReplication += ml->replications;
+  if (err != CLQMC_SUCCESS) {
+    clqmcLatticeRuleDestroy(lattice);
+    return err;
+  }
+
+  cl_event event = NULL;
+  cl_ulong start = clqmcHostTime();
+  err = ml->sampler(ml->userData, l, lattice, latticeSize, ml->replications, ml->shifts, ml->estimates, &event);
+  cl_ulong time = clqmcHostTime() - start;
+  clqmcLatticeRuleDestroy(lattice);
+
+  if (event) {
+    cl_ulong deviceStart, deviceEnd;
+    if (err == CLQMC_SUCCESS
+        && clWaitForEvents(1, &event) == CL_SUCCESS
+        && clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(deviceStart), &deviceStart, NULL) == CL_SUCCESS
+        && clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END,   sizeof(deviceEnd),   &deviceEnd,   NULL) == CL_SUCCESS)
+      time = deviceEnd - deviceStart;
+    if (err == CLQMC_SUCCESS && ml->profiler) {
+      char name[32];
+      snprintf(name, sizeof(name), "level %u", l);
+      err = clqmcProfilerRecordEvent(ml->profiler, name, event);
+    }
+    clReleaseEvent(event);
+  }
+  if (err != CLQMC_SUCCESS)
+    return err;
+
+  double sum = 0.0, sumSquares = 0.0;
+  for (cl_uint r = 0; r < ml->replications; r++) {
+    sum += ml->estimates[r];
+    sumSquares += ml->estimates[r] * ml->estimates[r];
+  }
+  level->mean = sum / ml->replications;
+  level->variance = (sumSquares - sum * level->mean) / (ml->replications - 1) / ml->replications;
+  if (level->variance < 0)
+    level->variance = 0;
+  level->cost = (double) time / ((double) ml->replications * ((cl_ulong) 1 << level->log2NumPoints));
+  ml->totalTime += time;
+  return CLQMC_SUCCESS;
+}
+
+static clqmcStatus clqmcMultilevelAddLevel(clqmcMultilevel* ml)
+{
+  cl_uint l = ml->numLevels;
+  ml->levels[l].log2NumPoints = ml->log2MinPoints;
+  clqmcStatus err = clqmcMultilevelEvaluate(ml, l);
+  if (err == CLQMC_SUCCESS)
+    ml->numLevels++;
+  return err;
+}
+
+static double clqmcMultilevelTotalVariance(const clqmcMultilevel* ml)
+{
+  double variance = 0.0;
+  for (cl_uint l = 0; l < ml->numLevels; l++)
+    variance += ml->levels[l].variance;
+  return variance;
+}
+
+// Weak order alpha, by least-squares regression of log2 |mean| on the level
+// for levels >= 1, bounded below by 1/2.
+static double clqmcMultilevelWeakOrder(const clqmcMultilevel* ml)
+{
+  double n = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (cl_uint l = 1; l < ml->numLevels; l++) {
+    double y = log2(fabs(ml->levels[l].mean) + 1e-300);
+    n += 1; sx += l; sy += y; sxx += (double) l * l; sxy += l * y;
+  }
+  double alpha = n >= 2 ? -(n * sxy - sx * sy) / (n * sxx - sx * sx) : 1.0;
+  return alpha > 0.5 ? alpha : 0.5;
+}
+
+clqmcStatus clqmcMultilevelRun(clqmcMultilevel* ml, double epsilon, double* estimate, double* variance, cl_bool* converged)
+{
+  clqmcStatus err = CLQMC_SUCCESS;
+  cl_bool converged_ = CL_FALSE;
+
+  if (!ml)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): ml cannot be NULL", __func__);
+  if (!(epsilon > 0))
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): epsilon must be positive", __func__);
+
+  while (err == CLQMC_SUCCESS && ml->numLevels < (ml->maxLevels < 3 ? ml->maxLevels : 3))
+    err = clqmcMultilevelAddLevel(ml);
+
+  while (err == CLQMC_SUCCESS) {
+
+    // Variance: double the number of points on the most profitable level
+    cl_bool varianceReached = CL_TRUE;
+    while (err == CLQMC_SUCCESS && clqmcMultilevelTotalVariance(ml) > epsilon * epsilon / 2) {
+      double best = -1.0;
+      cl_uint bestLevel = 0;
+      for (cl_uint l = 0; l < ml->numLevels; l++) {
+        const clqmcMultilevelLevel* level = &ml->levels[l];
+        if (level->log2NumPoints >= ml->log2MaxPoints)
+          continue;
+        double ratio = level->variance / ((double) ((cl_ulong) 1 << level->log2NumPoints) * (level->cost > 0 ? level->cost : 1.0));
+        if (ratio > best) {
+          best = ratio;
+          bestLevel = l;
+        }
+      }
+      if (best < 0) {
+        varianceReached = CL_FALSE;
+        break;
+      }
+      ml->levels[bestLevel].log2NumPoints++;
+      err = clqmcMultilevelEvaluate(ml, bestLevel);
+    }
+    if (err != CLQMC_SUCCESS)
+      break;
+
+    // Bias: add a level if the estimated bias is too large
+    cl_bool biasReached = CL_TRUE;
+    if (ml->numLevels >= 2) {
+      double alpha = clqmcMultilevelWeakOrder(ml);
+      double factor = pow(2.0, alpha);
+      double last = fabs(ml->levels[ml->numLevels - 1].mean);
+      double previous = fabs(ml->levels[ml->numLevels - 2].mean) / factor;
+      double bias = (last > previous ? last : previous) / (factor - 1.0);
+      biasReached = bias <= epsilon / sqrt(2.0) ? CL_TRUE : CL_FALSE;
+    }
+    if (biasReached || ml->numLevels == ml->maxLevels) {
+      converged_ = varianceReached && biasReached;
+      break;
+    }
+    err = clqmcMultilevelAddLevel(ml);
+  }
+
+  if (err != CLQMC_SUCCESS)
+    return err;
+
+  if (estimate) {
+    *estimate = 0.0;
+    for (cl_uint l = 0; l < ml->numLevels; l++)
+      *estimate += ml->levels[l].mean;
+  }
+  if (variance)
+    *variance = clqmcMultilevelTotalVariance(ml);
+  if (converged)
+    *converged = converged_;
+  return CLQMC_SUCCESS;
+}
+
+cl_uint clqmcMultilevelNumLevels(const clqmcMultilevel* ml)
+{
+  return ml ? ml->numLevels : 0;
+}
+
+clqmcStatus clqmcMultilevelGetLevel(const clqmcMultilevel* ml, cl_uint level, cl_uint* numPoints, double* mean, double* variance, double* cost)
+{
+  if (!ml)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): ml cannot be NULL", __func__);
+  if (level >= ml->numLevels)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): level %u has not been evaluated", __func__, level);
+  if (numPoints)
+    *numPoints = (cl_uint) 1 << ml->levels[level].log2NumPoints;
+  if (mean)
+    *mean = ml->levels[level].mean;
+  if (variance)
+    *variance = ml->levels[level].variance;
+  if (cost)
+    *cost = ml->levels[level].cost;
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcMultilevelWriteInfo(const clqmcMultilevel* ml, FILE* file)
+{
+  if (!ml || !file)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): ml and file cannot be NULL", __func__);
+  fprintf(file, "%6s %10s %10s %14s %14s %14s\n", "level", "dimension", "points", "mean", "variance", "cost (ns)");
+  for (cl_uint l = 0; l < ml->numLevels; l++) {
+    const clqmcMultilevelLevel* level = &ml->levels[l];
+    fprintf(file, "%6u %10u %10lu %14.6g %14.6g %14.6g\n", l, level->dimension,
+        (unsigned long) ((cl_ulong) 1 << level->log2NumPoints), level->mean, level->variance, level->cost);
+  }
+  fprintf(file, "replications per level: %u\n", ml->replications);
+  fprintf(file, "total evaluation time:  %.6g s\n", ml->totalTime * 1e-9);
+  return CLQMC_SUCCESS;
+}
@@ -31,10 +31,16 @@
 #include <stdarg.h>
 #include <stdlib.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
 #define CASE_ERR_(code,msg) case code: base = msg; break
 #define CASE_ERR(code)      CASE_ERR_(CLQMC_ ## code, MSG_ ## code)
 
-char clqmcErrorString[1024]                = "";
+CLQMC_THREAD_LOCAL char clqmcErrorString[1024] = "";
 
 static const char MSG_DEFAULT[]                 = "unknown status";
 static const char MSG_SUCCESS[]                 = "success";
@@ -46,8 +52,8 @@ static const char MSG_NOT_IMPLEMENTED[]         = "not implemented";
 
 clqmcStatus clqmcSetErrorString(cl_int err, const char* msg, ...)
 {
-    char formatted[1024];
     const char* base;
+    int nbytes;
     switch (err) {
         CASE_ERR(SUCCESS);
         CASE_ERR(OUT_OF_RESOURCES);
@@ -56,10 +62,28 @@ clqmcStatus clqmcSetErrorString(cl_int err, const char* msg, ...)
         CASE_ERR(NOT_IMPLEMENTED);
         default: base = MSG_DEFAULT;
     }
-    va_list args;
-    va_start(args, msg);
-    vsprintf(formatted, msg, args);
-    sprintf(clqmcErrorString, "[%s] %s", base, formatted);
-    va_end(args);
+    // format directly into the thread-local buffer, truncating if needed
+    nbytes = snprintf(clqmcErrorString, sizeof(clqmcErrorString), "[%s] ", base);
+    if (msg != NULL && nbytes >= 0 && (size_t) nbytes < sizeof(clqmcErrorString)) {
+        va_list args;
+        va_start(args, msg);
+        vsnprintf(clqmcErrorString + nbytes, sizeof(clqmcErrorString) - nbytes, msg, args);
+        va_end(args);
+    }
     return (clqmcStatus) err;
 }
+
+cl_ulong clqmcHostTime()
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (cl_ulong) (count.QuadPart / freq.QuadPart) * 1000000000ULL
+      + (cl_ulong) (count.QuadPart % freq.QuadPart) * 1000000000ULL / freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (cl_ulong) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
@@ -25,11 +25,28 @@
 #ifndef PRIVATE_H
 #define PRIVATE_H
 
+#include "clQMC/latticerule.h"
+
+/*! @brief Storage-class specifier for thread-local variables
+ */
+#if defined(_MSC_VER)
+  #define CLQMC_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+  #define CLQMC_THREAD_LOCAL _Thread_local
+#else
+  #define CLQMC_THREAD_LOCAL __thread
+#endif
+
+/*! @brief Error string of the calling thread
+ */
+extern CLQMC_THREAD_LOCAL char clqmcErrorString[1024];
 
 /*! @brief Set the current error string
  *
  *  The error string will be constructed based on the error code \c err and on
  *  the optional message \c msg.
+ *  It is stored in a thread-local buffer, so concurrent calls from distinct
+ *  threads do not interfere.
  *
  *  @param[in]  err     Error code.
  *  @param[in]  msg     Additional error message (format string).  Can be `NULL`.
@@ -38,6 +55,73 @@
  */
 clqmcStatus clqmcSetErrorString(cl_int err, const char* msg, ...);
 
+/*! @brief Return the value of a monotonic host clock, in nanoseconds.
+ */
+cl_ulong clqmcHostTime();
+
+/*! @brief Philox4x32-10 and uniform values derived from it
+ *
+ *  Implemented in private/randomshift.c.h and shared with the lattice rule
+ *  streams, which use them for padding.
+ */
+void clqmcPhilox4x32_10(clqmc_uint ctr[4], clqmc_uint key0, clqmc_uint key1);
+clqmc_float  clqmcPhiloxUniform_clqmc_float (clqmc_ulong seed, clqmc_uint c0, clqmc_uint c1, clqmc_uint c2, clqmc_uint c3);
+clqmc_double clqmcPhiloxUniform_clqmc_double(clqmc_ulong seed, clqmc_uint c0, clqmc_uint c1, clqmc_uint c2, clqmc_uint c3);
+
+/*! @brief Range of numbers of points of a family of the catalogue
+ *
+ *  Store the base-2 logarithms of the smallest and of the largest numbers of
+ *  points of the lattice rules of `family` in the catalogue used by
+ *  clqmcLatticeRuleCreateFromCatalogue().
+ *
+ *  @return Error status; CLQMC_INVALID_VALUE if `family` is invalid.
+ */
+clqmcStatus clqmcLatticeRuleCatalogueRange_(clqmcLatticeRuleFamily family, cl_uint* log2MinPoints, cl_uint* log2MaxPoints, const char* caller);
+
+/*! @brief Device header compiled into the library
+ *
+ *  The table clqmcEmbeddedHeaders[] is generated at build time by
+ *  embedheaders.cmake from the device headers, with their paths relative to
+ *  the include directory as names (e.g., `clQMC/latticerule.clh`); it ends
+ *  with an entry whose name is `NULL`.
+ */
+typedef struct clqmcEmbeddedHeader_ {
+  const char* name;
+  const char* source;
+  size_t length;
+} clqmcEmbeddedHeader;
+
+extern const clqmcEmbeddedHeader clqmcEmbeddedHeaders[];
+
+/*! @brief Replace the includes of embedded headers with their contents
+ *
+ *  Each `#include` directive of the program sources (and, recursively, of
+ *  the embedded headers) that names an embedded header is replaced with the
+ *  contents of the header, surrounded with `#line` directives; other lines
+ *  are copied unchanged.
+ *
+ *  @param[in]  count       Number of source strings.
+ *  @param[in]  strings     Source strings.
+ *  @param[in]  lengths     Lengths of the source strings, or `NULL` if they
+ *                          are all null-terminated; a zero length also
+ *                          denotes a null-terminated string.
+ *  @param[out] length      Length of the expanded source, or `NULL`.
+ *  @param[out] err         Error status variable, or `NULL`.
+ *  @param[in]  caller      Name of the calling function, for error messages.
+ *
+ *  @return Null-terminated expanded source, to be released with free(), or
+ *  `NULL` on error.
+ */
+char* clqmcExpandDeviceSource(cl_uint count, const char** strings, const size_t* lengths, size_t* length, clqmcStatus* err, const char* caller);
+
+/*! @brief 64-bit FNV-1a hash
+ *
+ *  Hash `size` bytes at `data`, continuing from `hash`, which must be
+ *  CLQMC_HASH_INIT for the first block.
+ */
+#define CLQMC_HASH_INIT 14695981039346656037ULL
+cl_ulong clqmcHashBytes(cl_ulong hash, const void* data, size_t size);
+
 
 #endif
 
@@ -0,0 +1,315 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include "clQMC/profiling.h"
+#include "private.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CLQMC_PROFILER_NAME_SIZE 64
+
+typedef struct clqmcProfilerRecord_ {
+  char name[CLQMC_PROFILER_NAME_SIZE];
+  cl_event event;       // NULL for host spans
+  cl_ulong hostStart;   // host time (ns) at the beginning of a span or when an event is recorded
+  cl_ulong hostEnd;     // host time (ns) at the end of a span; 0 for an open span
+} clqmcProfilerRecord;
+
+struct clqmcProfiler_ {
+  cl_ulong origin;
+  clqmcProfilerRecord* records;
+  size_t count;
+  size_t capacity;
+  size_t* openSpans;
+  size_t openCount;
+  size_t openCapacity;
+};
+
+// Device timestamps of a recorded command.
+typedef struct clqmcProfilerTimes_ {
+  cl_ulong queued;
+  cl_ulong start;
+  cl_ulong end;
+} clqmcProfilerTimes;
+
+static clqmcStatus clqmcProfilerGrow(void** buf, size_t* capacity, size_t count, size_t elemSize)
+{
+  if (count < *capacity)
+    return CLQMC_SUCCESS;
+  size_t newCapacity = *capacity ? 2 * *capacity : 64;
+  void* newBuf = realloc(*buf, newCapacity * elemSize);
+  if (newBuf == NULL)
+    return CLQMC_OUT_OF_RESOURCES;
+  *buf = newBuf;
+  *capacity = newCapacity;
+  return CLQMC_SUCCESS;
+}
+
+static clqmcProfilerRecord* clqmcProfilerNewRecord(clqmcProfiler* profiler, const char* name)
+{
+  if (clqmcProfilerGrow((void**) &profiler->records, &profiler->capacity, profiler->count, sizeof(clqmcProfilerRecord)) != CLQMC_SUCCESS)
+    return NULL;
+  clqmcProfilerRecord* record = &profiler->records[profiler->count++];
+  strncpy(record->name, name, CLQMC_PROFILER_NAME_SIZE - 1);
+  record->name[CLQMC_PROFILER_NAME_SIZE - 1] = '\0';
+  record->event = NULL;
+  record->hostStart = clqmcHostTime() - profiler->origin;
+  record->hostEnd = 0;
+  return record;
+}
+
+static clqmcStatus clqmcProfilerGetTimes(const clqmcProfilerRecord* record, clqmcProfilerTimes* times)
+{
+  cl_int err;
+  err  = clGetEventProfilingInfo(record->event, CL_PROFILING_COMMAND_QUEUED, sizeof(times->queued), &times->queued, NULL);
+  err |= clGetEventProfilingInfo(record->event, CL_PROFILING_COMMAND_START,  sizeof(times->start),  &times->start,  NULL);
+  err |= clGetEventProfilingInfo(record->event, CL_PROFILING_COMMAND_END,    sizeof(times->end),    &times->end,    NULL);
+  if (err != CL_SUCCESS)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE,
+        "cannot read profiling info for `%s' (queue without profiling or command not completed)", record->name);
+  return CLQMC_SUCCESS;
+}
+
+// Write a JSON string literal.
+static void clqmcWriteJSONString(FILE* file, const char* s)
+{
+  fputc('"', file);
+  for (; *s; s++) {
+    if (*s == '"' || *s == '\\')
+      fprintf(file, "\\%c", *s);
+    else if ((unsigned char) *s < 0x20)
+      fprintf(file, "\\u%04x", (unsigned) *s);
+    else
+      fputc(*s, file);
+  }
+  fputc('"', file);
+}
+
+
+clqmcProfiler* clqmcProfilerCreate(clqmcStatus* err)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  clqmcProfiler* profiler = (clqmcProfiler*) malloc(sizeof(clqmcProfiler));
+  if (profiler == NULL)
+    err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for profiler", __func__);
+  else {
+    profiler->origin = clqmcHostTime();
+    profiler->records = NULL;
+    profiler->count = 0;
+    profiler->capacity = 0;
+    profiler->openSpans = NULL;
+    profiler->openCount = 0;
+    profiler->openCapacity = 0;
+  }
+  if (err)
+    *err = err_;
+  return profiler;
+}
+
+clqmcStatus clqmcProfilerDestroy(clqmcProfiler* profiler)
+{
+  if (profiler == NULL)
+    return CLQMC_SUCCESS;
+  for (size_t i = 0; i < profiler->count; i++)
+    if (profiler->records[i].event)
+      clReleaseEvent(profiler->records[i].event);
+  free(profiler->records);
+  free(profiler->openSpans);
+  free(profiler);
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcProfilerRecordEvent(clqmcProfiler* profiler, const char* name, cl_event event)
+{
+  if (!profiler)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): profiler cannot be NULL", __func__);
+  if (!name || !event)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): name and event cannot be NULL", __func__);
+  if (clRetainEvent(event) != CL_SUCCESS)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): invalid event", __func__);
+  clqmcProfilerRecord* record = clqmcProfilerNewRecord(profiler, name);
+  if (record == NULL) {
+    clReleaseEvent(event);
+    return clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for record", __func__);
+  }
+  record->event = event;
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcProfilerBeginSpan(clqmcProfiler* profiler, const char* name)
+{
+  if (!profiler)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): profiler cannot be NULL", __func__);
+  if (!name)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): name cannot be NULL", __func__);
+  if (clqmcProfilerGrow((void**) &profiler->openSpans, &profiler->openCapacity, profiler->openCount, sizeof(size_t)) != CLQMC_SUCCESS
+      || clqmcProfilerNewRecord(profiler, name) == NULL)
+    return clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for span", __func__);
+  profiler->openSpans[profiler->openCount++] = profiler->count - 1;
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcProfilerEndSpan(clqmcProfiler* profiler)
+{
+  if (!profiler)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): profiler cannot be NULL", __func__);
+  if (profiler->openCount == 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): no open span", __func__);
+  clqmcProfilerRecord* record = &profiler->records[profiler->openSpans[--profiler->openCount]];
+  record->hostEnd = clqmcHostTime() - profiler->origin;
+  // avoid confusion with open spans
+  if (record->hostEnd == 0)
+    record->hostEnd = 1;
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcProfilerWriteTrace(const clqmcProfiler* profiler, FILE* file)
+{
+  if (!profiler || !file)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): profiler and file cannot be NULL", __func__);
+
+  // align the device timeline on the first queued command
+  cl_long offset = 0;
+  cl_bool aligned = CL_FALSE;
+  clqmcProfilerTimes times;
+  for (size_t i = 0; i < profiler->count; i++) {
+    const clqmcProfilerRecord* record = &profiler->records[i];
+    if (!record->event)
+      continue;
+    clqmcStatus err = clqmcProfilerGetTimes(record, &times);
+    if (err != CLQMC_SUCCESS)
+      return err;
+    if (!aligned || (cl_long) (record->hostStart - times.queued) < offset) {
+      offset = (cl_long) (record->hostStart - times.queued);
+      aligned = CL_TRUE;
+    }
+  }
+
+  fprintf(file, "{\"traceEvents\":[\n");
+  fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"host\"}},\n");
+  fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"device\"}}");
+
+  for (size_t i = 0; i < profiler->count; i++) {
+    const clqmcProfilerRecord* record = &profiler->records[i];
+    if (record->event) {
+      clqmcProfilerGetTimes(record, &times);
+      fprintf(file, ",\n{\"name\":");
+      clqmcWriteJSONString(file, record->name);
+      fprintf(file, ",\"cat\":\"device\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"queued_us\":%.3f}}",
+          1e-3 * (cl_long) (times.start + offset),
+          1e-3 * (times.end - times.start),
+          1e-3 * (times.start - times.queued));
+    }
+    else if (record->hostEnd) {
+      fprintf(file, ",\n{\"name\":");
+      clqmcWriteJSONString(file, record->name);
+      fprintf(file, ",\"cat\":\"host\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+          1e-3 * record->hostStart,
+          1e-3 * (record->hostEnd - record->hostStart));
+    }
+  }
+
+  fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcProfilerWriteSummary(const clqmcProfiler* profiler, FILE* file)
+{
+  if (!profiler || !file)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): profiler and file cannot be NULL", __func__);
+
+  // indices of the first record of each distinct (kind, name) pair
+  size_t* groups = (size_t*) malloc((profiler->count ? profiler->count : 1) * sizeof(size_t));
+  if (groups == NULL)
+    return clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory", __func__);
+  size_t groupCount = 0;
+  cl_ulong elapsed = 0;
+  clqmcProfilerTimes times;
+
+  for (size_t i = 0; i < profiler->count; i++) {
+    const clqmcProfilerRecord* record = &profiler->records[i];
+    if (record->event) {
+      clqmcStatus err = clqmcProfilerGetTimes(record, &times);
+      if (err != CLQMC_SUCCESS) {
+        free(groups);
+        return err;
+      }
+    }
+    if (record->hostEnd > elapsed)
+      elapsed = record->hostEnd;
+    size_t g = 0;
+    while (g < groupCount && !(
+          (profiler->records[groups[g]].event != NULL) == (record->event != NULL)
+          && strcmp(profiler->records[groups[g]].name, record->name) == 0))
+      g++;
+    if (g == groupCount)
+      groups[groupCount++] = i;
+  }
+
+  fprintf(file, "%-8s%-32s%8s%14s%14s%14s%14s%14s\n",
+      "kind", "name", "count", "total (ms)", "mean (ms)", "min (ms)", "max (ms)", "queued (ms)");
+
+  for (size_t g = 0; g < groupCount; g++) {
+    const clqmcProfilerRecord* first = &profiler->records[groups[g]];
+    cl_bool device = first->event != NULL;
+    size_t count = 0;
+    cl_ulong total = 0, min = 0, max = 0, queued = 0;
+    for (size_t i = groups[g]; i < profiler->count; i++) {
+      const clqmcProfilerRecord* record = &profiler->records[i];
+      if ((record->event != NULL) != device || strcmp(record->name, first->name) != 0)
+        continue;
+      cl_ulong duration;
+      if (device) {
+        clqmcProfilerGetTimes(record, &times);
+        duration = times.end - times.start;
+        queued += times.start - times.queued;
+      }
+      else if (record->hostEnd)
+        duration = record->hostEnd - record->hostStart;
+      else
+        continue;   // open span
+      if (count == 0 || duration < min)
+        min = duration;
+      if (duration > max)
+        max = duration;
+      total += duration;
+      count++;
+    }
+    if (count == 0)
+      continue;
+    fprintf(file, "%-8s%-32.32s%8lu%14.3f%14.3f%14.3f%14.3f",
+        device ? "device" : "host", first->name, (unsigned long) count,
+        1e-6 * total, 1e-6 * total / count, 1e-6 * min, 1e-6 * max);
+    if (device)
+      fprintf(file, "%14.3f\n", 1e-6 * queued);
+    else
+      fprintf(file, "%14s\n", "");
+  }
+
+  fprintf(file, "elapsed host time until the end of the last span: %.3f ms\n", 1e-6 * elapsed);
+
+  free(groups);
+  return CLQMC_SUCCESS;
+}
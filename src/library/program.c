@@ -0,0 +1,443 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include "clQMC/clQMC.h"
+#include "private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// Name given with #line to the program sources after an expanded header, so
+// that the build log refers to the lines of the original sources.
+#define CLQMC_PROGRAM_SOURCE_NAME "<source>"
+
+typedef struct clqmcSourceBuffer_ {
+  char* data;
+  size_t size;
+  size_t capacity;
+  int failed;
+} clqmcSourceBuffer;
+
+static void clqmcSourceAppend(clqmcSourceBuffer* buf, const char* data, size_t size)
+{
+  if (buf->failed)
+    return;
+  if (buf->size + size + 1 > buf->capacity) {
+    size_t capacity = buf->capacity ? buf->capacity : 4096;
+    while (buf->size + size + 1 > capacity)
+      capacity *= 2;
+    char* newData = (char*) realloc(buf->data, capacity);
+    if (!newData) {
+      buf->failed = 1;
+      return;
+    }
+    buf->data = newData;
+    buf->capacity = capacity;
+  }
+  memcpy(buf->data + buf->size, data, size);
+  buf->size += size;
+  buf->data[buf->size] = '\0';
+}
+
+static void clqmcSourceAppendLine(clqmcSourceBuffer* buf, size_t line, const char* name)
+{
+  char directive[128];
+  int n = snprintf(directive, sizeof(directive), "#line %lu \"%s\"\n", (unsigned long) line, name);
+  if (n > 0 && (size_t) n < sizeof(directive))
+    clqmcSourceAppend(buf, directive, (size_t) n);
+}
+
+// Return the embedded header named by the #include directive on the line
+// [begin, end), or NULL if the line is not such a directive.
+static const clqmcEmbeddedHeader* clqmcFindIncludedHeader(const char* begin, const char* end)
+{
+  const char* p = begin;
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  if (p == end || *p++ != '#')
+    return NULL;
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  if ((size_t) (end - p) < 7 || strncmp(p, "include", 7) != 0)
+    return NULL;
+  p += 7;
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  if (p == end || (*p != '<' && *p != '"'))
+    return NULL;
+  char close = *p++ == '<' ? '>' : '"';
+  const char* name = p;
+  while (p < end && *p != close)
+    p++;
+  if (p == end)
+    return NULL;
+  size_t nameLength = (size_t) (p - name);
+  for (const clqmcEmbeddedHeader* header = clqmcEmbeddedHeaders; header->name; header++)
+    if (strlen(header->name) == nameLength && strncmp(header->name, name, nameLength) == 0)
+      return header;
+  return NULL;
+}
+
+// Return nonzero if the line [begin, end) is a `#pragma once` directive.
+static int clqmcIsPragmaOnce(const char* begin, const char* end)
+{
+  const char* words[3] = { "#", "pragma", "once" };
+  const char* p = begin;
+  for (int i = 0; i < 3; i++) {
+    size_t n = strlen(words[i]);
+    while (p < end && (*p == ' ' || *p == '\t'))
+      p++;
+    if ((size_t) (end - p) < n || strncmp(p, words[i], n) != 0)
+      return 0;
+    p += n;
+  }
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    p++;
+  return p == end;
+}
+
+// Return nonzero if the line [begin, end) is a `#line` directive; then store
+// the number it gives to the next line in `number`, and its file name, if
+// any, in `name`, which has room for `nameSize` characters.
+static int clqmcParseLineDirective(const char* begin, const char* end, size_t* number, char* name, size_t nameSize)
+{
+  const char* p = begin;
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  if (p == end || *p++ != '#')
+    return 0;
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  if ((size_t) (end - p) < 5 || strncmp(p, "line", 4) != 0 || (p[4] != ' ' && p[4] != '\t'))
+    return 0;
+  p += 4;
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  if (p == end || *p < '0' || *p > '9')
+    return 0;
+  size_t n = 0;
+  while (p < end && *p >= '0' && *p <= '9')
+    n = 10 * n + (size_t) (*p++ - '0');
+  *number = n;
+  name[0] = '\0';
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+  if (p < end && *p == '"') {
+    const char* first = ++p;
+    while (p < end && *p != '"' && *p != '\n')
+      p++;
+    if (p < end && *p == '"' && (size_t) (p - first) < nameSize) {
+      memcpy(name, first, (size_t) (p - first));
+      name[p - first] = '\0';
+    }
+  }
+  return 1;
+}
+
+// Copy `source` into `buf`, replacing the includes of embedded headers with
+// their expansion.  The embedded headers include one another unconditionally,
+// so within the expansion of an include of the program sources, each header
+// is expanded only the first time; `expanded` marks those headers.  It is
+// cleared for each include of the program sources (where `topLevel` is
+// nonzero), as the first one may lie in a disabled conditional block, so that
+// later includes are expanded again and skipped by the include guards.
+// The `#pragma once` directives of the headers, which would apply to the
+// whole program, are removed; the headers also have include guards.
+// The `#line` directives of the source, e.g., after a prefix prepended to the
+// program sources, are followed, so that the line restored after an expanded
+// header is the one the compiler would have seen.
+static void clqmcExpandSource(clqmcSourceBuffer* buf, const char* source, size_t length, const char* name,
+    unsigned char* expanded, size_t numHeaders, int topLevel)
+{
+  const char* end = source + length;
+  const char* line = source;
+  size_t lineNumber = 1;
+  char lineName[128];
+  const char* currentName = name;
+
+  while (line < end) {
+    const char* next = memchr(line, '\n', (size_t) (end - line));
+    next = next ? next + 1 : end;
+    const clqmcEmbeddedHeader* header = clqmcFindIncludedHeader(line, next);
+    size_t directiveNumber;
+    char directiveName[sizeof(lineName)];
+    if (!header && clqmcParseLineDirective(line, next, &directiveNumber, directiveName, sizeof(directiveName))) {
+      // the directive numbers the next line, after the increment below
+      clqmcSourceAppend(buf, line, (size_t) (next - line));
+      lineNumber = directiveNumber - 1;
+      if (directiveName[0]) {
+        strcpy(lineName, directiveName);
+        currentName = lineName;
+      }
+    }
+    else {
+      if (header && topLevel)
+        memset(expanded, 0, numHeaders);
+      if (header && !expanded[header - clqmcEmbeddedHeaders]) {
+        expanded[header - clqmcEmbeddedHeaders] = 1;
+        clqmcSourceAppendLine(buf, 1, header->name);
+        clqmcExpandSource(buf, header->source, header->length, header->name, expanded, numHeaders, 0);
+        if (buf->size > 0 && buf->data[buf->size - 1] != '\n')
+          clqmcSourceAppend(buf, "\n", 1);
+        clqmcSourceAppendLine(buf, lineNumber + 1, currentName);
+      }
+      else if (header || (!topLevel && clqmcIsPragmaOnce(line, next)))
+        clqmcSourceAppend(buf, "\n", 1);
+      else
+        clqmcSourceAppend(buf, line, (size_t) (next - line));
+    }
+    line = next;
+    lineNumber++;
+  }
+}
+
+char* clqmcExpandDeviceSource(cl_uint count, const char** strings, const size_t* lengths, size_t* length, clqmcStatus* err, const char* caller)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  clqmcSourceBuffer source = { NULL, 0, 0, 0 };
+  clqmcSourceBuffer result = { NULL, 0, 0, 0 };
+  unsigned char* expanded = NULL;
+  size_t numHeaders = 0;
+
+  if (count == 0 || strings == NULL)
+    err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): at least one source string is required", caller);
+
+  // The strings are concatenated, as by clCreateProgramWithSource(), so that
+  // a directive may span several strings.
+  for (cl_uint i = 0; err_ == CLQMC_SUCCESS && i < count; i++) {
+    if (strings[i] == NULL)
+      err_ = clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): source string %u is NULL", caller, i);
+    else
+      clqmcSourceAppend(&source, strings[i], lengths && lengths[i] ? lengths[i] : strlen(strings[i]));
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    while (clqmcEmbeddedHeaders[numHeaders].name)
+      numHeaders++;
+    expanded = (unsigned char*) calloc(numHeaders + 1, 1);
+    if (!expanded || source.failed)
+      err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for the program source", caller);
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    clqmcSourceAppend(&result, "", 0);
+    clqmcExpandSource(&result, source.data, source.size, CLQMC_PROGRAM_SOURCE_NAME, expanded, numHeaders, 1);
+  }
+
+  if (err_ == CLQMC_SUCCESS && result.failed)
+    err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for the program source", caller);
+
+  free(source.data);
+  free(expanded);
+  if (err_ != CLQMC_SUCCESS) {
+    free(result.data);
+    result.data = NULL;
+    result.size = 0;
+  }
+  if (length)
+    *length = result.size;
+  if (err)
+    *err = err_;
+  return result.data;
+}
+
+cl_ulong clqmcHashBytes(cl_ulong hash, const void* data, size_t size)
+{
+  const unsigned char* bytes = (const unsigned char*) data;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+cl_program clqmcCreateProgramWithSource(cl_context context, cl_uint count, const char** strings, const size_t* lengths,
+    cl_ulong* hash, clqmcStatus* err)
+{
+  clqmcStatus err_;
+  cl_program program = NULL;
+  size_t length;
+  char* source = clqmcExpandDeviceSource(count, strings, lengths, &length, &err_, __func__);
+
+  if (err_ == CLQMC_SUCCESS) {
+    cl_int clerr;
+    program = clCreateProgramWithSource(context, 1, (const char**) &source, &length, &clerr);
+    if (clerr != CL_SUCCESS) {
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot create program", __func__);
+      program = NULL;
+    }
+  }
+  if (err_ == CLQMC_SUCCESS && hash)
+    *hash = clqmcHashBytes(CLQMC_HASH_INIT, source, length);
+
+  free(source);
+  if (err)
+    *err = err_;
+  return program;
+}
+
+/********************************************************************************
+ * Program cache                                                                *
+ ********************************************************************************/
+
+#ifdef _WIN32
+  static SRWLOCK clqmcProgramCacheLock = SRWLOCK_INIT;
+  #define CLQMC_PROGRAM_CACHE_LOCK()    AcquireSRWLockExclusive(&clqmcProgramCacheLock)
+  #define CLQMC_PROGRAM_CACHE_UNLOCK()  ReleaseSRWLockExclusive(&clqmcProgramCacheLock)
+#else
+  static pthread_mutex_t clqmcProgramCacheLock = PTHREAD_MUTEX_INITIALIZER;
+  #define CLQMC_PROGRAM_CACHE_LOCK()    pthread_mutex_lock(&clqmcProgramCacheLock)
+  #define CLQMC_PROGRAM_CACHE_UNLOCK()  pthread_mutex_unlock(&clqmcProgramCacheLock)
+#endif
+
+// The programs are keyed by context, device, hash of the expanded source and
+// build options.  A cached program keeps its context alive, so the context
+// of an entry cannot be released and its address reused.
+typedef struct clqmcProgramCacheEntry_ {
+  cl_context context;
+  cl_device_id device;
+  cl_ulong hash;
+  char* options;
+  cl_program program;
+  struct clqmcProgramCacheEntry_* next;
+} clqmcProgramCacheEntry;
+
+static clqmcProgramCacheEntry* clqmcProgramCache = NULL;
+
+// Return the cached program for the key, retained, or NULL.  The cache must
+// be locked.
+static cl_program clqmcProgramCacheFind(cl_context context, cl_device_id device, cl_ulong hash, const char* options)
+{
+  for (clqmcProgramCacheEntry* entry = clqmcProgramCache; entry; entry = entry->next) {
+    if (entry->context == context && entry->device == device && entry->hash == hash && strcmp(entry->options, options) == 0) {
+      clRetainProgram(entry->program);
+      return entry->program;
+    }
+  }
+  return NULL;
+}
+
+cl_program clqmcBuildProgramWithSource(cl_context context, cl_device_id device, cl_uint count, const char** strings, const size_t* lengths,
+    const char* options, clqmcStatus* err)
+{
+  clqmcStatus err_;
+  cl_program program = NULL;
+  size_t length;
+  char* source = clqmcExpandDeviceSource(count, strings, lengths, &length, &err_, __func__);
+  cl_ulong hash = 0;
+
+  if (!options)
+    options = "";
+
+  if (err_ == CLQMC_SUCCESS) {
+    hash = clqmcHashBytes(CLQMC_HASH_INIT, source, length);
+    CLQMC_PROGRAM_CACHE_LOCK();
+    program = clqmcProgramCacheFind(context, device, hash, options);
+    CLQMC_PROGRAM_CACHE_UNLOCK();
+  }
+
+  // Build outside of the lock, so that concurrent builds of different
+  // programs do not wait for one another.
+  if (err_ == CLQMC_SUCCESS && !program) {
+    cl_int clerr;
+    program = clCreateProgramWithSource(context, 1, (const char**) &source, &length, &clerr);
+    if (clerr != CL_SUCCESS) {
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot create program", __func__);
+      program = NULL;
+    }
+    else if ((clerr = clBuildProgram(program, 1, &device, options, NULL, NULL)) != CL_SUCCESS) {
+      char log[512] = "";
+      clGetProgramBuildInfo(program, device, CL_PROGRAM_BUILD_LOG, sizeof(log) - 1, log, NULL);
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot build program:\n%s", __func__, log);
+      clReleaseProgram(program);
+      program = NULL;
+    }
+
+    clqmcProgramCacheEntry* entry = NULL;
+    if (err_ == CLQMC_SUCCESS) {
+      entry = (clqmcProgramCacheEntry*) malloc(sizeof(clqmcProgramCacheEntry));
+      char* optionsCopy = (char*) malloc(strlen(options) + 1);
+      if (entry && optionsCopy) {
+        strcpy(optionsCopy, options);
+        entry->context = context;
+        entry->device = device;
+        entry->hash = hash;
+        entry->options = optionsCopy;
+        entry->program = program;
+      }
+      else {
+        // the program is usable even if it cannot be cached
+        free(entry);
+        free(optionsCopy);
+        entry = NULL;
+      }
+    }
+
+    if (entry) {
+      CLQMC_PROGRAM_CACHE_LOCK();
+      cl_program cached = clqmcProgramCacheFind(context, device, hash, options);
+      if (cached) {
+        // built concurrently by another thread
+        clReleaseProgram(program);
+        program = cached;
+        free(entry->options);
+        free(entry);
+      }
+      else {
+        clRetainProgram(program);
+        entry->next = clqmcProgramCache;
+        clqmcProgramCache = entry;
+      }
+      CLQMC_PROGRAM_CACHE_UNLOCK();
+    }
+  }
+
+  free(source);
+  if (err)
+    *err = err_;
+  return program;
+}
+
+clqmcStatus clqmcReleaseProgramCache(void)
+{
+  CLQMC_PROGRAM_CACHE_LOCK();
+  clqmcProgramCacheEntry* entry = clqmcProgramCache;
+  clqmcProgramCache = NULL;
+  CLQMC_PROGRAM_CACHE_UNLOCK();
+
+  while (entry) {
+    clqmcProgramCacheEntry* next = entry->next;
+    clReleaseProgram(entry->program);
+    free(entry->options);
+    free(entry);
+    entry = next;
+  }
+  return CLQMC_SUCCESS;
+}
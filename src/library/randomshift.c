@@ -0,0 +1,168 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+#include "clQMC/randomshift.h"
+#include "private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// code that is common to the host and to the device
+#include "../include/clQMC/private/randomshift.c.h"
+
+struct clqmcRandomShiftGenerator_ {
+  cl_program program;
+  cl_kernel kernel;
+};
+
+// Kernel that wraps the device function of randomshift.clh, with one work
+// item per coordinate.
+static const char clqmcRandomShiftGeneratorSource[] =
+  "#include <clQMC/randomshift.clh>\n"
+  "__kernel void clqmcRandomShiftsKernel(ulong seed, uint firstReplication, uint dimension,\n"
+  "    __global clqmc_fptype* shifts)\n"
+  "{\n"
+  "  uint i = get_global_id(0);\n"
+  "  shifts[i] = clqmcRandomShiftCoordinate(seed, firstReplication + i / dimension, i % dimension);\n"
+  "}\n";
+
+// The replications are independent, so they are distributed among threads,
+// and the coordinates of a replication are generated in SIMD lanes.
+#if defined(_OPENMP) && defined(_MSC_VER)
+  #define CLQMC_PRAGMA_OMP_PARALLEL_FOR __pragma(omp parallel for)
+#elif defined(_OPENMP)
+  #define CLQMC_PRAGMA_OMP_PARALLEL_FOR _Pragma("omp parallel for")
+#else
+  #define CLQMC_PRAGMA_OMP_PARALLEL_FOR
+#endif
+#if defined(_OPENMP) && _OPENMP >= 201307
+  #define CLQMC_PRAGMA_OMP_SIMD _Pragma("omp simd")
+#else
+  #define CLQMC_PRAGMA_OMP_SIMD
+#endif
+
+#define IMPLEMENT_GENERATE_FOR_TYPE(fptype) \
+  clqmcStatus clqmcRandomShiftsGenerate_##fptype(cl_ulong seed, cl_uint firstReplication, cl_uint replications, cl_uint dimension, fptype* shifts) \
+  { \
+    if (!shifts) \
+      return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): shifts cannot be NULL", __func__); \
+    long count = (long) replications; \
+    CLQMC_PRAGMA_OMP_PARALLEL_FOR \
+    for (long k = 0; k < count; k++) { \
+      fptype* shift = shifts + (size_t) k * dimension; \
+      cl_uint replication = firstReplication + (cl_uint) k; \
+      CLQMC_PRAGMA_OMP_SIMD \
+      for (cl_uint j = 0; j < dimension; j++) \
+        shift[j] = clqmcRandomShiftCoordinate_##fptype(seed, replication, j); \
+    } \
+    return CLQMC_SUCCESS; \
+  }
+
+IMPLEMENT_GENERATE_FOR_TYPE(clqmc_float)
+IMPLEMENT_GENERATE_FOR_TYPE(clqmc_double)
+#undef IMPLEMENT_GENERATE_FOR_TYPE
+#undef CLQMC_PRAGMA_OMP_PARALLEL_FOR
+#undef CLQMC_PRAGMA_OMP_SIMD
+
+static clqmcRandomShiftGenerator* clqmcRandomShiftGeneratorCreate_(cl_context context, cl_device_id device,
+    const char* precisionOption, clqmcStatus* err, const char* caller)
+{
+  clqmcStatus err_ = CLQMC_SUCCESS;
+  cl_int clerr;
+  clqmcRandomShiftGenerator* generator = (clqmcRandomShiftGenerator*) calloc(1, sizeof(clqmcRandomShiftGenerator));
+
+  if (!generator)
+    err_ = clqmcSetErrorString(CLQMC_OUT_OF_RESOURCES, "%s(): could not allocate memory for generator", caller);
+
+  if (err_ == CLQMC_SUCCESS) {
+    const char* source = clqmcRandomShiftGeneratorSource;
+    generator->program = clqmcCreateProgramWithSource(context, 1, &source, NULL, NULL, &err_);
+    if (err_ == CLQMC_SUCCESS && (clerr = clBuildProgram(generator->program, 1, &device, precisionOption, NULL, NULL)) != CL_SUCCESS) {
+      char log[512] = "";
+      clGetProgramBuildInfo(generator->program, device, CL_PROGRAM_BUILD_LOG, sizeof(log) - 1, log, NULL);
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot build program:\n%s", caller, log);
+    }
+  }
+
+  if (err_ == CLQMC_SUCCESS) {
+    generator->kernel = clCreateKernel(generator->program, "clqmcRandomShiftsKernel", &clerr);
+    if (clerr != CL_SUCCESS)
+      err_ = clqmcSetErrorString(clerr, "%s(): cannot create kernel", caller);
+  }
+
+  if (err_ != CLQMC_SUCCESS) {
+    clqmcRandomShiftGeneratorDestroy(generator);
+    generator = NULL;
+  }
+  if (err)
+    *err = err_;
+  return generator;
+}
+
+#define IMPLEMENT_GENERATOR_CREATE_FOR_TYPE(fptype, precisionOption) \
+  clqmcRandomShiftGenerator* clqmcRandomShiftGeneratorCreate_##fptype(cl_context context, cl_device_id device, clqmcStatus* err) \
+  { \
+    return clqmcRandomShiftGeneratorCreate_(context, device, precisionOption, err, __func__); \
+  }
+
+IMPLEMENT_GENERATOR_CREATE_FOR_TYPE(clqmc_float, "-DCLQMC_SINGLE_PRECISION")
+IMPLEMENT_GENERATOR_CREATE_FOR_TYPE(clqmc_double, "")
+#undef IMPLEMENT_GENERATOR_CREATE_FOR_TYPE
+
+clqmcStatus clqmcRandomShiftGeneratorDestroy(clqmcRandomShiftGenerator* generator)
+{
+  if (generator == NULL)
+    return CLQMC_SUCCESS;
+  if (generator->kernel)
+    clReleaseKernel(generator->kernel);
+  if (generator->program)
+    clReleaseProgram(generator->program);
+  free(generator);
+  return CLQMC_SUCCESS;
+}
+
+clqmcStatus clqmcRandomShiftGeneratorEnqueue(clqmcRandomShiftGenerator* generator, cl_command_queue queue, cl_ulong seed,
+    cl_uint firstReplication, cl_uint replications, cl_uint dimension, cl_mem shifts,
+    cl_uint numEventsInWaitList, const cl_event* eventWaitList, cl_event* event)
+{
+  if (!generator)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): generator cannot be NULL", __func__);
+  if (!shifts)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): shifts cannot be NULL", __func__);
+  if (replications == 0 || dimension == 0)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): replications and dimension must be positive", __func__);
+
+  cl_int err;
+  err  = clSetKernelArg(generator->kernel, 0, sizeof(seed), &seed);
+  err |= clSetKernelArg(generator->kernel, 1, sizeof(firstReplication), &firstReplication);
+  err |= clSetKernelArg(generator->kernel, 2, sizeof(dimension), &dimension);
+  err |= clSetKernelArg(generator->kernel, 3, sizeof(shifts), &shifts);
+  if (err != CL_SUCCESS)
+    return clqmcSetErrorString(CLQMC_INVALID_VALUE, "%s(): cannot set kernel arguments", __func__);
+
+  size_t globalSize = (size_t) replications * dimension;
+  err = clEnqueueNDRangeKernel(queue, generator->kernel, 1, NULL, &globalSize, NULL, numEventsInWaitList, eventWaitList, event);
+  if (err != CL_SUCCESS)
+    return clqmcSetErrorString(err, "%s(): cannot enqueue kernel", __func__);
+  return CLQMC_SUCCESS;
+}
@@ -0,0 +1,547 @@
+/* This file is part of clQMC.
+ *
+ * Copyright 2015-2016  Pierre L'Ecuyer, Universite de Montreal and Advanced Micro Devices, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * Authors:
+ *
+ *   David Munger <mungerd@iro.umontreal.ca>        (2015)
+ *   Pierre L'Ecuyer <lecuyer@iro.umontreal.ca>     (2015)
+ *
+ */
+
+// Generator for the catalogue of lattice rules (src/library/latticecatalogue.h).
+//
+// This program is not part of the build.  It is run offline whenever the
+// catalogue must be extended, with:
+//
+//   cc -O2 -std=c99 -o gencatalogue src/tools/gencatalogue.c -lm
+//   ./gencatalogue > src/library/latticecatalogue.h
+//
+// All searches minimize the P_2 criterion, i.e., the square worst-case error
+// of the shift-averaged rule in the weighted Korobov space of smoothness 1
+// (weighted Sobolev space with the baker's transformation), with product
+// weights:
+//
+//   e^2(z) = -1 + (1/n) sum_{k=0}^{n-1} prod_{j=1}^{s} (1 + gamma_j w(k z_j / n)),
+//
+// where w(x) = 2 pi^2 (x^2 - x + 1/6).
+//
+// For n = 2^m, the search over the units z = +-5^b mod n, b = 0, ..., n/4-1,
+// is carried out in O(n log n) time per coordinate with fast component-by-
+// component (CBC) construction: points k = 2^t u with u odd are grouped by t,
+// and the sum over u of each group is a circular cross-correlation over the
+// cyclic group generated by 5 modulo 2^(m-t), which is evaluated with FFTs.
+// Because of the symmetry w(x) = w(1-x), the sign of z does not matter and
+// the catalogue stores min(z, n - z).
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define CBC_MIN_LOG2     4
+#define CBC_MAX_LOG2     22
+#define CBC_MAX_DIM      128
+
+#define KOROBOV_MIN_LOG2 4
+#define KOROBOV_MAX_LOG2 20
+#define KOROBOV_NUM_DIMS 4
+static const unsigned korobovDims[KOROBOV_NUM_DIMS] = { 4, 8, 16, 32 };
+// Korobov searches are exhaustive up to this number of candidates and
+// evenly subsampled otherwise
+#define KOROBOV_MAX_CANDIDATES 1024
+
+#define EMBEDDED_MIN_LOG2 4
+#define EMBEDDED_MAX_LOG2 22
+#define EMBEDDED_MAX_DIM  128
+
+enum { WEIGHTS_POLY, WEIGHTS_GEOM };
+
+static double weight(int family, unsigned j)
+{
+  // j is 0-based
+  if (family == WEIGHTS_POLY)
+    return 1.0 / ((j + 1.0) * (j + 1.0));
+  else
+    return pow(0.9, j + 1.0);
+}
+
+static void* xmalloc(size_t size)
+{
+  void* p = malloc(size);
+  if (!p) {
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  return p;
+}
+
+// w(i / n) for i = 0, ..., n-1
+static double* omegaTable(uint32_t n)
+{
+  double* w = (double*) xmalloc(n * sizeof(double));
+  for (uint32_t i = 0; i < n; i++) {
+    double x = (double) i / n;
+    w[i] = 2.0 * M_PI * M_PI * (x * x - x + 1.0 / 6.0);
+  }
+  return w;
+}
+
+
+//
+// In-place radix-2 complex FFT
+//
+
+// twr[i] + I twi[i] = exp(-2 pi I i / len) for i < len / 2
+static void fftTwiddles(uint32_t len, double** twr, double** twi)
+{
+  *twr = (double*) xmalloc((len / 2 + 1) * sizeof(double));
+  *twi = (double*) xmalloc((len / 2 + 1) * sizeof(double));
+  for (uint32_t i = 0; i < len / 2 + 1; i++) {
+    (*twr)[i] = cos(2.0 * M_PI * i / len);
+    (*twi)[i] = -sin(2.0 * M_PI * i / len);
+  }
+}
+
+// The twiddle factors must have been computed for a size that is a multiple
+// of len.
+static void fft(double* re, double* im, uint32_t len, int inverse, const double* twr, const double* twi, uint32_t twlen)
+{
+  for (uint32_t i = 1, j = 0; i < len; i++) {
+    uint32_t bit = len >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      double t;
+      t = re[i]; re[i] = re[j]; re[j] = t;
+      t = im[i]; im[i] = im[j]; im[j] = t;
+    }
+  }
+  for (uint32_t size = 2; size <= len; size <<= 1) {
+    uint32_t stride = twlen / size;
+    for (uint32_t k = 0; k < size / 2; k++) {
+      double wr = twr[k * stride];
+      double wi = inverse ? -twi[k * stride] : twi[k * stride];
+      for (uint32_t i = k; i < len; i += size) {
+        uint32_t j = i + size / 2;
+        double xr = re[j] * wr - im[j] * wi;
+        double xi = re[j] * wi + im[j] * wr;
+        re[j] = re[i] - xr;
+        im[j] = im[i] - xi;
+        re[i] += xr;
+        im[i] += xi;
+      }
+    }
+  }
+  if (inverse)
+    for (uint32_t i = 0; i < len; i++) {
+      re[i] /= len;
+      im[i] /= len;
+    }
+}
+
+
+//
+// Fast CBC
+//
+
+typedef struct {
+  unsigned m;
+  uint32_t n;
+  uint32_t L;           // n / 4
+  uint32_t* pow5;       // 5^b mod n, b = 0, ..., L-1
+  double* omega;        // w(i / n)
+  double* p;            // product over the selected coordinates, for each point
+  double* twr; double* twi;
+  // FFT of w((5^a mod n_t) / n_t) for each level t, which does not depend on
+  // the coordinate
+  double* br; double* bi;
+  // scratch space
+  double* ar; double* ai;
+} CBC;
+
+static void cbcInit(CBC* c, unsigned m)
+{
+  c->m = m;
+  c->n = (uint32_t) 1 << m;
+  c->L = c->n / 4;
+  c->pow5 = (uint32_t*) xmalloc(c->L * sizeof(uint32_t));
+  uint32_t x = 1;
+  for (uint32_t b = 0; b < c->L; b++) {
+    c->pow5[b] = x;
+    x = (uint32_t) (((uint64_t) x * 5) & (c->n - 1));
+  }
+  c->omega = omegaTable(c->n);
+  c->p = (double*) xmalloc(c->n * sizeof(double));
+  for (uint32_t k = 0; k < c->n; k++)
+    c->p[k] = 1.0;
+  fftTwiddles(c->L, &c->twr, &c->twi);
+  c->ar = (double*) xmalloc(c->L * sizeof(double));
+  c->ai = (double*) xmalloc(c->L * sizeof(double));
+  c->br = (double*) xmalloc(2 * c->L * sizeof(double));
+  c->bi = (double*) xmalloc(2 * c->L * sizeof(double));
+  size_t offset = 0;
+  for (unsigned t = 0; t + 2 <= m; t++) {
+    uint32_t nt = c->n >> t;
+    uint32_t Lt = nt / 4;
+    for (uint32_t a = 0; a < Lt; a++) {
+      c->br[offset + a] = c->omega[(size_t) (c->pow5[a] & (nt - 1)) << t];
+      c->bi[offset + a] = 0.0;
+    }
+    fft(c->br + offset, c->bi + offset, Lt, 0, c->twr, c->twi, c->L);
+    offset += Lt;
+  }
+}
+
+static void cbcFree(CBC* c)
+{
+  free(c->pow5); free(c->omega); free(c->p);
+  free(c->twr); free(c->twi);
+  free(c->ar); free(c->ai); free(c->br); free(c->bi);
+}
+
+// Compute, for each level t = 0, ..., m-1 and each b in [0, L_t), the sum
+//
+//   S_t(b) = sum_{u odd, u < n_t} p[2^t u] w((u 5^b mod n_t) / n_t),
+//
+// with n_t = 2^(m-t) and L_t = max(n_t / 4, 1), and store it in
+// S[offset_t + b] with offset_t = L_0 + ... + L_{t-1}.
+static void cbcLevelSums(CBC* c, double* S)
+{
+  size_t offset = 0;
+  for (unsigned t = 0; t < c->m; t++) {
+    uint32_t nt = c->n >> t;
+    if (nt < 4) {
+      // n_t = 2: single point u = 1, with u 5^b mod 2 = 1
+      S[offset++] = c->p[(size_t) 1 << t] * c->omega[c->n / 2];
+      continue;
+    }
+    uint32_t Lt = nt / 4;
+    // 5^a mod n_t = pow5[a] mod n_t
+    for (uint32_t a = 0; a < Lt; a++) {
+      uint32_t u = c->pow5[a] & (nt - 1);
+      c->ar[a] = c->p[(size_t) u << t] + c->p[(size_t) (nt - u) << t];
+      c->ai[a] = 0.0;
+    }
+    fft(c->ar, c->ai, Lt, 0, c->twr, c->twi, c->L);
+    // cross-correlation: conj(A) * B
+    const double* br = c->br + offset;
+    const double* bi = c->bi + offset;
+    for (uint32_t a = 0; a < Lt; a++) {
+      double re = c->ar[a] * br[a] + c->ai[a] * bi[a];
+      double im = c->ar[a] * bi[a] - c->ai[a] * br[a];
+      c->ar[a] = re;
+      c->ai[a] = im;
+    }
+    fft(c->ar, c->ai, Lt, 1, c->twr, c->twi, c->L);
+    memcpy(S + offset, c->ar, Lt * sizeof(double));
+    offset += Lt;
+  }
+}
+
+static size_t cbcLevelSumsSize(const CBC* c)
+{
+  size_t size = 0;
+  for (unsigned t = 0; t < c->m; t++)
+    size += (c->n >> t) < 4 ? 1 : (c->n >> t) / 4;
+  return size;
+}
+
+static void cbcUpdate(CBC* c, uint32_t z, double gamma)
+{
+  uint32_t mask = c->n - 1;
+  uint32_t kz = 0;
+  for (uint32_t k = 0; k < c->n; k++) {
+    c->p[k] *= 1.0 + gamma * c->omega[kz];
+    kz = (kz + z) & mask;
+  }
+}
+
+static uint32_t canonical(uint32_t z, uint32_t n)
+{
+  return z <= n / 2 ? z : n - z;
+}
+
+// Standard CBC construction for n = 2^m points
+static void cbcSearch(unsigned m, unsigned dim, int family, uint32_t* z)
+{
+  CBC c;
+  cbcInit(&c, m);
+  double* S = (double*) xmalloc(cbcLevelSumsSize(&c) * sizeof(double));
+  z[0] = 1;
+  cbcUpdate(&c, 1, weight(family, 0));
+  for (unsigned j = 1; j < dim; j++) {
+    cbcLevelSums(&c, S);
+    double best = INFINITY;
+    uint32_t bestb = 0;
+    for (uint32_t b = 0; b < c.L; b++) {
+      double sum = 0.0;
+      size_t offset = 0;
+      for (unsigned t = 0; t < c.m; t++) {
+        uint32_t nt = c.n >> t;
+        uint32_t Lt = nt < 4 ? 1 : nt / 4;
+        sum += S[offset + (b & (Lt - 1))];
+        offset += Lt;
+      }
+      if (sum < best) {
+        best = sum;
+        bestb = b;
+      }
+    }
+    z[j] = canonical(c.pow5[bestb], c.n);
+    cbcUpdate(&c, z[j], weight(family, j));
+  }
+  free(S);
+  cbcFree(&c);
+}
+
+// Embedded (extensible) CBC construction for n = 2^mmin, ..., 2^mmax points:
+// each component minimizes the sum over the levels of n^2 e^2, where the
+// generating vector for 2^k points is z mod 2^k.
+static void embeddedSearch(unsigned mmin, unsigned mmax, unsigned dim, int family, uint32_t* z)
+{
+  CBC c;
+  cbcInit(&c, mmax);
+  double* S = (double*) xmalloc(cbcLevelSumsSize(&c) * sizeof(double));
+  double* levelSum = (double*) xmalloc(c.L * sizeof(double));
+  z[0] = 1;
+  cbcUpdate(&c, 1, weight(family, 0));
+  for (unsigned j = 1; j < dim; j++) {
+    cbcLevelSums(&c, S);
+    // The points of the rule with 2^k points are the points with indices
+    // that are multiples of 2^(m-k), so the criterion for 2^k points only
+    // involves the levels t >= m - k.
+    // Accumulate from the coarsest level.
+    size_t offsets[32];
+    size_t offset = 0;
+    for (unsigned t = 0; t < c.m; t++) {
+      offsets[t] = offset;
+      offset += (c.n >> t) < 4 ? 1 : (c.n >> t) / 4;
+    }
+    for (uint32_t b = 0; b < c.L; b++)
+      levelSum[b] = 0.0;
+    double* crit = (double*) xmalloc(c.L * sizeof(double));
+    for (uint32_t b = 0; b < c.L; b++)
+      crit[b] = 0.0;
+    for (unsigned k = 1; k <= c.m; k++) {
+      unsigned t = c.m - k;
+      uint32_t nt = c.n >> t;
+      uint32_t Lt = nt < 4 ? 1 : nt / 4;
+      for (uint32_t b = 0; b < c.L; b++)
+        levelSum[b] += S[offsets[t] + (b & (Lt - 1))];
+      if (k >= mmin) {
+        // n^2 e^2 up to a constant that does not depend on b
+        double scale = (double) nt;
+        for (uint32_t b = 0; b < c.L; b++)
+          crit[b] += scale * levelSum[b];
+      }
+    }
+    double best = INFINITY;
+    uint32_t bestb = 0;
+    for (uint32_t b = 0; b < c.L; b++)
+      if (crit[b] < best) {
+        best = crit[b];
+        bestb = b;
+      }
+    free(crit);
+    // no sign symmetry across levels: keep 5^b
+    z[j] = c.pow5[bestb];
+    cbcUpdate(&c, z[j], weight(family, j));
+  }
+  free(levelSum);
+  free(S);
+  cbcFree(&c);
+}
+
+
+//
+// Korobov search
+//
+
+static double korobovCriterion(uint32_t n, unsigned dim, int family, uint32_t a, const double* omega, double* p)
+{
+  uint32_t mask = n - 1;
+  for (uint32_t k = 0; k < n; k++)
+    p[k] = 1.0;
+  uint32_t zj = 1;
+  for (unsigned j = 0; j < dim; j++) {
+    double gamma = weight(family, j);
+    uint32_t kz = 0;
+    for (uint32_t k = 0; k < n; k++) {
+      p[k] *= 1.0 + gamma * omega[kz];
+      kz = (kz + zj) & mask;
+    }
+    zj = (uint32_t) (((uint64_t) zj * a) & mask);
+  }
+  double sum = 0.0;
+  for (uint32_t k = 0; k < n; k++)
+    sum += p[k];
+  return sum / n - 1.0;
+}
+
+static uint32_t korobovSearch(unsigned m, unsigned dim, int family)
+{
+  uint32_t n = (uint32_t) 1 << m;
+  uint32_t L = n / 4;
+  uint32_t step = L > KOROBOV_MAX_CANDIDATES ? L / KOROBOV_MAX_CANDIDATES : 1;
+  double* omega = omegaTable(n);
+  double* p = (double*) xmalloc(n * sizeof(double));
+  double best = INFINITY;
+  uint32_t besta = 1;
+  // a = 5^b mod n; b = 0 (a = 1) is useless and skipped
+  uint32_t a = 1;
+  uint64_t pow5step = 1;
+  for (uint32_t i = 0; i < step; i++)
+    pow5step = (pow5step * 5) & (n - 1);
+  for (uint32_t b = step; b < L; b += step) {
+    a = (uint32_t) (((uint64_t) a * pow5step) & (n - 1));
+    double crit = korobovCriterion(n, dim, family, a, omega, p);
+    if (crit < best) {
+      best = crit;
+      besta = a;
+    }
+  }
+  free(p);
+  free(omega);
+  return canonical(besta, n);
+}
+
+
+//
+// Output
+//
+
+// Bit-packed output of a list of values of the given width
+typedef struct {
+  uint32_t word;
+  unsigned used;
+  unsigned count;
+  size_t bits;
+} Packer;
+
+static void packPut(Packer* pk, uint32_t value, unsigned width)
+{
+  for (unsigned i = 0; i < width; i++) {
+    pk->word |= ((value >> i) & 1u) << pk->used;
+    pk->bits++;
+    if (++pk->used == 32) {
+      printf("%s0x%08xu,", pk->count % 6 == 0 ? "\n  " : " ", pk->word);
+      pk->count++;
+      pk->word = 0;
+      pk->used = 0;
+    }
+  }
+}
+
+static void packFlush(Packer* pk)
+{
+  if (pk->used > 0) {
+    printf("%s0x%08xu,", pk->count % 6 == 0 ? "\n  " : " ", pk->word);
+    pk->count++;
+    pk->word = 0;
+    pk->used = 0;
+  }
+}
+
+static void writeCbcFamily(const char* name, int family)
+{
+  uint32_t z[CBC_MAX_DIM];
+  size_t offsets[CBC_MAX_LOG2 + 2];
+  Packer pk = { 0, 0, 0, 0 };
+  printf("static const cl_uint %sData[] = {", name);
+  for (unsigned m = CBC_MIN_LOG2; m <= CBC_MAX_LOG2; m++) {
+    fprintf(stderr, "%s: n = 2^%u\n", name, m);
+    cbcSearch(m, CBC_MAX_DIM, family, z);
+    offsets[m] = pk.bits;
+    // z is odd and smaller than n / 2: store (z - 1) / 2 on m - 2 bits
+    for (unsigned j = 0; j < CBC_MAX_DIM; j++)
+      packPut(&pk, (z[j] - 1) / 2, m - 2);
+  }
+  packFlush(&pk);
+  printf("\n};\n\n");
+  printf("static const cl_uint %sOffset[] = {", name);
+  for (unsigned m = CBC_MIN_LOG2; m <= CBC_MAX_LOG2; m++)
+    printf("%s%lu,", (m - CBC_MIN_LOG2) % 8 == 0 ? "\n  " : " ", (unsigned long) offsets[m]);
+  printf("\n};\n\n");
+}
+
+static void writeEmbeddedFamily(const char* name, int family)
+{
+  uint32_t z[EMBEDDED_MAX_DIM];
+  Packer pk = { 0, 0, 0, 0 };
+  fprintf(stderr, "%s\n", name);
+  embeddedSearch(EMBEDDED_MIN_LOG2, EMBEDDED_MAX_LOG2, EMBEDDED_MAX_DIM, family, z);
+  printf("static const cl_uint %sData[] = {", name);
+  // z is odd and smaller than 2^mmax: store (z - 1) / 2 on mmax - 1 bits
+  for (unsigned j = 0; j < EMBEDDED_MAX_DIM; j++)
+    packPut(&pk, (z[j] - 1) / 2, EMBEDDED_MAX_LOG2 - 1);
+  packFlush(&pk);
+  printf("\n};\n\n");
+}
+
+static void writeKorobovFamily(const char* name, int family)
+{
+  printf("static const cl_uint %sData[][%d] = {\n", name, KOROBOV_NUM_DIMS);
+  for (unsigned m = KOROBOV_MIN_LOG2; m <= KOROBOV_MAX_LOG2; m++) {
+    printf("  {");
+    for (unsigned i = 0; i < KOROBOV_NUM_DIMS; i++) {
+      fprintf(stderr, "%s: n = 2^%u, s = %u\n", name, m, korobovDims[i]);
+      printf(" %lu%s", (unsigned long) korobovSearch(m, korobovDims[i], family), i + 1 < KOROBOV_NUM_DIMS ? "," : "");
+    }
+    printf(" },\n");
+  }
+  printf("};\n\n");
+}
+
+int main(void)
+{
+  printf("// Catalogue of lattice rules\n");
+  printf("//\n");
+  printf("// This file was generated by src/tools/gencatalogue.c; do not edit.\n");
+  printf("\n");
+  printf("#define CATALOGUE_CBC_MIN_LOG2      %d\n", CBC_MIN_LOG2);
+  printf("#define CATALOGUE_CBC_MAX_LOG2      %d\n", CBC_MAX_LOG2);
+  printf("#define CATALOGUE_CBC_MAX_DIM       %d\n", CBC_MAX_DIM);
+  printf("#define CATALOGUE_KOROBOV_MIN_LOG2  %d\n", KOROBOV_MIN_LOG2);
+  printf("#define CATALOGUE_KOROBOV_MAX_LOG2  %d\n", KOROBOV_MAX_LOG2);
+  printf("#define CATALOGUE_KOROBOV_NUM_DIMS  %d\n", KOROBOV_NUM_DIMS);
+  printf("#define CATALOGUE_EMBEDDED_MIN_LOG2 %d\n", EMBEDDED_MIN_LOG2);
+  printf("#define CATALOGUE_EMBEDDED_MAX_LOG2 %d\n", EMBEDDED_MAX_LOG2);
+  printf("#define CATALOGUE_EMBEDDED_MAX_DIM  %d\n", EMBEDDED_MAX_DIM);
+  printf("\n");
+  printf("static const cl_uint catalogueKorobovDims[CATALOGUE_KOROBOV_NUM_DIMS] = {");
+  for (unsigned i = 0; i < KOROBOV_NUM_DIMS; i++)
+    printf(" %u%s", korobovDims[i], i + 1 < KOROBOV_NUM_DIMS ? "," : "");
+  printf(" };\n\n");
+  printf("// Generating vectors for the CBC families, for each log2 of the number of\n");
+  printf("// points m and each coordinate j, stored as (z_j - 1) / 2 on m - 2 bits,\n");
+  printf("// starting at bit offset Offset[m - CATALOGUE_CBC_MIN_LOG2] + j (m - 2).\n");
+  writeCbcFamily("catalogueCbcPoly", WEIGHTS_POLY);
+  writeCbcFamily("catalogueCbcGeom", WEIGHTS_GEOM);
+  printf("// Generating vector for the embedded family, stored as (z_j - 1) / 2 on\n");
+  printf("// CATALOGUE_EMBEDDED_MAX_LOG2 - 1 bits, starting at bit offset\n");
+  printf("// j (CATALOGUE_EMBEDDED_MAX_LOG2 - 1).\n");
+  writeEmbeddedFamily("catalogueEmbeddedPoly", WEIGHTS_POLY);
+  printf("// Korobov parameters for each log2 of the number of points and each\n");
+  printf("// dimension in catalogueKorobovDims.\n");
+  writeKorobovFamily("catalogueKorobovPoly", WEIGHTS_POLY);
+  return 0;
+}